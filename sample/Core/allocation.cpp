@@ -0,0 +1,80 @@
+#include "allocation.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counters (All Threads)
+static std::atomic<uint64_t> allocation_count( 0 );
+static std::atomic<uint64_t> allocation_bytes( 0 );
+
+// Retrieve Number of Allocations
+uint64_t allocationCount()
+{
+    return allocation_count.load( std::memory_order_relaxed );
+}
+
+// Retrieve Allocated Bytes
+uint64_t allocationBytes()
+{
+    return allocation_bytes.load( std::memory_order_relaxed );
+}
+
+// Replace Global Allocation Functions (Count, then forward to malloc/free)
+void* operator new( std::size_t size )
+{
+    allocation_count.fetch_add( 1, std::memory_order_relaxed );
+    allocation_bytes.fetch_add( size, std::memory_order_relaxed );
+    void* pointer = std::malloc( size ? size : 1 );
+    if( !pointer ){
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[]( std::size_t size )
+{
+    return operator new( size );
+}
+
+void* operator new( std::size_t size, const std::nothrow_t& ) noexcept
+{
+    allocation_count.fetch_add( 1, std::memory_order_relaxed );
+    allocation_bytes.fetch_add( size, std::memory_order_relaxed );
+    return std::malloc( size ? size : 1 );
+}
+
+void* operator new[]( std::size_t size, const std::nothrow_t& tag ) noexcept
+{
+    return operator new( size, tag );
+}
+
+void operator delete( void* pointer ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete[]( void* pointer ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete( void* pointer, std::size_t ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete[]( void* pointer, std::size_t ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete( void* pointer, const std::nothrow_t& ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete[]( void* pointer, const std::nothrow_t& ) noexcept
+{
+    std::free( pointer );
+}
@@ -0,0 +1,14 @@
+#ifndef __ALLOCATION__
+#define __ALLOCATION__
+
+#include <cstdint>
+
+// Heap Allocation Counter (Link allocation_counter only to benchmarks, counts all threads)
+
+// Retrieve Number of Allocations since Start
+uint64_t allocationCount();
+
+// Retrieve Allocated Bytes since Start
+uint64_t allocationBytes();
+
+#endif // __ALLOCATION__
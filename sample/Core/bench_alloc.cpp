@@ -0,0 +1,170 @@
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "allocation.h"
+#include "benchmark.h"
+#include "pipeline.h"
+#include "user_source.h"
+
+// Allocations per Frame (Counted from update() of frame to update() of next frame)
+struct Allocations
+{
+    std::vector<uint64_t> counts;
+    std::vector<uint64_t> bytes;
+
+    // Constructor (Reserve all samples up front, recording doesn't allocate)
+    explicit Allocations( const uint32_t frames )
+    {
+        counts.reserve( frames + 1 );
+        bytes.reserve( frames + 1 );
+    }
+
+    // Record Counter (Drop samples beyond reserved size)
+    void record()
+    {
+        if( counts.size() == counts.capacity() ){
+            return;
+        }
+        counts.push_back( allocationCount() );
+        bytes.push_back( allocationBytes() );
+    }
+};
+
+// User Pipeline (Same stages as User sample without HighGUI)
+class UserPipeline : public Pipeline<UserSource, UserFrame>
+{
+private:
+    // Allocation Counter
+    Allocations& allocations;
+
+public:
+    // Constructor
+    UserPipeline( std::unique_ptr<UserSource> source, Allocations& allocations )
+        : Pipeline( std::move( source ), DEPTH_KERNEL_SIMD ),
+          allocations( allocations )
+    {
+    }
+
+private:
+    // Update Data
+    void update() override
+    {
+        allocations.record();
+        source->readFrame( *capture_frame );
+    }
+
+    // Draw Data
+    void draw() override
+    {
+        drawDepth();
+        visualizeUser( depth_mat, frame->user_map, colors.data(), static_cast<uint32_t>( colors.size() ), draw_mat, depth_kernel );
+    }
+
+    // Show Data
+    void show() override
+    {
+    }
+
+    // Write Data
+    void write( std::ostream& ) override
+    {
+    }
+};
+
+// Unpooled Frames (New frame, buffers and drawn image every frame)
+static void unpooledFrames( UserSource& source, Allocations& allocations, const uint32_t frames )
+{
+    std::array<cv::Vec3b, COLOR_COUNT> colors;
+    colors.fill( cv::Vec3b( 255, 0, 0 ) );
+
+    cv::Mat image;
+    for( uint32_t count = 0; count < frames; count++ ){
+        allocations.record();
+
+        // Update (Copy frame to keep pixels of frame alive across stages)
+        UserFrame capture_frame;
+        source.readFrame( capture_frame );
+        UserFrame frame;
+        frame.depth_mat = capture_frame.depth_mat.clone();
+        frame.user_map = capture_frame.user_map.clone();
+        frame.users = capture_frame.users;
+
+        // Draw (New image every frame, previous image is still shown)
+        cv::Mat draw_mat( frame.depth_mat.rows, frame.depth_mat.cols, CV_8UC3 );
+        visualizeUser( frame.depth_mat, frame.user_map, colors.data(), static_cast<uint32_t>( colors.size() ), draw_mat, DEPTH_KERNEL_SIMD );
+        image = draw_mat;
+    }
+    allocations.record();
+}
+
+// Write Result Row (Steady State is after warm-up frames)
+static void writeRow( const std::string& uri, const std::string& method, const Allocations& allocations, const uint32_t warmup )
+{
+    const size_t frames = allocations.counts.size() ? allocations.counts.size() - 1 : 0;
+    uint64_t warmup_count = 0, steady_count = 0, steady_bytes = 0, steady_max = 0, steady_frames = 0;
+    for( size_t i = 0; i < frames; i++ ){
+        const uint64_t count = allocations.counts[i + 1] - allocations.counts[i];
+        const uint64_t bytes = allocations.bytes[i + 1] - allocations.bytes[i];
+        if( i < warmup ){
+            warmup_count += count;
+            continue;
+        }
+        steady_count += count;
+        steady_bytes += bytes;
+        steady_max = std::max( steady_max, count );
+        steady_frames++;
+    }
+
+    const double per_frame = steady_frames ? static_cast<double>( steady_count ) / steady_frames : 0.0;
+    const double bytes_per_frame = steady_frames ? static_cast<double>( steady_bytes ) / steady_frames : 0.0;
+    std::cout << uri << "," << method << "," << frames << "," << warmup_count << "," << steady_frames << ","
+              << per_frame << "," << bytes_per_frame << "," << steady_max << std::endl;
+}
+
+// Allocation Benchmark
+// bench_alloc [source] [frames] [warmup]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const std::string uri = ( 1 < argc ) ? argv[1] : "synthetic:640x480@0:6";
+        const uint32_t frames = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 300;
+        const uint32_t warmup = ( 3 < argc ) ? static_cast<uint32_t>( std::stoul( argv[3] ) ) : 10;
+        if( frames <= warmup ){
+            throw std::runtime_error( "failed number of frames must be greater than warm-up frames" );
+        }
+
+        std::cout << "source,method,frames,warmup_allocations,steady_frames,allocations_per_frame,bytes_per_frame,max_allocations_per_frame" << std::endl;
+
+        // Unpooled
+        {
+            std::unique_ptr<UserSource> source = createUserSource( uri );
+            Allocations allocations( frames );
+            unpooledFrames( *source, allocations, frames );
+            writeRow( uri, "unpooled", allocations, warmup );
+        }
+
+        // Pooled (Serial, Pipeline)
+        const bool pipelines[] = { false, true };
+        for( const bool pipeline : pipelines ){
+            Allocations allocations( frames );
+            Benchmark benchmark( "Alloc", uri, pipeline ? "pipeline" : "serial" );
+            {
+                UserPipeline device( createUserSource( uri ), allocations );
+                device.benchmark( benchmark, frames, pipeline, false );
+            }
+            writeRow( uri, pipeline ? "pooled_pipeline" : "pooled_serial", allocations, warmup );
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "point_cloud.h"
+#include "user_source.h"
+
+// Per-Frame Samples of Method
+struct Samples
+{
+    std::vector<double> us;
+    uint64_t points = 0;
+    uint64_t bytes = 0;
+};
+
+// Measure Function [us]
+static void measure( Samples& samples, const std::function<void()>& function )
+{
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    function();
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - begin;
+    samples.us.push_back( elapsed.count() );
+}
+
+// Percentile of Samples
+static double percentile( std::vector<double> samples, const double rate )
+{
+    if( samples.empty() ){
+        return 0.0;
+    }
+    std::sort( samples.begin(), samples.end() );
+    const size_t index = std::min( samples.size() - 1, static_cast<size_t>( rate * samples.size() ) );
+    return samples[index];
+}
+
+// Naive Point Clouds (One pass over the frame per user, new vectors every frame)
+static size_t naiveClouds( const UserFrame& frame )
+{
+    const cv::Mat& depth_mat = frame.depth_mat;
+    const cv::Mat& user_map = frame.user_map;
+    const Intrinsics& intrinsics = frame.intrinsics;
+
+    size_t count = 0;
+    for( const User& user : frame.users ){
+        std::vector<cv::Point3f> cloud;
+        for( int32_t v = 0; v < depth_mat.rows; v++ ){
+            for( int32_t u = 0; u < depth_mat.cols; u++ ){
+                const uint16_t depth = depth_mat.at<uint16_t>( v, u );
+                if( user_map.at<uint16_t>( v, u ) != user.id || !depth ){
+                    continue;
+                }
+                float x, y;
+                unprojectPoint( intrinsics, static_cast<float>( u ), static_cast<float>( v ), depth, &x, &y );
+                cloud.push_back( cv::Point3f( x, y, depth ) );
+            }
+        }
+        count += cloud.size();
+    }
+    return count;
+}
+
+// Point Cloud Benchmark
+// bench_cloud [source] [frames] [voxel]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const std::string uri = ( 1 < argc ) ? argv[1] : "synthetic:640x480@0:6";
+        const uint32_t frames = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 300;
+        const float voxel_size = ( 3 < argc ) ? std::stof( argv[3] ) : 20.0f;
+
+        std::unique_ptr<UserSource> source = createUserSource( uri );
+        UserCloudBuilder builder;
+        UserCloudBuilder voxel_builder( voxel_size );
+        CloudWriter cloud_writer( CLOUD_FORMAT_BINARY );
+        CloudWriter ply_writer( CLOUD_FORMAT_PLY );
+        std::string buffer;
+
+        // Methods (Ordered by Name)
+        std::map<std::string, Samples> methods;
+        uint32_t count = 0;
+        uint32_t users = 0;
+        for( ; count < frames; count++ ){
+            UserFrame frame;
+            try{
+                source->readFrame( frame );
+            } catch( const EndOfSource& ){
+                break;
+            }
+            users = std::max( users, static_cast<uint32_t>( frame.users.size() ) );
+
+            // Naive
+            size_t naive = 0;
+            Samples& naive_samples = methods["1_naive"];
+            measure( naive_samples, [&](){ naive = naiveClouds( frame ); } );
+            naive_samples.points += naive;
+
+            // Builder
+            Samples& build_samples = methods["2_build"];
+            measure( build_samples, [&](){ builder.build( frame.depth_mat, frame.user_map, frame.intrinsics ); } );
+            build_samples.points += builder.points();
+            if( builder.points() != naive ){
+                throw std::runtime_error( "failed builder has different number of points" );
+            }
+
+            // Builder (Voxel Downsampling)
+            Samples& voxel_samples = methods["3_build_voxel"];
+            measure( voxel_samples, [&](){ voxel_builder.build( frame.depth_mat, frame.user_map, frame.intrinsics ); } );
+            voxel_samples.points += voxel_builder.points();
+
+            // Encode Stream Record
+            Samples& cloud_samples = methods["4_encode_cloud"];
+            measure( cloud_samples, [&](){ buffer.clear(); cloud_writer.encode( builder, count, frame.sensor_timestamp, buffer ); } );
+            cloud_samples.points += builder.points();
+            cloud_samples.bytes += buffer.size();
+
+            // Encode PLY Document
+            Samples& ply_samples = methods["5_encode_ply"];
+            measure( ply_samples, [&](){ buffer.clear(); ply_writer.encode( builder, count, frame.sensor_timestamp, buffer ); } );
+            ply_samples.points += builder.points();
+            ply_samples.bytes += buffer.size();
+
+            // Encode Stream Record (Voxel Downsampling)
+            Samples& voxel_cloud_samples = methods["6_encode_cloud_voxel"];
+            measure( voxel_cloud_samples, [&](){ buffer.clear(); cloud_writer.encode( voxel_builder, count, frame.sensor_timestamp, buffer ); } );
+            voxel_cloud_samples.points += voxel_builder.points();
+            voxel_cloud_samples.bytes += buffer.size();
+        }
+
+        // Write Result (Throughput of method alone)
+        std::cout << "method,frames,users,voxel_mm,points_per_frame,bytes_per_frame,mean_us,p50_us,p99_us,fps" << std::endl;
+        for( const std::pair<const std::string, Samples>& method : methods ){
+            const Samples& samples = method.second;
+            double mean = 0.0;
+            for( const double sample : samples.us ){
+                mean += sample;
+            }
+            mean /= std::max<size_t>( samples.us.size(), 1 );
+
+            const bool voxel = method.first.find( "voxel" ) != std::string::npos;
+            std::cout << method.first.substr( 2 ) << "," << count << "," << users << "," << ( voxel ? voxel_size : 0.0f ) << ","
+                      << samples.points / std::max<uint32_t>( count, 1 ) << "," << samples.bytes / std::max<uint32_t>( count, 1 ) << ","
+                      << mean << "," << percentile( samples.us, 0.50 ) << "," << percentile( samples.us, 0.99 ) << "," << ( 0.0 < mean ? 1000000.0 / mean : 0.0 ) << std::endl;
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "allocation.h"
+#include "event_bus.h"
+#include "ring.h"
+#include "telemetry.h"
+
+// Maximum p99 Dispatch Latency of Paced Storm [us] (Two burst intervals)
+#define LATENCY_BUDGET 2000
+
+// Events of Burst of Paced Storm and Interval of Bursts [us]
+#define BURST_SIZE 16
+#define BURST_INTERVAL 1000
+
+// Result of Storm
+struct StormResult
+{
+    double seconds = 0.0;      // Emit time of all producers
+    uint64_t emitted = 0;
+    uint64_t delivered = 0;    // Sum of subscribers
+    uint64_t dropped = 0;      // Sum of subscribers
+    uint64_t batches = 0;      // Sum of subscribers
+    uint64_t allocations = 0;  // During emit
+    HistogramSummary latency;  // Worst subscriber
+    bool ordered = true;       // Events of each producer in order at every subscriber
+};
+
+// Order Check of Subscriber (Sequence of each producer must increase)
+struct OrderCheck
+{
+    std::vector<int64_t> last;
+    uint64_t received = 0;
+    bool ordered = true;
+
+    explicit OrderCheck( const uint32_t producers )
+        : last( producers, -1 )
+    {
+    }
+
+    void check( const Event& event )
+    {
+        int64_t& previous = last[event.id];
+        const int64_t sequence = static_cast<int64_t>( event.timestamp );
+        if( sequence <= previous ){
+            ordered = false;
+        }
+        previous = sequence;
+        received++;
+    }
+};
+
+// Retrieve Steady Clock [ns]
+static int64_t nanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+// Run Producers (Bursts back-to-back or paced), and Retrieve Seconds of Emit
+template<typename Emit>
+static double produce( const uint32_t producers, const uint64_t count, const bool paced, uint64_t& allocations, Emit emit )
+{
+    std::atomic<bool> start( false );
+    std::atomic<uint32_t> ready( 0 );
+    std::vector<std::thread> threads;
+    for( uint32_t producer = 0; producer < producers; producer++ ){
+        threads.emplace_back( [&, producer]{
+            Event event;
+            event.id = static_cast<int32_t>( producer );
+            event.type = static_cast<EventType>( producer % EVENT_TYPE_COUNT );
+            ready++;
+            while( !start ){
+                std::this_thread::yield();
+            }
+
+            std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+            for( uint64_t sequence = 0; sequence < count; sequence++ ){
+                if( !( sequence % BURST_SIZE ) ){
+                    if( paced ){
+                        next += std::chrono::microseconds( BURST_INTERVAL );
+                        std::this_thread::sleep_until( next );
+                    }
+                    else{
+                        std::this_thread::yield();
+                    }
+                }
+                event.timestamp = sequence;
+                emit( event );
+            }
+        } );
+    }
+    while( ready < producers ){
+        std::this_thread::yield();
+    }
+
+    const uint64_t before = allocationCount();
+    const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+    start = true;
+    for( std::thread& thread : threads ){
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - time ).count();
+    allocations = allocationCount() - before;
+    return seconds;
+}
+
+// Storm through Event Bus (Lock-free queues, batches)
+static StormResult busStorm( const uint32_t producers, const uint32_t subscribers, const uint64_t count, const size_t batch, const bool paced )
+{
+    EventBus bus;
+    std::vector<std::unique_ptr<OrderCheck>> checks;
+    for( uint32_t subscriber = 0; subscriber < subscribers; subscriber++ ){
+        checks.emplace_back( new OrderCheck( producers ) );
+        OrderCheck& check = *checks.back();
+        bus.subscribe( EVENT_MASK_ALL, [&check]( const Event* events, const size_t size ){
+            for( size_t index = 0; index < size; index++ ){
+                check.check( events[index] );
+            }
+        }, batch );
+    }
+    bus.start();
+
+    StormResult result;
+    result.seconds = produce( producers, count, paced, result.allocations, [&bus]( const Event& event ){ bus.emit( event ); } );
+    result.emitted = producers * count;
+    bus.stop();
+
+    for( uint32_t subscriber = 0; subscriber < subscribers; subscriber++ ){
+        const EventStatistics statistics = bus.getStatistics( subscriber );
+        result.delivered += statistics.delivered;
+        result.dropped += statistics.dropped;
+        result.batches += statistics.batches;
+        if( result.latency.p99 <= statistics.latency.p99 ){
+            result.latency = statistics.latency;
+        }
+        result.ordered = result.ordered && checks[subscriber]->ordered && checks[subscriber]->received == statistics.delivered;
+    }
+    return result;
+}
+
+// Storm through Mutex Rings (Reference, one wake-up per event)
+static StormResult ringStorm( const uint32_t producers, const uint32_t subscribers, const uint64_t count, const bool paced )
+{
+    std::vector<std::unique_ptr<Ring<Event>>> rings;
+    std::vector<std::unique_ptr<OrderCheck>> checks;
+    std::vector<std::unique_ptr<LatencyHistogram>> latencies;
+    std::vector<std::thread> threads;
+    for( uint32_t subscriber = 0; subscriber < subscribers; subscriber++ ){
+        rings.emplace_back( new Ring<Event>( EVENT_QUEUE_SIZE ) );
+        checks.emplace_back( new OrderCheck( producers ) );
+        latencies.emplace_back( new LatencyHistogram() );
+    }
+    for( uint32_t subscriber = 0; subscriber < subscribers; subscriber++ ){
+        threads.emplace_back( [&, subscriber]{
+            Event event;
+            while( rings[subscriber]->pop( event ) ){
+                const int64_t latency = nanoseconds() - event.emitted;
+                latencies[subscriber]->record( static_cast<uint64_t>( 0 < latency ? latency / 1000 : 0 ) );
+                checks[subscriber]->check( event );
+            }
+        } );
+    }
+
+    StormResult result;
+    result.seconds = produce( producers, count, paced, result.allocations, [&rings]( const Event& event ){
+        Event stamped = event;
+        stamped.emitted = nanoseconds();
+        for( std::unique_ptr<Ring<Event>>& ring : rings ){
+            Event copy = stamped;
+            ring->push( std::move( copy ) );
+        }
+    } );
+    result.emitted = producers * count;
+
+    // Drain and Close Rings
+    for( std::unique_ptr<Ring<Event>>& ring : rings ){
+        while( ring->size() ){
+            std::this_thread::yield();
+        }
+        ring->close();
+    }
+    for( std::thread& thread : threads ){
+        thread.join();
+    }
+
+    for( uint32_t subscriber = 0; subscriber < subscribers; subscriber++ ){
+        const HistogramSummary latency = latencies[subscriber]->summarize();
+        result.delivered += checks[subscriber]->received;
+        result.dropped += rings[subscriber]->drops();
+        result.batches += checks[subscriber]->received;
+        if( result.latency.p99 <= latency.p99 ){
+            result.latency = latency;
+        }
+        result.ordered = result.ordered && checks[subscriber]->ordered;
+    }
+    return result;
+}
+
+// Print Result
+static void print( const std::string& mode, const uint32_t producers, const uint32_t subscribers, const StormResult& result )
+{
+    const double emit_ns = result.seconds * 1e9 / static_cast<double>( result.emitted / producers );
+    const double rate = static_cast<double>( result.delivered ) / result.seconds;
+    const double mean_batch = result.batches ? static_cast<double>( result.delivered ) / static_cast<double>( result.batches ) : 0.0;
+    std::cout << mode << "," << producers << "," << subscribers << "," << result.emitted << "," << emit_ns << "," << rate << ","
+              << result.delivered << "," << result.dropped << "," << mean_batch << "," << result.latency.p50 << "," << result.latency.p99 << ","
+              << result.latency.max << "," << result.allocations << "," << ( result.ordered ? "ok" : "failed" ) << std::endl;
+}
+
+// Event Bus Benchmark
+// bench_event_bus [producers] [subscribers] [events] [batch]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const uint32_t producers = ( 1 < argc ) ? static_cast<uint32_t>( std::stoul( argv[1] ) ) : 2;
+        const uint32_t subscribers = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 2;
+        const uint64_t events = ( 3 < argc ) ? std::stoull( argv[3] ) : 500000;
+        const size_t batch = ( 4 < argc ) ? static_cast<size_t>( std::stoul( argv[4] ) ) : EVENT_BATCH_SIZE;
+        if( !producers || !subscribers || !events || !batch ){
+            throw std::runtime_error( "failed number of producers, subscribers, events and batch must be greater than 0" );
+        }
+
+        // Paced Storm (Bursts for about a second, no drops expected)
+        const uint64_t paced = BURST_SIZE * 1000;
+
+        std::cout << "mode,producers,subscribers,emitted,emit_ns,delivered_per_s,delivered,dropped,mean_batch,latency_p50_us,latency_p99_us,latency_max_us,allocations,order" << std::endl;
+        const StormResult storm = busStorm( producers, subscribers, events, batch, false );
+        print( "bus_storm", producers, subscribers, storm );
+        const StormResult ring_storm = ringStorm( producers, subscribers, events, false );
+        print( "ring_storm", producers, subscribers, ring_storm );
+        const StormResult bus_paced = busStorm( producers, subscribers, paced, batch, true );
+        print( "bus_paced", producers, subscribers, bus_paced );
+        const StormResult ring_paced = ringStorm( producers, subscribers, paced, true );
+        print( "ring_paced", producers, subscribers, ring_paced );
+
+        // Check Event Bus
+        bool failed = false;
+        for( const StormResult* result : { &storm, &bus_paced } ){
+            if( !result->ordered || result->delivered + result->dropped != result->emitted * subscribers ){
+                std::cerr << "failed events are out of order or lost" << std::endl;
+                failed = true;
+            }
+            if( result->allocations ){
+                std::cerr << "failed " << result->allocations << " allocations during emit" << std::endl;
+                failed = true;
+            }
+        }
+        if( bus_paced.dropped ){
+            std::cerr << "failed " << bus_paced.dropped << " events dropped in paced storm" << std::endl;
+            failed = true;
+        }
+        if( LATENCY_BUDGET < bus_paced.latency.p99 ){
+            std::cerr << "failed p99 dispatch latency " << bus_paced.latency.p99 << " us exceeds " << LATENCY_BUDGET << " us" << std::endl;
+            failed = true;
+        }
+        if( failed ){
+            return 1;
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "skeleton_filter.h"
+#include "user_source.h"
+
+// Budget of Filter per Frame [us]
+#define FILTER_BUDGET 50.0
+
+// Warm-Up Frames of Error (Filters settle from first measurement)
+#define FILTER_SETTLE_FRAMES 30
+
+// Frames of Users
+struct Sequence
+{
+    std::vector<std::vector<User>> users;
+    std::vector<uint64_t> timestamps;
+};
+
+// Snapshot Filter (Fill skeleton snapshot of frame, and filter it by SkeletonFilter)
+struct SnapshotFilter
+{
+    SkeletonFilter filter;
+
+    // Constructor
+    explicit SnapshotFilter( const FilterParameters& parameters = FilterParameters() )
+        : filter( parameters )
+    {
+    }
+
+    // Filter Joints of Frame
+    void apply( UserFrame& frame )
+    {
+        fillSnapshot( frame, frame.skeleton );
+        filter.apply( frame.skeleton );
+    }
+};
+
+// Reference Filter (Array of Structures, Scalar per Joint, Same Model as SkeletonFilter)
+class ReferenceFilter
+{
+private:
+    // Joint State
+    struct State
+    {
+        bool active = false;
+        std::array<float, 3> position;
+        std::array<float, 3> velocity;
+        float pp, pv, vv;
+    };
+
+    FilterParameters parameters;
+    std::array<std::array<State, JOINT_COUNT>, USER_COUNT> states;
+    uint64_t timestamp = 0;
+
+public:
+    // Constructor
+    explicit ReferenceFilter( const FilterParameters& parameters )
+        : parameters( parameters )
+    {
+    }
+
+    // Filter Joints of Frame (Fill skeleton snapshot of frame)
+    void apply( UserFrame& frame )
+    {
+        const bool restart = ( frame.sensor_timestamp <= timestamp ) || ( FILTER_MAX_GAP < frame.sensor_timestamp - timestamp );
+        const float dt = static_cast<float>( frame.sensor_timestamp - timestamp ) * 1.0e-6f;
+        timestamp = frame.sensor_timestamp;
+
+        for( uint32_t index = 0; index < frame.users.size() && index < USER_COUNT; index++ ){
+            for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+                State& state = states[index][type];
+                Joint& joint = frame.users[index].joints[type];
+                const std::array<float, 3> measurement = { { joint.position.x, joint.position.y, joint.position.z } };
+                if( restart || !state.active ){
+                    state.active = true;
+                    state.position = measurement;
+                    state.velocity.fill( 0.0f );
+                    state.pp = parameters.noise * parameters.noise;
+                    state.pv = 0.0f;
+                    state.vv = FILTER_INITIAL_SPEED * FILTER_INITIAL_SPEED;
+                }
+                else if( parameters.method == FILTER_ONE_EURO ){
+                    oneEuro( state, measurement, dt );
+                }
+                else if( parameters.method == FILTER_KALMAN ){
+                    kalman( state, measurement, dt );
+                }
+                joint.position = nite::Point3f( state.position[0], state.position[1], state.position[2] );
+            }
+        }
+        fillSnapshot( frame, frame.skeleton );
+    }
+
+private:
+    // One-Euro
+    void oneEuro( State& state, const std::array<float, 3>& measurement, const float dt )
+    {
+        const float rate = 6.28318531f * dt;
+        const float derivative_alpha = rate * parameters.derivative_cutoff / ( 1.0f + rate * parameters.derivative_cutoff );
+        float speed = 0.0f;
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            state.velocity[axis] += derivative_alpha * ( ( measurement[axis] - state.position[axis] ) / dt - state.velocity[axis] );
+            speed += state.velocity[axis] * state.velocity[axis];
+        }
+        const float r = rate * ( parameters.min_cutoff + parameters.beta * std::sqrt( speed ) );
+        const float alpha = r / ( 1.0f + r );
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            state.position[axis] += alpha * ( measurement[axis] - state.position[axis] );
+        }
+    }
+
+    // Kalman
+    void kalman( State& state, const std::array<float, 3>& measurement, const float dt )
+    {
+        const float variance = parameters.acceleration * parameters.acceleration;
+        const float pp = state.pp + 2.0f * dt * state.pv + dt * dt * state.vv + variance * dt * dt * dt * dt / 4.0f;
+        const float pv = state.pv + dt * state.vv + variance * dt * dt * dt / 2.0f;
+        const float vv = state.vv + variance * dt * dt;
+        const float gain_p = pp / ( pp + parameters.noise * parameters.noise );
+        const float gain_v = pv / ( pp + parameters.noise * parameters.noise );
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            const float predict = state.position[axis] + dt * state.velocity[axis];
+            const float innovation = measurement[axis] - predict;
+            state.position[axis] = predict + gain_p * innovation;
+            state.velocity[axis] += gain_v * innovation;
+        }
+        state.pp = ( 1.0f - gain_p ) * pp;
+        state.pv = ( 1.0f - gain_p ) * pv;
+        state.vv = vv - gain_v * pv;
+    }
+};
+
+// Result of Filter
+struct Result
+{
+    std::vector<double> samples; // [us]
+    double error = 0.0;          // RMS Error from Ground Truth [mm]
+    float difference = 0.0f;     // Maximum Difference from Reference [mm]
+};
+
+// Run Filter over Noisy Sequence (Error and output of last pass)
+template<typename Filter>
+static void run( Filter& filter, const Sequence& noisy, const Sequence& truth, const uint32_t passes, Result& result, std::vector<SkeletonSnapshot>& output )
+{
+    UserFrame frame;
+    result.samples.clear();
+    result.samples.reserve( static_cast<size_t>( passes ) * noisy.users.size() );
+    output.resize( noisy.users.size() );
+
+    double square = 0.0;
+    size_t count = 0;
+    for( uint32_t pass = 0; pass < passes; pass++ ){
+        for( size_t index = 0; index < noisy.users.size(); index++ ){
+            frame.users = noisy.users[index];
+            frame.sensor_timestamp = noisy.timestamps[index];
+
+            const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+            filter.apply( frame );
+            const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - time;
+            result.samples.push_back( elapsed.count() );
+
+            if( pass + 1 < passes ){
+                continue;
+            }
+            const SkeletonSnapshot& snapshot = frame.skeleton;
+            output[index] = snapshot;
+            if( index < FILTER_SETTLE_FRAMES ){
+                continue;
+            }
+            for( uint32_t number = 0; number < snapshot.count; number++ ){
+                for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+                    const size_t lane = SkeletonSnapshot::lane( number, type );
+                    const nite::Point3f& ground = truth.users[index][snapshot.users[number]].joints[type].position;
+                    const float dx = snapshot.x[lane] - ground.x;
+                    const float dy = snapshot.y[lane] - ground.y;
+                    const float dz = snapshot.z[lane] - ground.z;
+                    square += dx * dx + dy * dy + dz * dz;
+                    count++;
+                }
+            }
+        }
+    }
+    result.error = count ? std::sqrt( square / count ) : 0.0;
+}
+
+// Maximum Difference of Joint Positions [mm]
+static float maxDifference( const std::vector<SkeletonSnapshot>& a, const std::vector<SkeletonSnapshot>& b )
+{
+    float difference = 0.0f;
+    for( size_t index = 0; index < a.size(); index++ ){
+        for( size_t lane = 0; lane < a[index].lanes(); lane++ ){
+            difference = std::max( difference, std::abs( a[index].x[lane] - b[index].x[lane] ) );
+            difference = std::max( difference, std::abs( a[index].y[lane] - b[index].y[lane] ) );
+            difference = std::max( difference, std::abs( a[index].z[lane] - b[index].z[lane] ) );
+        }
+    }
+    return difference;
+}
+
+// Percentile of Samples
+static double percentile( std::vector<double> samples, const double rank )
+{
+    if( samples.empty() ){
+        return 0.0;
+    }
+    const size_t index = std::min( samples.size() - 1, static_cast<size_t>( rank * ( samples.size() - 1 ) + 0.5 ) );
+    std::nth_element( samples.begin(), samples.begin() + index, samples.end() );
+    return samples[index];
+}
+
+// Write Result Row
+static void writeRow( const std::string& method, const std::string& implementation, const uint32_t users, const Result& result )
+{
+    double sum = 0.0;
+    for( const double sample : result.samples ){
+        sum += sample;
+    }
+    const double mean = result.samples.empty() ? 0.0 : sum / result.samples.size();
+    std::cout << method << "," << implementation << "," << users << "," << users * JOINT_COUNT << ","
+              << mean << "," << percentile( result.samples, 0.99 ) << "," << percentile( result.samples, 1.0 ) << ","
+              << result.error << "," << result.difference << std::endl;
+}
+
+// Skeleton Filter Benchmark
+// bench_filter [users] [frames] [noise] [passes]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const uint32_t users = std::min<uint32_t>( ( 1 < argc ) ? static_cast<uint32_t>( std::stoul( argv[1] ) ) : USER_COUNT, USER_COUNT );
+        const uint32_t frames = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 900;
+        const float noise = ( 3 < argc ) ? std::stof( argv[3] ) : 15.0f;
+        const uint32_t passes = ( 4 < argc ) ? static_cast<uint32_t>( std::stoul( argv[4] ) ) : 20;
+        if( frames <= FILTER_SETTLE_FRAMES || !passes ){
+            throw std::runtime_error( "failed number of frames must be greater than settle frames" );
+        }
+
+        // Generate Ground Truth (Skeletons of All Users are Tracked)
+        Sequence truth, noisy;
+        {
+            SyntheticUserSource source( 160, 120, 0, users );
+            for( uint32_t id = 1; id <= users; id++ ){
+                source.startSkeletonTracking( static_cast<nite::UserId>( id ) );
+            }
+            UserFrame frame;
+            for( uint32_t index = 0; index < frames; index++ ){
+                source.readFrame( frame );
+                truth.users.push_back( frame.users );
+                truth.timestamps.push_back( frame.sensor_timestamp );
+            }
+        }
+
+        // Add Noise (Deterministic)
+        std::mt19937 engine( 1 );
+        std::normal_distribution<float> distribution( 0.0f, noise );
+        noisy = truth;
+        for( std::vector<User>& frame_users : noisy.users ){
+            for( User& user : frame_users ){
+                for( Joint& joint : user.joints ){
+                    joint.position.x += distribution( engine );
+                    joint.position.y += distribution( engine );
+                    joint.position.z += distribution( engine );
+                }
+            }
+        }
+
+        std::cout << "method,implementation,users,joints,us_per_frame,p99_us,max_us,rms_error_mm,max_difference_mm" << std::endl;
+        std::cout << "# instruction set: " << filterInstructionSet() << ", noise: " << noise << " mm" << std::endl;
+
+        // Raw Joints
+        std::vector<SkeletonSnapshot> output, reference_output;
+        {
+            SnapshotFilter filter;
+            Result result;
+            run( filter, noisy, truth, passes, result, output );
+            writeRow( "none", "soa", users, result );
+        }
+
+        // One-Euro and Kalman
+        double worst = 0.0;
+        const char* methods[] = { "oneeuro", "kalman" };
+        for( const char* method : methods ){
+            const FilterParameters parameters = parseFilter( method );
+
+            ReferenceFilter reference( parameters );
+            Result reference_result;
+            run( reference, noisy, truth, passes, reference_result, reference_output );
+
+            SnapshotFilter filter( parameters );
+            Result result;
+            run( filter, noisy, truth, passes, result, output );
+            result.difference = maxDifference( output, reference_output );
+
+            writeRow( method, "scalar_aos", users, reference_result );
+            writeRow( method, std::string( "soa_" ) + filterInstructionSet(), users, result );
+            worst = std::max( worst, percentile( result.samples, 0.99 ) );
+        }
+
+        // Check Budget
+        if( FILTER_BUDGET < worst ){
+            throw std::runtime_error( "failed p99 of skeleton filter exceeds budget per frame" );
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "skeleton_fusion.h"
+
+// Joint Offsets from Torso [mm] (NiTE joint order, arms are animated)
+static const float JOINT_OFFSETS[JOINT_COUNT][3] = {
+    {    0.0f,  450.0f, 0.0f }, // Head
+    {    0.0f,  300.0f, 0.0f }, // Neck
+    { -180.0f,  280.0f, 0.0f }, // Left Shoulder
+    {  180.0f,  280.0f, 0.0f }, // Right Shoulder
+    { -180.0f,    0.0f, 0.0f }, // Left Elbow
+    {  180.0f,    0.0f, 0.0f }, // Right Elbow
+    { -180.0f, -280.0f, 0.0f }, // Left Hand
+    {  180.0f, -280.0f, 0.0f }, // Right Hand
+    {    0.0f,    0.0f, 0.0f }, // Torso
+    { -100.0f, -250.0f, 0.0f }, // Left Hip
+    {  100.0f, -250.0f, 0.0f }, // Right Hip
+    { -100.0f, -700.0f, 0.0f }, // Left Knee
+    {  100.0f, -700.0f, 0.0f }, // Right Knee
+    { -100.0f, -1150.0f, 0.0f }, // Left Foot
+    {  100.0f, -1150.0f, 0.0f }  // Right Foot
+};
+
+// Ground Truth Joint of User at Time [s] (World Coordinates)
+static void groundTruth( const uint32_t user, const uint32_t users, const double time, const uint32_t type, float* position )
+{
+    const float phase = static_cast<float>( user );
+    const float t = static_cast<float>( time );
+    const float torso[3] = {
+        ( phase - ( users - 1 ) / 2.0f ) * 900.0f + 300.0f * std::sin( 0.6f * t + phase ),
+        0.0f,
+        400.0f * std::sin( 0.4f * t + 2.0f * phase )
+    };
+
+    // Elbows and Hands Swing
+    float offset[3] = { JOINT_OFFSETS[type][0], JOINT_OFFSETS[type][1], JOINT_OFFSETS[type][2] };
+    if( 4 <= type && type <= 7 ){
+        const float length = ( type <= 5 ) ? 280.0f : 560.0f;
+        const float angle = 0.8f * std::sin( 2.0f * t + phase ) * ( ( type % 2 ) ? -1.0f : 1.0f );
+        offset[1] = 280.0f - length * std::cos( angle );
+        offset[2] = length * std::sin( angle );
+    }
+
+    for( uint32_t axis = 0; axis < 3; axis++ ){
+        position[axis] = torso[axis] + offset[axis];
+    }
+}
+
+// Sensor Result
+struct SensorResult
+{
+    double square_error = 0.0;
+    uint64_t joints = 0;
+    uint64_t frames = 0;
+};
+
+// Percentile of Sorted Values
+static double percentile( const std::vector<double>& values, const double rate )
+{
+    if( values.empty() ){
+        return 0.0;
+    }
+    return values[std::min( values.size() - 1, static_cast<size_t>( rate * values.size() ) )];
+}
+
+// Skeleton Fusion Benchmark
+// bench_fusion [sensors] [seconds] [noise] [latency]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const uint32_t sensors = std::min<uint32_t>( ( 1 < argc ) ? static_cast<uint32_t>( std::stoul( argv[1] ) ) : 3, FUSION_SENSOR_COUNT );
+        const double seconds = ( 2 < argc ) ? std::stod( argv[2] ) : 3.0;
+        const float noise = ( 3 < argc ) ? std::stof( argv[3] ) : 20.0f;
+        FusionParameters parameters;
+        parameters.latency = ( 4 < argc ) ? static_cast<uint32_t>( std::stoul( argv[4] ) ) : 100000;
+
+        constexpr uint32_t users = 3;
+        constexpr uint32_t fps = 30;
+        constexpr double warmup = 0.5;
+        constexpr float occlusion = 0.15f;
+        constexpr float pi = 3.14159265f;
+
+        bool failed = false;
+        std::cout << "sensors,outputs,user_match_rate,id_switches,fused_rms_mm,measured_rms_mm,orientation_error_deg,delay_p50_us,delay_p99_us,dropped" << std::endl;
+
+        for( uint32_t count = 1; count <= sensors; count++ ){
+            // Sensors on Circle (Looking at Center)
+            std::vector<Extrinsics> extrinsics;
+            std::vector<float> yaws;
+            for( uint32_t k = 0; k < count; k++ ){
+                const float yaw = 2.0f * pi * k / count;
+                yaws.push_back( yaw );
+                extrinsics.push_back( extrinsicsFromPose( yaw, 0.0f, 0.0f, -3000.0f * std::sin( yaw ), 500.0f, -3000.0f * std::cos( yaw ) ) );
+            }
+
+            SkeletonFusion fusion( extrinsics, parameters );
+            const uint64_t start = SkeletonFusion::now() + 100000;
+            const uint64_t end = start + static_cast<uint64_t>( seconds * 1e6 );
+
+            // Sensor Threads
+            std::vector<SensorResult> results( count );
+            std::vector<std::thread> threads;
+            for( uint32_t k = 0; k < count; k++ ){
+                threads.emplace_back( [&, k](){
+                    const Extrinsics world_to_sensor = invertExtrinsics( extrinsics[k] );
+                    const float orientation[4] = { 0.0f, -std::sin( yaws[k] / 2.0f ), 0.0f, std::cos( yaws[k] / 2.0f ) }; // Identity in World
+                    const uint64_t clock = 1000000000ull * ( k + 1 ) + 7777 * k;
+                    const uint64_t period = 1000000 / fps;
+                    std::mt19937 random( 1234 + k );
+                    std::normal_distribution<float> gaussian( 0.0f, noise );
+                    std::uniform_real_distribution<float> uniform( 0.0f, 1.0f );
+                    std::uniform_int_distribution<uint32_t> delay( 3000, 12000 );
+
+                    SkeletonSnapshot snapshot;
+                    SensorResult& result = results[k];
+                    for( uint64_t sample = start + k * period / count; sample < end; sample += period ){
+                        std::this_thread::sleep_until( std::chrono::steady_clock::time_point( std::chrono::microseconds( sample ) ) );
+                        const double time = ( sample - start ) / 1e6;
+
+                        // Observe Users (User ids differ per sensor)
+                        snapshot.frame_index = static_cast<int32_t>( result.frames );
+                        snapshot.timestamp = sample - start + clock;
+                        snapshot.count = 0;
+                        for( uint32_t user = 0; user < users; user++ ){
+                            if( 3 <= count && user % count == k ){
+                                continue;
+                            }
+
+                            const uint32_t number = snapshot.count++;
+                            snapshot.ids[number] = static_cast<nite::UserId>( 1 + ( user * 7 + k * 3 ) % 13 );
+                            snapshot.states[number] = nite::SkeletonState::SKELETON_TRACKED;
+                            snapshot.poses[number] = 0;
+                            snapshot.users[number] = number;
+                            for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+                                float world[3], x, y, z;
+                                groundTruth( user, users, time, type, world );
+                                transformPoint( world_to_sensor, world[0], world[1], world[2], &x, &y, &z );
+
+                                const bool occluded = uniform( random ) < occlusion;
+                                const float error = occluded ? 300.0f : 0.0f;
+                                const size_t lane = SkeletonSnapshot::lane( number, type );
+                                snapshot.x[lane] = x + gaussian( random ) + error;
+                                snapshot.y[lane] = y + gaussian( random );
+                                snapshot.z[lane] = z + gaussian( random );
+                                snapshot.position_confidence[lane] = occluded ? 0.0f : 1.0f;
+                                snapshot.orientation_x[lane] = orientation[0];
+                                snapshot.orientation_y[lane] = orientation[1];
+                                snapshot.orientation_z[lane] = orientation[2];
+                                snapshot.orientation_w[lane] = orientation[3];
+                                snapshot.orientation_confidence[lane] = occluded ? 0.0f : 1.0f;
+
+                                // Measured Error of Confident Joints
+                                if( !occluded ){
+                                    const float dx = snapshot.x[lane] - x, dy = snapshot.y[lane] - y, dz = snapshot.z[lane] - z;
+                                    result.square_error += dx * dx + dy * dy + dz * dz;
+                                    result.joints++;
+                                }
+                            }
+                        }
+
+                        // Processing Delay of Tracker
+                        std::this_thread::sleep_for( std::chrono::microseconds( delay( random ) ) );
+                        fusion.push( k, snapshot, SkeletonFusion::now() );
+                        result.frames++;
+                    }
+                } );
+            }
+
+            // Fusion (Main Thread)
+            uint64_t outputs = 0, matched = 0, switches = 0, joints = 0;
+            double square_error = 0.0, orientation_error = 0.0;
+            std::vector<double> delays;
+            delays.reserve( static_cast<size_t>( seconds * fps * 2 ) );
+            std::map<uint32_t, nite::UserId> identities;
+            fusion.run( [&]( const SkeletonSnapshot& fused ){
+                const uint64_t now = SkeletonFusion::now();
+                delays.push_back( static_cast<double>( now - ( fused.timestamp + parameters.latency ) ) );
+                if( end <= fused.timestamp ){
+                    return false;
+                }
+                if( fused.timestamp < start + static_cast<uint64_t>( warmup * 1e6 ) ){
+                    return true;
+                }
+
+                // Compare with Ground Truth at Fused Time
+                const double time = ( static_cast<double>( fused.timestamp ) - static_cast<double>( start ) ) / 1e6;
+                outputs++;
+                matched += ( fused.count == users ) ? 1 : 0;
+                for( uint32_t user = 0; user < users; user++ ){
+                    // Nearest Fused User by Torso
+                    float torso[3];
+                    groundTruth( user, users, time, FUSION_ANCHOR_JOINT, torso );
+                    int32_t nearest = -1;
+                    float best = 1e12f;
+                    for( uint32_t number = 0; number < fused.count; number++ ){
+                        const size_t lane = SkeletonSnapshot::lane( number, FUSION_ANCHOR_JOINT );
+                        const float dx = fused.x[lane] - torso[0], dy = fused.y[lane] - torso[1], dz = fused.z[lane] - torso[2];
+                        if( dx * dx + dy * dy + dz * dz < best ){
+                            best = dx * dx + dy * dy + dz * dz;
+                            nearest = static_cast<int32_t>( number );
+                        }
+                    }
+                    if( nearest < 0 ){
+                        continue;
+                    }
+
+                    // Id Switch
+                    const nite::UserId id = fused.ids[nearest];
+                    if( identities.count( user ) && identities[user] != id ){
+                        switches++;
+                    }
+                    identities[user] = id;
+
+                    // Joint and Orientation Error
+                    for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+                        const size_t lane = SkeletonSnapshot::lane( nearest, type );
+                        if( fused.position_confidence[lane] < parameters.confidence ){
+                            continue;
+                        }
+                        float position[3];
+                        groundTruth( user, users, time, type, position );
+                        const float dx = fused.x[lane] - position[0], dy = fused.y[lane] - position[1], dz = fused.z[lane] - position[2];
+                        square_error += dx * dx + dy * dy + dz * dz;
+                        joints++;
+
+                        const float w = std::min( std::abs( fused.orientation_w[lane] ), 1.0f );
+                        orientation_error = std::max( orientation_error, 2.0 * std::acos( w ) * 180.0 / pi );
+                    }
+                }
+                return true;
+            } );
+
+            for( std::thread& thread : threads ){
+                thread.join();
+            }
+
+            // Aggregate Results
+            double measured_error = 0.0;
+            uint64_t measured_joints = 0, dropped = 0;
+            for( uint32_t k = 0; k < count; k++ ){
+                measured_error += results[k].square_error;
+                measured_joints += results[k].joints;
+                dropped += fusion.droppedSnapshots( k );
+            }
+            std::sort( delays.begin(), delays.end() );
+
+            const double match_rate = outputs ? static_cast<double>( matched ) / outputs : 0.0;
+            const double fused_rms = joints ? std::sqrt( square_error / joints ) : 0.0;
+            const double measured_rms = measured_joints ? std::sqrt( measured_error / measured_joints ) : 0.0;
+            const double delay_p99 = percentile( delays, 0.99 );
+            std::cout << count << "," << outputs << "," << match_rate << "," << switches << "," << fused_rms << "," << measured_rms << ","
+                      << orientation_error << "," << percentile( delays, 0.5 ) << "," << delay_p99 << "," << dropped << std::endl;
+
+            // Check Results
+            if( match_rate < 0.95 || users < switches || ( 2 <= count && measured_rms <= fused_rms ) || 5.0 < orientation_error || 1000000 / fps < delay_p99 ){
+                std::cerr << "failed fusion of " << count << " sensors" << std::endl;
+                failed = true;
+            }
+        }
+
+        if( failed ){
+            return 1;
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,335 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gesture_engine.h"
+
+// Budget of Gesture Engine per Frame [us] (p99 at all templates)
+#define GESTURE_BUDGET 1000.0
+
+// Frame Interval [us] (30 fps)
+#define FRAME_INTERVAL 33333
+
+// Shapes of Synthetic Gestures
+#define SHAPE_COUNT 12
+
+// Frames after End of Gesture a Detection still Belongs to it
+#define DETECTION_LATENCY 20
+
+// Pi
+#define BENCH_PI 3.14159265f
+
+// Shape Names
+static const std::array<const char*, SHAPE_COUNT> shape_names = { {
+    "swipe_right", "swipe_left", "swipe_up", "swipe_down", "push", "circle_cw",
+    "circle_ccw", "wave", "zigzag", "figure_eight", "triangle", "check"
+} };
+
+// Nominal Duration of Shapes [ms]
+static const std::array<float, SHAPE_COUNT> shape_durations = { {
+    600.0f, 600.0f, 600.0f, 600.0f, 800.0f, 1200.0f, 1200.0f, 1200.0f, 1000.0f, 1500.0f, 1200.0f, 800.0f
+} };
+
+// Position of Shape at Phase [0, 1] (Offset from start [mm])
+static std::array<float, 3> shapePosition( const uint32_t shape, const float phase )
+{
+    const float u = phase;
+    const float turn = 2.0f * BENCH_PI * u;
+    std::array<float, 3> p = { { 0.0f, 0.0f, 0.0f } };
+    switch( shape ){
+        case 0: p = { { 400.0f * u, 40.0f * std::sin( BENCH_PI * u ), 0.0f } }; break;
+        case 1: p = { { -400.0f * u, 40.0f * std::sin( BENCH_PI * u ), 0.0f } }; break;
+        case 2: p = { { 30.0f * std::sin( BENCH_PI * u ), 400.0f * u, 0.0f } }; break;
+        case 3: p = { { 30.0f * std::sin( BENCH_PI * u ), -400.0f * u, 0.0f } }; break;
+        case 4: p = { { 0.0f, 20.0f * std::sin( BENCH_PI * u ), -300.0f * std::sin( BENCH_PI * u ) } }; break;
+        case 5: p = { { 150.0f * std::sin( turn ), 150.0f * std::cos( turn ) - 150.0f, 0.0f } }; break;
+        case 6: p = { { -150.0f * std::sin( turn ), 150.0f * std::cos( turn ) - 150.0f, 0.0f } }; break;
+        case 7: p = { { 120.0f * std::sin( 2.0f * turn ), 30.0f * std::sin( turn / 2.0f ), 0.0f } }; break;
+        case 8: p = { { 400.0f * u, 100.0f * std::asin( std::sin( 3.0f * turn ) ) / BENCH_PI * 2.0f, 0.0f } }; break;
+        case 9: p = { { 150.0f * std::sin( turn ), 80.0f * std::sin( 2.0f * turn ), 0.0f } }; break;
+        case 10:
+        {
+            // Triangle (Up-right, down-right, back left)
+            const std::array<std::array<float, 2>, 4> corners = { { { { 0.0f, 0.0f } }, { { 150.0f, 260.0f } }, { { 300.0f, 0.0f } }, { { 0.0f, 0.0f } } } };
+            const float side = std::min( u * 3.0f, 2.999f );
+            const uint32_t index = static_cast<uint32_t>( side );
+            const float t = side - index;
+            p = { { corners[index][0] + t * ( corners[index + 1][0] - corners[index][0] ), corners[index][1] + t * ( corners[index + 1][1] - corners[index][1] ), 0.0f } };
+            break;
+        }
+        default:
+            // Check Mark (Short down-right, long up-right)
+            p = ( u < 0.35f ) ? std::array<float, 3>{ { 100.0f * u / 0.35f, -120.0f * u / 0.35f, 0.0f } }
+                              : std::array<float, 3>{ { 100.0f + 250.0f * ( u - 0.35f ) / 0.65f, -120.0f + 420.0f * ( u - 0.35f ) / 0.65f, 0.0f } };
+            break;
+    }
+    return p;
+}
+
+// Transform Offset of Shape (Rotation about z [rad] and scale)
+static std::array<float, 3> transform( const std::array<float, 3>& p, const float angle, const float scale )
+{
+    const float c = std::cos( angle ), s = std::sin( angle );
+    return { { scale * ( c * p[0] - s * p[1] ), scale * ( s * p[0] + c * p[1] ), scale * p[2] } };
+}
+
+// Generate Templates (Template i is a variant of shape i % SHAPE_COUNT)
+static std::vector<GestureTemplate> generateTemplates( const uint32_t count, std::mt19937& random )
+{
+    std::uniform_real_distribution<float> uniform( -1.0f, 1.0f );
+    std::normal_distribution<float> noise( 0.0f, 2.0f );
+
+    std::vector<GestureTemplate> templates( count );
+    for( uint32_t index = 0; index < count; index++ ){
+        GestureTemplate& gesture = templates[index];
+        const uint32_t shape = index % SHAPE_COUNT;
+        gesture.name = std::string( shape_names[shape] ) + "_" + std::to_string( index / SHAPE_COUNT );
+        const float angle = ( index < SHAPE_COUNT ) ? 0.0f : 0.15f * uniform( random );
+        const float duration = shape_durations[shape] * ( ( index < SHAPE_COUNT ) ? 1.0f : 1.0f + 0.1f * uniform( random ) );
+        const uint32_t samples = static_cast<uint32_t>( duration * 1000.0f / FRAME_INTERVAL ) + 1;
+        for( uint32_t sample = 0; sample < samples; sample++ ){
+            std::array<float, 3> point = transform( shapePosition( shape, static_cast<float>( sample ) / ( samples - 1 ) ), angle, 1.0f );
+            for( float& value : point ){
+                value += noise( random );
+            }
+            gesture.times.push_back( sample * FRAME_INTERVAL / 1000.0f );
+            gesture.points.push_back( point );
+        }
+    }
+    return templates;
+}
+
+// Performed Gesture of Track
+struct Performance
+{
+    uint32_t track;
+    uint32_t shape;
+    uint32_t begin; // First frame
+    uint32_t end;   // Last frame
+};
+
+// Generate Hand Stream (Idle, then random shape at random speed, scale and rotation with noise)
+static std::vector<std::vector<Hand>> generateStream( const uint32_t tracks, const uint32_t frames, std::mt19937& random, std::vector<Performance>& performances )
+{
+    std::uniform_real_distribution<float> uniform( -1.0f, 1.0f );
+    std::uniform_int_distribution<uint32_t> shapes( 0, SHAPE_COUNT - 1 );
+    std::uniform_int_distribution<uint32_t> idle( 20, 60 );
+    std::normal_distribution<float> noise( 0.0f, 5.0f );
+
+    std::vector<std::vector<Hand>> stream( frames, std::vector<Hand>( tracks ) );
+    for( uint32_t track = 0; track < tracks; track++ ){
+        std::array<float, 3> base = { { ( track - ( tracks - 1 ) / 2.0f ) * 400.0f, 0.0f, 1500.0f } };
+        uint32_t frame = 0;
+        while( frame < frames ){
+            // Idle (Slow drift)
+            const uint32_t rest = idle( random );
+            const std::array<float, 3> drift = { { 1.0f * uniform( random ), 1.0f * uniform( random ), 1.0f * uniform( random ) } };
+            for( uint32_t count = 0; count < rest && frame < frames; count++, frame++ ){
+                for( uint32_t axis = 0; axis < 3; axis++ ){
+                    base[axis] += drift[axis];
+                }
+                Hand& hand = stream[frame][track];
+                hand.position = nite::Point3f( base[0] + noise( random ), base[1] + noise( random ), base[2] + noise( random ) );
+            }
+
+            // Gesture
+            Performance performance;
+            performance.track = track;
+            performance.shape = shapes( random );
+            const float speed = 1.0f + 0.15f * uniform( random );
+            const float scale = 1.05f + 0.35f * uniform( random );
+            const float angle = 0.15f * uniform( random );
+            const uint32_t length = static_cast<uint32_t>( shape_durations[performance.shape] * 1000.0f / speed / FRAME_INTERVAL ) + 1;
+            performance.begin = frame;
+            performance.end = frame + length - 1;
+            std::array<float, 3> offset = { { 0.0f, 0.0f, 0.0f } };
+            for( uint32_t count = 0; count < length && frame < frames; count++, frame++ ){
+                offset = transform( shapePosition( performance.shape, static_cast<float>( count ) / ( length - 1 ) ), angle, scale );
+                Hand& hand = stream[frame][track];
+                hand.position = nite::Point3f( base[0] + offset[0] + noise( random ), base[1] + offset[1] + noise( random ), base[2] + offset[2] + noise( random ) );
+            }
+            for( uint32_t axis = 0; axis < 3; axis++ ){
+                base[axis] += offset[axis];
+            }
+            if( performance.end < frames ){
+                performances.push_back( performance );
+            }
+        }
+    }
+
+    // Hand Ids and States
+    for( std::vector<Hand>& hands : stream ){
+        for( uint32_t track = 0; track < tracks; track++ ){
+            hands[track].id = static_cast<nite::HandId>( track + 1 );
+            hands[track].is_tracking = true;
+        }
+    }
+    return stream;
+}
+
+// Percentile of Samples
+static double percentile( std::vector<double> samples, const double rank )
+{
+    if( samples.empty() ){
+        return 0.0;
+    }
+    const size_t index = std::min( samples.size() - 1, static_cast<size_t>( rank * ( samples.size() - 1 ) + 0.5 ) );
+    std::nth_element( samples.begin(), samples.begin() + index, samples.end() );
+    return samples[index];
+}
+
+// Result of Templates
+struct Result
+{
+    std::vector<double> samples;       // Time per frame [us] (Pruned)
+    std::vector<double> brute_samples; // Time per frame [us] (Full DTW)
+    GestureStatistics statistics;
+    uint64_t mismatches = 0;
+    uint64_t correct = 0; // Detected shape of performed gesture
+    uint64_t wrong = 0;   // Other shape during performed gesture
+    uint64_t idle = 0;    // Detection while idle
+    uint64_t expected = 0; // Performed gestures of shapes with template
+};
+
+// Run Stream through Pruned and Full DTW Engines
+static Result run( const std::vector<GestureTemplate>& templates, const std::vector<std::vector<Hand>>& stream, const std::vector<Performance>& performances )
+{
+    GestureEngine engine( templates );
+    GestureEngine brute( templates );
+    brute.setPruning( false );
+
+    Result result;
+    result.samples.reserve( stream.size() );
+    result.brute_samples.reserve( stream.size() );
+    std::vector<bool> detected( performances.size(), false );
+    for( uint32_t frame = 0; frame < stream.size(); frame++ ){
+        const uint64_t timestamp = static_cast<uint64_t>( frame ) * FRAME_INTERVAL;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        engine.update( stream[frame], timestamp );
+        result.samples.push_back( std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count() );
+
+        start = std::chrono::steady_clock::now();
+        brute.update( stream[frame], timestamp );
+        result.brute_samples.push_back( std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count() );
+
+        // Compare with Full DTW (Same best template and distance)
+        const std::vector<GestureMatch>& matches = engine.getMatches();
+        const std::vector<GestureMatch>& expected = brute.getMatches();
+        bool same = ( matches.size() == expected.size() );
+        for( size_t index = 0; same && index < matches.size(); index++ ){
+            same = matches[index].gesture == expected[index].gesture && matches[index].id == expected[index].id && matches[index].distance == expected[index].distance;
+        }
+        result.mismatches += !same;
+
+        // Classify Detections
+        for( const GestureMatch& match : matches ){
+            const uint32_t track = static_cast<uint32_t>( match.id - 1 );
+            const uint32_t shape = match.gesture % SHAPE_COUNT;
+            bool during = false, credited = false;
+            for( size_t index = 0; index < performances.size() && !credited; index++ ){
+                const Performance& performance = performances[index];
+                if( performance.track != track || frame < performance.begin || performance.end + DETECTION_LATENCY < frame ){
+                    continue;
+                }
+                during = true;
+                if( performance.shape == shape && !detected[index] ){
+                    detected[index] = true;
+                    credited = true;
+                }
+            }
+            result.correct += credited;
+            result.wrong += ( during && !credited );
+            result.idle += !during;
+        }
+    }
+
+    for( const Performance& performance : performances ){
+        result.expected += ( performance.shape < templates.size() );
+    }
+    result.statistics = engine.getStatistics();
+    return result;
+}
+
+// Gesture Engine Benchmark
+// bench_gesture_engine [templates] [tracks] [frames]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const uint32_t template_count = ( 1 < argc ) ? static_cast<uint32_t>( std::stoul( argv[1] ) ) : 64;
+        const uint32_t tracks = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : HAND_COUNT;
+        const uint32_t frames = ( 3 < argc ) ? static_cast<uint32_t>( std::stoul( argv[3] ) ) : 3000;
+        if( !template_count || !tracks || GESTURE_TRACK_COUNT < tracks || !frames ){
+            throw std::runtime_error( "failed invalid number of templates, tracks or frames" );
+        }
+
+        // Generate Templates and Stream
+        std::mt19937 random( 1 );
+        const std::vector<GestureTemplate> templates = generateTemplates( template_count, random );
+        std::vector<Performance> performances;
+        const std::vector<std::vector<Hand>> stream = generateStream( tracks, frames, random, performances );
+
+        // Save and Load Templates
+        const std::string path = "bench_gesture_engine.gestures";
+        saveGestureTemplates( path, templates );
+        const std::vector<GestureTemplate> loaded = loadGestureTemplates( path );
+        std::remove( path.c_str() );
+        bool same = ( loaded.size() == templates.size() );
+        for( size_t index = 0; same && index < templates.size(); index++ ){
+            same = loaded[index].name == templates[index].name && loaded[index].threshold == templates[index].threshold
+                && loaded[index].times == templates[index].times && loaded[index].points == templates[index].points;
+        }
+
+        // Run Templates (1, 2, 4, ... and all)
+        std::cout << "templates,tracks,frames,us_per_frame,p99_us,full_us_per_frame,full_p99_us,speedup,comparisons,scale_pruned,kim_pruned,keogh_pruned,abandoned,completed,gestures,correct,wrong,idle,mismatches" << std::endl;
+        double p99 = 0.0;
+        uint64_t mismatches = 0;
+        for( uint32_t count = 1; ; count = std::min( count * 2, template_count ) ){
+            const std::vector<GestureTemplate> subset( templates.begin(), templates.begin() + count );
+            const Result result = run( subset, stream, performances );
+
+            double sum = 0.0, brute_sum = 0.0;
+            for( size_t frame = 0; frame < result.samples.size(); frame++ ){
+                sum += result.samples[frame];
+                brute_sum += result.brute_samples[frame];
+            }
+            const double mean = sum / frames, brute_mean = brute_sum / frames;
+            const GestureStatistics& statistics = result.statistics;
+            const double comparisons = std::max<double>( 1.0, static_cast<double>( statistics.comparisons ) );
+            p99 = percentile( result.samples, 0.99 );
+            mismatches += result.mismatches;
+
+            std::cout << count << "," << tracks << "," << frames << "," << mean << "," << p99 << "," << brute_mean << "," << percentile( result.brute_samples, 0.99 ) << ","
+                      << brute_mean / mean << "," << statistics.comparisons << "," << statistics.scale_pruned / comparisons << "," << statistics.kim_pruned / comparisons << ","
+                      << statistics.keogh_pruned / comparisons << "," << statistics.abandoned / comparisons << "," << statistics.completed / comparisons << ","
+                      << result.expected << "," << result.correct << "," << result.wrong << "," << result.idle << "," << result.mismatches << std::endl;
+
+            if( count == template_count ){
+                break;
+            }
+        }
+
+        if( mismatches ){
+            throw std::runtime_error( "failed gesture engine differs from full DTW" );
+        }
+        if( !same ){
+            throw std::runtime_error( "failed save and load of gesture templates" );
+        }
+        if( GESTURE_BUDGET < p99 ){
+            throw std::runtime_error( "failed p99 of gesture engine exceeds budget per frame" );
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <opencv2/opencv.hpp>
+
+#include <array>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "kernel.h"
+#include "user_source.h"
+
+// Count Mismatched Bytes
+static uint32_t mismatches( const cv::Mat& a, const cv::Mat& b )
+{
+    uint32_t count = 0;
+    for( int32_t y = 0; y < a.rows; y++ ){
+        const uint8_t* pa = a.ptr<uint8_t>( y );
+        const uint8_t* pb = b.ptr<uint8_t>( y );
+        for( int32_t x = 0; x < a.cols * 3; x++ ){
+            count += ( pa[x] != pb[x] );
+        }
+    }
+    return count;
+}
+
+// Kernel Benchmark
+// bench_kernel [WIDTHxHEIGHT] [iterations]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        std::vector<cv::Size> sizes = { cv::Size( 320, 240 ), cv::Size( 640, 480 ), cv::Size( 1280, 720 ) };
+        if( 1 < argc ){
+            uint32_t width = 0, height = 0;
+            if( std::sscanf( argv[1], "%ux%u", &width, &height ) != 2 ){
+                throw std::runtime_error( "failed invalid size (WIDTHxHEIGHT)" );
+            }
+            sizes = { cv::Size( width, height ) };
+        }
+        const uint32_t iterations = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 1000;
+
+        // User Colors
+        std::array<cv::Vec3b, USER_COUNT> colors;
+        for( uint32_t i = 0; i < colors.size(); i++ ){
+            colors[i] = cv::Vec3b( 60 * i % 256, 120 * i % 256, 255 - 40 * i );
+        }
+
+        const std::array<DepthKernel, 3> kernels = { { DEPTH_KERNEL_OPENCV, DEPTH_KERNEL_LUT, DEPTH_KERNEL_SIMD } };
+
+        bool header = true;
+        for( const cv::Size& size : sizes ){
+            // Generate Frame
+            SyntheticUserSource source( size.width, size.height, 0, 2 );
+            UserFrame frame;
+            source.readFrame( frame );
+
+            const std::string name = std::to_string( size.width ) + "x" + std::to_string( size.height );
+
+            std::array<cv::Mat, 3> depth_mats;
+            std::array<cv::Mat, 3> user_mats;
+            for( uint32_t k = 0; k < kernels.size(); k++ ){
+                const DepthKernel kernel = kernels[k];
+                const std::string mode = ( kernel == DEPTH_KERNEL_SIMD ) ? std::string( "simd-" ) + kernelInstructionSet() : depthKernelName( kernel );
+
+                // Depth (Scaling and GRAY to BGR)
+                Benchmark depth( "depth", name, mode );
+                depth.begin( iterations );
+                for( uint32_t i = 0; i < iterations; i++ ){
+                    depth.measure( STAGE_DRAW, [&](){
+                        visualizeDepth( frame.depth_mat, depth_mats[k], kernel );
+                    } );
+                }
+                depth.finish( iterations );
+
+                // User (Scaling, GRAY to BGR and User Color)
+                Benchmark user( "user", name, mode );
+                user.begin( iterations );
+                for( uint32_t i = 0; i < iterations; i++ ){
+                    user.measure( STAGE_DRAW, [&](){
+                        visualizeUser( frame.depth_mat, frame.user_map, colors.data(), static_cast<uint32_t>( colors.size() ), user_mats[k], kernel );
+                    } );
+                }
+                user.finish( iterations );
+
+                // Write Result
+                depth.writeCSV( std::cout, header );
+                user.writeCSV( std::cout, false );
+                header = false;
+
+                // Verify Result (OpenCV as Reference)
+                std::cerr << name << " " << mode << " mismatches: depth " << mismatches( depth_mats[0], depth_mats[k] ) << ", user " << mismatches( user_mats[0], user_mats[k] ) << std::endl;
+            }
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "multi_source.h"
+#include "user_source.h"
+
+// Percentile of Sorted Values
+static double percentile( const std::vector<double>& values, const double rate )
+{
+    if( values.empty() ){
+        return 0.0;
+    }
+    const size_t index = std::min( values.size() - 1, static_cast<size_t>( rate * values.size() ) );
+    return values[index];
+}
+
+// Multi Sensor Benchmark
+// bench_multi [sensors] [seconds] [uri]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const uint32_t sensors = std::min<uint32_t>( ( 1 < argc ) ? static_cast<uint32_t>( std::stoul( argv[1] ) ) : 4, SENSOR_COUNT );
+        const double seconds = ( 2 < argc ) ? std::stod( argv[2] ) : 2.0;
+        const std::string uri = ( 3 < argc ) ? argv[3] : "synthetic:320x240@0:2";
+
+        std::cout << "sensors,captured_fps,merged_fps,fps_per_sensor,scaling,dropped,latency_p50_us,latency_p99_us,pinned" << std::endl;
+
+        double single_fps = 0.0;
+        for( uint32_t count = 1; count <= sensors; count++ ){
+            // Create Sources
+            std::vector<std::unique_ptr<UserSource>> sources;
+            for( uint32_t i = 0; i < count; i++ ){
+                sources.push_back( createUserSource( uri ) );
+            }
+            MultiUserSource source( std::move( sources ) );
+
+            // Read Merged Stream
+            UserFrame frame;
+            SkeletonRecord record;
+            std::vector<uint64_t> merged( count, 0 );
+            std::vector<double> latencies;
+            latencies.reserve( 1 << 20 );
+
+            std::chrono::steady_clock::time_point previous;
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            const std::chrono::steady_clock::time_point end = begin + std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double>( seconds ) );
+            std::chrono::steady_clock::time_point now = begin;
+            try{
+                while( now < end ){
+                    source.readFrame( frame );
+                    fillSnapshot( frame, frame.skeleton );
+                    convertSkeletonRecord( frame.skeleton, record );
+                    frame.release();
+
+                    // Check Order of Capture Time
+                    if( frame.timestamp < previous ){
+                        throw std::runtime_error( "failed merged stream is not ordered by capture time" );
+                    }
+                    previous = frame.timestamp;
+
+                    now = std::chrono::steady_clock::now();
+                    merged[frame.sensor]++;
+                    latencies.push_back( std::chrono::duration<double, std::micro>( now - frame.timestamp ).count() );
+                }
+            } catch( const EndOfSource& ){
+                now = std::chrono::steady_clock::now();
+            }
+            const double elapsed = std::chrono::duration<double>( now - begin ).count();
+
+            // Aggregate Results
+            uint64_t captured = 0, total = 0;
+            uint32_t pinned = 0;
+            for( uint32_t i = 0; i < count; i++ ){
+                if( !merged[i] ){
+                    throw std::runtime_error( "failed sensor " + std::to_string( i ) + " didn't deliver frames" );
+                }
+                captured += source.capturedFrames( i );
+                total += merged[i];
+                pinned += source.isPinned( i ) ? 1 : 0;
+            }
+
+            const double captured_fps = captured / elapsed;
+            const double merged_fps = total / elapsed;
+            if( count == 1 ){
+                single_fps = merged_fps;
+            }
+            std::sort( latencies.begin(), latencies.end() );
+
+            std::cout << count << "," << captured_fps << "," << merged_fps << "," << merged_fps / count << "," << merged_fps / ( count * single_fps ) << ","
+                      << source.droppedFrames() << "," << percentile( latencies, 0.5 ) << "," << percentile( latencies, 0.99 ) << "," << pinned << std::endl;
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
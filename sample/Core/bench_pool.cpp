@@ -0,0 +1,182 @@
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "kernel.h"
+#include "task_pool.h"
+#include "user_source.h"
+
+// User Feature (Centroid and Extent of Confident Joints)
+struct Feature
+{
+    float centroid[3];
+    float extent[3];
+};
+
+// Extract Feature of User
+static void extractFeature( const User& user, Feature& feature )
+{
+    float minimum[3] = { 1e9f, 1e9f, 1e9f };
+    float maximum[3] = { -1e9f, -1e9f, -1e9f };
+    float sum[3] = { 0.0f, 0.0f, 0.0f };
+    uint32_t count = 0;
+    for( const Joint& joint : user.joints ){
+        if( joint.position_confidence < 0.5f ){
+            continue;
+        }
+
+        const float position[3] = { joint.position.x, joint.position.y, joint.position.z };
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            minimum[axis] = std::min( minimum[axis], position[axis] );
+            maximum[axis] = std::max( maximum[axis], position[axis] );
+            sum[axis] += position[axis];
+        }
+        count++;
+    }
+
+    for( uint32_t axis = 0; axis < 3; axis++ ){
+        feature.centroid[axis] = count ? sum[axis] / count : 0.0f;
+        feature.extent[axis] = count ? maximum[axis] - minimum[axis] : 0.0f;
+    }
+}
+
+// Measure Function per Iteration [us] (Sorted)
+static std::vector<double> measure( const uint32_t iterations, const std::function<void()>& function )
+{
+    std::vector<double> samples( iterations );
+    for( double& sample : samples ){
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        function();
+        const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - begin;
+        sample = elapsed.count();
+    }
+    std::sort( samples.begin(), samples.end() );
+    return samples;
+}
+
+// Write Result Row
+static void writeRow( const std::string& workload, const std::string& size, const std::string& method, const uint32_t threads, const std::vector<double>& samples )
+{
+    double mean = 0.0;
+    for( const double sample : samples ){
+        mean += sample;
+    }
+    mean /= std::max<size_t>( samples.size(), 1 );
+
+    const double p50 = samples[std::min( samples.size() - 1, samples.size() / 2 )];
+    const double p99 = samples[std::min( samples.size() - 1, samples.size() * 99 / 100 )];
+    std::cout << workload << "," << size << "," << method << "," << threads << "," << mean << "," << p50 << "," << p99 << "," << samples.back() << std::endl;
+}
+
+// Task Pool Benchmark
+// bench_pool [WIDTHxHEIGHT] [iterations] [workers]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        uint32_t width = 640, height = 480;
+        if( 1 < argc && std::sscanf( argv[1], "%ux%u", &width, &height ) != 2 ){
+            throw std::runtime_error( "failed invalid size (WIDTHxHEIGHT)" );
+        }
+        const uint32_t iterations = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 2000;
+        const uint32_t workers = ( 3 < argc ) ? static_cast<uint32_t>( std::stoul( argv[3] ) ) : taskPool().threads();
+
+        // Generate Frame (Skeletons of All Users are Tracked)
+        SyntheticUserSource source( width, height, 0, USER_COUNT );
+        for( uint32_t id = 1; id <= USER_COUNT; id++ ){
+            source.startSkeletonTracking( static_cast<nite::UserId>( id ) );
+        }
+        UserFrame frame;
+        for( uint32_t i = 0; i < 2; i++ ){
+            source.readFrame( frame );
+        }
+
+        TaskPool pool( workers );
+        TaskPool serial( 0 );
+#ifdef _OPENMP
+        omp_set_num_threads( static_cast<int>( workers + 1 ) );
+#endif
+        std::cout << "workload,size,method,threads,mean_us,p50_us,p99_us,max_us" << std::endl;
+
+        // User Feature Extraction
+        const std::vector<User>& users = frame.users;
+        std::vector<Feature> features( users.size() );
+        const std::string count = std::to_string( users.size() ) + "users";
+
+        writeRow( "features", count, "serial", 1, measure( iterations, [&](){
+            for( uint32_t i = 0; i < users.size(); i++ ){
+                extractFeature( users[i], features[i] );
+            }
+        } ) );
+
+#ifdef _OPENMP
+        writeRow( "features", count, "openmp", omp_get_max_threads(), measure( iterations, [&](){
+            #pragma omp parallel for
+            for( int32_t i = 0; i < static_cast<int32_t>( users.size() ); i++ ){
+                extractFeature( users[i], features[i] );
+            }
+        } ) );
+#endif
+
+        writeRow( "features", count, "pool_tile1", pool.threads() + 1, measure( iterations, [&](){
+            pool.parallelFor( users.size(), 1, [&]( const size_t begin, const size_t end ){
+                for( size_t i = begin; i < end; i++ ){
+                    extractFeature( users[i], features[i] );
+                }
+            } );
+        } ) );
+
+        writeRow( "features", count, "pool_inline", pool.threads() + 1, measure( iterations, [&](){
+            pool.parallelFor( users.size(), 64, [&]( const size_t begin, const size_t end ){
+                for( size_t i = begin; i < end; i++ ){
+                    extractFeature( users[i], features[i] );
+                }
+            } );
+        } ) );
+
+        // Depth/User Visualization Kernels (Row Tiles)
+        const std::string size = std::to_string( width ) + "x" + std::to_string( height );
+        std::array<cv::Vec3b, USER_COUNT> colors;
+        for( uint32_t i = 0; i < colors.size(); i++ ){
+            colors[i] = cv::Vec3b( 60 * i % 256, 120 * i % 256, 255 - 40 * i );
+        }
+
+        cv::Mat bgr_mat;
+        writeRow( "depth", size, "serial", 1, measure( iterations, [&](){
+            visualizeDepth( frame.depth_mat, bgr_mat, DEPTH_KERNEL_SIMD, serial );
+        } ) );
+        writeRow( "depth", size, "pool", pool.threads() + 1, measure( iterations, [&](){
+            visualizeDepth( frame.depth_mat, bgr_mat, DEPTH_KERNEL_SIMD, pool );
+        } ) );
+        writeRow( "user", size, "serial", 1, measure( iterations, [&](){
+            visualizeUser( frame.depth_mat, frame.user_map, colors.data(), USER_COUNT, bgr_mat, DEPTH_KERNEL_SIMD, serial );
+        } ) );
+        writeRow( "user", size, "pool", pool.threads() + 1, measure( iterations, [&](){
+            visualizeUser( frame.depth_mat, frame.user_map, colors.data(), USER_COUNT, bgr_mat, DEPTH_KERNEL_SIMD, pool );
+        } ) );
+
+        // Keep Features
+        float checksum = 0.0f;
+        for( const Feature& feature : features ){
+            checksum += feature.centroid[0] + feature.extent[0];
+        }
+        std::cerr << "checksum " << checksum << std::endl;
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
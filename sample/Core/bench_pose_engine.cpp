@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "pose_engine.h"
+
+// Budget of Pose Engine per Frame [us] (p99)
+#define POSE_BUDGET 50.0
+
+// Margin of Reference Check [deg or mm] (Values this close to a bound are not compared)
+#define POSE_MARGIN 0.01
+
+// Frame Interval [us] (30 fps)
+#define FRAME_INTERVAL 33333
+
+// Joint Offsets from Torso [mm] (NiTE joint order, standing)
+static const float JOINT_OFFSETS[JOINT_COUNT][3] = {
+    {    0.0f,  450.0f, 0.0f }, // Head
+    {    0.0f,  300.0f, 0.0f }, // Neck
+    { -180.0f,  280.0f, 0.0f }, // Left Shoulder
+    {  180.0f,  280.0f, 0.0f }, // Right Shoulder
+    { -180.0f,    0.0f, 0.0f }, // Left Elbow
+    {  180.0f,    0.0f, 0.0f }, // Right Elbow
+    { -180.0f, -280.0f, 0.0f }, // Left Hand
+    {  180.0f, -280.0f, 0.0f }, // Right Hand
+    {    0.0f,    0.0f, 0.0f }, // Torso
+    { -100.0f, -250.0f, 0.0f }, // Left Hip
+    {  100.0f, -250.0f, 0.0f }, // Right Hip
+    { -100.0f, -700.0f, 0.0f }, // Left Knee
+    {  100.0f, -700.0f, 0.0f }, // Right Knee
+    { -100.0f, -1150.0f, 0.0f }, // Left Foot
+    {  100.0f, -1150.0f, 0.0f }  // Right Foot
+};
+
+// Fill Users of Snapshot at Time [s] (Swinging arms, gaussian noise [mm] and occluded joints)
+static void fillUsers( const uint32_t users, const double time, std::mt19937& random, SkeletonSnapshot& snapshot )
+{
+    std::normal_distribution<float> gaussian( 0.0f, 15.0f );
+    std::uniform_real_distribution<float> uniform( 0.0f, 1.0f );
+
+    snapshot.count = users;
+    for( uint32_t user = 0; user < users; user++ ){
+        snapshot.ids[user] = static_cast<nite::UserId>( user + 1 );
+        snapshot.states[user] = nite::SkeletonState::SKELETON_TRACKED;
+        snapshot.poses[user] = 0;
+        snapshot.users[user] = user;
+
+        const float t = static_cast<float>( time );
+        const float phase = static_cast<float>( user ) * 1.3f;
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            float offset[3] = { JOINT_OFFSETS[type][0], JOINT_OFFSETS[type][1], JOINT_OFFSETS[type][2] };
+
+            // Arms
+            if( 4 <= type && type <= 7 ){
+                const float side = ( type % 2 ) ? 1.0f : -1.0f;
+                const float raise = 0.8f + 0.8f * std::sin( 0.7f * t + phase + side );
+                const float bend = ( type <= 5 ) ? 0.0f : 0.9f * ( 0.5f + 0.5f * std::sin( 1.1f * t + 2.0f * phase ) );
+                const float upper = 280.0f;
+                const float elbow[3] = { side * ( 180.0f + upper * std::sin( raise ) ), 280.0f - upper * std::cos( raise ), 0.0f };
+                if( type <= 5 ){
+                    offset[0] = elbow[0];
+                    offset[1] = elbow[1];
+                    offset[2] = elbow[2];
+                }
+                else{
+                    offset[0] = elbow[0] + side * upper * std::sin( raise ) * std::cos( bend );
+                    offset[1] = elbow[1] - upper * std::cos( raise + bend );
+                    offset[2] = -upper * std::sin( bend );
+                }
+            }
+
+            const bool occluded = uniform( random ) < 0.02f;
+            const size_t lane = SkeletonSnapshot::lane( user, type );
+            snapshot.x[lane] = ( static_cast<float>( user ) - ( users - 1 ) / 2.0f ) * 800.0f + offset[0] + gaussian( random );
+            snapshot.y[lane] = offset[1] + gaussian( random );
+            snapshot.z[lane] = 2500.0f + offset[2] + gaussian( random );
+            snapshot.position_confidence[lane] = occluded ? 0.0f : 1.0f;
+            snapshot.orientation_confidence[lane] = 0.0f;
+        }
+    }
+}
+
+// Retrieve Value of Constraint for User in Snapshot (Reference, Double Precision)
+static double constraintValue( const PoseConstraint& constraint, const SkeletonSnapshot& snapshot, const uint32_t user )
+{
+    const uint32_t used = ( constraint.type == POSE_CONSTRAINT_ANGLE ) ? 3 : 2;
+    std::array<std::array<double, 3>, 3> joints;
+    for( uint32_t i = 0; i < used; i++ ){
+        const size_t lane = SkeletonSnapshot::lane( user, constraint.joints[i] );
+        if( snapshot.position_confidence[lane] < 0.5f ){
+            return std::nan( "" );
+        }
+        joints[i] = { { snapshot.x[lane], snapshot.y[lane], snapshot.z[lane] } };
+    }
+
+    const double dx = joints[0][0] - joints[1][0], dy = joints[0][1] - joints[1][1], dz = joints[0][2] - joints[1][2];
+    switch( constraint.type ){
+        case POSE_CONSTRAINT_ANGLE:
+        {
+            const double vx = joints[2][0] - joints[1][0], vy = joints[2][1] - joints[1][1], vz = joints[2][2] - joints[1][2];
+            const double cosine = ( dx * vx + dy * vy + dz * vz ) / std::sqrt( ( dx * dx + dy * dy + dz * dz ) * ( vx * vx + vy * vy + vz * vz ) );
+            return std::acos( std::max( -1.0, std::min( 1.0, cosine ) ) ) * 57.295779513;
+        }
+        case POSE_CONSTRAINT_OFFSET_X:
+            return dx;
+        case POSE_CONSTRAINT_OFFSET_Y:
+            return dy;
+        case POSE_CONSTRAINT_OFFSET_Z:
+            return dz;
+        default:
+            return std::sqrt( dx * dx + dy * dy + dz * dz );
+    }
+}
+
+// Generate Poses (Targets from a random user of snapshot, 2-5 constraints of random joints)
+static std::vector<PoseDefinition> generatePoses( const uint32_t count, const SkeletonSnapshot& snapshot, std::mt19937& random )
+{
+    std::uniform_int_distribution<uint32_t> joint( 0, JOINT_COUNT - 1 );
+    std::uniform_int_distribution<uint32_t> constraints( 2, 5 );
+    std::uniform_int_distribution<uint32_t> types( 0, POSE_CONSTRAINT_DISTANCE );
+    std::uniform_int_distribution<uint32_t> user( 0, snapshot.count - 1 );
+    std::uniform_real_distribution<float> uniform( 0.0f, 1.0f );
+
+    std::vector<PoseDefinition> poses( count );
+    for( uint32_t index = 0; index < count; index++ ){
+        PoseDefinition& pose = poses[index];
+        pose.name = "pose_" + std::to_string( index );
+        const uint32_t source = user( random );
+        const uint32_t number = constraints( random );
+        while( pose.constraints.size() < number ){
+            PoseConstraint constraint;
+            constraint.type = static_cast<PoseConstraintType>( types( random ) );
+            constraint.joints = { { joint( random ), joint( random ), joint( random ) } };
+            if( constraint.joints[0] == constraint.joints[1] || constraint.joints[1] == constraint.joints[2] ){
+                continue;
+            }
+
+            const double value = constraintValue( constraint, snapshot, source );
+            if( std::isnan( value ) ){
+                continue;
+            }
+            constraint.tolerance = ( constraint.type == POSE_CONSTRAINT_ANGLE ) ? 15.0f + 25.0f * uniform( random ) : 80.0f + 170.0f * uniform( random );
+            constraint.target = static_cast<float>( value ) + ( uniform( random ) - 0.5f ) * constraint.tolerance;
+            pose.constraints.push_back( constraint );
+        }
+    }
+    return poses;
+}
+
+// Check Pose Engine against Reference (Return number of compared user x pose)
+static uint64_t checkMatches( const PoseEngine& engine, const std::vector<PoseDefinition>& poses, const SkeletonSnapshot& snapshot, uint64_t& mismatches )
+{
+    uint64_t compared = 0;
+    for( uint32_t user = 0; user < snapshot.count; user++ ){
+        for( uint32_t pose = 0; pose < poses.size(); pose++ ){
+            bool match = true;
+            double margin = 1.0e9;
+            for( const PoseConstraint& constraint : poses[pose].constraints ){
+                const double value = constraintValue( constraint, snapshot, user );
+                const double distance = std::abs( value - constraint.target );
+                match = match && distance <= constraint.tolerance;
+                if( !std::isnan( value ) ){
+                    margin = std::min( margin, std::abs( distance - constraint.tolerance ) );
+                }
+            }
+            if( margin < POSE_MARGIN ){
+                continue;
+            }
+
+            compared++;
+            if( match != engine.matched( user, pose ) ){
+                mismatches++;
+            }
+        }
+    }
+    return compared;
+}
+
+// Check State Machine (Hands together and apart for 15 frames each)
+static bool checkStates()
+{
+    PoseDefinition definition;
+    definition.name = "hands_together";
+    definition.hold = 200;
+    definition.release = 100;
+    PoseConstraint constraint;
+    constraint.type = POSE_CONSTRAINT_DISTANCE;
+    constraint.joints = { { 6, 7, 0 } }; // Left Hand, Right Hand
+    constraint.target = 0.0f;
+    constraint.tolerance = 100.0f;
+    definition.constraints.push_back( constraint );
+    PoseEngine engine( std::vector<PoseDefinition>( 1, definition ) );
+
+    // Expected Frames of Entered and Exited
+    const uint32_t entered_frame = ( 200000 + FRAME_INTERVAL - 1 ) / FRAME_INTERVAL;
+    const uint32_t exited_frame = 15 + ( 100000 + FRAME_INTERVAL - 1 ) / FRAME_INTERVAL;
+
+    SkeletonSnapshot snapshot;
+    for( uint32_t frame = 0; frame < 30; frame++ ){
+        snapshot.timestamp = 1000000 + static_cast<uint64_t>( frame ) * FRAME_INTERVAL;
+        snapshot.count = 1;
+        snapshot.ids[0] = 1;
+        snapshot.states[0] = nite::SkeletonState::SKELETON_TRACKED;
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const size_t lane = SkeletonSnapshot::lane( 0, type );
+            snapshot.x[lane] = JOINT_OFFSETS[type][0];
+            snapshot.y[lane] = JOINT_OFFSETS[type][1];
+            snapshot.z[lane] = 2000.0f;
+            snapshot.position_confidence[lane] = 1.0f;
+        }
+        const float gap = ( frame < 15 ) ? 20.0f : 400.0f;
+        snapshot.x[SkeletonSnapshot::lane( 0, 6 )] = -gap / 2.0f;
+        snapshot.x[SkeletonSnapshot::lane( 0, 7 )] = gap / 2.0f;
+        engine.evaluate( snapshot );
+
+        uint8_t expected = 0;
+        if( frame == entered_frame ){
+            expected = POSE_ENTERED;
+        }
+        else if( entered_frame < frame && frame < exited_frame ){
+            expected = POSE_HELD;
+        }
+        else if( frame == exited_frame ){
+            expected = POSE_EXITED;
+        }
+        if( engine.status( 0, 0 ) != expected ){
+            return false;
+        }
+    }
+    return true;
+}
+
+// Percentile of Samples
+static double percentile( std::vector<double> samples, const double rank )
+{
+    if( samples.empty() ){
+        return 0.0;
+    }
+    const size_t index = std::min( samples.size() - 1, static_cast<size_t>( rank * ( samples.size() - 1 ) + 0.5 ) );
+    std::nth_element( samples.begin(), samples.begin() + index, samples.end() );
+    return samples[index];
+}
+
+// Pose Engine Benchmark
+// bench_pose_engine [poses] [users] [frames]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const uint32_t pose_count = ( 1 < argc ) ? static_cast<uint32_t>( std::stoul( argv[1] ) ) : 100;
+        const uint32_t users = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : USER_COUNT;
+        const uint32_t frames = ( 3 < argc ) ? static_cast<uint32_t>( std::stoul( argv[3] ) ) : 3000;
+        if( !pose_count || !users || USER_COUNT < users || !frames ){
+            throw std::runtime_error( "failed invalid number of poses, users or frames" );
+        }
+
+        // Generate Poses
+        std::mt19937 random( 1 );
+        SkeletonSnapshot snapshot;
+        fillUsers( users, 0.0, random, snapshot );
+        const std::vector<PoseDefinition> poses = generatePoses( pose_count, snapshot, random );
+        uint32_t constraints = 0;
+        for( const PoseDefinition& pose : poses ){
+            constraints += static_cast<uint32_t>( pose.constraints.size() );
+        }
+
+        // Save and Load Pose Definitions
+        const std::string path = "bench_pose_engine.poses";
+        savePoseDefinitions( path, poses );
+        const std::vector<PoseDefinition> loaded = loadPoseDefinitions( path );
+        std::remove( path.c_str() );
+        PoseEngine engine( loaded );
+        PoseEngine original( poses );
+
+        // Evaluate Frames
+        std::vector<double> samples;
+        samples.reserve( frames );
+        uint64_t compared = 0, mismatches = 0, matches = 0, entered = 0, exited = 0, differences = 0;
+        for( uint32_t frame = 0; frame < frames; frame++ ){
+            snapshot.timestamp = static_cast<uint64_t>( frame ) * FRAME_INTERVAL;
+            snapshot.frame_index = static_cast<int32_t>( frame );
+            fillUsers( users, frame * FRAME_INTERVAL * 1.0e-6, random, snapshot );
+
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            engine.evaluate( snapshot );
+            samples.push_back( std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count() );
+
+            // Check against Reference and Loaded Definitions
+            compared += checkMatches( engine, poses, snapshot, mismatches );
+            original.evaluate( snapshot );
+            differences += ( original.getStatuses() != engine.getStatuses() );
+            for( uint32_t user = 0; user < users; user++ ){
+                for( uint32_t pose = 0; pose < pose_count; pose++ ){
+                    matches += engine.matched( user, pose );
+                    entered += ( engine.status( user, pose ) & POSE_ENTERED ) != 0;
+                    exited += ( engine.status( user, pose ) & POSE_EXITED ) != 0;
+                }
+            }
+        }
+        const bool states = checkStates();
+
+        // Write Result
+        double sum = 0.0;
+        for( const double sample : samples ){
+            sum += sample;
+        }
+        const double mean = sum / samples.size();
+        const double p99 = percentile( samples, 0.99 );
+        std::cout << "poses,users,constraints,features,instruction_set,us_per_frame,p99_us,max_us,ns_per_user_pose,match_rate,entered,exited,compared,mismatches,load_differences,state_machine" << std::endl;
+        std::cout << pose_count << "," << users << "," << constraints << "," << engine.featureCount() << "," << poseInstructionSet() << ","
+                  << mean << "," << p99 << "," << percentile( samples, 1.0 ) << "," << mean * 1000.0 / ( users * pose_count ) << ","
+                  << static_cast<double>( matches ) / ( static_cast<double>( frames ) * users * pose_count ) << "," << entered << "," << exited << ","
+                  << compared << "," << mismatches << "," << differences << "," << ( states ? "ok" : "failed" ) << std::endl;
+
+        if( mismatches || differences ){
+            throw std::runtime_error( "failed pose engine differs from reference" );
+        }
+        if( !states ){
+            throw std::runtime_error( "failed pose state machine" );
+        }
+        if( POSE_BUDGET < p99 ){
+            throw std::runtime_error( "failed p99 of pose engine exceeds budget per frame" );
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "projection.h"
+#include "user_source.h"
+#include "util.h"
+
+// Measure Nanoseconds per Iteration
+static double measure( const uint32_t iterations, const std::function<void()>& function )
+{
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for( uint32_t i = 0; i < iterations; i++ ){
+        function();
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / iterations;
+}
+
+// Maximum Absolute Difference
+static float maxError( const std::vector<float>& a, const std::vector<float>& b )
+{
+    if( a.size() != b.size() ){
+        throw std::runtime_error( "failed different number of points" );
+    }
+    float error = 0.0f;
+    for( size_t i = 0; i < a.size(); i++ ){
+        error = std::max( error, std::abs( a[i] - b[i] ) );
+    }
+    return error;
+}
+
+// Projection Benchmark
+// bench_projection [users] [iterations] [calibration]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const uint32_t users = std::min<uint32_t>( ( 1 < argc ) ? static_cast<uint32_t>( std::stoul( argv[1] ) ) : USER_COUNT, USER_COUNT );
+        const uint32_t iterations = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 200000;
+        const std::string calibration = ( 3 < argc ) ? argv[3] : "";
+
+        // Generate Frame (Skeletons of All Users are Tracked)
+        std::unique_ptr<UserSource> source( new SyntheticUserSource( 640, 480, 0, users ) );
+        for( uint32_t id = 1; id <= users; id++ ){
+            source->startSkeletonTracking( static_cast<nite::UserId>( id ) );
+        }
+        UserFrame frame;
+        for( uint32_t i = 0; i < 2; i++ ){
+            source->readFrame( frame );
+        }
+
+        constexpr float threshold = 0.7f;
+        std::vector<float> depth_x, depth_y;
+        depth_x.reserve( USER_COUNT * JOINT_COUNT );
+        depth_y.reserve( USER_COUNT * JOINT_COUNT );
+
+        // Per Joint
+        const double per_joint = measure( iterations, [&](){
+            depth_x.clear();
+            depth_y.clear();
+            for( const User& user : frame.users ){
+                if( user.is_lost || user.skeleton_state != nite::SkeletonState::SKELETON_TRACKED ){
+                    continue;
+                }
+                for( const Joint& joint : user.joints ){
+                    if( joint.position_confidence < threshold ){
+                        continue;
+                    }
+                    float x, y;
+                    NITE_CHECK( source->convertJointCoordinatesToDepth( joint.position.x, joint.position.y, joint.position.z, &x, &y ) );
+                    depth_x.push_back( x );
+                    depth_y.push_back( y );
+                }
+            }
+        } );
+
+        // Batch (Gather and Project)
+        JointBatch batch;
+        const double gather_project = measure( iterations, [&](){
+            projectJoints( frame, threshold, batch );
+        } );
+
+        // Batch (Project Only)
+        const double project = measure( iterations, [&](){
+            batch.project( frame.intrinsics );
+        } );
+
+        // Maximum Difference [px]
+        if( batch.size() != depth_x.size() ){
+            throw std::runtime_error( "failed batch has different number of joints" );
+        }
+        float error = 0.0f;
+        for( size_t i = 0; i < batch.size(); i++ ){
+            error = std::max( error, std::max( std::abs( batch.depth_x[i] - depth_x[i] ), std::abs( batch.depth_y[i] - depth_y[i] ) ) );
+        }
+
+        const double joints = static_cast<double>( std::max<size_t>( batch.size(), 1 ) );
+        std::cout << "method,users,joints,ns_per_frame,ns_per_joint,max_error_px" << std::endl;
+        std::cout << "per_joint," << users << "," << batch.size() << "," << per_joint << "," << per_joint / joints << ",0" << std::endl;
+        std::cout << "batch," << users << "," << batch.size() << "," << gather_project << "," << gather_project / joints << "," << error << std::endl;
+        std::cout << "batch_project_only," << users << "," << batch.size() << "," << project << "," << project / joints << "," << error << std::endl;
+
+        // Known Intrinsics of Depth Frame
+        const Intrinsics intrinsics = calibration.empty() ? intrinsicsFromFieldOfView( 640, 480, 1.0210f, 0.7959f ) : loadIntrinsics( calibration );
+        const cv::Mat& depth_mat = frame.depth_mat;
+        const uint32_t width = depth_mat.cols;
+        const uint32_t height = depth_mat.rows;
+        const size_t points = static_cast<size_t>( width ) * height;
+        const uint32_t cloud_iterations = std::max<uint32_t>( iterations / 1000, 10 );
+
+        // Calibration File Round Trip
+        const std::string calibration_path = "bench_projection.calibration";
+        saveIntrinsics( calibration_path, intrinsics );
+        const Intrinsics loaded = loadIntrinsics( calibration_path );
+        std::remove( calibration_path.c_str() );
+        const float calibration_error = std::max( std::max( std::abs( loaded.focal_x - intrinsics.focal_x ), std::abs( loaded.focal_y - intrinsics.focal_y ) ),
+                                                  std::max( std::abs( loaded.center_x - intrinsics.center_x ), std::abs( loaded.center_y - intrinsics.center_y ) ) );
+
+        // Point Cloud (Per Pixel unprojectPoint(), Reference)
+        PointBatch reference;
+        const double per_pixel = measure( cloud_iterations, [&](){
+            reference.resize( points );
+            for( uint32_t v = 0; v < height; v++ ){
+                const uint16_t* row = depth_mat.ptr<uint16_t>( v );
+                for( uint32_t u = 0; u < width; u++ ){
+                    const size_t i = static_cast<size_t>( v ) * width + u;
+                    const float z = static_cast<float>( row[u] );
+                    unprojectPoint( intrinsics, static_cast<float>( u ), static_cast<float>( v ), z, &reference.x[i], &reference.y[i] );
+                    reference.z[i] = z;
+                }
+            }
+        } );
+
+        // Point Cloud (SIMD, Calling Thread Only)
+        TaskPool serial( 0 );
+        PointBatch cloud;
+        const double cloud_serial = measure( cloud_iterations, [&](){
+            depthToPointCloud( intrinsics, depth_mat.ptr<uint16_t>(), width, height, depth_mat.step, cloud, serial );
+        } );
+        const float cloud_serial_error = std::max( std::max( maxError( cloud.x, reference.x ), maxError( cloud.y, reference.y ) ), maxError( cloud.z, reference.z ) );
+
+        // Point Cloud (SIMD, Row Tiles on Task Pool)
+        const double cloud_pool = measure( cloud_iterations, [&](){
+            depthToPointCloud( intrinsics, depth_mat.ptr<uint16_t>(), width, height, depth_mat.step, cloud, taskPool() );
+        } );
+        const float cloud_pool_error = std::max( std::max( maxError( cloud.x, reference.x ), maxError( cloud.y, reference.y ) ), maxError( cloud.z, reference.z ) );
+
+        // Round Trip (Pixel error and world error [mm] of valid pixels)
+        cloud.project( intrinsics );
+        PointBatch round_trip;
+        round_trip.resize( points );
+        const double unproject = measure( cloud_iterations, [&](){
+            unprojectPoints( intrinsics, cloud.depth_x.data(), cloud.depth_y.data(), cloud.z.data(), round_trip.x.data(), round_trip.y.data(), points );
+        } );
+        float pixel_error = 0.0f, world_error = 0.0f;
+        for( size_t i = 0; i < points; i++ ){
+            if( cloud.z[i] <= 0.0f ){
+                continue;
+            }
+            pixel_error = std::max( pixel_error, std::max( std::abs( cloud.depth_x[i] - static_cast<float>( i % width ) ), std::abs( cloud.depth_y[i] - static_cast<float>( i / width ) ) ) );
+            world_error = std::max( world_error, std::max( std::abs( round_trip.x[i] - cloud.x[i] ), std::abs( round_trip.y[i] - cloud.y[i] ) ) );
+        }
+
+        std::cout << std::endl;
+        std::cout << "method,width,height,ns_per_frame,ns_per_point,max_error" << std::endl;
+        std::cout << "calibration_roundtrip," << width << "," << height << ",0,0," << calibration_error << std::endl;
+        std::cout << "point_cloud_per_pixel," << width << "," << height << "," << per_pixel << "," << per_pixel / points << ",0" << std::endl;
+        std::cout << "point_cloud_serial," << width << "," << height << "," << cloud_serial << "," << cloud_serial / points << "," << cloud_serial_error << std::endl;
+        std::cout << "point_cloud_pool," << width << "," << height << "," << cloud_pool << "," << cloud_pool / points << "," << cloud_pool_error << std::endl;
+        std::cout << "project_pixel_error," << width << "," << height << ",0,0," << pixel_error << std::endl;
+        std::cout << "unproject_world_error_mm," << width << "," << height << "," << unproject << "," << unproject / points << "," << world_error << std::endl;
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,479 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "publisher.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment( lib, "ws2_32.lib" )
+typedef WSAPOLLFD PollDescriptor;
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef pollfd PollDescriptor;
+#endif
+
+// Maximum p99 Time of publish() [us]
+#define PUBLISH_BUDGET 100
+
+// Maximum p99 Publish to Receive Latency of Full Rate TCP Subscribers [us]
+#define LATENCY_BUDGET 5000
+
+// Slow Subscriber Reads [bytes] every [ms]
+#define SLOW_READ_SIZE 2048
+#define SLOW_READ_INTERVAL 100
+
+// Rate of Rate Limited Subscribers [Hz]
+#define LIMITED_RATE 10
+
+// Interval of UDP Keep-Alive [ms]
+#define KEEP_ALIVE_INTERVAL 1000
+
+// Class of Subscriber
+enum SubscriberClass
+{
+    CLASS_FULL,    // TCP, all streams, every frame (No request)
+    CLASS_SUBSET,  // TCP, skeleton of 3 joints of 2 users (Invalid request first)
+    CLASS_LIMITED, // TCP, all streams at LIMITED_RATE
+    CLASS_SLOW,    // TCP, reads SLOW_READ_SIZE every SLOW_READ_INTERVAL (Decimated by backlog)
+    CLASS_UDP,     // UDP, all streams, every frame
+    CLASS_COUNT
+};
+
+// Names of Classes
+static const char* const class_names[CLASS_COUNT] = { "tcp_full", "tcp_subset", "tcp_rate", "tcp_slow", "udp_full" };
+
+// Retrieve Request of Class
+static std::string classRequest( const SubscriberClass type )
+{
+    switch( type ){
+        case CLASS_SUBSET:
+            return "joints=nose\nstreams=skeleton joints=head,left_hand,right_hand users=1,2\n";
+        case CLASS_LIMITED:
+            return "rate=" + std::to_string( LIMITED_RATE ) + "\n";
+        case CLASS_UDP:
+            return "streams=all\n";
+        default:
+            return "";
+    }
+}
+
+// Subscriber Client
+struct Client
+{
+    SubscriberClass type = CLASS_FULL;
+    intptr_t fd = -1;
+    std::string buffer;
+    int64_t next_read = 0;
+    int64_t next_keep_alive = 0;
+
+    uint64_t messages = 0;
+    uint64_t missing = 0;    // Frames skipped by full rate subscriber
+    uint64_t violations = 0; // Messages that don't match the filter
+    uint64_t errors = 0;     // Error replies
+    int64_t last_frame = -1;
+    std::vector<uint32_t> latencies; // Publish to receive [us]
+};
+
+// Retrieve Steady Clock [us]
+static int64_t microseconds()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+// Close Socket
+static void closeClient( const intptr_t fd )
+{
+    #ifdef _WIN32
+    closesocket( static_cast<SOCKET>( fd ) );
+    #else
+    close( static_cast<int>( fd ) );
+    #endif
+}
+
+// Set Socket Non-Blocking
+static void setNonBlocking( const intptr_t fd )
+{
+    #ifdef _WIN32
+    u_long mode = 1;
+    ioctlsocket( static_cast<SOCKET>( fd ), FIONBIO, &mode );
+    #else
+    fcntl( static_cast<int>( fd ), F_SETFL, fcntl( static_cast<int>( fd ), F_GETFL, 0 ) | O_NONBLOCK );
+    #endif
+}
+
+// Retrieve Integer Field of Message (-1 if not found)
+static int64_t field( const std::string& line, const char* key )
+{
+    const size_t position = line.find( key );
+    if( position == std::string::npos ){
+        return -1;
+    }
+    return std::strtoll( line.c_str() + position + std::strlen( key ), nullptr, 10 );
+}
+
+// Check Message of Subscriber
+static void consume( Client& client, const std::string& line )
+{
+    if( line.compare( 0, 9, "{\"error\":" ) == 0 ){
+        client.errors++;
+        return;
+    }
+
+    const int64_t frame = field( line, "{\"frame\":" );
+    const int64_t timestamp = field( line, ",\"timestamp\":" );
+    if( frame < 0 || timestamp < 0 || line.back() != '}' ){
+        client.violations++;
+        return;
+    }
+    client.messages++;
+    client.latencies.push_back( static_cast<uint32_t>( std::max<int64_t>( 0, microseconds() - timestamp ) ) );
+
+    // Every Frame in Order
+    if( client.type == CLASS_FULL || client.type == CLASS_UDP ){
+        if( 0 <= client.last_frame && client.last_frame + 1 < frame ){
+            client.missing += frame - client.last_frame - 1;
+        }
+    }
+    if( frame <= client.last_frame ){
+        client.violations++;
+    }
+    client.last_frame = frame;
+
+    // Joint and User Subset without Hands
+    if( client.type == CLASS_SUBSET ){
+        const bool valid = line.find( "\"head\"" ) != std::string::npos && line.find( "\"left_hand\"" ) != std::string::npos
+                        && line.find( "\"neck\"" ) == std::string::npos && line.find( "\"poses\"" ) == std::string::npos
+                        && line.find( "\"hands\"" ) == std::string::npos && line.find( "{\"id\":3" ) == std::string::npos
+                        && line.find( "{\"id\":1" ) != std::string::npos && line.find( "{\"id\":2" ) != std::string::npos;
+        if( !valid ){
+            client.violations++;
+        }
+    } else if( line.find( "\"right_foot\"" ) == std::string::npos || line.find( "\"hands\"" ) == std::string::npos || line.find( "{\"id\":4" ) == std::string::npos ){
+        client.violations++;
+    }
+}
+
+// Fill Frame (Timestamp is publish time [us])
+static void fillFrame( PublishedFrame& frame, const int32_t index )
+{
+    frame.timestamp = static_cast<uint64_t>( microseconds() );
+    frame.frame_index = index;
+    frame.sensor = 0;
+    frame.user_count = 4;
+    for( uint32_t number = 0; number < frame.user_count; number++ ){
+        PublishedUser& user = frame.users[number];
+        user.id = static_cast<int32_t>( number + 1 );
+        user.state = 2;
+        user.poses = ( index & 0x10 ) ? 0x02 : 0x00;
+        for( uint32_t type = 0; type < PUBLISHER_JOINT_COUNT; type++ ){
+            PublishedJoint& joint = user.joints[type];
+            joint.position[0] = 100.0f * number + type + 0.25f * ( index & 0xFF );
+            joint.position[1] = 50.0f * type - 400.0f;
+            joint.position[2] = 2000.0f + 10.0f * number;
+            joint.confidence = 1.0f;
+        }
+    }
+    frame.hand_count = 2;
+    for( uint32_t number = 0; number < frame.hand_count; number++ ){
+        PublishedHand& hand = frame.hands[number];
+        hand.id = static_cast<int32_t>( number + 1 );
+        hand.flags = 0x04;
+        hand.position[0] = 200.0f * number;
+        hand.position[1] = 100.0f;
+        hand.position[2] = 1500.0f;
+    }
+    frame.gesture_count = 1;
+    frame.gestures[0].type = 0;
+    frame.gestures[0].flags = 0x02;
+    std::copy( frame.hands[0].position, frame.hands[0].position + 3, frame.gestures[0].position );
+    frame.match_count = 1;
+    frame.matches[0].gesture = 0;
+    frame.matches[0].id = 1;
+    frame.matches[0].distance = 0.05f;
+    std::copy( frame.hands[1].position, frame.hands[1].position + 3, frame.matches[0].position );
+}
+
+// Percentile of Sorted Values
+static uint32_t percentile( const std::vector<uint32_t>& values, const size_t permille )
+{
+    return values.empty() ? 0 : values[std::min( values.size() - 1, values.size() * permille / 1000 )];
+}
+
+// Subscribers (Single thread polls all clients)
+static void subscribe( std::vector<Client>& clients, const sockaddr_in& address, const std::atomic<bool>& done )
+{
+    std::vector<PollDescriptor> descriptors;
+    std::vector<size_t> polled;
+    char buffer[65536];
+    while( !done ){
+        // Poll Clients (Slow clients only when their read is due)
+        const int64_t now = microseconds();
+        descriptors.clear();
+        polled.clear();
+        for( size_t index = 0; index < clients.size(); index++ ){
+            Client& client = clients[index];
+            if( client.type == CLASS_UDP && client.next_keep_alive <= now ){
+                const std::string request = classRequest( CLASS_UDP );
+                sendto( client.fd, request.data(), static_cast<int>( request.size() ), 0, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) );
+                client.next_keep_alive = now + KEEP_ALIVE_INTERVAL * 1000;
+            }
+            if( client.type == CLASS_SLOW && now < client.next_read ){
+                continue;
+            }
+            PollDescriptor descriptor = {};
+            descriptor.fd = static_cast<decltype( descriptor.fd )>( client.fd );
+            descriptor.events = POLLIN;
+            descriptors.push_back( descriptor );
+            polled.push_back( index );
+        }
+
+        #ifdef _WIN32
+        WSAPoll( descriptors.data(), static_cast<ULONG>( descriptors.size() ), 10 );
+        #else
+        poll( descriptors.data(), static_cast<nfds_t>( descriptors.size() ), 10 );
+        #endif
+
+        for( size_t number = 0; number < polled.size(); number++ ){
+            if( !( descriptors[number].revents & POLLIN ) ){
+                continue;
+            }
+            Client& client = clients[polled[number]];
+
+            // Datagrams (One message each)
+            if( client.type == CLASS_UDP ){
+                int size = 0;
+                while( 0 < ( size = static_cast<int>( recv( client.fd, buffer, sizeof( buffer ), 0 ) ) ) ){
+                    std::string line( buffer, static_cast<size_t>( size ) );
+                    while( !line.empty() && line.back() == '\n' ){
+                        line.pop_back();
+                    }
+                    consume( client, line );
+                }
+                continue;
+            }
+
+            // Stream (Lines, slow clients read once)
+            const size_t limit = ( client.type == CLASS_SLOW ) ? SLOW_READ_SIZE : sizeof( buffer );
+            int size = 0;
+            while( 0 < ( size = static_cast<int>( recv( client.fd, buffer, static_cast<int>( limit ), 0 ) ) ) ){
+                client.buffer.append( buffer, static_cast<size_t>( size ) );
+                if( client.type == CLASS_SLOW ){
+                    client.next_read = microseconds() + SLOW_READ_INTERVAL * 1000;
+                    break;
+                }
+            }
+            size_t begin = 0;
+            size_t end = 0;
+            while( ( end = client.buffer.find( '\n', begin ) ) != std::string::npos ){
+                consume( client, client.buffer.substr( begin, end - begin ) );
+                begin = end + 1;
+            }
+            client.buffer.erase( 0, begin );
+        }
+    }
+}
+
+// Stream Publisher Benchmark
+// bench_publisher [frames] [rate] [subscribers]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const uint32_t frames = ( 1 < argc ) ? static_cast<uint32_t>( std::stoul( argv[1] ) ) : 1000;
+        const uint32_t rate = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 100;
+        const uint32_t count = ( 3 < argc ) ? static_cast<uint32_t>( std::stoul( argv[3] ) ) : 50;
+        if( !frames || !rate || count < 10 || PUBLISHER_MAX_SUBSCRIBERS < count ){
+            throw std::runtime_error( "failed number of frames and rate must be greater than 0, subscribers must be 10-" + std::to_string( PUBLISHER_MAX_SUBSCRIBERS ) );
+        }
+
+        StreamPublisher publisher( "127.0.0.1", 0, { "circle" } );
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons( publisher.port() );
+        address.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+        // Connect Subscribers
+        const uint32_t class_counts[CLASS_COUNT] = { count - count * 2 / 10 * 2 - count / 10 * 2, count * 2 / 10, count * 2 / 10, count / 10, count / 10 };
+        std::vector<Client> clients;
+        uint64_t expected_requests = 0;
+        for( uint32_t type = 0; type < CLASS_COUNT; type++ ){
+            for( uint32_t number = 0; number < class_counts[type]; number++ ){
+                Client client;
+                client.type = static_cast<SubscriberClass>( type );
+                client.latencies.reserve( frames );
+                client.fd = static_cast<intptr_t>( socket( AF_INET, ( type == CLASS_UDP ) ? SOCK_DGRAM : SOCK_STREAM, 0 ) );
+                if( client.fd < 0 ){
+                    throw std::runtime_error( "failed can not create socket" );
+                }
+
+                if( type == CLASS_UDP ){
+                    // Request is Sent by Subscriber Thread (Also as keep-alive)
+                    expected_requests++;
+                } else{
+                    // Small Receive Buffer of Slow Subscriber
+                    if( type == CLASS_SLOW ){
+                        const int size = 8192;
+                        setsockopt( client.fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>( &size ), sizeof( size ) );
+                    }
+                    if( connect( client.fd, reinterpret_cast<const sockaddr*>( &address ), sizeof( address ) ) != 0 ){
+                        throw std::runtime_error( "failed can not connect subscriber" );
+                    }
+
+                    const std::string request = classRequest( client.type );
+                    if( !request.empty() && send( client.fd, request.data(), static_cast<int>( request.size() ), 0 ) != static_cast<int>( request.size() ) ){
+                        throw std::runtime_error( "failed can not send request" );
+                    }
+                    expected_requests += ( type == CLASS_SUBSET || type == CLASS_LIMITED ) ? 1 : 0;
+                }
+                setNonBlocking( client.fd );
+                clients.push_back( std::move( client ) );
+            }
+        }
+
+        // Start Subscribers, Wait until All are Subscribed
+        std::atomic<bool> done( false );
+        std::thread thread( subscribe, std::ref( clients ), std::cref( address ), std::cref( done ) );
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 5 );
+        while( publisher.getStatistics().subscribers < clients.size() || publisher.getStatistics().requests < expected_requests ){
+            if( deadline < std::chrono::steady_clock::now() ){
+                done = true;
+                thread.join();
+                throw std::runtime_error( "failed subscribers are not subscribed" );
+            }
+            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        }
+
+        // Publish Frames at Rate (Tracker thread)
+        std::vector<uint32_t> publish_times;
+        publish_times.reserve( frames );
+        uint64_t rejected = 0;
+        const std::chrono::steady_clock::duration interval = std::chrono::nanoseconds( 1000000000 / rate );
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point next = start;
+        for( uint32_t index = 0; index < frames; index++ ){
+            next += interval;
+            std::this_thread::sleep_until( next );
+
+            const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+            if( !publisher.publish( [&]( PublishedFrame& frame ){ fillFrame( frame, static_cast<int32_t>( index ) ); } ) ){
+                rejected++;
+            }
+            publish_times.push_back( static_cast<uint32_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - time ).count() ) );
+        }
+        const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+        // Drain, Stop Subscribers
+        std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) );
+        done = true;
+        thread.join();
+        const PublisherStatistics statistics = publisher.getStatistics();
+        for( const Client& client : clients ){
+            closeClient( client.fd );
+        }
+
+        // Summarize Classes
+        bool failed = false;
+        uint64_t total = 0;
+        uint32_t full_p99 = 0;
+        std::cout << "class,subscribers,messages,messages_per_s,missing,violations,latency_p50_us,latency_p99_us,latency_p999_us,latency_max_us" << std::endl;
+        for( uint32_t type = 0; type < CLASS_COUNT; type++ ){
+            uint32_t subscribers = 0;
+            uint64_t messages = 0;
+            uint64_t missing = 0;
+            uint64_t violations = 0;
+            uint64_t errors = 0;
+            uint64_t most = 0;
+            std::vector<uint32_t> latencies;
+            for( const Client& client : clients ){
+                if( client.type != type ){
+                    continue;
+                }
+                subscribers++;
+                messages += client.messages;
+                missing += client.missing;
+                violations += client.violations;
+                errors += client.errors;
+                most = std::max( most, client.messages );
+                latencies.insert( latencies.end(), client.latencies.begin(), client.latencies.end() );
+            }
+            std::sort( latencies.begin(), latencies.end() );
+            total += messages;
+            std::cout << class_names[type] << "," << subscribers << "," << messages << "," << messages / seconds << "," << missing << "," << violations << ","
+                      << percentile( latencies, 500 ) << "," << percentile( latencies, 990 ) << "," << percentile( latencies, 999 ) << "," << ( latencies.empty() ? 0 : latencies.back() ) << std::endl;
+
+            // Check Subscribers
+            if( violations ){
+                std::cerr << "failed " << violations << " messages of " << class_names[type] << " don't match the filter" << std::endl;
+                failed = true;
+            }
+            if( type == CLASS_FULL ){
+                full_p99 = percentile( latencies, 990 );
+                if( missing || messages != static_cast<uint64_t>( frames ) * subscribers ){
+                    std::cerr << "failed full rate TCP subscribers received " << messages << " of " << static_cast<uint64_t>( frames ) * subscribers << " messages" << std::endl;
+                    failed = true;
+                }
+            }
+            if( type == CLASS_SUBSET && errors != subscribers ){
+                std::cerr << "failed " << errors << " errors for " << subscribers << " invalid requests" << std::endl;
+                failed = true;
+            }
+            if( type == CLASS_LIMITED && seconds * LIMITED_RATE + 1 < most ){
+                std::cerr << "failed rate limited subscriber received " << most << " messages in " << seconds << " s at " << LIMITED_RATE << " Hz" << std::endl;
+                failed = true;
+            }
+            if( type == CLASS_LIMITED && !messages ){
+                std::cerr << "failed rate limited subscribers received no messages" << std::endl;
+                failed = true;
+            }
+        }
+
+        // Summarize Publisher
+        std::sort( publish_times.begin(), publish_times.end() );
+        const uint32_t publish_p99 = percentile( publish_times, 990 ) / 1000;
+        std::cout << "frames,queue_drops,sent,decimated,dropped,encoded,messages_per_s,publish_p50_us,publish_p99_us,publish_max_us" << std::endl;
+        std::cout << statistics.frames << "," << statistics.queue_drops << "," << statistics.sent << "," << statistics.decimated << "," << statistics.dropped << ","
+                  << statistics.encoded << "," << total / seconds << "," << percentile( publish_times, 500 ) / 1000.0 << "," << percentile( publish_times, 990 ) / 1000.0 << ","
+                  << publish_times.back() / 1000.0 << std::endl;
+
+        // Check Publisher
+        if( rejected || statistics.queue_drops ){
+            std::cerr << "failed " << statistics.queue_drops << " frames were dropped at publish()" << std::endl;
+            failed = true;
+        }
+        if( PUBLISH_BUDGET < publish_p99 ){
+            std::cerr << "failed p99 time of publish() " << publish_p99 << " us exceeds " << PUBLISH_BUDGET << " us" << std::endl;
+            failed = true;
+        }
+        if( !statistics.dropped ){
+            std::cerr << "failed slow subscribers were not decimated" << std::endl;
+            failed = true;
+        }
+        if( LATENCY_BUDGET < full_p99 ){
+            std::cerr << "failed p99 latency " << full_p99 << " us exceeds " << LATENCY_BUDGET << " us" << std::endl;
+            failed = true;
+        }
+        if( failed ){
+            return 1;
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ring.h"
+
+// Ring Size of Pipeline
+#define RING_SIZE 2
+
+// Maximum p99 Time of push() [us]
+#define PUSH_BUDGET 200
+
+// Synthetic Frame
+struct SyntheticFrame
+{
+    int32_t index = -1;
+    std::chrono::steady_clock::time_point timestamp;
+    std::vector<uint16_t> depth;
+};
+
+// Drawn Image
+struct SyntheticImage
+{
+    int32_t index = -1;
+    std::chrono::steady_clock::time_point timestamp;
+    uint64_t checksum = 0;
+};
+
+// Result of Round
+struct RoundResult
+{
+    double capture_fps = 0.0;
+    uint32_t shown = 0;
+    uint64_t frame_drops = 0;
+    uint64_t image_drops = 0;
+    uint32_t push_p99 = 0;    // [us]
+    uint32_t latency_p50 = 0; // Capture to shown [us]
+    uint32_t latency_p99 = 0;
+    bool ordered = true;
+    bool counted = true;      // Every frame is shown, dropped or left in ring
+};
+
+// Percentile of Sorted Values
+static uint32_t percentile( const std::vector<uint32_t>& values, const size_t percent )
+{
+    return values.empty() ? 0 : values[std::min( values.size() - 1, values.size() * percent / 100 )];
+}
+
+// Fill Synthetic Depth (Moving blob on ramp)
+static void fillDepth( std::vector<uint16_t>& depth, const uint32_t width, const uint32_t height, const int32_t index )
+{
+    depth.resize( static_cast<size_t>( width ) * height );
+    const int32_t center_x = static_cast<int32_t>( ( index * 4 ) % width );
+    const int32_t center_y = static_cast<int32_t>( height / 2 );
+    for( uint32_t y = 0; y < height; y++ ){
+        for( uint32_t x = 0; x < width; x++ ){
+            const int32_t dx = static_cast<int32_t>( x ) - center_x;
+            const int32_t dy = static_cast<int32_t>( y ) - center_y;
+            depth[y * width + x] = static_cast<uint16_t>( ( dx * dx + dy * dy < 2500 ) ? 1500 : 3000 + y );
+        }
+    }
+}
+
+// Run Round (Capture at rate, process and display with delay [ms])
+static RoundResult runRound( const uint32_t frames, const uint32_t rate, const uint32_t process_delay, const uint32_t display_delay )
+{
+    Ring<SyntheticFrame> frame_ring( RING_SIZE );
+    Ring<SyntheticImage> image_ring( RING_SIZE );
+    RoundResult result;
+
+    // Capture Thread
+    std::vector<uint32_t> push_times;
+    push_times.reserve( frames );
+    double capture_seconds = 0.0;
+    std::thread capture_thread( [&]{
+        const std::chrono::steady_clock::duration interval = std::chrono::nanoseconds( 1000000000 / rate );
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point next = start;
+        for( uint32_t index = 0; index < frames; index++ ){
+            next += interval;
+            std::this_thread::sleep_until( next );
+
+            SyntheticFrame frame;
+            frame.index = static_cast<int32_t>( index );
+            fillDepth( frame.depth, 320, 240, frame.index );
+            frame.timestamp = std::chrono::steady_clock::now();
+
+            const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+            frame_ring.push( std::move( frame ) );
+            push_times.push_back( static_cast<uint32_t>( std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - time ).count() ) );
+        }
+        capture_seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+        frame_ring.close();
+    } );
+
+    // Process Thread
+    uint32_t processed = 0;
+    int32_t last_frame = -1;
+    std::thread process_thread( [&]{
+        SyntheticFrame frame;
+        while( frame_ring.pop( frame ) ){
+            result.ordered = result.ordered && ( last_frame < frame.index );
+            last_frame = frame.index;
+            processed++;
+
+            SyntheticImage image;
+            image.index = frame.index;
+            image.timestamp = frame.timestamp;
+            for( const uint16_t value : frame.depth ){
+                image.checksum += value;
+            }
+            std::this_thread::sleep_for( std::chrono::milliseconds( process_delay ) );
+            image_ring.push( std::move( image ) );
+        }
+        image_ring.close();
+    } );
+
+    // Display (Main Thread)
+    std::vector<uint32_t> latencies;
+    int32_t last_image = -1;
+    SyntheticImage image;
+    while( image_ring.pop( image ) ){
+        result.ordered = result.ordered && ( last_image < image.index );
+        last_image = image.index;
+        latencies.push_back( static_cast<uint32_t>( std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - image.timestamp ).count() ) );
+        result.shown++;
+        std::this_thread::sleep_for( std::chrono::milliseconds( display_delay ) );
+    }
+
+    capture_thread.join();
+    process_thread.join();
+
+    // Summarize
+    result.capture_fps = frames / capture_seconds;
+    result.frame_drops = frame_ring.drops();
+    result.image_drops = image_ring.drops();
+    result.counted = ( processed + result.frame_drops + frame_ring.size() == frames ) && ( result.shown + result.image_drops + image_ring.size() == processed );
+    std::sort( push_times.begin(), push_times.end() );
+    std::sort( latencies.begin(), latencies.end() );
+    result.push_p99 = percentile( push_times, 99 );
+    result.latency_p50 = percentile( latencies, 50 );
+    result.latency_p99 = percentile( latencies, 99 );
+    return result;
+}
+
+// Print Usage
+static void printUsage()
+{
+    std::cerr << "usage: bench_ring [frames] [rate]" << std::endl;
+}
+
+// Ring Benchmark
+// bench_ring [frames] [rate]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const uint32_t frames = ( 1 < argc ) ? static_cast<uint32_t>( std::stoul( argv[1] ) ) : 300;
+        const uint32_t rate = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 60;
+        if( !frames || !rate ){
+            throw std::runtime_error( "failed number of frames and rate must be greater than 0" );
+        }
+
+        // Rounds (Name, process delay [ms], display delay [ms])
+        struct Round
+        {
+            const char* name;
+            uint32_t process_delay;
+            uint32_t display_delay;
+        };
+        const Round rounds[] = { { "fast", 0, 0 }, { "slow_process", 50, 0 }, { "slow_display", 0, 50 } };
+
+        std::cout << "round,frames,capture_fps,shown,frame_drops,image_drops,push_p99_us,latency_p50_us,latency_p99_us" << std::endl;
+        bool failed = false;
+        for( const Round& round : rounds ){
+            const RoundResult result = runRound( frames, rate, round.process_delay, round.display_delay );
+            std::cout << round.name << "," << frames << "," << result.capture_fps << "," << result.shown << "," << result.frame_drops << "," << result.image_drops << ","
+                      << result.push_p99 << "," << result.latency_p50 << "," << result.latency_p99 << std::endl;
+
+            // Check
+            if( !result.ordered ){
+                std::cerr << "failed frames of " << round.name << " are out of order" << std::endl;
+                failed = true;
+            }
+            if( !result.counted ){
+                std::cerr << "failed frames of " << round.name << " are lost without being counted as dropped" << std::endl;
+                failed = true;
+            }
+            if( result.capture_fps < rate * 0.9 ){
+                std::cerr << "failed capture of " << round.name << " runs at " << result.capture_fps << " fps instead of " << rate << " fps" << std::endl;
+                failed = true;
+            }
+            if( PUSH_BUDGET < result.push_p99 ){
+                std::cerr << "failed p99 time of push() " << result.push_p99 << " us exceeds " << PUSH_BUDGET << " us" << std::endl;
+                failed = true;
+            }
+        }
+        if( failed ){
+            return 1;
+        }
+    } catch( std::invalid_argument& ex ){
+        std::cerr << "failed invalid argument (" << ex.what() << ")" << std::endl;
+        printUsage();
+        return 1;
+    } catch( std::out_of_range& ex ){
+        std::cerr << "failed argument out of range (" << ex.what() << ")" << std::endl;
+        printUsage();
+        return 1;
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
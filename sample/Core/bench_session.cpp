@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "session.h"
+#include "user_source.h"
+
+// Elapsed Time [ms]
+static double elapsed( const std::chrono::steady_clock::time_point begin )
+{
+    const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - begin;
+    return duration.count();
+}
+
+// Percentile of Sorted Samples
+static double percentile( const std::vector<double>& samples, const double rate )
+{
+    if( samples.empty() ){
+        return 0.0;
+    }
+    const size_t index = std::min( samples.size() - 1, static_cast<size_t>( rate * samples.size() ) );
+    return samples[index];
+}
+
+// Generate Synthetic User Session (640x480 with Depth and User Map)
+static void generateSession( const std::string& path, const uint64_t frames )
+{
+    SyntheticUserSource source( 640, 480, 0, USER_COUNT );
+    for( uint32_t id = 1; id <= USER_COUNT; id++ ){
+        source.startSkeletonTracking( static_cast<nite::UserId>( id ) );
+    }
+
+    UserFrame frame;
+    source.readFrame( frame );
+    SessionWriter writer( path, createUserSessionHeader( frame, SESSION_DEPTH | SESSION_USER_MAP ) );
+    for( uint64_t i = 0; i < frames; i++ ){
+        if( i ){
+            source.readFrame( frame );
+        }
+        appendSession( writer, frame );
+    }
+    writer.close();
+}
+
+// Session Benchmark
+// bench_session [path|synthetic] [frames] [seeks]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        std::string path = ( 1 < argc ) ? argv[1] : "synthetic";
+        const uint64_t frames = ( 2 < argc ) ? std::stoull( argv[2] ) : 2000;
+        const uint32_t seeks = ( 3 < argc ) ? static_cast<uint32_t>( std::stoul( argv[3] ) ) : 1000;
+
+        // Generate Session
+        if( path == "synthetic" ){
+            path = "bench_session.session";
+            const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            generateSession( path, frames );
+            std::cerr << "generated " << frames << " frames in " << elapsed( begin ) << " ms" << std::endl;
+        }
+
+        std::cout << "metric,frames,value,p50_ms,p95_ms,p99_ms,max_ms" << std::endl;
+
+        // Open Latency (Map File and Load Chunk Table)
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        std::unique_ptr<SessionReader> reader( new SessionReader( path ) );
+        const double open = elapsed( begin );
+        std::cout << "open_ms," << reader->frames() << "," << open << ",,,," << std::endl;
+
+        // Random Seek + Read Latency (Touch Every Depth Pixel)
+        std::mt19937_64 random( 0 );
+        std::uniform_int_distribution<uint64_t> distribution( reader->firstTimestamp(), reader->lastTimestamp() );
+        const SessionHeader& header = reader->sessionHeader();
+        const size_t pixels = static_cast<size_t>( header.depth_width ) * header.depth_height;
+
+        std::vector<double> samples;
+        samples.reserve( seeks );
+        uint64_t checksum = 0;
+        for( uint32_t i = 0; i < seeks; i++ ){
+            const uint64_t timestamp = distribution( random );
+            begin = std::chrono::steady_clock::now();
+            reader->seek( timestamp );
+            SessionFrame session_frame;
+            if( reader->read( session_frame ) ){
+                if( session_frame.depth ){
+                    for( size_t pixel = 0; pixel < pixels; pixel++ ){
+                        checksum += session_frame.depth[pixel];
+                    }
+                }
+            }
+            samples.push_back( elapsed( begin ) );
+        }
+        std::sort( samples.begin(), samples.end() );
+        std::cout << "seek_read_ms," << reader->frames() << "," << seeks << ","
+                  << percentile( samples, 0.50 ) << "," << percentile( samples, 0.95 ) << "," << percentile( samples, 0.99 ) << "," << ( samples.empty() ? 0.0 : samples.back() ) << std::endl;
+        reader.reset();
+
+        // Sequential Replay (Same Path as Samples, No Wait)
+        SessionUserSource source( path, 0.0f );
+        UserFrame frame;
+        uint64_t count = 0;
+        begin = std::chrono::steady_clock::now();
+        try{
+            while( true ){
+                source.readFrame( frame );
+                checksum += frame.users.size();
+                count++;
+            }
+        } catch( const EndOfSource& ){
+        }
+        const double replay = elapsed( begin );
+        std::cout << "replay_fps," << count << "," << ( replay > 0.0 ? count * 1000.0 / replay : 0.0 ) << ",,,," << std::endl;
+
+        std::cerr << "checksum " << checksum << std::endl;
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "shared_frame.h"
+
+// Name of Benchmark Region
+#define BENCH_REGION "nite2_bench_shared"
+
+// Maximum p99 Publish to Consume Latency [us]
+#define LATENCY_BUDGET 2000
+
+// Result of Reader
+struct ReaderResult
+{
+    std::vector<uint32_t> latencies; // Publish to consumed [us]
+    uint64_t consumed = 0;
+    uint64_t lapped = 0;       // Frames overwritten before or while reading
+    uint64_t inconsistent = 0; // Frames read as consistent with data of another frame (Must be 0)
+    double read_seconds = 0.0; // Time in read()
+    uint64_t checksum = 0;
+};
+
+// Result of Round
+struct RoundResult
+{
+    double publish_us = 0.0;   // Mean time of begin() to commit() including copy of planes
+    uint64_t consumed = 0;     // Sum of readers
+    uint64_t lapped = 0;       // Sum of readers
+    uint64_t inconsistent = 0; // Sum of readers
+    double read_us = 0.0;      // Mean time of read() per frame
+    uint32_t p50 = 0;          // Latency of all readers [us]
+    uint32_t p99 = 0;
+    uint32_t max = 0;
+};
+
+// Retrieve Steady Clock [ns]
+static int64_t nanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+// Expected Joint Value of Frame
+static inline float jointValue( const uint64_t sequence, const size_t lane )
+{
+    return static_cast<float>( ( sequence & 0xFFFF ) * 128 + lane );
+}
+
+// Reader (Maps the region by name, consumes every frame in order)
+static void reader( const std::atomic<bool>& done, ReaderResult& result )
+{
+    SharedFrameReader shared( BENCH_REGION );
+    uint64_t last = 0;
+    while( true ){
+        const uint64_t latest = shared.wait( last, std::chrono::milliseconds( 10 ) );
+        if( latest == last ){
+            if( done ){
+                break;
+            }
+            continue;
+        }
+
+        // Skip Frames that are already Overwritten
+        if( shared.slots() < latest - last ){
+            result.lapped += latest - last - shared.slots();
+            last = latest - shared.slots();
+        }
+
+        for( uint64_t sequence = last + 1; sequence <= latest; sequence++ ){
+            // Consume in Place
+            bool consistent = true;
+            uint64_t checksum = 0;
+            int64_t published = 0;
+            const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+            const SharedReadStatus status = shared.read( sequence, [&]( const SharedFrameView& frame ){
+                const SharedFrameInfo& info = *frame.info;
+                published = info.published;
+                consistent = ( info.frame_index == static_cast<int32_t>( sequence ) ) && ( info.user_count == SHARED_USER_COUNT );
+                for( size_t lane = 0; lane < SHARED_USER_COUNT * SHARED_JOINT_COUNT; lane++ ){
+                    consistent = consistent && ( frame.x[lane] == jointValue( sequence, lane ) );
+                    checksum += static_cast<uint64_t>( frame.x[lane] + frame.y[lane] + frame.z[lane] );
+                }
+                for( const uint16_t* plane : { frame.depth, frame.user_map } ){
+                    if( !plane ){
+                        continue;
+                    }
+                    const size_t size = static_cast<size_t>( info.width ) * info.height;
+                    consistent = consistent && ( plane[0] == static_cast<uint16_t>( sequence ) ) && ( plane[size - 1] == static_cast<uint16_t>( sequence ) );
+                    for( size_t index = 0; index < size; index += SHARED_ALIGNMENT / sizeof( uint16_t ) ){
+                        checksum += plane[index];
+                    }
+                }
+            } );
+            const int64_t now = nanoseconds();
+            result.read_seconds += std::chrono::duration<double>( std::chrono::steady_clock::now() - time ).count();
+
+            if( status != SHARED_READ_OK ){
+                result.lapped++;
+                continue;
+            }
+            if( !consistent ){
+                result.inconsistent++;
+            }
+            result.checksum += checksum;
+            result.latencies.push_back( static_cast<uint32_t>( std::max<int64_t>( 0, now - published ) / 1000 ) );
+            result.consumed++;
+        }
+        last = latest;
+    }
+}
+
+// Run Round (Writer publishes frames at rate to readers)
+static RoundResult runRound( const uint32_t flags, const uint32_t readers, const uint32_t frames, const uint32_t rate )
+{
+    SharedFrameWriter writer( BENCH_REGION, flags );
+
+    // Planes of Frame (Copied once per frame as the tracker does)
+    std::vector<uint16_t> plane( static_cast<size_t>( writer.width() ) * writer.height(), 1000 );
+
+    // Start Readers
+    std::atomic<bool> done( false );
+    std::vector<ReaderResult> results( readers );
+    std::vector<std::thread> threads;
+    for( uint32_t index = 0; index < readers; index++ ){
+        results[index].latencies.reserve( frames );
+        threads.emplace_back( reader, std::cref( done ), std::ref( results[index] ) );
+    }
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+
+    // Publish Frames
+    double publish_seconds = 0.0;
+    const std::chrono::steady_clock::duration interval = std::chrono::nanoseconds( 1000000000 / rate );
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    for( uint32_t count = 0; count < frames; count++ ){
+        next += interval;
+        std::this_thread::sleep_until( next );
+
+        const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+        SharedFrame& frame = writer.begin();
+        const uint64_t sequence = writer.published() + 1;
+        frame.info->frame_index = static_cast<int32_t>( sequence );
+        frame.info->timestamp = sequence * 33333;
+        frame.info->user_count = SHARED_USER_COUNT;
+        for( uint32_t user = 0; user < SHARED_USER_COUNT; user++ ){
+            frame.info->user_ids[user] = static_cast<int32_t>( user + 1 );
+        }
+        for( size_t lane = 0; lane < SHARED_USER_COUNT * SHARED_JOINT_COUNT; lane++ ){
+            frame.x[lane] = jointValue( sequence, lane );
+            frame.y[lane] = frame.z[lane] = 1000.0f;
+        }
+        for( const SharedFrameFlag flag : { SHARED_FRAME_DEPTH, SHARED_FRAME_USER_MAP } ){
+            if( flags & flag ){
+                plane.front() = plane.back() = static_cast<uint16_t>( sequence );
+                writer.writePlane( flag, plane.data(), writer.width() * sizeof( uint16_t ), writer.width(), writer.height() );
+            }
+        }
+        writer.commit();
+        publish_seconds += std::chrono::duration<double>( std::chrono::steady_clock::now() - time ).count();
+    }
+
+    // Stop Readers
+    done = true;
+    for( std::thread& thread : threads ){
+        thread.join();
+    }
+
+    // Summarize
+    RoundResult result;
+    result.publish_us = publish_seconds * 1e6 / frames;
+    std::vector<uint32_t> latencies;
+    double read_seconds = 0.0;
+    for( const ReaderResult& data : results ){
+        result.consumed += data.consumed;
+        result.lapped += data.lapped;
+        result.inconsistent += data.inconsistent;
+        read_seconds += data.read_seconds;
+        latencies.insert( latencies.end(), data.latencies.begin(), data.latencies.end() );
+    }
+    result.read_us = result.consumed ? read_seconds * 1e6 / result.consumed : 0.0;
+    if( !latencies.empty() ){
+        std::sort( latencies.begin(), latencies.end() );
+        result.p50 = latencies[latencies.size() / 2];
+        result.p99 = latencies[std::min( latencies.size() - 1, latencies.size() * 99 / 100 )];
+        result.max = latencies.back();
+    }
+    return result;
+}
+
+// Check Planes beyond Capacity (Skipped and Flagged)
+static bool checkCapacity()
+{
+    std::unique_ptr<SharedFrameWriter> writer = createSharedFrameWriter( BENCH_REGION ":all:320x240" );
+    const std::vector<uint16_t> large( 640 * 480, 1000 );
+    const std::vector<uint16_t> small( 320 * 240, 1 );
+    writer->begin();
+    writer->writePlane( SHARED_FRAME_DEPTH, large.data(), 640 * sizeof( uint16_t ), 640, 480 );
+    writer->writePlane( SHARED_FRAME_USER_MAP, small.data(), 320 * sizeof( uint16_t ), 320, 240 );
+    writer->commit();
+
+    SharedFrameReader reader( BENCH_REGION );
+    bool valid = false;
+    const SharedReadStatus status = reader.read( reader.latest(), [&]( const SharedFrameView& view ){
+        valid = !view.depth && view.user_map && view.info->skipped == SHARED_FRAME_DEPTH && view.info->width == 320 && view.info->height == 240;
+    } );
+    return writer->width() == 320 && writer->height() == 240 && status == SHARED_READ_OK && valid;
+}
+
+// Shared Frame Benchmark
+// bench_shared [frames] [rate] [readers,...]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const uint32_t frames = ( 1 < argc ) ? static_cast<uint32_t>( std::stoul( argv[1] ) ) : 600;
+        const uint32_t rate = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 200;
+        std::vector<uint32_t> reader_counts = { 1, 4, 16 };
+        if( 3 < argc ){
+            reader_counts.assign( 1, static_cast<uint32_t>( std::stoul( argv[3] ) ) );
+        }
+        if( !frames || !rate || !reader_counts.front() ){
+            throw std::runtime_error( "failed number of frames, rate and readers must be greater than 0" );
+        }
+
+        std::cout << "planes,readers,frames,publish_us,read_us,consumed,lapped,inconsistent,latency_p50_us,latency_p99_us,latency_max_us" << std::endl;
+        bool failed = false;
+        for( const uint32_t flags : { 0u, static_cast<uint32_t>( SHARED_FRAME_DEPTH | SHARED_FRAME_USER_MAP ) } ){
+            for( const uint32_t readers : reader_counts ){
+                const RoundResult result = runRound( flags, readers, frames, rate );
+                std::cout << ( flags ? "all" : "skeleton" ) << "," << readers << "," << frames << "," << result.publish_us << "," << result.read_us << ","
+                          << result.consumed << "," << result.lapped << "," << result.inconsistent << "," << result.p50 << "," << result.p99 << "," << result.max << std::endl;
+
+                // Check
+                if( result.inconsistent ){
+                    std::cerr << "failed " << result.inconsistent << " inconsistent frames were read as consistent" << std::endl;
+                    failed = true;
+                }
+                if( result.consumed + result.lapped != static_cast<uint64_t>( frames ) * readers ){
+                    std::cerr << "failed frames are lost without being counted as lapped" << std::endl;
+                    failed = true;
+                }
+                if( LATENCY_BUDGET < result.p99 ){
+                    std::cerr << "failed p99 latency " << result.p99 << " us exceeds " << LATENCY_BUDGET << " us" << std::endl;
+                    failed = true;
+                }
+            }
+        }
+        if( !checkCapacity() ){
+            std::cerr << "failed planes beyond capacity of shared memory are not skipped and flagged" << std::endl;
+            failed = true;
+        }
+        if( failed ){
+            return 1;
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
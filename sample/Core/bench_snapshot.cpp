@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "skeleton_filter.h"
+#include "skeleton_snapshot.h"
+#include "user_source.h"
+
+// User Feature (Centroid and Extent of Confident Joints)
+struct Feature
+{
+    float centroid[3];
+    float extent[3];
+};
+
+// Measure Nanoseconds per Iteration
+static double measure( const uint32_t iterations, const std::function<void()>& function )
+{
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for( uint32_t i = 0; i < iterations; i++ ){
+        function();
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / iterations;
+}
+
+// Extract Features of Tracked Users (Users and Joints of Frame, Array of Structures)
+static void extractFeatures( const std::vector<User>& users, const float threshold, std::vector<Feature>& features )
+{
+    features.clear();
+    for( const User& user : users ){
+        if( user.is_lost || user.skeleton_state != nite::SkeletonState::SKELETON_TRACKED ){
+            continue;
+        }
+
+        float minimum[3] = { 1e9f, 1e9f, 1e9f };
+        float maximum[3] = { -1e9f, -1e9f, -1e9f };
+        float sum[3] = { 0.0f, 0.0f, 0.0f };
+        uint32_t count = 0;
+        for( const Joint& joint : user.joints ){
+            if( joint.position_confidence < threshold ){
+                continue;
+            }
+
+            const float position[3] = { joint.position.x, joint.position.y, joint.position.z };
+            for( uint32_t axis = 0; axis < 3; axis++ ){
+                minimum[axis] = std::min( minimum[axis], position[axis] );
+                maximum[axis] = std::max( maximum[axis], position[axis] );
+                sum[axis] += position[axis];
+            }
+            count++;
+        }
+
+        Feature feature;
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            feature.centroid[axis] = count ? sum[axis] / count : 0.0f;
+            feature.extent[axis] = count ? maximum[axis] - minimum[axis] : 0.0f;
+        }
+        features.push_back( feature );
+    }
+}
+
+// Extract Features of Tracked Users (Rows of Snapshot, Structure of Arrays)
+static void extractFeatures( const SkeletonSnapshot& snapshot, const float threshold, std::vector<Feature>& features )
+{
+    features.resize( snapshot.count );
+    for( uint32_t number = 0; number < snapshot.count; number++ ){
+        const size_t row = SkeletonSnapshot::lane( number, 0 );
+        const float* confidence = snapshot.position_confidence + row;
+        const float* position[3] = { snapshot.x + row, snapshot.y + row, snapshot.z + row };
+
+        float minimum[3] = { 1e9f, 1e9f, 1e9f };
+        float maximum[3] = { -1e9f, -1e9f, -1e9f };
+        float sum[3] = { 0.0f, 0.0f, 0.0f };
+        uint32_t count = 0;
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            if( confidence[type] < threshold ){
+                continue;
+            }
+
+            for( uint32_t axis = 0; axis < 3; axis++ ){
+                minimum[axis] = std::min( minimum[axis], position[axis][type] );
+                maximum[axis] = std::max( maximum[axis], position[axis][type] );
+                sum[axis] += position[axis][type];
+            }
+            count++;
+        }
+
+        Feature& feature = features[number];
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            feature.centroid[axis] = count ? sum[axis] / count : 0.0f;
+            feature.extent[axis] = count ? maximum[axis] - minimum[axis] : 0.0f;
+        }
+    }
+}
+
+// Maximum Difference of Features
+static float maxDifference( const std::vector<Feature>& a, const std::vector<Feature>& b )
+{
+    if( a.size() != b.size() ){
+        throw std::runtime_error( "failed different number of features" );
+    }
+    float difference = 0.0f;
+    for( size_t i = 0; i < a.size(); i++ ){
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            difference = std::max( difference, std::abs( a[i].centroid[axis] - b[i].centroid[axis] ) );
+            difference = std::max( difference, std::abs( a[i].extent[axis] - b[i].extent[axis] ) );
+        }
+    }
+    return difference;
+}
+
+// Maximum Difference of Projected Joints [px]
+static float maxDifference( const JointBatch& a, const JointBatch& b )
+{
+    if( a.size() != b.size() ){
+        throw std::runtime_error( "failed different number of joints" );
+    }
+    float difference = 0.0f;
+    for( size_t i = 0; i < a.size(); i++ ){
+        if( a.user[i] != b.user[i] || a.type[i] != b.type[i] ){
+            throw std::runtime_error( "failed different order of joints" );
+        }
+        difference = std::max( difference, std::max( std::abs( a.depth_x[i] - b.depth_x[i] ), std::abs( a.depth_y[i] - b.depth_y[i] ) ) );
+    }
+    return difference;
+}
+
+// Maximum Difference of Skeleton Records
+static float maxDifference( const SkeletonRecord& a, const SkeletonRecord& b )
+{
+    if( a.users.size() != b.users.size() || a.frame_index != b.frame_index || a.timestamp != b.timestamp ){
+        throw std::runtime_error( "failed different skeleton records" );
+    }
+    float difference = 0.0f;
+    for( size_t i = 0; i < a.users.size(); i++ ){
+        if( a.users[i].id != b.users[i].id || a.users[i].state != b.users[i].state || a.users[i].poses != b.users[i].poses ){
+            throw std::runtime_error( "failed different users of skeleton records" );
+        }
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const SkeletonJoint& p = a.users[i].joints[type];
+            const SkeletonJoint& q = b.users[i].joints[type];
+            for( uint32_t axis = 0; axis < 3; axis++ ){
+                difference = std::max( difference, std::abs( p.position[axis] - q.position[axis] ) );
+            }
+            for( uint32_t axis = 0; axis < 4; axis++ ){
+                difference = std::max( difference, std::abs( p.orientation[axis] - q.orientation[axis] ) );
+            }
+            difference = std::max( difference, std::abs( p.position_confidence - q.position_confidence ) );
+            difference = std::max( difference, std::abs( p.orientation_confidence - q.orientation_confidence ) );
+        }
+    }
+    return difference;
+}
+
+// Write Result Row
+static void writeRow( const std::string& consumer, const std::string& layout, const uint32_t users, const double nanoseconds, const float difference )
+{
+    std::cout << consumer << "," << layout << "," << users << "," << nanoseconds << "," << difference << std::endl;
+}
+
+// Skeleton Snapshot Benchmark
+// bench_snapshot [users] [iterations]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const uint32_t users = std::min<uint32_t>( ( 1 < argc ) ? static_cast<uint32_t>( std::stoul( argv[1] ) ) : USER_COUNT, USER_COUNT );
+        const uint32_t iterations = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 200000;
+
+        // Generate Frame (Skeletons of All Users are Tracked)
+        SyntheticUserSource source( 320, 240, 0, users );
+        for( uint32_t id = 1; id <= users; id++ ){
+            source.startSkeletonTracking( static_cast<nite::UserId>( id ) );
+        }
+        UserFrame frame;
+        for( uint32_t i = 0; i < 2; i++ ){
+            source.readFrame( frame );
+        }
+
+        constexpr float threshold = 0.7f;
+        std::cout << "consumer,layout,users,ns_per_frame,max_difference" << std::endl;
+
+        // Fill
+        SkeletonSnapshot& snapshot = frame.skeleton;
+        const double fill = measure( iterations, [&](){
+            fillSnapshot( frame, snapshot );
+        } );
+        writeRow( "fill", "soa", users, fill, 0.0f );
+
+        // Projection (Draw)
+        JointBatch frame_batch, snapshot_batch;
+        const double project_frame = measure( iterations, [&](){
+            projectJoints( frame, threshold, frame_batch );
+        } );
+        const double project_snapshot = measure( iterations, [&](){
+            projectJoints( snapshot, frame.intrinsics, threshold, snapshot_batch );
+        } );
+        const float project_difference = maxDifference( frame_batch, snapshot_batch );
+        writeRow( "project", "aos", users, project_frame, 0.0f );
+        writeRow( "project", "soa", users, project_snapshot, project_difference );
+
+        // Feature Extraction
+        std::vector<Feature> frame_features, snapshot_features;
+        frame_features.reserve( USER_COUNT );
+        snapshot_features.reserve( USER_COUNT );
+        const double feature_frame = measure( iterations, [&](){
+            extractFeatures( frame.users, threshold, frame_features );
+        } );
+        const double feature_snapshot = measure( iterations, [&](){
+            extractFeatures( snapshot, threshold, snapshot_features );
+        } );
+        const float feature_difference = maxDifference( frame_features, snapshot_features );
+        writeRow( "feature", "aos", users, feature_frame, 0.0f );
+        writeRow( "feature", "soa", users, feature_snapshot, feature_difference );
+
+        // Skeleton Stream Record (Write)
+        SkeletonRecord frame_record, snapshot_record;
+        const double record_frame = measure( iterations, [&](){
+            convertSkeletonRecord( frame, frame_record );
+        } );
+        const double record_snapshot = measure( iterations, [&](){
+            convertSkeletonRecord( snapshot, snapshot_record );
+        } );
+        const float record_difference = maxDifference( frame_record, snapshot_record );
+        writeRow( "record", "aos", users, record_frame, 0.0f );
+        writeRow( "record", "soa", users, record_snapshot, record_difference );
+
+        // All Consumers of Frame (Array of Structures) and Snapshot (Fill once, Structure of Arrays)
+        writeRow( "fill+all", "aos", users, project_frame + feature_frame + record_frame, 0.0f );
+        writeRow( "fill+all", "soa", users, fill + project_snapshot + feature_snapshot + record_snapshot, 0.0f );
+
+        // Joint Filter (Reads Snapshot Only)
+        SkeletonFilter filter( parseFilter( "oneeuro" ) );
+        SkeletonSnapshot filtered = snapshot;
+        const double filter_snapshot = measure( iterations, [&](){
+            filtered.timestamp += 33333;
+            filter.apply( filtered );
+        } );
+        writeRow( "filter", "soa", users, filter_snapshot, 0.0f );
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "skeleton_stream.h"
+#include "user_source.h"
+
+// Write Record as Text (Naive Dump: one line per user and joint)
+static void writeText( const SkeletonRecord& record, std::ostream& stream )
+{
+    stream << record.frame_index << " " << record.timestamp << " " << record.users.size() << "\n";
+    for( const SkeletonUser& user : record.users ){
+        stream << user.id << " " << static_cast<uint32_t>( user.state ) << " " << static_cast<uint32_t>( user.poses ) << "\n";
+        for( const SkeletonJoint& joint : user.joints ){
+            stream << joint.position[0] << " " << joint.position[1] << " " << joint.position[2] << " "
+                   << joint.orientation[0] << " " << joint.orientation[1] << " " << joint.orientation[2] << " " << joint.orientation[3] << " "
+                   << joint.position_confidence << " " << joint.orientation_confidence << "\n";
+        }
+    }
+}
+
+// Read Record from Text
+static bool readText( std::istream& stream, SkeletonRecord& record )
+{
+    size_t user_count = 0;
+    if( !( stream >> record.frame_index >> record.timestamp >> user_count ) ){
+        return false;
+    }
+
+    record.users.resize( user_count );
+    for( SkeletonUser& user : record.users ){
+        uint32_t state = 0, poses = 0;
+        stream >> user.id >> state >> poses;
+        user.state = static_cast<uint8_t>( state );
+        user.poses = static_cast<uint8_t>( poses );
+        for( SkeletonJoint& joint : user.joints ){
+            stream >> joint.position[0] >> joint.position[1] >> joint.position[2]
+                   >> joint.orientation[0] >> joint.orientation[1] >> joint.orientation[2] >> joint.orientation[3]
+                   >> joint.position_confidence >> joint.orientation_confidence;
+        }
+    }
+
+    if( !stream ){
+        throw std::runtime_error( "failed can not read text record" );
+    }
+    return true;
+}
+
+// Maximum Position Error [mm]
+static float positionError( const SkeletonRecord& a, const SkeletonRecord& b )
+{
+    if( a.users.size() != b.users.size() ){
+        throw std::runtime_error( "failed decoded record has different number of users" );
+    }
+
+    float error = 0.0f;
+    for( size_t i = 0; i < a.users.size(); i++ ){
+        for( uint32_t type = 0; type < SKELETON_JOINT_COUNT; type++ ){
+            for( uint32_t axis = 0; axis < 3; axis++ ){
+                error = std::max( error, std::abs( a.users[i].joints[type].position[axis] - b.users[i].joints[type].position[axis] ) );
+            }
+        }
+    }
+    return error;
+}
+
+// Measure Records per Second
+static double measure( const uint64_t records, const std::function<void()>& function )
+{
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    function();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return records / elapsed.count();
+}
+
+// Skeleton Stream Benchmark
+// bench_stream [frames] [users] [iterations]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const uint32_t frames = ( 1 < argc ) ? static_cast<uint32_t>( std::stoul( argv[1] ) ) : 300;
+        const uint32_t users = std::min<uint32_t>( ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : USER_COUNT, USER_COUNT );
+        const uint32_t iterations = ( 3 < argc ) ? static_cast<uint32_t>( std::stoul( argv[3] ) ) : 20;
+
+        // Generate Records (30 fps Motion, Skeletons of All Users are Tracked)
+        SyntheticUserSource source( 160, 120, 0, users );
+        for( uint32_t id = 1; id <= users; id++ ){
+            source.startSkeletonTracking( static_cast<nite::UserId>( id ) );
+        }
+
+        std::vector<SkeletonRecord> records( frames );
+        for( SkeletonRecord& record : records ){
+            UserFrame frame;
+            source.readFrame( frame );
+            convertSkeletonRecord( frame, record );
+        }
+
+        const uint64_t count = static_cast<uint64_t>( frames ) * iterations;
+        std::cout << "format,frames,users,bytes_per_frame,encode_records_per_sec,decode_records_per_sec,max_error_mm" << std::endl;
+
+        // Text Dump
+        {
+            std::string text;
+            const double encode = measure( count, [&](){
+                for( uint32_t i = 0; i < iterations; i++ ){
+                    std::ostringstream stream;
+                    for( const SkeletonRecord& record : records ){
+                        writeText( record, stream );
+                    }
+                    text = stream.str();
+                }
+            } );
+
+            float error = 0.0f;
+            const double decode = measure( count, [&](){
+                for( uint32_t i = 0; i < iterations; i++ ){
+                    std::istringstream stream( text );
+                    SkeletonRecord record;
+                    for( const SkeletonRecord& original : records ){
+                        readText( stream, record );
+                        error = std::max( error, positionError( original, record ) );
+                    }
+                }
+            } );
+
+            std::cout << "text," << frames << "," << users << "," << static_cast<double>( text.size() ) / frames << "," << encode << "," << decode << "," << error << std::endl;
+        }
+
+        // Binary Skeleton Stream
+        const std::vector<StreamEncoding> encodings = { STREAM_ENCODING_FLOAT32, STREAM_ENCODING_FLOAT16, STREAM_ENCODING_QUANTIZED, STREAM_ENCODING_DELTA };
+        for( const StreamEncoding encoding : encodings ){
+            std::string buffer;
+            const double encode = measure( count, [&](){
+                for( uint32_t i = 0; i < iterations; i++ ){
+                    SkeletonStreamWriter writer( encoding );
+                    buffer.clear();
+                    for( const SkeletonRecord& record : records ){
+                        writer.encode( record, buffer );
+                    }
+                }
+            } );
+
+            float error = 0.0f;
+            const double decode = measure( count, [&](){
+                for( uint32_t i = 0; i < iterations; i++ ){
+                    SkeletonStreamReader reader;
+                    SkeletonRecord record;
+                    size_t offset = 0;
+                    for( const SkeletonRecord& original : records ){
+                        const size_t size = reader.decode( buffer.data() + offset, buffer.size() - offset, record );
+                        if( !size ){
+                            throw std::runtime_error( "failed incomplete skeleton stream" );
+                        }
+                        offset += size;
+                        error = std::max( error, positionError( original, record ) );
+                    }
+                }
+            } );
+
+            std::cout << streamEncodingName( encoding ) << "," << frames << "," << users << "," << static_cast<double>( buffer.size() ) / frames << "," << encode << "," << decode << "," << error << std::endl;
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
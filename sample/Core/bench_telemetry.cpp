@@ -0,0 +1,186 @@
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark.h"
+#include "pipeline.h"
+#include "ring.h"
+#include "telemetry.h"
+#include "user_source.h"
+
+// Maximum Overhead of Telemetry [%] of Frame Time
+#define MAX_OVERHEAD 1.0
+
+// User Pipeline (Same stages as User sample without HighGUI)
+class UserPipeline : public Pipeline<UserSource, UserFrame>
+{
+public:
+    // Constructor
+    explicit UserPipeline( std::unique_ptr<UserSource> source )
+        : Pipeline( std::move( source ), DEPTH_KERNEL_SIMD )
+    {
+    }
+
+private:
+    // Update Data
+    void update() override
+    {
+        readFrame();
+    }
+
+    // Draw Data
+    void draw() override
+    {
+        drawDepth();
+        visualizeUser( depth_mat, frame->user_map, colors.data(), static_cast<uint32_t>( colors.size() ), draw_mat, depth_kernel );
+    }
+
+    // Show Data
+    void show() override
+    {
+    }
+
+    // Write Data
+    void write( std::ostream& ) override
+    {
+    }
+};
+
+// Retrieve Nanoseconds per Iteration of Function
+template<typename Function>
+static double nanoseconds( const uint32_t iterations, Function function )
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for( uint32_t i = 0; i < iterations; i++ ){
+        function( i );
+    }
+    return std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count() / iterations;
+}
+
+// Telemetry Operations of One Frame in Pipeline Mode (Including clock reads and ring locks)
+static void frameOperations( Telemetry& telemetry, Ring<int>& ring, const uint32_t index )
+{
+    const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+    const std::chrono::steady_clock::time_point output = std::chrono::steady_clock::now();
+    telemetry.record( TELEMETRY_READ, output - time );
+    telemetry.recordFrame( 0, static_cast<int32_t>( index ), static_cast<uint64_t>( index ) * 33333, output );
+    const TelemetryHistogram stages[] = { TELEMETRY_UPDATE, TELEMETRY_DRAW, TELEMETRY_SHOW };
+    for( const TelemetryHistogram stage : stages ){
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        telemetry.record( stage, std::chrono::steady_clock::now() - begin );
+    }
+    telemetry.record( TELEMETRY_OUTPUT_LATENCY, std::chrono::steady_clock::now() - time );
+    telemetry.record( TELEMETRY_DISPLAY_AGE, std::chrono::steady_clock::now() - time );
+    for( uint32_t push = 0; push < 2; push++ ){
+        telemetry.recordQueue( TELEMETRY_FRAME_QUEUE, ring.size(), ring.drops() );
+        telemetry.recordQueue( TELEMETRY_IMAGE_QUEUE, ring.size(), ring.drops() );
+    }
+}
+
+// Run Pipeline and Retrieve Frame Time [us] (Wall clock / frames)
+static double frameTime( const std::string& uri, const uint32_t frames, Telemetry* telemetry )
+{
+    Benchmark benchmark( "Telemetry", uri, "pipeline" );
+    UserPipeline device( createUserSource( uri ) );
+    device.setTelemetry( telemetry );
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    device.benchmark( benchmark, frames, true, false );
+    return std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count() / frames;
+}
+
+// Telemetry Benchmark
+// bench_telemetry [source] [frames] [rounds]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const std::string uri = ( 1 < argc ) ? argv[1] : "synthetic:640x480@0:6";
+        const uint32_t frames = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 300;
+        const uint32_t rounds = ( 3 < argc ) ? static_cast<uint32_t>( std::stoul( argv[3] ) ) : 3;
+        if( !frames || !rounds ){
+            throw std::runtime_error( "failed number of frames and rounds must be greater than 0" );
+        }
+
+        // Cost of Recording
+        const uint32_t iterations = 1000000;
+        Telemetry telemetry;
+        const double record_ns = nanoseconds( iterations, [&telemetry]( const uint32_t i ){
+            telemetry.record( TELEMETRY_UPDATE, std::chrono::microseconds( i & 0xffff ) );
+        } );
+
+        std::atomic<bool> start( false );
+        std::vector<std::thread> threads;
+        std::vector<double> contended( 4 );
+        for( uint32_t t = 0; t < contended.size(); t++ ){
+            threads.emplace_back( [&, t]{
+                while( !start ){
+                    std::this_thread::yield();
+                }
+                contended[t] = nanoseconds( iterations / 4, [&telemetry]( const uint32_t i ){
+                    telemetry.record( TELEMETRY_DRAW, std::chrono::microseconds( i & 0xffff ) );
+                } );
+            } );
+        }
+        start = true;
+        for( std::thread& thread : threads ){
+            thread.join();
+        }
+        const double contended_ns = *std::max_element( contended.begin(), contended.end() );
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        const double frame_record_ns = nanoseconds( iterations, [&telemetry, &now]( const uint32_t i ){
+            telemetry.recordFrame( 1, static_cast<int32_t>( i + ( i % 100 == 0 ) ), static_cast<uint64_t>( i ) * 33333, now );
+        } );
+
+        TelemetrySnapshot snapshot;
+        const double snapshot_ns = nanoseconds( 1000, [&telemetry, &snapshot]( const uint32_t ){
+            telemetry.snapshot( snapshot );
+        } );
+
+        Ring<int> ring( RING_SIZE );
+        const double frame_ns = nanoseconds( iterations / 10, [&telemetry, &ring]( const uint32_t i ){
+            frameOperations( telemetry, ring, i );
+        } );
+
+        std::cout << "record_ns,contended_record_ns,record_frame_ns,snapshot_ns,frame_ns" << std::endl;
+        std::cout << record_ns << "," << contended_ns << "," << frame_record_ns << "," << snapshot_ns << "," << frame_ns << std::endl;
+
+        // Overhead of Pipeline (Alternating rounds)
+        double off = 0.0, on = 0.0;
+        for( uint32_t round = 0; round < rounds; round++ ){
+            const double time_off = frameTime( uri, frames, nullptr );
+            Telemetry pipeline_telemetry;
+            const double time_on = frameTime( uri, frames, &pipeline_telemetry );
+            off = round ? std::min( off, time_off ) : time_off;
+            on = round ? std::min( on, time_on ) : time_on;
+
+            // Dump Telemetry of Last Round
+            if( round + 1 == rounds ){
+                pipeline_telemetry.snapshot( snapshot );
+                writeTelemetryJSON( snapshot, std::cout );
+            }
+        }
+
+        const double overhead = frame_ns / 1000.0 / off * 100.0;
+        const double measured = ( on - off ) / off * 100.0;
+        std::cout << "source,frames,rounds,frame_us_off,frame_us_on,measured_overhead_percent,overhead_percent" << std::endl;
+        std::cout << uri << "," << frames << "," << rounds << "," << off << "," << on << "," << measured << "," << overhead << std::endl;
+
+        if( MAX_OVERHEAD < overhead ){
+            std::cerr << "failed telemetry overhead is above " << MAX_OVERHEAD << "% of frame time" << std::endl;
+            return 1;
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
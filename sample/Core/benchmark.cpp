@@ -0,0 +1,194 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+// Stage Names
+static const std::array<const char*, STAGE_COUNT> stage_names = { { "update", "draw", "show", "write", "latency" } };
+
+// Constructor
+Benchmark::Benchmark( const std::string& sample, const std::string& source, const std::string& mode )
+    : sample( sample ),
+      source( source ),
+      mode( mode )
+{
+}
+
+// Begin Measurement
+void Benchmark::begin( const uint32_t reserve )
+{
+    // Reserve Samples (Keep allocation out of measurement)
+    for( std::vector<double>& stage_samples : samples ){
+        stage_samples.clear();
+        stage_samples.reserve( reserve );
+    }
+
+    // Reserve Allocation Marks (Frame marks and the last mark)
+    allocations.clear();
+    if( allocation_counter ){
+        allocations.reserve( reserve + 1 );
+    }
+
+    frames = 0;
+    start = std::chrono::steady_clock::now();
+}
+
+// Finish Measurement
+void Benchmark::finish( const uint32_t frames )
+{
+    end = std::chrono::steady_clock::now();
+    this->frames = frames;
+}
+
+// Count Allocations
+void Benchmark::countAllocations( const AllocationCounter counter, const uint32_t warmup )
+{
+    allocation_counter = counter;
+    this->warmup = warmup;
+}
+
+// Mark Frame
+void Benchmark::markFrame()
+{
+    // Drop marks beyond reserved size (Recording never allocates)
+    if( !allocation_counter || allocations.size() == allocations.capacity() ){
+        return;
+    }
+
+    allocations.push_back( allocation_counter() );
+}
+
+// Check Steady-State Allocation
+bool Benchmark::allocates() const
+{
+    return allocation_counter && summarizeAllocations().max;
+}
+
+// Record Sample
+void Benchmark::record( const Stage stage, const std::chrono::steady_clock::duration& duration )
+{
+    samples[stage].push_back( std::chrono::duration<double, std::micro>( duration ).count() );
+}
+
+// Write Result as JSON
+void Benchmark::writeJSON( std::ostream& stream ) const
+{
+    stream << "{\n";
+    stream << "  \"sample\": \"" << sample << "\",\n";
+    stream << "  \"source\": \"" << source << "\",\n";
+    stream << "  \"mode\": \"" << mode << "\",\n";
+    stream << "  \"frames\": " << frames << ",\n";
+    stream << "  \"fps\": " << fps() << ",\n";
+    stream << "  \"unit\": \"us\",\n";
+    stream << "  \"stages\": {";
+
+    bool first = true;
+    for( uint32_t stage = 0; stage < STAGE_COUNT; stage++ ){
+        if( samples[stage].empty() ){
+            continue;
+        }
+
+        const Summary summary = summarize( static_cast<Stage>( stage ) );
+        stream << ( first ? "\n" : ",\n" );
+        stream << "    \"" << stage_names[stage] << "\": { ";
+        stream << "\"count\": " << summary.count << ", ";
+        stream << "\"mean\": " << summary.mean << ", ";
+        stream << "\"p50\": " << summary.p50 << ", ";
+        stream << "\"p95\": " << summary.p95 << ", ";
+        stream << "\"p99\": " << summary.p99 << ", ";
+        stream << "\"max\": " << summary.max << " }";
+        first = false;
+    }
+
+    stream << "\n  }";
+
+    // Allocations per Frame (Steady State)
+    if( allocation_counter ){
+        const AllocationSummary summary = summarizeAllocations();
+        stream << ",\n  \"allocations\": { ";
+        stream << "\"warmup\": " << warmup << ", ";
+        stream << "\"frames\": " << summary.frames << ", ";
+        stream << "\"mean\": " << summary.mean << ", ";
+        stream << "\"max\": " << summary.max << " }";
+    }
+
+    stream << "\n}" << std::endl;
+}
+
+// Write Result as CSV
+void Benchmark::writeCSV( std::ostream& stream, const bool header ) const
+{
+    if( header ){
+        stream << "sample,source,mode,frames,fps,stage,count,mean_us,p50_us,p95_us,p99_us,max_us,allocations_mean,allocations_max\n";
+    }
+
+    const AllocationSummary allocation_summary = summarizeAllocations();
+
+    for( uint32_t stage = 0; stage < STAGE_COUNT; stage++ ){
+        if( samples[stage].empty() ){
+            continue;
+        }
+
+        const Summary summary = summarize( static_cast<Stage>( stage ) );
+        stream << sample << "," << source << "," << mode << "," << frames << "," << fps() << ",";
+        stream << stage_names[stage] << "," << summary.count << "," << summary.mean << ",";
+        stream << summary.p50 << "," << summary.p95 << "," << summary.p99 << "," << summary.max << ",";
+
+        // Allocations per Frame (Steady State, empty if not counted)
+        if( allocation_counter ){
+            stream << allocation_summary.mean << "," << allocation_summary.max;
+        }
+        else{
+            stream << ",";
+        }
+        stream << "\n";
+    }
+
+    stream << std::flush;
+}
+
+// Summarize Stage
+Benchmark::Summary Benchmark::summarize( const Stage stage ) const
+{
+    std::vector<double> sorted = samples[stage];
+    std::sort( sorted.begin(), sorted.end() );
+
+    // Percentile (Nearest Rank)
+    const auto percentile = [&sorted]( const double rank ){
+        const size_t index = static_cast<size_t>( std::ceil( rank / 100.0 * sorted.size() ) );
+        return sorted[std::min( sorted.size(), std::max<size_t>( index, 1 ) ) - 1];
+    };
+
+    Summary summary;
+    summary.count = sorted.size();
+    summary.mean = std::accumulate( sorted.begin(), sorted.end(), 0.0 ) / sorted.size();
+    summary.p50 = percentile( 50.0 );
+    summary.p95 = percentile( 95.0 );
+    summary.p99 = percentile( 99.0 );
+    summary.max = sorted.back();
+    return summary;
+}
+
+// Summarize Allocations
+Benchmark::AllocationSummary Benchmark::summarizeAllocations() const
+{
+    AllocationSummary summary = { 0, 0.0, 0 };
+    uint64_t total = 0;
+    for( size_t i = warmup + 1; i < allocations.size(); i++ ){
+        const uint64_t count = allocations[i] - allocations[i - 1];
+        summary.max = std::max( summary.max, count );
+        summary.frames++;
+        total += count;
+    }
+
+    summary.mean = summary.frames ? static_cast<double>( total ) / summary.frames : 0.0;
+    return summary;
+}
+
+// Retrieve Frames per Second
+double Benchmark::fps() const
+{
+    const double seconds = std::chrono::duration<double>( end - start ).count();
+    return ( 0.0 < seconds ) ? frames / seconds : 0.0;
+}
@@ -0,0 +1,117 @@
+#ifndef __BENCHMARK__
+#define __BENCHMARK__
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Benchmark Stage
+enum Stage
+{
+    STAGE_UPDATE,  // update() (readFrame and tracker control)
+    STAGE_DRAW,    // updateDepth() and draw()
+    STAGE_SHOW,    // show() and cv::waitKey()
+    STAGE_WRITE,   // write() and Sink::write() (headless mode)
+    STAGE_LATENCY, // capture to display (pipeline mode)
+    STAGE_COUNT
+};
+
+// Allocation Counter (Number of heap allocations since start, e.g. allocationCount() of allocation.h)
+typedef uint64_t ( *AllocationCounter )();
+
+// Number of Warm-Up Frames (Allocations of these frames are not steady state)
+#define BENCHMARK_WARMUP_FRAMES 10
+
+// Benchmark Result Recorder
+class Benchmark
+{
+private:
+    // Information
+    std::string sample;
+    std::string source;
+    std::string mode;
+
+    // Samples [us]
+    std::array<std::vector<double>, STAGE_COUNT> samples;
+
+    // Elapsed Time
+    uint32_t frames = 0;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+
+    // Allocation Counter at each Frame Mark
+    AllocationCounter allocation_counter = nullptr;
+    uint32_t warmup = BENCHMARK_WARMUP_FRAMES;
+    std::vector<uint64_t> allocations;
+
+public:
+    // Constructor
+    Benchmark( const std::string& sample, const std::string& source, const std::string& mode );
+
+    // Begin Measurement
+    void begin( const uint32_t reserve );
+
+    // Finish Measurement
+    void finish( const uint32_t frames );
+
+    // Count Allocations between Frame Marks (Except first warmup frames)
+    void countAllocations( const AllocationCounter counter, const uint32_t warmup = BENCHMARK_WARMUP_FRAMES );
+
+    // Mark Frame (No allocation)
+    void markFrame();
+
+    // Check Steady-State Allocation (true if any frame after warm-up allocated)
+    bool allocates() const;
+
+    // Record Sample
+    void record( const Stage stage, const std::chrono::steady_clock::duration& duration );
+
+    // Measure Function
+    template<typename Function>
+    void measure( const Stage stage, Function function )
+    {
+        const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+        function();
+        record( stage, std::chrono::steady_clock::now() - time );
+    }
+
+    // Write Result as JSON
+    void writeJSON( std::ostream& stream ) const;
+
+    // Write Result as CSV (Without header row for appending results)
+    void writeCSV( std::ostream& stream, const bool header = true ) const;
+
+private:
+    // Summary of Stage
+    struct Summary
+    {
+        size_t count;
+        double mean;
+        double p50;
+        double p95;
+        double p99;
+        double max;
+    };
+
+    // Summarize Stage
+    Summary summarize( const Stage stage ) const;
+
+    // Summary of Allocations (Steady State)
+    struct AllocationSummary
+    {
+        size_t frames;
+        double mean;
+        uint64_t max;
+    };
+
+    // Summarize Allocations
+    AllocationSummary summarizeAllocations() const;
+
+    // Retrieve Frames per Second
+    double fps() const;
+};
+
+#endif // __BENCHMARK__
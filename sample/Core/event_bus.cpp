@@ -0,0 +1,485 @@
+#include "event_bus.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+// Event Type Names
+static const std::array<const char*, EVENT_TYPE_COUNT> event_names = { {
+    "user_new", "user_lost", "skeleton_tracked", "pose_entered", "pose_held", "pose_exited",
+    "gesture_progress", "gesture_complete", "gesture_match", "hand_new", "hand_lost"
+} };
+
+// NiTE Pose and Gesture Names
+static const std::array<const char*, POSE_COUNT> pose_names = { { "psi", "crossed_hands" } };
+static const std::array<const char*, EVENT_GESTURE_TYPE_COUNT> gesture_names = { { "wave", "click", "hand_raise" } };
+
+// Retrieve Name of Event Type
+const char* eventTypeName( const EventType type )
+{
+    return event_names[type];
+}
+
+// Retrieve Steady Clock [ns]
+static inline int64_t steadyNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+// Write Name of Custom Pose or Template (Index if names are not given)
+static inline void writeName( const int32_t index, std::ostream& stream, const std::vector<std::string>& names )
+{
+    if( 0 <= index && static_cast<size_t>( index ) < names.size() ){
+        writeJSONString( stream, names[index] );
+    }
+    else{
+        stream << "\"custom_" << index << "\"";
+    }
+}
+
+// Write Event as JSON Object
+void writeEventJSON( const Event& event, std::ostream& stream, const std::vector<std::string>& names )
+{
+    stream << "{\"event\":\"" << event_names[event.type] << "\",\"timestamp\":" << event.timestamp << ",\"sensor\":" << event.sensor << ",\"id\":" << event.id;
+
+    switch( event.type ){
+        case EVENT_POSE_ENTERED:
+        case EVENT_POSE_HELD:
+        case EVENT_POSE_EXITED:
+            stream << ",\"pose\":";
+            if( 0 <= event.kind && event.kind < POSE_COUNT ){
+                stream << "\"" << pose_names[event.kind] << "\"";
+            }
+            else{
+                writeName( event.kind - POSE_COUNT, stream, names );
+            }
+            break;
+        case EVENT_GESTURE_PROGRESS:
+        case EVENT_GESTURE_COMPLETE:
+            stream << ",\"gesture\":\"" << ( ( 0 <= event.kind && event.kind < EVENT_GESTURE_TYPE_COUNT ) ? gesture_names[event.kind] : "unknown" ) << "\"";
+            break;
+        case EVENT_GESTURE_MATCH:
+            stream << ",\"gesture\":";
+            writeName( event.kind, stream, names );
+            stream << ",\"distance\":" << event.value;
+            break;
+        default:
+            break;
+    }
+
+    stream << ",\"position\":[" << event.x << "," << event.y << "," << event.z << "]}";
+}
+
+// Constructor of Subscriber
+EventBus::Subscriber::Subscriber( const uint32_t mask, EventCallback callback, const size_t batch, const size_t capacity )
+    : mask( mask ),
+      batch( batch ),
+      callback( std::move( callback ) ),
+      queue( capacity ),
+      events( batch ),
+      active( true ),
+      waiting( false ),
+      delivered( 0 ),
+      batches( 0 ),
+      max_batch( 0 )
+{
+}
+
+// Constructor
+EventBus::EventBus()
+    : running( false )
+{
+}
+
+// Destructor
+EventBus::~EventBus()
+{
+    stop();
+}
+
+// Subscribe Event Types of Mask
+uint32_t EventBus::subscribe( const uint32_t mask, EventCallback callback, const size_t batch, const size_t capacity )
+{
+    if( started ){
+        throw std::runtime_error( "failed subscribe after start of event bus" );
+    }
+    if( !mask || !callback || !batch ){
+        throw std::runtime_error( "failed invalid mask, callback or batch of subscriber" );
+    }
+
+    subscribers.emplace_back( new Subscriber( mask, std::move( callback ), batch, capacity ) );
+    return static_cast<uint32_t>( subscribers.size() - 1 );
+}
+
+// Start Threads of Subscribers
+void EventBus::start()
+{
+    if( started ){
+        throw std::runtime_error( "failed event bus is already started" );
+    }
+
+    started = true;
+    running = true;
+    for( std::unique_ptr<Subscriber>& subscriber : subscribers ){
+        subscriber->thread = std::thread( &EventBus::dispatch, this, std::ref( *subscriber ) );
+    }
+}
+
+// Stop Threads of Subscribers
+void EventBus::stop()
+{
+    if( !running ){
+        return;
+    }
+
+    running = false;
+    for( std::unique_ptr<Subscriber>& subscriber : subscribers ){
+        {
+            std::lock_guard<std::mutex> lock( subscriber->mutex );
+            subscriber->waiting.store( false, std::memory_order_relaxed );
+        }
+        subscriber->condition.notify_one();
+    }
+    for( std::unique_ptr<Subscriber>& subscriber : subscribers ){
+        if( subscriber->thread.joinable() ){
+            subscriber->thread.join();
+        }
+    }
+}
+
+// Unsubscribe
+void EventBus::unsubscribe( const uint32_t subscriber )
+{
+    if( subscribers.size() <= subscriber ){
+        throw std::runtime_error( "failed invalid index of subscriber" );
+    }
+
+    // Wake Thread to Drain Queue and Exit
+    Subscriber& target = *subscribers[subscriber];
+    target.active.store( false, std::memory_order_release );
+    {
+        std::lock_guard<std::mutex> lock( target.mutex );
+        target.waiting.store( false, std::memory_order_relaxed );
+    }
+    target.condition.notify_one();
+    if( target.thread.joinable() ){
+        target.thread.join();
+    }
+}
+
+// Emit Event
+void EventBus::emit( const Event& event )
+{
+    const int64_t emitted = steadyNanoseconds();
+    const uint32_t bit = EVENT_MASK( event.type );
+    for( std::unique_ptr<Subscriber>& subscriber : subscribers ){
+        if( !( subscriber->mask & bit ) || !subscriber->active.load( std::memory_order_relaxed ) ){
+            continue;
+        }
+
+        // Push Copy (Drop if full, the tracker never waits for a subscriber)
+        if( !subscriber->queue.emplace( [&event, emitted]( Event& cell ){ cell = event; cell.emitted = emitted; } ) ){
+            continue;
+        }
+
+        // Wake Subscriber if Waiting (Fence orders push before load of flag)
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if( subscriber->waiting.load( std::memory_order_relaxed ) ){
+            {
+                std::lock_guard<std::mutex> lock( subscriber->mutex );
+                subscriber->waiting.store( false, std::memory_order_relaxed );
+            }
+            subscriber->condition.notify_one();
+        }
+    }
+}
+
+// Retrieve Number of Subscribers
+uint32_t EventBus::subscriberCount() const
+{
+    return static_cast<uint32_t>( subscribers.size() );
+}
+
+// Retrieve Statistics of Subscriber
+EventStatistics EventBus::getStatistics( const uint32_t subscriber, const bool reset )
+{
+    if( subscribers.size() <= subscriber ){
+        throw std::runtime_error( "failed invalid index of subscriber" );
+    }
+
+    Subscriber& target = *subscribers[subscriber];
+    EventStatistics statistics;
+    statistics.delivered = target.delivered.load( std::memory_order_relaxed );
+    statistics.batches = target.batches.load( std::memory_order_relaxed );
+    statistics.max_batch = target.max_batch.load( std::memory_order_relaxed );
+    statistics.dropped = target.queue.drops();
+    statistics.latency = target.latency.summarize( reset );
+    return statistics;
+}
+
+// Subscriber Thread
+void EventBus::dispatch( Subscriber& subscriber )
+{
+    Event* events = subscriber.events.data();
+    while( true ){
+        // Drain up to Batch
+        size_t count = 0;
+        while( count < subscriber.batch && subscriber.queue.pop( events[count] ) ){
+            count++;
+        }
+
+        if( count ){
+            // Record Dispatch Latency (One clock read per batch)
+            const int64_t now = steadyNanoseconds();
+            for( size_t index = 0; index < count; index++ ){
+                const int64_t latency = now - events[index].emitted;
+                subscriber.latency.record( static_cast<uint64_t>( 0 < latency ? latency / 1000 : 0 ) );
+            }
+            subscriber.delivered.fetch_add( count, std::memory_order_relaxed );
+            subscriber.batches.fetch_add( 1, std::memory_order_relaxed );
+            if( subscriber.max_batch.load( std::memory_order_relaxed ) < count ){
+                subscriber.max_batch.store( count, std::memory_order_relaxed );
+            }
+
+            // Deliver Batch (A failing subscriber doesn't stop the bus)
+            try{
+                subscriber.callback( events, count );
+            } catch( ... ){
+            }
+            continue;
+        }
+
+        // Exit after Queue is Drained (Bus is stopped or subscriber is unsubscribed)
+        if( !running.load( std::memory_order_acquire ) || !subscriber.active.load( std::memory_order_acquire ) ){
+            if( !subscriber.queue.size() ){
+                break;
+            }
+            continue;
+        }
+
+        // Announce Waiting, then Check Queue again (Fence orders store of flag before check)
+        subscriber.waiting.store( true, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        if( subscriber.queue.size() || !running.load( std::memory_order_acquire ) || !subscriber.active.load( std::memory_order_acquire ) ){
+            subscriber.waiting.store( false, std::memory_order_relaxed );
+            continue;
+        }
+
+        // Wait for Emit (Flag is cleared under mutex by emit() or stop())
+        std::unique_lock<std::mutex> lock( subscriber.mutex );
+        subscriber.condition.wait_for( lock, std::chrono::milliseconds( EVENT_WAIT ), [&subscriber]{ return !subscriber.waiting.load( std::memory_order_relaxed ); } );
+        subscriber.waiting.store( false, std::memory_order_relaxed );
+    }
+}
+
+// Constructor
+EventEmitter::EventEmitter( EventBus& bus )
+    : bus( bus ),
+      held( EVENT_USER_SLOTS * POSE_COUNT, 0 )
+{
+    progress.fill( false );
+}
+
+// Emit Events of User Frame
+void EventEmitter::emit( const UserFrame& frame )
+{
+    // Resize Held Poses when Number of Custom Poses Changes (Once)
+    const uint32_t custom = static_cast<uint32_t>( frame.pose_status.size() / USER_COUNT );
+    if( poses != POSE_COUNT + custom ){
+        poses = POSE_COUNT + custom;
+        held.assign( static_cast<size_t>( EVENT_USER_SLOTS ) * poses, 0 );
+    }
+
+    // Users and NiTE Poses
+    for( const User& user : frame.users ){
+        UserSlot* target = slot( frame.sensor, user.id );
+        if( !target ){
+            continue;
+        }
+
+        if( user.is_new ){
+            emitEvent( EVENT_USER_NEW, frame.sensor, frame.sensor_timestamp, user.id, -1, user.center_of_mass );
+        }
+
+        const bool tracked = ( user.skeleton_state == nite::SkeletonState::SKELETON_TRACKED );
+        if( tracked && !target->tracked ){
+            emitEvent( EVENT_SKELETON_TRACKED, frame.sensor, frame.sensor_timestamp, user.id, -1, user.center_of_mass );
+        }
+        target->tracked = tracked;
+
+        const uint32_t index = static_cast<uint32_t>( target - slots.data() );
+        for( uint32_t pose = 0; pose < POSE_COUNT; pose++ ){
+            const Pose& state = user.poses[pose];
+            emitPose( frame, user, index, pose, state.is_entered, state.is_held, state.is_exited );
+        }
+    }
+
+    // Custom Poses of Users in Skeleton Snapshot
+    for( uint32_t number = 0; custom && number < frame.skeleton.count; number++ ){
+        const uint32_t user_index = frame.skeleton.users[number];
+        if( frame.users.size() <= user_index ){
+            continue;
+        }
+        const User& user = frame.users[user_index];
+        UserSlot* target = slot( frame.sensor, user.id );
+        if( !target ){
+            continue;
+        }
+
+        const uint32_t index = static_cast<uint32_t>( target - slots.data() );
+        for( uint32_t pose = 0; pose < custom; pose++ ){
+            const uint8_t status = frame.pose_status[static_cast<size_t>( number ) * custom + pose];
+            emitPose( frame, user, index, POSE_COUNT + pose, ( status & POSE_ENTERED ) != 0, ( status & POSE_HELD ) != 0, ( status & POSE_EXITED ) != 0 );
+        }
+    }
+
+    // Lost Users (Release slot)
+    for( const User& user : frame.users ){
+        if( !user.is_lost ){
+            continue;
+        }
+
+        emitEvent( EVENT_USER_LOST, frame.sensor, frame.sensor_timestamp, user.id, -1, user.center_of_mass );
+        for( UserSlot& target : slots ){
+            if( target.active && target.sensor == frame.sensor && target.id == user.id ){
+                const size_t begin = static_cast<size_t>( &target - slots.data() ) * poses;
+                std::fill( held.begin() + begin, held.begin() + begin + poses, 0 );
+                target = UserSlot();
+            }
+        }
+    }
+}
+
+// Emit Events of Hand Frame
+void EventEmitter::emit( const HandFrame& frame )
+{
+    // NiTE Gestures (Progress once until it stops, complete every time)
+    std::array<bool, EVENT_GESTURE_TYPE_COUNT> current;
+    current.fill( false );
+    for( const Gesture& gesture : frame.gestures ){
+        const int32_t type = static_cast<int32_t>( gesture.type );
+        if( type < 0 || EVENT_GESTURE_TYPE_COUNT <= type ){
+            continue;
+        }
+
+        if( gesture.is_in_progress ){
+            if( !progress[type] && !current[type] ){
+                emitEvent( EVENT_GESTURE_PROGRESS, frame.sensor, frame.sensor_timestamp, 0, type, gesture.current_position );
+            }
+            current[type] = true;
+        }
+        if( gesture.is_complete ){
+            emitEvent( EVENT_GESTURE_COMPLETE, frame.sensor, frame.sensor_timestamp, 0, type, gesture.current_position );
+        }
+    }
+    progress = current;
+
+    // Custom Gesture Matches
+    for( const GestureMatch& match : frame.matches ){
+        emitEvent( EVENT_GESTURE_MATCH, frame.sensor, frame.sensor_timestamp, match.id, static_cast<int32_t>( match.gesture ), match.position, match.distance );
+    }
+
+    // Hands
+    for( const Hand& hand : frame.hands ){
+        if( hand.is_new ){
+            emitEvent( EVENT_HAND_NEW, frame.sensor, frame.sensor_timestamp, hand.id, -1, hand.position );
+        }
+        if( hand.is_lost ){
+            emitEvent( EVENT_HAND_LOST, frame.sensor, frame.sensor_timestamp, hand.id, -1, hand.position );
+        }
+    }
+}
+
+// Clear State
+void EventEmitter::reset()
+{
+    slots.fill( UserSlot() );
+    std::fill( held.begin(), held.end(), 0 );
+    progress.fill( false );
+}
+
+// Find Slot of User
+EventEmitter::UserSlot* EventEmitter::slot( const uint32_t sensor, const nite::UserId id )
+{
+    UserSlot* free = nullptr;
+    for( UserSlot& target : slots ){
+        if( target.active && target.sensor == sensor && target.id == id ){
+            return &target;
+        }
+        if( !target.active && !free ){
+            free = &target;
+        }
+    }
+
+    if( free ){
+        free->active = true;
+        free->sensor = sensor;
+        free->id = id;
+        free->tracked = false;
+    }
+    return free;
+}
+
+// Emit Pose Transition
+void EventEmitter::emitPose( const UserFrame& frame, const User& user, const uint32_t slot, const uint32_t pose, const bool entered, const bool is_held, const bool exited )
+{
+    uint8_t& previous = held[static_cast<size_t>( slot ) * poses + pose];
+    if( entered ){
+        emitEvent( EVENT_POSE_ENTERED, frame.sensor, frame.sensor_timestamp, user.id, static_cast<int32_t>( pose ), user.center_of_mass );
+    }
+    if( is_held && !previous ){
+        emitEvent( EVENT_POSE_HELD, frame.sensor, frame.sensor_timestamp, user.id, static_cast<int32_t>( pose ), user.center_of_mass );
+    }
+    previous = is_held ? 1 : 0;
+    if( exited ){
+        emitEvent( EVENT_POSE_EXITED, frame.sensor, frame.sensor_timestamp, user.id, static_cast<int32_t>( pose ), user.center_of_mass );
+        previous = 0;
+    }
+}
+
+// Emit Event of Frame
+inline void EventEmitter::emitEvent( const EventType type, const uint32_t sensor, const uint64_t timestamp, const int32_t id, const int32_t kind, const nite::Point3f& position, const float value )
+{
+    Event event;
+    event.timestamp = timestamp;
+    event.type = type;
+    event.sensor = sensor;
+    event.id = id;
+    event.kind = kind;
+    event.x = position.x;
+    event.y = position.y;
+    event.z = position.z;
+    event.value = value;
+    bus.emit( event );
+}
+
+// Constructor
+EventWriter::EventWriter( EventBus& bus, Sink& sink, const uint32_t mask, const std::vector<std::string>& names )
+    : bus( bus ),
+      sink( sink ),
+      names( names )
+{
+    subscriber = bus.subscribe( mask, [this]( const Event* events, const size_t count ){ write( events, count ); } );
+}
+
+// Destructor
+EventWriter::~EventWriter()
+{
+    bus.unsubscribe( subscriber );
+}
+
+// Write Batch
+void EventWriter::write( const Event* events, const size_t count )
+{
+    record.reset();
+    for( size_t index = 0; index < count; index++ ){
+        writeEventJSON( events[index], record, names );
+        record << "\n";
+    }
+
+    try{
+        sink.write( record.str() );
+    } catch( ... ){
+        // Ignore (Events don't stop the tracker loop)
+    }
+}
@@ -0,0 +1,234 @@
+#ifndef __EVENT_BUS__
+#define __EVENT_BUS__
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hand_source.h"
+#include "mpmc_queue.h"
+#include "pose_engine.h"
+#include "sink.h"
+#include "telemetry.h"
+#include "user_source.h"
+
+// Default Capacity of Queue of Subscriber [events]
+#define EVENT_QUEUE_SIZE 4096
+
+// Default Maximum Batch of Subscriber [events]
+#define EVENT_BATCH_SIZE 64
+
+// Wait Timeout of Subscriber [ms]
+#define EVENT_WAIT 10
+
+// User Slots of Event Emitter (Users of up to 4 sensors)
+#define EVENT_USER_SLOTS ( 4 * USER_COUNT )
+
+// NiTE Gesture Types (Wave, Click and Hand Raise)
+#define EVENT_GESTURE_TYPE_COUNT 3
+
+// Event Type
+enum EventType
+{
+    EVENT_USER_NEW,         // User appeared (is_new)
+    EVENT_USER_LOST,        // User lost (is_lost)
+    EVENT_SKELETON_TRACKED, // Skeleton state of user became tracked
+    EVENT_POSE_ENTERED,     // Pose entered (NiTE or custom pose)
+    EVENT_POSE_HELD,        // Pose held (first frame after entered)
+    EVENT_POSE_EXITED,      // Pose exited
+    EVENT_GESTURE_PROGRESS, // NiTE gesture started progress
+    EVENT_GESTURE_COMPLETE, // NiTE gesture completed
+    EVENT_GESTURE_MATCH,    // Custom gesture matched (Gesture engine)
+    EVENT_HAND_NEW,         // Hand tracking started (is_new)
+    EVENT_HAND_LOST,        // Hand lost (is_lost)
+    EVENT_TYPE_COUNT
+};
+
+// Event Mask (Bit of each type)
+#define EVENT_MASK( type ) ( 1u << ( type ) )
+#define EVENT_MASK_ALL ( ( 1u << EVENT_TYPE_COUNT ) - 1 )
+
+// Retrieve Name of Event Type
+const char* eventTypeName( const EventType type );
+
+// Event (Compact, copied by value through queues)
+struct Event
+{
+    uint64_t timestamp = 0; // Sensor Timestamp of Frame [us]
+    int64_t emitted = 0;    // Emit Time [ns] (Steady clock, stamped by EventBus::emit())
+    EventType type = EVENT_USER_NEW;
+    uint32_t sensor = 0;    // Sensor Index
+    int32_t id = 0;         // User Id or Hand Id (0 for NiTE gestures)
+    int32_t kind = -1;      // Pose: nite::PoseType or POSE_COUNT + custom pose, Gesture: nite::GestureType, Match: template (-1: none)
+    float x = 0.0f;         // Position [mm] (Center of mass of user, position of gesture or hand)
+    float y = 0.0f;
+    float z = 0.0f;
+    float value = 0.0f;     // DTW distance of match
+};
+
+// Write Event as JSON Object (Name of custom pose or template from names if given)
+void writeEventJSON( const Event& event, std::ostream& stream, const std::vector<std::string>& names = std::vector<std::string>() );
+
+// Event Callback (Batch of events in order of each producer, called on thread of subscriber)
+typedef std::function<void( const Event* events, const size_t count )> EventCallback;
+
+// Statistics of Subscriber
+struct EventStatistics
+{
+    uint64_t delivered = 0; // Events passed to callback
+    uint64_t batches = 0;   // Callback calls
+    uint64_t max_batch = 0; // Largest batch
+    uint64_t dropped = 0;   // Events dropped at emit (Queue was full)
+    HistogramSummary latency; // Dispatch latency [us] (Emit to callback)
+};
+
+// Event Bus (Lock-free queue per subscriber, full queue drops, callbacks in batches on thread of subscriber)
+// emit() locks only to wake a waiting subscriber, the waiting flag is fenced on both sides so that no wake-up is missed.
+class EventBus
+{
+private:
+    // Subscriber
+    struct Subscriber
+    {
+        uint32_t mask;
+        size_t batch;
+        EventCallback callback;
+        MpmcQueue<Event> queue;
+        std::vector<Event> events; // Batch Buffer
+        std::thread thread;
+        std::atomic<bool> active;  // Cleared by unsubscribe()
+
+        // Wake-Up
+        std::atomic<bool> waiting;
+        std::mutex mutex;
+        std::condition_variable condition;
+
+        // Statistics
+        std::atomic<uint64_t> delivered;
+        std::atomic<uint64_t> batches;
+        std::atomic<uint64_t> max_batch;
+        LatencyHistogram latency;
+
+        Subscriber( const uint32_t mask, EventCallback callback, const size_t batch, const size_t capacity );
+    };
+    std::vector<std::unique_ptr<Subscriber>> subscribers;
+
+    // Status
+    std::atomic<bool> running;
+    bool started = false;
+
+public:
+    // Constructor
+    EventBus();
+
+    // Destructor (Stop)
+    ~EventBus();
+
+    EventBus( const EventBus& ) = delete;
+    EventBus& operator=( const EventBus& ) = delete;
+
+    // Subscribe Event Types of Mask (Before start(), Retrieve Index of Subscriber)
+    uint32_t subscribe( const uint32_t mask, EventCallback callback, const size_t batch = EVENT_BATCH_SIZE, const size_t capacity = EVENT_QUEUE_SIZE );
+
+    // Start Threads of Subscribers
+    void start();
+
+    // Stop Threads of Subscribers (Queued events are delivered)
+    void stop();
+
+    // Unsubscribe (Thread of start() and stop(), queued events are delivered, callback is never called after return, other subscribers keep running)
+    void unsubscribe( const uint32_t subscriber );
+
+    // Emit Event (Any thread, lock-free unless a subscriber is waiting)
+    void emit( const Event& event );
+
+    // Retrieve Number of Subscribers
+    uint32_t subscriberCount() const;
+
+    // Retrieve Statistics of Subscriber (Latency since previous call if reset is true)
+    EventStatistics getStatistics( const uint32_t subscriber, const bool reset = false );
+
+private:
+    // Subscriber Thread
+    void dispatch( Subscriber& subscriber );
+};
+
+// Event Emitter (Diff frames into events on capture thread)
+class EventEmitter
+{
+private:
+    // User Slot (Previous state of user)
+    struct UserSlot
+    {
+        bool active = false;
+        uint32_t sensor = 0;
+        nite::UserId id = 0;
+        bool tracked = false;
+    };
+
+    EventBus& bus;
+    std::array<UserSlot, EVENT_USER_SLOTS> slots;
+    std::vector<uint8_t> held; // Held Poses of Slots (slot * poses + pose, NiTE poses then custom poses)
+    uint32_t poses = POSE_COUNT;
+
+    // NiTE Gestures in Progress at Previous Frame
+    std::array<bool, EVENT_GESTURE_TYPE_COUNT> progress;
+
+public:
+    // Constructor
+    explicit EventEmitter( EventBus& bus );
+
+    // Emit Events of User Frame (Users, NiTE poses and custom pose status)
+    void emit( const UserFrame& frame );
+
+    // Emit Events of Hand Frame (NiTE gestures, matches and hands)
+    void emit( const HandFrame& frame );
+
+    // Clear State
+    void reset();
+
+private:
+    // Find Slot of User (Assign free slot if not found, nullptr if no slot is free)
+    UserSlot* slot( const uint32_t sensor, const nite::UserId id );
+
+    // Emit Pose Transition (Held is emitted once per hold)
+    void emitPose( const UserFrame& frame, const User& user, const uint32_t slot, const uint32_t pose, const bool entered, const bool is_held, const bool exited );
+
+    // Emit Event of Frame
+    inline void emitEvent( const EventType type, const uint32_t sensor, const uint64_t timestamp, const int32_t id, const int32_t kind, const nite::Point3f& position, const float value = 0.0f );
+};
+
+// Event Writer (Subscriber that writes events as JSON lines to sink, one write per batch)
+class EventWriter
+{
+private:
+    EventBus& bus;
+    Sink& sink;
+    std::vector<std::string> names;
+    RecordStream record;
+    uint32_t subscriber; // Index of Subscriber
+
+public:
+    // Constructor (Subscribe types of mask, names of custom poses or templates)
+    EventWriter( EventBus& bus, Sink& sink, const uint32_t mask = EVENT_MASK_ALL, const std::vector<std::string>& names = std::vector<std::string>() );
+
+    // Destructor (Unsubscribe, so that no batch is written after destruction, bus keeps running)
+    ~EventWriter();
+
+    EventWriter( const EventWriter& ) = delete;
+    EventWriter& operator=( const EventWriter& ) = delete;
+
+private:
+    // Write Batch
+    void write( const Event* events, const size_t count );
+};
+
+#endif // __EVENT_BUS__
@@ -0,0 +1,244 @@
+#ifndef __FRAME_POOL__
+#define __FRAME_POOL__
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+template<typename Type>
+class FramePool;
+
+// Pooled Object with Reference Count
+template<typename Type>
+struct FrameSlot
+{
+    Type object;
+    std::atomic<uint32_t> references;
+    FramePool<Type>* pool;
+};
+
+// Reference Counted Handle of Pooled Object (Returns to pool when the last handle is released)
+template<typename Type>
+class FrameHandle
+{
+    friend class FramePool<Type>;
+
+private:
+    // Slot
+    FrameSlot<Type>* slot = nullptr;
+
+    // Constructor (Take Acquired Slot)
+    explicit FrameHandle( FrameSlot<Type>* slot )
+        : slot( slot )
+    {
+    }
+
+public:
+    // Constructor
+    FrameHandle() = default;
+
+    // Copy Constructor (Share Object)
+    FrameHandle( const FrameHandle& other )
+        : slot( other.slot )
+    {
+        if( slot ){
+            slot->references.fetch_add( 1, std::memory_order_relaxed );
+        }
+    }
+
+    // Move Constructor
+    FrameHandle( FrameHandle&& other ) noexcept
+        : slot( other.slot )
+    {
+        other.slot = nullptr;
+    }
+
+    // Destructor
+    ~FrameHandle()
+    {
+        reset();
+    }
+
+    // Assignment (Copy and Move)
+    FrameHandle& operator=( FrameHandle other ) noexcept
+    {
+        std::swap( slot, other.slot );
+        return *this;
+    }
+
+    // Release Reference (Return object to pool if this is the last handle)
+    void reset()
+    {
+        if( slot && slot->references.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ){
+            slot->pool->recycle( slot );
+        }
+        slot = nullptr;
+    }
+
+    // Access Object
+    Type& operator*() const
+    {
+        return slot->object;
+    }
+
+    Type* operator->() const
+    {
+        return &slot->object;
+    }
+
+    // Check Handle
+    explicit operator bool() const
+    {
+        return slot != nullptr;
+    }
+
+    // Retrieve Number of Handles sharing Object
+    uint32_t references() const
+    {
+        return slot ? slot->references.load( std::memory_order_relaxed ) : 0;
+    }
+};
+
+// Object Pool of Reference Counted Handles (Grows if all objects are in use)
+template<typename Type>
+class FramePool
+{
+    friend class FrameHandle<Type>;
+
+private:
+    // Objects
+    std::vector<std::unique_ptr<FrameSlot<Type>>> slots;
+    std::vector<FrameSlot<Type>*> free_slots;
+    mutable std::mutex mutex;
+
+    // Recycler (Release external references, keep buffers for reuse)
+    std::function<void( Type& )> recycler;
+
+public:
+    // Constructor
+    explicit FramePool( const uint32_t capacity, std::function<void( Type& )> recycler = nullptr )
+        : recycler( std::move( recycler ) )
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        for( uint32_t i = 0; i < capacity; i++ ){
+            free_slots.push_back( addSlot() );
+        }
+    }
+
+    FramePool( const FramePool& ) = delete;
+    FramePool& operator=( const FramePool& ) = delete;
+
+    // Acquire Object
+    FrameHandle<Type> acquire()
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        FrameSlot<Type>* slot;
+        if( free_slots.empty() ){
+            slot = addSlot();
+        }
+        else{
+            slot = free_slots.back();
+            free_slots.pop_back();
+        }
+        slot->references.store( 1, std::memory_order_relaxed );
+        return FrameHandle<Type>( slot );
+    }
+
+    // Prepare All Objects (Before objects are in use)
+    void prepare( const std::function<void( Type& )>& function )
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        for( std::unique_ptr<FrameSlot<Type>>& slot : slots ){
+            function( slot->object );
+        }
+    }
+
+    // Retrieve Number of Objects
+    size_t capacity() const
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        return slots.size();
+    }
+
+    // Retrieve Number of Objects not in Use
+    size_t available() const
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        return free_slots.size();
+    }
+
+private:
+    // Add Object (Locked)
+    FrameSlot<Type>* addSlot()
+    {
+        slots.emplace_back( new FrameSlot<Type>() );
+        FrameSlot<Type>* slot = slots.back().get();
+        slot->references.store( 0, std::memory_order_relaxed );
+        slot->pool = this;
+
+        // Keep room for all objects in free list (recycle() never allocates)
+        free_slots.reserve( slots.size() );
+        return slot;
+    }
+
+    // Recycle Object
+    void recycle( FrameSlot<Type>* slot )
+    {
+        if( recycler ){
+            recycler( slot->object );
+        }
+
+        std::lock_guard<std::mutex> lock( mutex );
+        free_slots.push_back( slot );
+    }
+};
+
+// Handle of Pooled Image Buffer
+typedef FrameHandle<cv::Mat> ImageHandle;
+
+// Image Buffer Pool (Drawn image or synthetic depth, reallocated only if size or type differs)
+class ImagePool
+{
+private:
+    // Buffers
+    FramePool<cv::Mat> pool;
+
+public:
+    // Constructor
+    explicit ImagePool( const uint32_t capacity )
+        : pool( capacity )
+    {
+    }
+
+    // Acquire Buffer
+    ImageHandle acquire( const int32_t rows, const int32_t cols, const int32_t type )
+    {
+        ImageHandle buffer = pool.acquire();
+        buffer->create( rows, cols, type );
+        return buffer;
+    }
+
+    // Reserve Buffers (All buffers not in use, and grow to count)
+    void reserve( const int32_t rows, const int32_t cols, const int32_t type, const size_t count = 0 )
+    {
+        std::vector<ImageHandle> buffers( std::max( pool.available(), count ) );
+        for( ImageHandle& buffer : buffers ){
+            buffer = acquire( rows, cols, type );
+        }
+    }
+
+    // Retrieve Number of Buffers
+    size_t capacity() const
+    {
+        return pool.capacity();
+    }
+};
+
+#endif // __FRAME_POOL__
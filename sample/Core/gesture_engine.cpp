@@ -0,0 +1,586 @@
+#include "gesture_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+// Infinity of Distances
+#define GESTURE_INFINITY std::numeric_limits<float>::infinity()
+
+// Load Gesture Templates from File
+std::vector<GestureTemplate> loadGestureTemplates( const std::string& path )
+{
+    std::ifstream stream( path );
+    if( !stream.is_open() ){
+        throw std::runtime_error( "failed can not open " + path );
+    }
+
+    std::vector<GestureTemplate> templates;
+    std::string line;
+    uint32_t number = 0;
+    while( std::getline( stream, line ) ){
+        number++;
+
+        // Skip Comment and Empty Line
+        const size_t comment = line.find( '#' );
+        if( comment != std::string::npos ){
+            line.erase( comment );
+        }
+
+        std::istringstream fields( line );
+        std::string keyword;
+        if( !( fields >> keyword ) ){
+            continue;
+        }
+        const std::string location = path + ":" + std::to_string( number );
+
+        // Gesture
+        if( keyword == "gesture" ){
+            GestureTemplate gesture;
+            if( !( fields >> gesture.name ) ){
+                throw std::runtime_error( "failed gesture name is missing at " + location );
+            }
+            if( !( fields >> gesture.threshold ) ){
+                gesture.threshold = GESTURE_THRESHOLD;
+            }
+            else if( gesture.threshold <= 0.0f ){
+                throw std::runtime_error( "failed invalid threshold at " + location );
+            }
+            for( const GestureTemplate& other : templates ){
+                if( other.name == gesture.name ){
+                    throw std::runtime_error( "failed duplicate gesture " + gesture.name + " at " + location );
+                }
+            }
+            templates.push_back( gesture );
+            continue;
+        }
+
+        // Point
+        if( keyword != "point" ){
+            throw std::runtime_error( "failed unknown keyword " + keyword + " at " + location );
+        }
+        if( templates.empty() ){
+            throw std::runtime_error( "failed point before gesture at " + location );
+        }
+        float time;
+        std::array<float, 3> point;
+        if( !( fields >> time >> point[0] >> point[1] >> point[2] ) ){
+            throw std::runtime_error( "failed invalid point at " + location );
+        }
+        GestureTemplate& gesture = templates.back();
+        if( !gesture.times.empty() && time <= gesture.times.back() ){
+            throw std::runtime_error( "failed time of point is not increasing at " + location );
+        }
+        gesture.times.push_back( time );
+        gesture.points.push_back( point );
+    }
+
+    return templates;
+}
+
+// Save Gesture Templates to File
+void saveGestureTemplates( const std::string& path, const std::vector<GestureTemplate>& templates )
+{
+    std::ofstream stream( path, std::ios::out | std::ios::trunc );
+    if( !stream.is_open() ){
+        throw std::runtime_error( "failed can not open " + path );
+    }
+
+    stream.precision( 9 );
+    for( const GestureTemplate& gesture : templates ){
+        stream << "gesture " << gesture.name << " " << gesture.threshold << "\n";
+        for( size_t index = 0; index < gesture.points.size(); index++ ){
+            const std::array<float, 3>& point = gesture.points[index];
+            stream << "point " << gesture.times[index] << " " << point[0] << " " << point[1] << " " << point[2] << "\n";
+        }
+    }
+
+    if( !stream ){
+        throw std::runtime_error( "failed can not write " + path );
+    }
+}
+
+// Resample Trajectory to Shape (axis * GESTURE_LENGTH + point) at Uniform Time over [start, start + duration]
+template<typename Time, typename Position>
+static void resampleTrajectory( Time time, Position position, const uint32_t count, uint32_t index, const uint64_t start, const uint64_t duration, float* shape )
+{
+    for( uint32_t point = 0; point < GESTURE_LENGTH; point++ ){
+        const uint64_t at = start + duration * point / ( GESTURE_LENGTH - 1 );
+        while( index + 1 < count && time( index + 1 ) <= at ){
+            index++;
+        }
+
+        // Linear Interpolation between Samples around Time
+        const uint32_t next = std::min( index + 1, count - 1 );
+        const uint64_t begin = time( index );
+        const uint64_t end = time( next );
+        const float weight = ( begin < at && begin < end ) ? static_cast<float>( at - begin ) / static_cast<float>( end - begin ) : 0.0f;
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            const float from = position( index, axis );
+            shape[axis * GESTURE_LENGTH + point] = from + weight * ( position( next, axis ) - from );
+        }
+    }
+}
+
+// Normalize Shape (Centroid at origin, RMS radius 1), and Retrieve Extent [mm]
+static float normalizeShape( float* shape )
+{
+    float squares = 0.0f;
+    for( uint32_t axis = 0; axis < 3; axis++ ){
+        float* values = shape + axis * GESTURE_LENGTH;
+        const float mean = std::accumulate( values, values + GESTURE_LENGTH, 0.0f ) / GESTURE_LENGTH;
+        for( uint32_t point = 0; point < GESTURE_LENGTH; point++ ){
+            values[point] -= mean;
+            squares += values[point] * values[point];
+        }
+    }
+
+    const float extent = std::sqrt( squares / GESTURE_LENGTH );
+    if( extent <= 0.0f ){
+        return 0.0f;
+    }
+    const float scale = 1.0f / extent;
+    for( uint32_t index = 0; index < 3 * GESTURE_LENGTH; index++ ){
+        shape[index] *= scale;
+    }
+    return extent;
+}
+
+// Constructor
+GestureEngine::GestureEngine( const std::vector<GestureTemplate>& templates, const float confidence )
+    : confidence( confidence ),
+      tracks( GESTURE_TRACK_COUNT )
+{
+    if( templates.empty() ){
+        throw std::runtime_error( "failed no gesture template" );
+    }
+
+    // Resample and Normalize Templates
+    shapes.resize( templates.size() * 3 * GESTURE_LENGTH );
+    uppers.resize( shapes.size() );
+    lowers.resize( shapes.size() );
+    for( uint32_t gesture = 0; gesture < templates.size(); gesture++ ){
+        const GestureTemplate& definition = templates[gesture];
+        if( definition.points.size() < 2 || definition.points.size() != definition.times.size() ){
+            throw std::runtime_error( "failed gesture " + definition.name + " has less than 2 points" );
+        }
+        const float duration = definition.times.back() - definition.times.front();
+        if( duration <= 0.0f || GESTURE_MAX_DURATION < duration ){
+            throw std::runtime_error( "failed duration of gesture " + definition.name + " is out of range" );
+        }
+
+        names.push_back( definition.name );
+        thresholds.push_back( definition.threshold );
+        const float step = std::max( 1.0f, std::round( duration / GESTURE_DURATION_STEP ) ) * GESTURE_DURATION_STEP;
+        durations.push_back( static_cast<uint64_t>( step ) * 1000 );
+
+        // Template is Resampled over its Own Duration
+        const float origin = definition.times.front();
+        float* shape = &shapes[static_cast<size_t>( gesture ) * 3 * GESTURE_LENGTH];
+        resampleTrajectory(
+            [&definition, origin]( const uint32_t index ){ return static_cast<uint64_t>( std::llround( ( definition.times[index] - origin ) * 1000.0f ) ); },
+            [&definition]( const uint32_t index, const uint32_t axis ){ return definition.points[index][axis]; },
+            static_cast<uint32_t>( definition.points.size() ), 0, 0, static_cast<uint64_t>( std::llround( duration * 1000.0f ) ), shape
+        );
+        const float extent = normalizeShape( shape );
+        if( extent < GESTURE_MIN_EXTENT ){
+            throw std::runtime_error( "failed gesture " + definition.name + " has no motion" );
+        }
+        extents.push_back( extent );
+
+        // Envelope of Sakoe-Chiba Band
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            const size_t offset = ( static_cast<size_t>( gesture ) * 3 + axis ) * GESTURE_LENGTH;
+            for( uint32_t point = 0; point < GESTURE_LENGTH; point++ ){
+                const uint32_t begin = ( GESTURE_BAND < point ) ? point - GESTURE_BAND : 0;
+                const uint32_t end = std::min<uint32_t>( point + GESTURE_BAND + 1, GESTURE_LENGTH );
+                uppers[offset + point] = *std::max_element( &shapes[offset + begin], &shapes[offset + begin] + ( end - begin ) );
+                lowers[offset + point] = *std::min_element( &shapes[offset + begin], &shapes[offset + begin] + ( end - begin ) );
+            }
+        }
+    }
+
+    // Order by Duration
+    order.resize( templates.size() );
+    std::iota( order.begin(), order.end(), 0 );
+    std::stable_sort( order.begin(), order.end(), [this]( const uint32_t a, const uint32_t b ){ return durations[a] < durations[b]; } );
+
+    matches.reserve( GESTURE_TRACK_COUNT );
+    remains.fill( 0.0f );
+}
+
+// Update Tracks of Hands and Match Updated Tracks
+void GestureEngine::update( const std::vector<Hand>& hands, const uint64_t timestamp )
+{
+    expire( timestamp );
+
+    for( const Hand& hand : hands ){
+        // Release Track of Lost Hand
+        if( hand.is_lost ){
+            for( Track& track : tracks ){
+                if( track.active && track.joint < 0 && track.id == hand.id ){
+                    track.active = false;
+                }
+            }
+            continue;
+        }
+
+        if( !hand.is_tracking ){
+            continue;
+        }
+        Track* hand_track = track( hand.id, -1 );
+        if( hand_track ){
+            addPosition( *hand_track, hand.position.x, hand.position.y, hand.position.z, timestamp );
+        }
+    }
+
+    matchTracks();
+}
+
+// Update Tracks of Hand Joints of Users in Snapshot and Match Updated Tracks
+void GestureEngine::update( const SkeletonSnapshot& snapshot )
+{
+    expire( snapshot.timestamp );
+
+    const int32_t joints[2] = { nite::JointType::JOINT_LEFT_HAND, nite::JointType::JOINT_RIGHT_HAND };
+    for( uint32_t user = 0; user < snapshot.count; user++ ){
+        if( snapshot.states[user] != nite::SkeletonState::SKELETON_TRACKED ){
+            continue;
+        }
+
+        for( const int32_t joint : joints ){
+            const size_t lane = SkeletonSnapshot::lane( user, joint );
+            if( snapshot.position_confidence[lane] < confidence ){
+                continue;
+            }
+            Track* joint_track = track( snapshot.ids[user], joint );
+            if( joint_track ){
+                addPosition( *joint_track, snapshot.x[lane], snapshot.y[lane], snapshot.z[lane], snapshot.timestamp );
+            }
+        }
+    }
+
+    matchTracks();
+}
+
+// Clear All Tracks
+void GestureEngine::reset()
+{
+    for( Track& track : tracks ){
+        track.active = false;
+    }
+    matches.clear();
+}
+
+// Enable Pruning
+void GestureEngine::setPruning( const bool enable )
+{
+    pruning = enable;
+}
+
+// Retrieve Number of Templates
+uint32_t GestureEngine::templateCount() const
+{
+    return static_cast<uint32_t>( names.size() );
+}
+
+// Retrieve Template Name
+const std::string& GestureEngine::templateName( const uint32_t gesture ) const
+{
+    return names[gesture];
+}
+
+// Retrieve Matches of Last Update
+const std::vector<GestureMatch>& GestureEngine::getMatches() const
+{
+    return matches;
+}
+
+// Retrieve Statistics
+const GestureStatistics& GestureEngine::getStatistics() const
+{
+    return statistics;
+}
+
+// Reset Statistics
+void GestureEngine::resetStatistics()
+{
+    statistics = GestureStatistics();
+}
+
+// Find Track
+GestureEngine::Track* GestureEngine::track( const int32_t id, const int32_t joint )
+{
+    Track* free = nullptr;
+    for( Track& track : tracks ){
+        if( track.active && track.id == id && track.joint == joint ){
+            return &track;
+        }
+        if( !track.active && !free ){
+            free = &track;
+        }
+    }
+
+    if( free ){
+        free->active = true;
+        free->updated = false;
+        free->id = id;
+        free->joint = joint;
+        free->head = 0;
+        free->count = 0;
+        free->pending = false;
+    }
+    return free;
+}
+
+// Add Position to Track
+void GestureEngine::addPosition( Track& track, const float x, const float y, const float z, const uint64_t timestamp )
+{
+    // Same Frame is Added Once, and History is Cleared if Time Goes Back
+    track.seen = timestamp;
+    if( track.count ){
+        const uint64_t newest = track.times[( track.head + GESTURE_HISTORY - 1 ) % GESTURE_HISTORY];
+        if( timestamp == newest ){
+            return;
+        }
+        if( timestamp < newest ){
+            track.count = 0;
+            track.pending = false;
+        }
+    }
+
+    track.x[track.head] = x;
+    track.y[track.head] = y;
+    track.z[track.head] = z;
+    track.times[track.head] = timestamp;
+    track.head = ( track.head + 1 ) % GESTURE_HISTORY;
+    track.count = std::min<uint32_t>( track.count + 1, GESTURE_HISTORY );
+    track.updated = true;
+}
+
+// Release Tracks without Position since Timeout
+void GestureEngine::expire( const uint64_t timestamp )
+{
+    for( Track& track : tracks ){
+        if( !track.active ){
+            continue;
+        }
+        if( track.seen + static_cast<uint64_t>( GESTURE_TIMEOUT ) * 1000 < timestamp ){
+            track.active = false;
+        }
+    }
+}
+
+// Match Updated Tracks
+void GestureEngine::matchTracks()
+{
+    matches.clear();
+
+    for( Track& track : tracks ){
+        if( !track.active || !track.updated ){
+            continue;
+        }
+        track.updated = false;
+
+        // Best Template below Threshold
+        float best = GESTURE_INFINITY;
+        uint32_t best_gesture = 0;
+        uint64_t window_duration = 0;
+        float extent = 0.0f;
+        for( const uint32_t gesture : order ){
+            if( durations[gesture] != window_duration ){
+                window_duration = durations[gesture];
+                extent = resample( track, window_duration );
+            }
+            if( extent <= 0.0f ){
+                continue;
+            }
+            statistics.comparisons++;
+
+            // Scale Range (Eligibility of template, also without pruning)
+            if( extent < extents[gesture] / GESTURE_SCALE_RANGE || extents[gesture] * GESTURE_SCALE_RANGE < extent ){
+                statistics.scale_pruned++;
+                continue;
+            }
+
+            const float threshold = thresholds[gesture] * GESTURE_LENGTH;
+            float bound = GESTURE_INFINITY;
+            if( pruning ){
+                bound = std::min( threshold, best );
+
+                // LB_Kim (First and last point are on every warping path)
+                const float* shape = &shapes[static_cast<size_t>( gesture ) * 3 * GESTURE_LENGTH];
+                float kim = 0.0f;
+                for( uint32_t axis = 0; axis < 3; axis++ ){
+                    const float first = window[axis * GESTURE_LENGTH] - shape[axis * GESTURE_LENGTH];
+                    const float last = window[axis * GESTURE_LENGTH + GESTURE_LENGTH - 1] - shape[axis * GESTURE_LENGTH + GESTURE_LENGTH - 1];
+                    kim += first * first + last * last;
+                }
+                if( bound < kim ){
+                    statistics.kim_pruned++;
+                    continue;
+                }
+
+                // LB_Keogh (Envelope of template)
+                if( bound < lowerBound( gesture, bound ) ){
+                    statistics.keogh_pruned++;
+                    continue;
+                }
+            }
+
+            // DTW
+            const float sum = distance( gesture, bound );
+            if( sum == GESTURE_INFINITY ){
+                statistics.abandoned++;
+                continue;
+            }
+            statistics.completed++;
+            if( sum <= threshold && sum < best ){
+                best = sum;
+                best_gesture = gesture;
+            }
+        }
+
+        // Pending Match (Replaced by Longer Template or Smaller Distance)
+        const uint32_t newest = ( track.head + GESTURE_HISTORY - 1 ) % GESTURE_HISTORY;
+        const uint64_t timestamp = track.times[newest];
+        if( best != GESTURE_INFINITY ){
+            const GestureMatch& pending = track.candidate;
+            const float value = best / GESTURE_LENGTH;
+            if( !track.pending || durations[pending.gesture] < durations[best_gesture] || ( durations[pending.gesture] == durations[best_gesture] && value < pending.distance ) ){
+                track.pending = true;
+                track.since = timestamp;
+                track.candidate.gesture = best_gesture;
+                track.candidate.id = track.id;
+                track.candidate.joint = track.joint;
+                track.candidate.distance = value;
+                track.candidate.position.x = track.x[newest];
+                track.candidate.position.y = track.y[newest];
+                track.candidate.position.z = track.z[newest];
+            }
+        }
+
+        // Report Match after Defer Time and Clear History
+        if( track.pending && track.since + static_cast<uint64_t>( GESTURE_DEFER ) * 1000 <= timestamp ){
+            matches.push_back( track.candidate );
+            track.pending = false;
+            track.count = 0;
+        }
+    }
+}
+
+// Resample Last Duration of Track to Window
+float GestureEngine::resample( const Track& track, const uint64_t duration )
+{
+    if( track.count < 2 ){
+        return 0.0f;
+    }
+
+    // Sample at or before Start of Window (Searched from newest)
+    const uint32_t oldest = ( track.head + GESTURE_HISTORY - track.count ) % GESTURE_HISTORY;
+    const uint64_t end = track.times[( track.head + GESTURE_HISTORY - 1 ) % GESTURE_HISTORY];
+    if( end < duration ){
+        return 0.0f;
+    }
+    const uint64_t start = end - duration;
+    uint32_t index = track.count - 1;
+    while( start < track.times[( oldest + index ) % GESTURE_HISTORY] ){
+        if( !index ){
+            return 0.0f;
+        }
+        index--;
+    }
+
+    resampleTrajectory(
+        [&track, oldest]( const uint32_t sample ){ return track.times[( oldest + sample ) % GESTURE_HISTORY]; },
+        [&track, oldest]( const uint32_t sample, const uint32_t axis ){
+            const uint32_t ring = ( oldest + sample ) % GESTURE_HISTORY;
+            return ( axis == 0 ) ? track.x[ring] : ( axis == 1 ) ? track.y[ring] : track.z[ring];
+        },
+        track.count, index, start, duration, window.data()
+    );
+
+    const float extent = normalizeShape( window.data() );
+    return ( GESTURE_MIN_EXTENT <= extent ) ? extent : 0.0f;
+}
+
+// Retrieve Lower Bound of Template
+float GestureEngine::lowerBound( const uint32_t gesture, const float bound )
+{
+    const size_t offset = static_cast<size_t>( gesture ) * 3 * GESTURE_LENGTH;
+    const float* upper = &uppers[offset];
+    const float* lower = &lowers[offset];
+
+    // Distance of Each Point to Envelope (Abandoned above bound)
+    float sum = 0.0f;
+    for( uint32_t point = 0; point < GESTURE_LENGTH; point++ ){
+        float value = 0.0f;
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            const uint32_t index = axis * GESTURE_LENGTH + point;
+            const float over = std::max( window[index] - upper[index], 0.0f );
+            const float under = std::max( lower[index] - window[index], 0.0f );
+            value += over * over + under * under;
+        }
+        bounds[point] = value;
+        sum += value;
+        if( bound < sum ){
+            return sum;
+        }
+    }
+
+    // Lower Bound of Rows from Point to End
+    remains[GESTURE_LENGTH] = 0.0f;
+    for( uint32_t point = GESTURE_LENGTH; point--; ){
+        remains[point] = remains[point + 1] + bounds[point];
+    }
+    return sum;
+}
+
+// Retrieve DTW Distance of Template
+float GestureEngine::distance( const uint32_t gesture, const float bound )
+{
+    const float* shape = &shapes[static_cast<size_t>( gesture ) * 3 * GESTURE_LENGTH];
+    const float* sx = shape;
+    const float* sy = shape + GESTURE_LENGTH;
+    const float* sz = shape + 2 * GESTURE_LENGTH;
+    const float* wx = window.data();
+    const float* wy = wx + GESTURE_LENGTH;
+    const float* wz = wy + GESTURE_LENGTH;
+
+    // Rows of Cumulative Cost (Column j + 1 is point j of template)
+    float* previous = previous_row.data();
+    float* current = current_row.data();
+    std::fill( previous, previous + GESTURE_LENGTH + 1, GESTURE_INFINITY );
+    previous[0] = 0.0f;
+
+    for( uint32_t row = 0; row < GESTURE_LENGTH; row++ ){
+        const uint32_t begin = ( GESTURE_BAND < row ) ? row - GESTURE_BAND : 0;
+        const uint32_t end = std::min<uint32_t>( row + GESTURE_BAND + 1, GESTURE_LENGTH );
+
+        // Cells within Band (Cells outside band are infinity)
+        current[begin] = GESTURE_INFINITY;
+        float minimum = GESTURE_INFINITY;
+        for( uint32_t column = begin; column < end; column++ ){
+            const float dx = wx[row] - sx[column];
+            const float dy = wy[row] - sy[column];
+            const float dz = wz[row] - sz[column];
+            const float cost = dx * dx + dy * dy + dz * dz + std::min( std::min( previous[column], previous[column + 1] ), current[column] );
+            current[column + 1] = cost;
+            minimum = std::min( minimum, cost );
+        }
+        if( end < GESTURE_LENGTH ){
+            current[end + 1] = GESTURE_INFINITY;
+        }
+
+        // Early Abandoning (Every path passes this row and one cell of each remaining row)
+        if( bound < minimum + remains[row + 1] ){
+            return GESTURE_INFINITY;
+        }
+        std::swap( previous, current );
+    }
+
+    return previous[GESTURE_LENGTH];
+}
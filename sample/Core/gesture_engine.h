@@ -0,0 +1,182 @@
+#ifndef __GESTURE_ENGINE__
+#define __GESTURE_ENGINE__
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "hand_source.h"
+#include "skeleton_snapshot.h"
+
+// Capacity of Trajectory Ring of each Track [samples] (8.5 seconds at 30 fps)
+#define GESTURE_HISTORY 256
+
+// Tracks (Hands of hand tracker and left/right hand joints of users)
+#define GESTURE_TRACK_COUNT ( HAND_COUNT + 2 * USER_COUNT )
+
+// Points of Resampled Template and Window
+#define GESTURE_LENGTH 32
+
+// Sakoe-Chiba Band of DTW [points] (About +/-20% of speed)
+#define GESTURE_BAND 6
+
+// Default Threshold of DTW Distance (Mean squared distance of normalized points)
+#define GESTURE_THRESHOLD 0.05f
+
+// Step of Window Durations [ms]
+#define GESTURE_DURATION_STEP 100
+
+// Maximum Duration of Template [ms]
+#define GESTURE_MAX_DURATION 4000
+
+// Minimum Extent of Window [mm] (RMS radius around centroid)
+#define GESTURE_MIN_EXTENT 30.0f
+
+// Scale Range of Window against Template
+#define GESTURE_SCALE_RANGE 3.0f
+
+// Defer Time of Match [ms] (Longer gesture wins over a shorter gesture it contains)
+#define GESTURE_DEFER 250
+
+// Track Timeout [ms] (Track without new position is released)
+#define GESTURE_TIMEOUT 500
+
+// Gesture Template (Recorded trajectory)
+struct GestureTemplate
+{
+    std::string name;
+    float threshold = GESTURE_THRESHOLD;
+    std::vector<float> times;                 // [ms] from start of gesture (Increasing)
+    std::vector<std::array<float, 3>> points; // Position [mm]
+};
+
+// Load Gesture Templates from File (Point lines belong to the gesture above, # starts a comment)
+//   gesture NAME [THRESHOLD]  : Start gesture (threshold of DTW distance)
+//   point TIME X Y Z          : Position [mm] at time [ms] from start of gesture
+std::vector<GestureTemplate> loadGestureTemplates( const std::string& path );
+
+// Save Gesture Templates to File
+void saveGestureTemplates( const std::string& path, const std::vector<GestureTemplate>& templates );
+
+// Gesture Statistics (Counts of template x window comparisons)
+struct GestureStatistics
+{
+    uint64_t comparisons = 0;  // Templates compared with a window
+    uint64_t scale_pruned = 0; // Extent of window out of scale range of template
+    uint64_t kim_pruned = 0;   // Pruned by first and last point (LB_Kim)
+    uint64_t keogh_pruned = 0; // Pruned by envelope of template (LB_Keogh)
+    uint64_t abandoned = 0;    // DTW abandoned (Row minimum and remaining LB_Keogh above bound)
+    uint64_t completed = 0;    // DTW completed
+};
+
+// Trajectory Gesture Engine (Latest window of each track against resampled and normalized templates)
+// Pruning cascade: scale range, LB_Kim, LB_Keogh, then DTW abandoned above min( threshold, best distance ), so the best match is exact.
+class GestureEngine
+{
+private:
+    // Track (Ring of positions and sensor timestamps)
+    struct Track
+    {
+        bool active = false;
+        bool updated = false;
+        int32_t id = 0;
+        int32_t joint = -1;
+        uint32_t head = 0;  // Next write
+        uint32_t count = 0;
+        std::array<float, GESTURE_HISTORY> x;
+        std::array<float, GESTURE_HISTORY> y;
+        std::array<float, GESTURE_HISTORY> z;
+        std::array<uint64_t, GESTURE_HISTORY> times;
+        uint64_t seen = 0;      // Sensor timestamp of last position (Expires track even if history is cleared)
+        bool pending = false;   // Candidate is reported at since + defer time
+        uint64_t since = 0;
+        GestureMatch candidate;
+    };
+
+    // Definitions
+    std::vector<std::string> names;
+    std::vector<float> thresholds;
+    std::vector<uint64_t> durations; // [us] (Window, rounded to step)
+    std::vector<float> extents;      // [mm]
+    std::vector<uint32_t> order;     // Templates by duration
+    float confidence;
+
+    // Normalized Templates and Envelopes (template * 3 * GESTURE_LENGTH + axis * GESTURE_LENGTH + point)
+    std::vector<float> shapes;
+    std::vector<float> uppers;
+    std::vector<float> lowers;
+
+    // Tracks
+    std::vector<Track> tracks;
+
+    // Window (axis * GESTURE_LENGTH + point), LB_Keogh of points and cumulative from point to end, DTW rows
+    std::array<float, 3 * GESTURE_LENGTH> window;
+    std::array<float, GESTURE_LENGTH> bounds;
+    std::array<float, GESTURE_LENGTH + 1> remains;
+    std::array<float, GESTURE_LENGTH + 1> previous_row;
+    std::array<float, GESTURE_LENGTH + 1> current_row;
+
+    // Matches of Last Update
+    std::vector<GestureMatch> matches;
+
+    // Statistics and Pruning (Disabled: Full DTW of all templates)
+    GestureStatistics statistics;
+    bool pruning = true;
+
+public:
+    // Constructor
+    explicit GestureEngine( const std::vector<GestureTemplate>& templates, const float confidence = 0.5f );
+
+    // Update Tracks of Hands (Hand tracker) and Match Updated Tracks
+    void update( const std::vector<Hand>& hands, const uint64_t timestamp );
+
+    // Update Tracks of Hand Joints of Users in Snapshot and Match Updated Tracks
+    void update( const SkeletonSnapshot& snapshot );
+
+    // Clear All Tracks
+    void reset();
+
+    // Enable Pruning (Lower bounds and early abandoning, enabled by default)
+    void setPruning( const bool enable );
+
+    // Retrieve Number of Templates
+    uint32_t templateCount() const;
+
+    // Retrieve Template Name
+    const std::string& templateName( const uint32_t gesture ) const;
+
+    // Retrieve Matches of Last Update
+    const std::vector<GestureMatch>& getMatches() const;
+
+    // Retrieve Statistics
+    const GestureStatistics& getStatistics() const;
+
+    // Reset Statistics
+    void resetStatistics();
+
+private:
+    // Find Track (Assign free track if not found, nullptr if no track is free)
+    Track* track( const int32_t id, const int32_t joint );
+
+    // Add Position to Track
+    void addPosition( Track& track, const float x, const float y, const float z, const uint64_t timestamp );
+
+    // Release Tracks without Position since Timeout
+    void expire( const uint64_t timestamp );
+
+    // Match Updated Tracks
+    void matchTracks();
+
+    // Resample Last Duration of Track to Window, and Retrieve Extent [mm] (0: Short History)
+    float resample( const Track& track, const uint64_t duration );
+
+    // Retrieve Lower Bound of Template (LB_Keogh, abandoned above bound)
+    float lowerBound( const uint32_t gesture, const float bound );
+
+    // Retrieve DTW Distance of Template (Infinity if abandoned above bound)
+    float distance( const uint32_t gesture, const float bound );
+};
+
+#endif // __GESTURE_ENGINE__
@@ -0,0 +1,562 @@
+#include "hand_source.h"
+#include "util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+// Constructor
+HandTrackerSource::HandTrackerSource( const std::string& uri )
+{
+    // Initialize OpenNI2 and NiTE2
+    initializeSensor();
+
+    // Create Hand Tracker (Opened Device or Any Connected Device)
+    if( openDevice( device, uri ) ){
+        NITE_CHECK( hand_tracker.create( &device ) );
+
+        // Read Depth Field of View (RealSense projects by its own camera model)
+        #if (DEVICE != REALSENSE)
+        if( !readDepthFieldOfView( device, horizontal_fov, vertical_fov ) ){
+            horizontal_fov = vertical_fov = 0.0f;
+        }
+        #endif
+    }
+    else{
+        NITE_CHECK( hand_tracker.create() );
+    }
+}
+
+// Read Frame
+void HandTrackerSource::readFrame( HandFrame& frame )
+{
+    // Update Frame
+    NITE_CHECK( hand_tracker.readFrame( &frame.hand_frame ) );
+
+    // Retrieve Depth Frame
+    frame.depth_frame = frame.hand_frame.getDepthFrame();
+    if( !frame.depth_frame.isValid() ){
+        throw std::runtime_error( "failed can not retrieve depth frame" );
+    }
+
+    // Retrive Frame Size
+    depth_width = frame.depth_frame.getWidth();
+    depth_height = frame.depth_frame.getHeight();
+
+    // Compute Depth Intrinsics (Once per depth size, field of view or two projections by tracker)
+    if( intrinsics_width != depth_width || intrinsics_height != depth_height ){
+        if( 0.0f < horizontal_fov ){
+            intrinsics = intrinsicsFromFieldOfView( depth_width, depth_height, horizontal_fov, vertical_fov );
+        }
+        else{
+            const bool estimated = estimateIntrinsics( [this]( const float x, const float y, const float z, float* pOutX, float* pOutY ){
+                return convertHandCoordinatesToDepth( x, y, z, pOutX, pOutY ) == nite::Status::STATUS_OK;
+            }, intrinsics );
+            if( !estimated ){
+                throw std::runtime_error( "failed can not estimate depth intrinsics" );
+            }
+        }
+        intrinsics_width = depth_width;
+        intrinsics_height = depth_height;
+    }
+    frame.intrinsics = intrinsics;
+
+    // Create cv::Mat form Depth Frame (Valid while Frame References are held)
+    frame.depth_mat = cv::Mat( depth_height, depth_width, CV_16UC1, const_cast<void*>( frame.depth_frame.getData() ), frame.depth_frame.getStrideInBytes() );
+
+    // Retrieve Timestamp
+    frame.sensor_timestamp = frame.hand_frame.getTimestamp();
+    frame.frame_index = frame.hand_frame.getFrameIndex();
+
+    // Retrieve Hands
+    const nite::Array<nite::HandData>& hands = frame.hand_frame.getHands();
+    frame.hands.resize( hands.getSize() );
+    for( int32_t index = 0; index < hands.getSize(); index++ ){
+        const nite::HandData& hand = hands[index];
+        Hand& data = frame.hands[index];
+        data.id = hand.getId();
+        data.position = hand.getPosition();
+        data.is_new = hand.isNew();
+        data.is_lost = hand.isLost();
+        data.is_tracking = hand.isTracking();
+        data.is_touching_fov = hand.isTouchingFov();
+    }
+
+    // Retrieve Gestures
+    const nite::Array<nite::GestureData>& gestures = frame.hand_frame.getGestures();
+    frame.gestures.resize( gestures.getSize() );
+    for( int32_t index = 0; index < gestures.getSize(); index++ ){
+        const nite::GestureData& gesture = gestures[index];
+        Gesture& data = frame.gestures[index];
+        data.type = gesture.getType();
+        data.current_position = gesture.getCurrentPosition();
+        data.is_complete = gesture.isComplete();
+        data.is_in_progress = gesture.isInProgress();
+    }
+}
+
+// Start Hand Tracking
+nite::Status HandTrackerSource::startHandTracking( const nite::Point3f& position, nite::HandId* pNewHandId )
+{
+    return hand_tracker.startHandTracking( position, pNewHandId );
+}
+
+// Start Gesture Detection
+nite::Status HandTrackerSource::startGestureDetection( const nite::GestureType type )
+{
+    return hand_tracker.startGestureDetection( type );
+}
+
+// Convert Hand Coordinates to Depth
+nite::Status HandTrackerSource::convertHandCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY )
+{
+    #if (DEVICE != REALSENSE)
+    return hand_tracker.convertHandCoordinatesToDepth( x, y, z, pOutX, pOutY ); // for PrimeSensor
+    #else
+    return convertRealSenseCoordinatesToDepth( device, depth_height, x, y, z, pOutX, pOutY ); // for RealSense
+    #endif
+}
+
+// Constructor
+SyntheticHandSource::SyntheticHandSource( const uint32_t width, const uint32_t height, const uint32_t fps, const uint32_t hands )
+    : depth_width( width ),
+      depth_height( height ),
+      depth_fps( fps ),
+      hand_count( std::min<uint32_t>( hands, HAND_COUNT ) ),
+      image_pool( 4 )
+{
+    if( !depth_width || !depth_height ){
+        throw std::runtime_error( "failed invalid synthetic resolution" );
+    }
+
+    // Camera Intrinsics from PrimeSense Field of View (58.5 x 45.6 degrees)
+    intrinsics = intrinsicsFromFieldOfView( depth_width, depth_height, 1.0210f, 0.7959f );
+
+    // Allocate Buffers of Depth
+    image_pool.reserve( depth_height, depth_width, CV_16UC1 );
+
+    // Initialize Status
+    hand_ids.fill( 0 );
+    tracked_frames.fill( 0 );
+}
+
+// Read Frame
+void SyntheticHandSource::readFrame( HandFrame& frame )
+{
+    // Wait Next Frame
+    if( depth_fps ){
+        if( !index ){
+            next = std::chrono::steady_clock::now();
+        }
+
+        std::this_thread::sleep_until( next );
+        next += std::chrono::microseconds( 1000000 / depth_fps );
+    }
+
+    // Move Virtual Hands (Circles in front of the sensor)
+    const uint32_t rate = depth_fps ? depth_fps : 30;
+    const float time = static_cast<float>( index ) / rate;
+    for( uint32_t number = 0; number < hand_count; number++ ){
+        const float phase = static_cast<float>( number );
+        positions[number].x = ( phase - ( hand_count - 1 ) / 2.0f ) * 500.0f + 150.0f * std::cos( time * 1.2f + phase );
+        positions[number].y = 100.0f + 150.0f * std::sin( time * 1.2f + phase );
+        positions[number].z = 1500.0f + 100.0f * std::sin( time * 0.7f + phase );
+    }
+
+    // Generate Hands (Tracking is lost after 10 seconds)
+    frame.hands.clear();
+    for( uint32_t number = 0; number < hand_count; number++ ){
+        if( !hand_ids[number] ){
+            continue;
+        }
+
+        Hand hand;
+        hand.id = hand_ids[number];
+        hand.position = positions[number];
+        hand.is_new = ( tracked_frames[number] == 0 );
+        hand.is_lost = ( tracked_frames[number] == rate * 10 );
+        hand.is_tracking = !hand.is_lost;
+        frame.hands.push_back( hand );
+
+        tracked_frames[number]++;
+        if( hand.is_lost ){
+            hand_ids[number] = 0;
+            tracked_frames[number] = 0;
+        }
+    }
+
+    // Generate Gestures (Untracked hands perform one of the enabled gestures every 3 seconds)
+    frame.gestures.clear();
+    for( uint32_t number = 0; number < hand_count && !gesture_types.empty(); number++ ){
+        if( hand_ids[number] ){
+            continue;
+        }
+
+        const uint32_t cycle = rate * 3;
+        const uint32_t phase = ( index + number * rate ) % cycle;
+        if( phase < cycle / 2 ){
+            continue;
+        }
+
+        Gesture gesture;
+        gesture.type = gesture_types[number % gesture_types.size()];
+        gesture.current_position = positions[number];
+        gesture.is_complete = ( phase == cycle - 1 );
+        gesture.is_in_progress = !gesture.is_complete;
+        frame.gestures.push_back( gesture );
+    }
+
+    // Generate Depth (Pooled Buffer)
+    frame.depth_buffer = image_pool.acquire( depth_height, depth_width, CV_16UC1 );
+    frame.depth_mat = *frame.depth_buffer;
+    generateDepth( frame.depth_mat );
+
+    // Set Timestamp
+    frame.sensor_timestamp = static_cast<uint64_t>( index ) * 1000000 / rate;
+    frame.frame_index = static_cast<int32_t>( index );
+    frame.hand_frame = nite::HandTrackerFrameRef();
+    frame.depth_frame = openni::VideoFrameRef();
+    frame.intrinsics = intrinsics;
+
+    index++;
+}
+
+// Start Hand Tracking
+nite::Status SyntheticHandSource::startHandTracking( const nite::Point3f& position, nite::HandId* pNewHandId )
+{
+    // Find Nearest Untracked Hand
+    constexpr float threshold = 200.0f;
+    for( uint32_t number = 0; number < hand_count; number++ ){
+        const float dx = positions[number].x - position.x;
+        const float dy = positions[number].y - position.y;
+        const float dz = positions[number].z - position.z;
+        if( hand_ids[number] || threshold * threshold < dx * dx + dy * dy + dz * dz ){
+            continue;
+        }
+
+        hand_ids[number] = next_id++;
+        tracked_frames[number] = 0;
+        *pNewHandId = hand_ids[number];
+        return nite::Status::STATUS_OK;
+    }
+
+    return nite::Status::STATUS_ERROR;
+}
+
+// Start Gesture Detection
+nite::Status SyntheticHandSource::startGestureDetection( const nite::GestureType type )
+{
+    if( std::find( gesture_types.begin(), gesture_types.end(), type ) == gesture_types.end() ){
+        gesture_types.push_back( type );
+    }
+
+    return nite::Status::STATUS_OK;
+}
+
+// Convert Hand Coordinates to Depth
+nite::Status SyntheticHandSource::convertHandCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY )
+{
+    // Pinhole Projection (NiTE World Coordinates: X Right, Y Up, Z Forward [mm])
+    return projectPoint( intrinsics, x, y, z, pOutX, pOutY ) ? nite::Status::STATUS_OK : nite::Status::STATUS_ERROR;
+}
+
+// Generate Depth
+inline void SyntheticHandSource::generateDepth( cv::Mat& depth_mat )
+{
+    // Background (Slanted Floor to Wall, 4000-5000mm)
+    for( uint32_t y = 0; y < depth_height; y++ ){
+        uint16_t* depth = depth_mat.ptr<uint16_t>( y );
+        const uint16_t value = static_cast<uint16_t>( 5000 - ( 1000 * y ) / depth_height );
+        std::fill( depth, depth + depth_width, value );
+    }
+
+    // Hands (Disc of 80mm Radius)
+    for( uint32_t number = 0; number < hand_count; number++ ){
+        const nite::Point3f& position = positions[number];
+        float center_x, center_y;
+        convertHandCoordinatesToDepth( position.x, position.y, position.z, &center_x, &center_y );
+        const float radius = 80.0f * intrinsics.focal_x / position.z;
+        const uint16_t z = static_cast<uint16_t>( position.z );
+
+        const int32_t top = std::max<int32_t>( 0, static_cast<int32_t>( center_y - radius ) );
+        const int32_t bottom = std::min<int32_t>( depth_height - 1, static_cast<int32_t>( center_y + radius ) );
+        for( int32_t y = top; y <= bottom; y++ ){
+            const float dy = y - center_y;
+            const float span = std::sqrt( std::max( 0.0f, radius * radius - dy * dy ) );
+            const int32_t left = std::max<int32_t>( 0, static_cast<int32_t>( center_x - span ) );
+            const int32_t right = std::min<int32_t>( depth_width - 1, static_cast<int32_t>( center_x + span ) );
+
+            uint16_t* depth = depth_mat.ptr<uint16_t>( y );
+            for( int32_t x = left; x <= right; x++ ){
+                depth[x] = std::min( depth[x], z );
+            }
+        }
+    }
+}
+
+// Constructor
+SessionHandSource::SessionHandSource( const std::string& path, const float speed )
+    : reader( path ),
+      clock( speed )
+{
+    const SessionHeader& header = reader.sessionHeader();
+    if( header.kind != SESSION_HAND ){
+        throw std::runtime_error( "failed " + path + " is not hand session" );
+    }
+
+    // Blank Depth
+    if( !( header.flags & SESSION_DEPTH ) ){
+        blank_mat = cv::Mat::zeros( header.depth_height ? header.depth_height : 480, header.depth_width ? header.depth_width : 640, CV_16UC1 );
+    }
+}
+
+// Read Frame
+void SessionHandSource::readFrame( HandFrame& frame )
+{
+    // Read Frame
+    SessionFrame session_frame;
+    if( !reader.read( session_frame ) ){
+        throw EndOfSource( "end of session" );
+    }
+    const SessionFrameHeader& frame_header = *session_frame.header;
+
+    // Wait Recorded Time
+    clock.wait( frame_header.timestamp );
+
+    // Create cv::Mat from Mapped Depth
+    const SessionHeader& header = reader.sessionHeader();
+    frame.depth_mat = session_frame.depth ? cv::Mat( header.depth_height, header.depth_width, CV_16UC1, const_cast<uint16_t*>( session_frame.depth ) ) : blank_mat;
+
+    // Retrieve Timestamp
+    frame.sensor_timestamp = frame_header.timestamp;
+    frame.frame_index = static_cast<int32_t>( frame_header.frame_index );
+    frame.hand_frame = nite::HandTrackerFrameRef();
+    frame.depth_frame = openni::VideoFrameRef();
+
+    // Recorded Intrinsics
+    frame.intrinsics = sessionIntrinsics( header );
+
+    // Retrieve Hands
+    frame.hands.resize( frame_header.count );
+    for( uint32_t index = 0; index < frame_header.count; index++ ){
+        const SessionHand& hand = session_frame.hands[index];
+        Hand& data = frame.hands[index];
+        data.id = static_cast<nite::HandId>( hand.id );
+        data.position = nite::Point3f( hand.position[0], hand.position[1], hand.position[2] );
+        data.is_new = ( hand.flags & 0x01 ) != 0;
+        data.is_lost = ( hand.flags & 0x02 ) != 0;
+        data.is_tracking = ( hand.flags & 0x04 ) != 0;
+        data.is_touching_fov = ( hand.flags & 0x08 ) != 0;
+    }
+
+    // Retrieve Gestures
+    frame.gestures.resize( frame_header.gesture_count );
+    for( uint32_t index = 0; index < frame_header.gesture_count; index++ ){
+        const SessionGesture& gesture = session_frame.gestures[index];
+        Gesture& data = frame.gestures[index];
+        data.type = static_cast<nite::GestureType>( gesture.type );
+        data.current_position = nite::Point3f( gesture.position[0], gesture.position[1], gesture.position[2] );
+        data.is_complete = ( gesture.flags & 0x01 ) != 0;
+        data.is_in_progress = ( gesture.flags & 0x02 ) != 0;
+    }
+}
+
+// Start Hand Tracking
+nite::Status SessionHandSource::startHandTracking( const nite::Point3f& position, nite::HandId* pNewHandId )
+{
+    static_cast<void>( position );
+    static_cast<void>( pNewHandId );
+    return nite::Status::STATUS_ERROR;
+}
+
+// Start Gesture Detection
+nite::Status SessionHandSource::startGestureDetection( const nite::GestureType type )
+{
+    static_cast<void>( type );
+    return nite::Status::STATUS_OK;
+}
+
+// Convert Hand Coordinates to Depth
+nite::Status SessionHandSource::convertHandCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY )
+{
+    // Recorded Projection
+    return projectPoint( sessionIntrinsics( reader.sessionHeader() ), x, y, z, pOutX, pOutY ) ? nite::Status::STATUS_OK : nite::Status::STATUS_ERROR;
+}
+
+// Seek to First Frame at or after Timestamp
+void SessionHandSource::seek( const uint64_t timestamp )
+{
+    reader.seek( timestamp );
+    clock.reset();
+}
+
+// Retrieve Session
+const SessionReader& SessionHandSource::session() const
+{
+    return reader;
+}
+
+// Create Frame Source
+std::unique_ptr<HandSource> createHandSource( const std::string& uri )
+{
+    // Recorded Session
+    std::string path;
+    float speed;
+    if( parseSessionUri( uri, path, speed ) ){
+        return std::unique_ptr<HandSource>( new SessionHandSource( path, speed ) );
+    }
+
+    // Synthetic Generator
+    const std::string synthetic = "synthetic";
+    if( uri.compare( 0, synthetic.size(), synthetic ) == 0 ){
+        uint32_t width = 640, height = 480, fps = 30, hands = 2;
+        std::sscanf( uri.c_str(), "synthetic:%ux%u@%u:%u", &width, &height, &fps, &hands );
+        return std::unique_ptr<HandSource>( new SyntheticHandSource( width, height, fps, hands ) );
+    }
+
+    // NiTE Hand Tracker (Connected Device or Playback File)
+    return std::unique_ptr<HandSource>( new HandTrackerSource( uri ) );
+}
+
+// Create Session Header of Hand Session
+SessionHeader createHandSessionHeader( const HandFrame& frame, const uint32_t flags )
+{
+    SessionHeader header;
+    header.kind = SESSION_HAND;
+    header.flags = flags;
+    header.depth_width = frame.depth_mat.cols;
+    header.depth_height = frame.depth_mat.rows;
+
+    // Projection (Intrinsics of Source)
+    setSessionIntrinsics( header, frame.intrinsics );
+
+    return header;
+}
+
+// Append Hand Frame to Session
+void appendSession( SessionWriter& writer, const HandFrame& frame )
+{
+    const SessionHeader& header = writer.sessionHeader();
+    if( ( header.flags & SESSION_DEPTH ) && frame.depth_mat.size() != cv::Size( header.depth_width, header.depth_height ) ){
+        throw std::runtime_error( "failed frame size doesn't match session" );
+    }
+
+    // Hands and Gestures (Gestures follow Hands, record buffer of writer)
+    uint8_t* records = writer.recordBuffer( frame.hands.size() * sizeof( SessionHand ) + frame.gestures.size() * sizeof( SessionGesture ) );
+    SessionHand* hands = reinterpret_cast<SessionHand*>( records );
+    for( size_t index = 0; index < frame.hands.size(); index++ ){
+        const Hand& data = frame.hands[index];
+        SessionHand& hand = hands[index];
+        hand = SessionHand();
+        hand.id = static_cast<uint16_t>( data.id );
+        hand.flags = ( data.is_new ? 0x01 : 0 ) | ( data.is_lost ? 0x02 : 0 ) | ( data.is_tracking ? 0x04 : 0 ) | ( data.is_touching_fov ? 0x08 : 0 );
+        hand.position[0] = data.position.x;
+        hand.position[1] = data.position.y;
+        hand.position[2] = data.position.z;
+    }
+
+    SessionGesture* gestures = reinterpret_cast<SessionGesture*>( hands + frame.hands.size() );
+    for( size_t index = 0; index < frame.gestures.size(); index++ ){
+        const Gesture& data = frame.gestures[index];
+        SessionGesture& gesture = gestures[index];
+        gesture = SessionGesture();
+        gesture.type = static_cast<uint8_t>( data.type );
+        gesture.flags = ( data.is_complete ? 0x01 : 0 ) | ( data.is_in_progress ? 0x02 : 0 );
+        gesture.position[0] = data.current_position.x;
+        gesture.position[1] = data.current_position.y;
+        gesture.position[2] = data.current_position.z;
+    }
+
+    SessionFrameHeader frame_header;
+    frame_header.timestamp = frame.sensor_timestamp;
+    frame_header.frame_index = static_cast<uint32_t>( frame.frame_index );
+    frame_header.count = static_cast<uint16_t>( frame.hands.size() );
+    frame_header.gesture_count = static_cast<uint16_t>( frame.gestures.size() );
+    writer.append( frame_header, records, nullptr, 0, frame.depth_mat.empty() ? nullptr : frame.depth_mat.ptr<uint16_t>(), frame.depth_mat.step );
+}
+
+// Publish Hand Frame to Shared Memory
+void publishSharedFrame( SharedFrameWriter& writer, const HandFrame& frame )
+{
+    static_assert( HAND_COUNT == SHARED_HAND_COUNT, "shared frame layout doesn't match hand tracker" );
+
+    SharedFrame& shared = writer.begin();
+    SharedFrameInfo& info = *shared.info;
+    info.timestamp = frame.sensor_timestamp;
+    info.frame_index = frame.frame_index;
+    info.sensor = frame.sensor;
+    info.focal_x = frame.intrinsics.focal_x;
+    info.focal_y = frame.intrinsics.focal_y;
+    info.center_x = frame.intrinsics.center_x;
+    info.center_y = frame.intrinsics.center_y;
+
+    // Hands (Hands beyond SHARED_HAND_COUNT are dropped)
+    info.hand_count = static_cast<uint32_t>( std::min<size_t>( frame.hands.size(), SHARED_HAND_COUNT ) );
+    for( uint32_t index = 0; index < info.hand_count; index++ ){
+        const Hand& data = frame.hands[index];
+        SharedHand& hand = info.hands[index];
+        hand.id = static_cast<int32_t>( data.id );
+        hand.flags = ( data.is_new ? 0x01 : 0 ) | ( data.is_lost ? 0x02 : 0 ) | ( data.is_tracking ? 0x04 : 0 ) | ( data.is_touching_fov ? 0x08 : 0 );
+        hand.position[0] = data.position.x;
+        hand.position[1] = data.position.y;
+        hand.position[2] = data.position.z;
+    }
+
+    // Depth
+    if( !frame.depth_mat.empty() ){
+        writer.writePlane( SHARED_FRAME_DEPTH, frame.depth_mat.ptr<uint16_t>(), frame.depth_mat.step, frame.depth_mat.cols, frame.depth_mat.rows );
+    }
+
+    writer.commit();
+}
+
+// Publish Hand Frame to Subscribers
+bool publishStream( StreamPublisher& publisher, const HandFrame& frame )
+{
+    static_assert( HAND_COUNT == PUBLISHER_HAND_COUNT, "published frame layout doesn't match hand tracker" );
+
+    return publisher.publish( [&]( PublishedFrame& published ){
+        published.timestamp = frame.sensor_timestamp;
+        published.frame_index = frame.frame_index;
+        published.sensor = frame.sensor;
+        published.user_count = 0;
+
+        // Hands (Hands beyond PUBLISHER_HAND_COUNT are dropped)
+        published.hand_count = static_cast<uint32_t>( std::min<size_t>( frame.hands.size(), PUBLISHER_HAND_COUNT ) );
+        for( uint32_t index = 0; index < published.hand_count; index++ ){
+            const Hand& data = frame.hands[index];
+            PublishedHand& hand = published.hands[index];
+            hand.id = static_cast<int32_t>( data.id );
+            hand.flags = ( data.is_new ? 0x01 : 0 ) | ( data.is_lost ? 0x02 : 0 ) | ( data.is_tracking ? 0x04 : 0 ) | ( data.is_touching_fov ? 0x08 : 0 );
+            hand.position[0] = data.position.x;
+            hand.position[1] = data.position.y;
+            hand.position[2] = data.position.z;
+        }
+
+        // Gestures
+        published.gesture_count = static_cast<uint32_t>( std::min<size_t>( frame.gestures.size(), PUBLISHER_GESTURE_COUNT ) );
+        for( uint32_t index = 0; index < published.gesture_count; index++ ){
+            const Gesture& data = frame.gestures[index];
+            PublishedGesture& gesture = published.gestures[index];
+            gesture.type = static_cast<uint32_t>( data.type );
+            gesture.flags = ( data.is_complete ? 0x01 : 0 ) | ( data.is_in_progress ? 0x02 : 0 );
+            gesture.position[0] = data.current_position.x;
+            gesture.position[1] = data.current_position.y;
+            gesture.position[2] = data.current_position.z;
+        }
+
+        // Custom Gesture Matches
+        published.match_count = static_cast<uint32_t>( std::min<size_t>( frame.matches.size(), PUBLISHER_MATCH_COUNT ) );
+        for( uint32_t index = 0; index < published.match_count; index++ ){
+            const GestureMatch& data = frame.matches[index];
+            PublishedMatch& match = published.matches[index];
+            match.gesture = data.gesture;
+            match.id = data.id;
+            match.distance = data.distance;
+            match.position[0] = data.position.x;
+            match.position[1] = data.position.y;
+            match.position[2] = data.position.z;
+        }
+    } );
+}
@@ -0,0 +1,263 @@
+#ifndef __HAND_SOURCE__
+#define __HAND_SOURCE__
+
+#include <OpenNI.h>
+#include <NiTE.h>
+#include <opencv2/opencv.hpp>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "frame_pool.h"
+#include "projection.h"
+#include "publisher.h"
+#include "sensor.h"
+#include "session.h"
+#include "shared_frame.h"
+
+#define HAND_COUNT 6
+
+// Hand
+struct Hand
+{
+    nite::HandId id = 0;
+    nite::Point3f position;
+    bool is_new = false;
+    bool is_lost = false;
+    bool is_tracking = false;
+    bool is_touching_fov = false;
+};
+
+// Gesture
+struct Gesture
+{
+    nite::GestureType type = nite::GestureType::GESTURE_WAVE;
+    nite::Point3f current_position;
+    bool is_complete = false;
+    bool is_in_progress = false;
+};
+
+// Custom Gesture Match (Trajectory of a hand matched a template of gesture_engine.h)
+struct GestureMatch
+{
+    uint32_t gesture = 0;   // Index of Template
+    int32_t id = 0;         // Hand Id (Hand tracker) or User Id (Skeleton hand joint)
+    int32_t joint = -1;     // nite::JointType of Skeleton Hand Joint (-1: Hand tracker)
+    float distance = 0.0f;  // DTW Distance (Mean squared distance of normalized points)
+    nite::Point3f position; // Position at End of Gesture [mm]
+};
+
+// Hand Frame
+struct HandFrame
+{
+    // Depth (CV_16UC1)
+    cv::Mat depth_mat;
+
+    // Hands and Gestures
+    std::vector<Hand> hands;
+    std::vector<Gesture> gestures;
+
+    // Custom Gestures Matched at this Frame (Gesture engine)
+    std::vector<GestureMatch> matches;
+
+    // Depth Intrinsics (Project hands to depth without calling the tracker)
+    Intrinsics intrinsics;
+
+    // Sensor Timestamp [us] and Frame Index
+    uint64_t sensor_timestamp = 0;
+    int32_t frame_index = 0;
+
+    // Sensor Index (0 for single sensor)
+    uint32_t sensor = 0;
+
+    // Capture Time
+    std::chrono::steady_clock::time_point timestamp;
+
+    // Frame References (Keep buffer of depth_mat alive)
+    nite::HandTrackerFrameRef hand_frame;
+    openni::VideoFrameRef depth_frame;
+
+    // Pooled Buffer of depth_mat (Synthetic Source)
+    ImageHandle depth_buffer;
+
+    // Constructor (Reserve hands, gestures and matches)
+    HandFrame()
+    {
+        hands.reserve( HAND_COUNT );
+        gestures.reserve( HAND_COUNT );
+        matches.reserve( HAND_COUNT );
+    }
+
+    // Release References (Keep capacity)
+    void release()
+    {
+        depth_mat.release();
+        hand_frame.release();
+        depth_frame.release();
+        depth_buffer.reset();
+    }
+};
+
+// Hand Frame Source
+class HandSource
+{
+public:
+    // Destructor
+    virtual ~HandSource() = default;
+
+    // Read Frame (Block until next frame is available)
+    virtual void readFrame( HandFrame& frame ) = 0;
+
+    // Start Hand Tracking
+    virtual nite::Status startHandTracking( const nite::Point3f& position, nite::HandId* pNewHandId ) = 0;
+
+    // Start Gesture Detection
+    virtual nite::Status startGestureDetection( const nite::GestureType type ) = 0;
+
+    // Convert Hand Coordinates to Depth
+    virtual nite::Status convertHandCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY ) = 0;
+};
+
+// Frame Source from NiTE Hand Tracker (Connected Device or Playback File)
+class HandTrackerSource : public HandSource
+{
+private:
+    // Device
+    openni::Device device;
+
+    // Tracker
+    nite::HandTracker hand_tracker;
+
+    // Depth Size
+    uint32_t depth_width = 640;
+    uint32_t depth_height = 480;
+
+    // Depth Field of View [rad] (Read once from opened device, 0 if unknown)
+    float horizontal_fov = 0.0f;
+    float vertical_fov = 0.0f;
+
+    // Depth Intrinsics (Computed once per depth size)
+    Intrinsics intrinsics;
+    uint32_t intrinsics_width = 0;
+    uint32_t intrinsics_height = 0;
+
+public:
+    // Constructor
+    explicit HandTrackerSource( const std::string& uri );
+
+    // Read Frame
+    void readFrame( HandFrame& frame ) override;
+
+    // Start Hand Tracking
+    nite::Status startHandTracking( const nite::Point3f& position, nite::HandId* pNewHandId ) override;
+
+    // Start Gesture Detection
+    nite::Status startGestureDetection( const nite::GestureType type ) override;
+
+    // Convert Hand Coordinates to Depth
+    nite::Status convertHandCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY ) override;
+};
+
+// Frame Source from Deterministic Synthetic Generator (No Sensor Required)
+class SyntheticHandSource : public HandSource
+{
+private:
+    // Configuration
+    uint32_t depth_width;
+    uint32_t depth_height;
+    uint32_t depth_fps;
+    uint32_t hand_count;
+
+    // Camera Intrinsics (PrimeSense Field of View)
+    Intrinsics intrinsics;
+
+    // Depth Buffers (Frames hold them until released)
+    ImagePool image_pool;
+
+    // Status
+    uint32_t index = 0;
+    nite::HandId next_id = 1;
+    std::vector<nite::GestureType> gesture_types;
+    std::array<nite::Point3f, HAND_COUNT> positions;
+    std::array<nite::HandId, HAND_COUNT> hand_ids;
+    std::array<uint32_t, HAND_COUNT> tracked_frames;
+    std::chrono::steady_clock::time_point next;
+
+public:
+    // Constructor
+    SyntheticHandSource( const uint32_t width, const uint32_t height, const uint32_t fps, const uint32_t hands );
+
+    // Read Frame
+    void readFrame( HandFrame& frame ) override;
+
+    // Start Hand Tracking
+    nite::Status startHandTracking( const nite::Point3f& position, nite::HandId* pNewHandId ) override;
+
+    // Start Gesture Detection
+    nite::Status startGestureDetection( const nite::GestureType type ) override;
+
+    // Convert Hand Coordinates to Depth
+    nite::Status convertHandCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY ) override;
+
+private:
+    // Generate Depth
+    inline void generateDepth( cv::Mat& depth_mat );
+};
+
+// Frame Source from Recorded Session (No Sensor and NiTE2 Required, depth points into the mapped file)
+class SessionHandSource : public HandSource
+{
+private:
+    // Session
+    SessionReader reader;
+    ReplayClock clock;
+
+    // Blank Depth (Not Recorded)
+    cv::Mat blank_mat;
+
+public:
+    // Constructor (speed 0 replays as fast as possible)
+    SessionHandSource( const std::string& path, const float speed );
+
+    // Read Frame (Throw EndOfSource at end of session)
+    void readFrame( HandFrame& frame ) override;
+
+    // Start Hand Tracking (Hands are replayed as recorded)
+    nite::Status startHandTracking( const nite::Point3f& position, nite::HandId* pNewHandId ) override;
+
+    // Start Gesture Detection (Recorded)
+    nite::Status startGestureDetection( const nite::GestureType type ) override;
+
+    // Convert Hand Coordinates to Depth (Recorded Projection)
+    nite::Status convertHandCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY ) override;
+
+    // Seek to First Frame at or after Timestamp [us]
+    void seek( const uint64_t timestamp );
+
+    // Retrieve Session
+    const SessionReader& session() const;
+};
+
+// Create Frame Source
+// ""                                  : Connected Device
+// "*.oni"                             : Playback File
+// "synthetic[:WIDTHxHEIGHT@FPS:HANDS]" : Synthetic Generator (FPS 0 runs as fast as possible)
+// "session:PATH[@SPEED]"              : Recorded Session (SPEED 1 by default, 0 replays as fast as possible)
+std::unique_ptr<HandSource> createHandSource( const std::string& uri );
+
+// Create Session Header of Hand Session (flags: SESSION_DEPTH)
+SessionHeader createHandSessionHeader( const HandFrame& frame, const uint32_t flags );
+
+// Append Hand Frame to Session
+void appendSession( SessionWriter& writer, const HandFrame& frame );
+
+// Publish Hand Frame to Shared Memory
+void publishSharedFrame( SharedFrameWriter& writer, const HandFrame& frame );
+
+// Publish Hand Frame to Subscribers (Return false if the event loop was behind)
+bool publishStream( StreamPublisher& publisher, const HandFrame& frame );
+
+#endif // __HAND_SOURCE__
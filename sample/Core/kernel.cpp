@@ -0,0 +1,417 @@
+#include "kernel.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#if defined( __AVX2__ )
+#define KERNEL_AVX2
+#include <immintrin.h>
+#elif defined( __SSSE3__ ) || defined( __AVX__ )
+#define KERNEL_SSSE3
+#include <tmmintrin.h>
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define KERNEL_SSE2
+#include <emmintrin.h>
+#endif
+
+// Depth Scaling (Same as depth_mat.convertTo( mat, CV_8U, -255.0 / 10000.0, 255.0 ))
+static const float depth_alpha = static_cast<float>( -255.0 / 10000.0 );
+static const float depth_beta = 255.0f;
+
+// Retrieve Depth to Gray Lookup Table
+static const std::array<uint8_t, 65536>& depthTable()
+{
+    static const std::array<uint8_t, 65536> table = []{
+        std::array<uint8_t, 65536> table;
+        for( uint32_t depth = 0; depth < table.size(); depth++ ){
+            table[depth] = cv::saturate_cast<uint8_t>( depth * depth_alpha + depth_beta );
+        }
+        return table;
+    }();
+
+    return table;
+}
+
+// Retrieve Rows of Tile (KERNEL_TILE_PIXELS or more)
+static inline size_t tileRows( const int32_t width )
+{
+    return ( KERNEL_TILE_PIXELS + std::max( width, 1 ) - 1 ) / std::max( width, 1 );
+}
+
+// Visualize Depth Pixels (Lookup Table)
+static inline void depthPixels( const uint16_t* depth, const std::array<uint8_t, 65536>& table, uint8_t* bgr, const int32_t begin, const int32_t end )
+{
+    for( int32_t x = begin; x < end; x++ ){
+        const uint8_t gray = table[depth[x]];
+        bgr[x * 3 + 0] = gray;
+        bgr[x * 3 + 1] = gray;
+        bgr[x * 3 + 2] = gray;
+    }
+}
+
+// Visualize User Pixels (Lookup Table)
+static inline void userPixels( const uint16_t* depth, const uint16_t* label, const cv::Vec3b* colors, const uint32_t color_count, const std::array<uint8_t, 65536>& table, uint8_t* bgr, const int32_t begin, const int32_t end )
+{
+    for( int32_t x = begin; x < end; x++ ){
+        const uint16_t id = label[x];
+        if( id != 0 && id <= color_count ){
+            const cv::Vec3b& color = colors[id - 1];
+            bgr[x * 3 + 0] = color[0];
+            bgr[x * 3 + 1] = color[1];
+            bgr[x * 3 + 2] = color[2];
+        }
+        else{
+            const uint8_t gray = table[depth[x]];
+            bgr[x * 3 + 0] = gray;
+            bgr[x * 3 + 1] = gray;
+            bgr[x * 3 + 2] = gray;
+        }
+    }
+}
+
+#if defined( KERNEL_AVX2 ) || defined( KERNEL_SSSE3 )
+// Interleave Masks of Planar B, G, R to Packed BGR (16 Pixels -> 48 Bytes)
+struct InterleaveMasks
+{
+    __m128i masks[3][3]; // [output block][channel]
+    __m128i expand[3];   // [output block] (gray replicated to all channels)
+
+    InterleaveMasks()
+    {
+        for( int32_t block = 0; block < 3; block++ ){
+            alignas( 16 ) int8_t pixels[16];
+            for( int32_t i = 0; i < 16; i++ ){
+                pixels[i] = static_cast<int8_t>( ( block * 16 + i ) / 3 );
+            }
+            expand[block] = _mm_load_si128( reinterpret_cast<const __m128i*>( pixels ) );
+
+            for( int32_t channel = 0; channel < 3; channel++ ){
+                alignas( 16 ) int8_t indices[16];
+                for( int32_t i = 0; i < 16; i++ ){
+                    const int32_t byte = block * 16 + i;
+                    indices[i] = ( byte % 3 == channel ) ? static_cast<int8_t>( byte / 3 ) : static_cast<int8_t>( 0x80 );
+                }
+                masks[block][channel] = _mm_load_si128( reinterpret_cast<const __m128i*>( indices ) );
+            }
+        }
+    }
+};
+
+// Retrieve Interleave Masks
+static inline const InterleaveMasks& interleaveMasks()
+{
+    static const InterleaveMasks interleave_masks;
+    return interleave_masks;
+}
+
+// Interleave Planar B, G, R to Packed BGR
+static inline void interleave( const __m128i& b, const __m128i& g, const __m128i& r, uint8_t* bgr )
+{
+    const InterleaveMasks& interleave_masks = interleaveMasks();
+    for( int32_t block = 0; block < 3; block++ ){
+        const __m128i* masks = interleave_masks.masks[block];
+        const __m128i packed = _mm_or_si128( _mm_or_si128( _mm_shuffle_epi8( b, masks[0] ), _mm_shuffle_epi8( g, masks[1] ) ), _mm_shuffle_epi8( r, masks[2] ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( bgr + block * 16 ), packed );
+    }
+}
+
+// Expand Gray to Packed BGR
+static inline void expand( const __m128i& gray, uint8_t* bgr )
+{
+    const InterleaveMasks& interleave_masks = interleaveMasks();
+    for( int32_t block = 0; block < 3; block++ ){
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( bgr + block * 16 ), _mm_shuffle_epi8( gray, interleave_masks.expand[block] ) );
+    }
+}
+
+// Pixels Written Past Block by interleave()
+static const int32_t interleave_slack = 0;
+#elif defined( KERNEL_SSE2 )
+// Pack 4 BGRx Pixels to 12 Bytes of BGR (Writes 16 bytes)
+static inline void pack( const __m128i& pixels, uint8_t* bgr )
+{
+    const __m128i low = _mm_and_si128( pixels, _mm_set_epi32( 0, 0x00FFFFFF, 0, 0x00FFFFFF ) );
+    const __m128i high = _mm_and_si128( _mm_srli_epi64( pixels, 8 ), _mm_set_epi32( 0x0000FFFF, static_cast<int32_t>( 0xFF000000 ), 0x0000FFFF, static_cast<int32_t>( 0xFF000000 ) ) );
+    const __m128i lanes = _mm_or_si128( low, high );
+    const __m128i packed = _mm_or_si128( _mm_move_epi64( lanes ), _mm_and_si128( _mm_srli_si128( lanes, 2 ), _mm_set_epi32( -1, -1, static_cast<int32_t>( 0xFFFF0000 ), 0 ) ) );
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( bgr ), packed );
+}
+
+// Interleave Planar B, G, R to Packed BGR (16 Pixels -> 48 Bytes, writes 4 bytes past)
+static inline void interleave( const __m128i& b, const __m128i& g, const __m128i& r, uint8_t* bgr )
+{
+    const __m128i bg_low = _mm_unpacklo_epi8( b, g );
+    const __m128i bg_high = _mm_unpackhi_epi8( b, g );
+    const __m128i rr_low = _mm_unpacklo_epi8( r, r );
+    const __m128i rr_high = _mm_unpackhi_epi8( r, r );
+    pack( _mm_unpacklo_epi16( bg_low, rr_low ), bgr );
+    pack( _mm_unpackhi_epi16( bg_low, rr_low ), bgr + 12 );
+    pack( _mm_unpacklo_epi16( bg_high, rr_high ), bgr + 24 );
+    pack( _mm_unpackhi_epi16( bg_high, rr_high ), bgr + 36 );
+}
+
+// Expand Gray to Packed BGR
+static inline void expand( const __m128i& gray, uint8_t* bgr )
+{
+    interleave( gray, gray, gray, bgr );
+}
+
+// Pixels Written Past Block by interleave()
+static const int32_t interleave_slack = 2;
+#endif
+
+#if defined( KERNEL_AVX2 )
+// Convert 16 Depth Pixels to Gray (16 x int16)
+static inline __m256i scaleDepth( const uint16_t* depth, const __m256& alpha, const __m256& beta )
+{
+    const __m256i low = _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( depth ) ) );
+    const __m256i high = _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( depth + 8 ) ) );
+    const __m256i gray_low = _mm256_cvtps_epi32( _mm256_add_ps( _mm256_mul_ps( _mm256_cvtepi32_ps( low ), alpha ), beta ) );
+    const __m256i gray_high = _mm256_cvtps_epi32( _mm256_add_ps( _mm256_mul_ps( _mm256_cvtepi32_ps( high ), alpha ), beta ) );
+    return _mm256_permute4x64_epi64( _mm256_packs_epi32( gray_low, gray_high ), 0xD8 );
+}
+
+// Convert 32 Depth Pixels to Gray (32 x uint8)
+static inline __m256i scaleDepth32( const uint16_t* depth, const __m256& alpha, const __m256& beta )
+{
+    return _mm256_permute4x64_epi64( _mm256_packus_epi16( scaleDepth( depth, alpha, beta ), scaleDepth( depth + 16, alpha, beta ) ), 0xD8 );
+}
+
+// Visualize Depth Row (AVX2, 32 Pixels per Iteration)
+static inline int32_t depthRow( const uint16_t* depth, uint8_t* bgr, const int32_t width )
+{
+    const __m256 alpha = _mm256_set1_ps( depth_alpha );
+    const __m256 beta = _mm256_set1_ps( depth_beta );
+
+    int32_t x = 0;
+    for( ; x + 32 <= width; x += 32 ){
+        const __m256i gray = scaleDepth32( depth + x, alpha, beta );
+        expand( _mm256_castsi256_si128( gray ), bgr + x * 3 );
+        expand( _mm256_extracti128_si256( gray, 1 ), bgr + x * 3 + 48 );
+    }
+
+    return x;
+}
+
+// Visualize User Row (AVX2, 32 Pixels per Iteration)
+static inline int32_t userRow( const uint16_t* depth, const uint16_t* label, const cv::Vec3b* colors, const uint32_t color_count, uint8_t* bgr, const int32_t width )
+{
+    const __m256 alpha = _mm256_set1_ps( depth_alpha );
+    const __m256 beta = _mm256_set1_ps( depth_beta );
+
+    int32_t x = 0;
+    for( ; x + 32 <= width; x += 32 ){
+        // Scaling
+        const __m256i gray = scaleDepth32( depth + x, alpha, beta );
+        __m256i b = gray, g = gray, r = gray;
+
+        // User Color
+        const __m256i id_low = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( label + x ) );
+        const __m256i id_high = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( label + x + 16 ) );
+        if( !_mm256_testz_si256( _mm256_or_si256( id_low, id_high ), _mm256_or_si256( id_low, id_high ) ) ){
+            for( uint32_t id = 1; id <= color_count; id++ ){
+                const __m256i value = _mm256_set1_epi16( static_cast<int16_t>( id ) );
+                const __m256i mask = _mm256_permute4x64_epi64( _mm256_packs_epi16( _mm256_cmpeq_epi16( id_low, value ), _mm256_cmpeq_epi16( id_high, value ) ), 0xD8 );
+                const cv::Vec3b& color = colors[id - 1];
+                b = _mm256_blendv_epi8( b, _mm256_set1_epi8( static_cast<char>( color[0] ) ), mask );
+                g = _mm256_blendv_epi8( g, _mm256_set1_epi8( static_cast<char>( color[1] ) ), mask );
+                r = _mm256_blendv_epi8( r, _mm256_set1_epi8( static_cast<char>( color[2] ) ), mask );
+            }
+        }
+
+        // GRAY to BGR
+        interleave( _mm256_castsi256_si128( b ), _mm256_castsi256_si128( g ), _mm256_castsi256_si128( r ), bgr + x * 3 );
+        interleave( _mm256_extracti128_si256( b, 1 ), _mm256_extracti128_si256( g, 1 ), _mm256_extracti128_si256( r, 1 ), bgr + x * 3 + 48 );
+    }
+
+    return x;
+}
+#elif defined( KERNEL_SSSE3 ) || defined( KERNEL_SSE2 )
+// Convert 8 Depth Pixels to Gray (8 x int16)
+static inline __m128i scaleDepth( const uint16_t* depth, const __m128& alpha, const __m128& beta )
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i value = _mm_loadu_si128( reinterpret_cast<const __m128i*>( depth ) );
+    const __m128i low = _mm_unpacklo_epi16( value, zero );
+    const __m128i high = _mm_unpackhi_epi16( value, zero );
+    const __m128i gray_low = _mm_cvtps_epi32( _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps( low ), alpha ), beta ) );
+    const __m128i gray_high = _mm_cvtps_epi32( _mm_add_ps( _mm_mul_ps( _mm_cvtepi32_ps( high ), alpha ), beta ) );
+    return _mm_packs_epi32( gray_low, gray_high );
+}
+
+// Convert 16 Depth Pixels to Gray (16 x uint8)
+static inline __m128i scaleDepth16( const uint16_t* depth, const __m128& alpha, const __m128& beta )
+{
+    return _mm_packus_epi16( scaleDepth( depth, alpha, beta ), scaleDepth( depth + 8, alpha, beta ) );
+}
+
+// Visualize Depth Row (SSSE3/SSE2, 16 Pixels per Iteration)
+static inline int32_t depthRow( const uint16_t* depth, uint8_t* bgr, const int32_t width )
+{
+    const __m128 alpha = _mm_set1_ps( depth_alpha );
+    const __m128 beta = _mm_set1_ps( depth_beta );
+
+    int32_t x = 0;
+    for( ; x + 16 + interleave_slack <= width; x += 16 ){
+        expand( scaleDepth16( depth + x, alpha, beta ), bgr + x * 3 );
+    }
+
+    return x;
+}
+
+// Visualize User Row (SSSE3/SSE2, 16 Pixels per Iteration)
+static inline int32_t userRow( const uint16_t* depth, const uint16_t* label, const cv::Vec3b* colors, const uint32_t color_count, uint8_t* bgr, const int32_t width )
+{
+    const __m128 alpha = _mm_set1_ps( depth_alpha );
+    const __m128 beta = _mm_set1_ps( depth_beta );
+    const __m128i zero = _mm_setzero_si128();
+
+    int32_t x = 0;
+    for( ; x + 16 + interleave_slack <= width; x += 16 ){
+        // Scaling
+        const __m128i gray = scaleDepth16( depth + x, alpha, beta );
+        __m128i b = gray, g = gray, r = gray;
+
+        // User Color
+        const __m128i id_low = _mm_loadu_si128( reinterpret_cast<const __m128i*>( label + x ) );
+        const __m128i id_high = _mm_loadu_si128( reinterpret_cast<const __m128i*>( label + x + 8 ) );
+        if( _mm_movemask_epi8( _mm_cmpeq_epi16( _mm_or_si128( id_low, id_high ), zero ) ) != 0xFFFF ){
+            for( uint32_t id = 1; id <= color_count; id++ ){
+                const __m128i value = _mm_set1_epi16( static_cast<int16_t>( id ) );
+                const __m128i mask = _mm_packs_epi16( _mm_cmpeq_epi16( id_low, value ), _mm_cmpeq_epi16( id_high, value ) );
+                const cv::Vec3b& color = colors[id - 1];
+                b = _mm_or_si128( _mm_and_si128( mask, _mm_set1_epi8( static_cast<char>( color[0] ) ) ), _mm_andnot_si128( mask, b ) );
+                g = _mm_or_si128( _mm_and_si128( mask, _mm_set1_epi8( static_cast<char>( color[1] ) ) ), _mm_andnot_si128( mask, g ) );
+                r = _mm_or_si128( _mm_and_si128( mask, _mm_set1_epi8( static_cast<char>( color[2] ) ) ), _mm_andnot_si128( mask, r ) );
+            }
+        }
+
+        // GRAY to BGR
+        interleave( b, g, r, bgr + x * 3 );
+    }
+
+    return x;
+}
+#else
+// Visualize Depth Row (Scalar Fallback, Handled by Lookup Table)
+static inline int32_t depthRow( const uint16_t*, uint8_t*, const int32_t )
+{
+    return 0;
+}
+
+// Visualize User Row (Scalar Fallback, Handled by Lookup Table)
+static inline int32_t userRow( const uint16_t*, const uint16_t*, const cv::Vec3b*, const uint32_t, uint8_t*, const int32_t )
+{
+    return 0;
+}
+#endif
+
+// Parse Depth Kernel
+DepthKernel parseDepthKernel( const std::string& name )
+{
+    if( name == "opencv" ){
+        return DEPTH_KERNEL_OPENCV;
+    }
+    else if( name == "lut" ){
+        return DEPTH_KERNEL_LUT;
+    }
+    else if( name == "simd" ){
+        return DEPTH_KERNEL_SIMD;
+    }
+
+    throw std::runtime_error( "failed unknown depth kernel " + name + " (opencv, lut or simd)" );
+}
+
+// Retrieve Depth Kernel Name
+const char* depthKernelName( const DepthKernel kernel )
+{
+    switch( kernel ){
+        case DEPTH_KERNEL_OPENCV:
+            return "opencv";
+        case DEPTH_KERNEL_LUT:
+            return "lut";
+        default:
+            return "simd";
+    }
+}
+
+// Retrieve Instruction Set of SIMD Kernel
+const char* kernelInstructionSet()
+{
+    #if defined( KERNEL_AVX2 )
+    return "avx2";
+    #elif defined( KERNEL_SSSE3 )
+    return "ssse3";
+    #elif defined( KERNEL_SSE2 )
+    return "sse2";
+    #else
+    return "scalar";
+    #endif
+}
+
+// Visualize Depth
+void visualizeDepth( const cv::Mat& depth_mat, cv::Mat& bgr_mat, const DepthKernel kernel, TaskPool& pool )
+{
+    if( depth_mat.type() != CV_16UC1 ){
+        throw std::runtime_error( "failed invalid depth" );
+    }
+
+    // OpenCV (Scaling and Convert GRAY to BGR)
+    if( kernel == DEPTH_KERNEL_OPENCV ){
+        depth_mat.convertTo( bgr_mat, CV_8U, -255.0 / 10000.0, 255.0 );
+        cv::cvtColor( bgr_mat, bgr_mat, cv::COLOR_GRAY2BGR );
+        return;
+    }
+
+    bgr_mat.create( depth_mat.rows, depth_mat.cols, CV_8UC3 );
+
+    // Row Tiles
+    const std::array<uint8_t, 65536>& table = depthTable();
+    pool.parallelFor( depth_mat.rows, tileRows( depth_mat.cols ), [&]( const size_t begin, const size_t end ){
+        for( int32_t y = static_cast<int32_t>( begin ); y < static_cast<int32_t>( end ); y++ ){
+            const uint16_t* depth = depth_mat.ptr<uint16_t>( y );
+            uint8_t* bgr = bgr_mat.ptr<uint8_t>( y );
+
+            // SIMD Body and Lookup Table Tail
+            const int32_t x = ( kernel == DEPTH_KERNEL_SIMD ) ? depthRow( depth, bgr, depth_mat.cols ) : 0;
+            depthPixels( depth, table, bgr, x, depth_mat.cols );
+        }
+    } );
+}
+
+// Visualize User
+void visualizeUser( const cv::Mat& depth_mat, const cv::Mat& user_map, const cv::Vec3b* colors, const uint32_t color_count, cv::Mat& user_mat, const DepthKernel kernel, TaskPool& pool )
+{
+    if( depth_mat.type() != CV_16UC1 || user_map.type() != CV_16UC1 || depth_mat.size() != user_map.size() ){
+        throw std::runtime_error( "failed invalid depth or user map" );
+    }
+
+    // OpenCV (Scaling, Convert GRAY to BGR and Draw User Area)
+    if( kernel == DEPTH_KERNEL_OPENCV ){
+        visualizeDepth( depth_mat, user_mat, kernel );
+        user_mat.forEach<cv::Vec3b>( [&]( cv::Vec3b& p, const int* position ){
+            const uint16_t id = user_map.ptr<uint16_t>( position[0] )[position[1]];
+            if( id != 0 && id <= color_count ){
+                p = colors[id - 1];
+            }
+        } );
+        return;
+    }
+
+    user_mat.create( depth_mat.rows, depth_mat.cols, CV_8UC3 );
+
+    // Row Tiles
+    const std::array<uint8_t, 65536>& table = depthTable();
+    pool.parallelFor( depth_mat.rows, tileRows( depth_mat.cols ), [&]( const size_t begin, const size_t end ){
+        for( int32_t y = static_cast<int32_t>( begin ); y < static_cast<int32_t>( end ); y++ ){
+            const uint16_t* depth = depth_mat.ptr<uint16_t>( y );
+            const uint16_t* label = user_map.ptr<uint16_t>( y );
+            uint8_t* bgr = user_mat.ptr<uint8_t>( y );
+
+            // SIMD Body and Lookup Table Tail
+            const int32_t x = ( kernel == DEPTH_KERNEL_SIMD ) ? userRow( depth, label, colors, color_count, bgr, depth_mat.cols ) : 0;
+            userPixels( depth, label, colors, color_count, table, bgr, x, depth_mat.cols );
+        }
+    } );
+}
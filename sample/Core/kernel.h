@@ -0,0 +1,37 @@
+#ifndef __KERNEL__
+#define __KERNEL__
+
+#include <opencv2/opencv.hpp>
+
+#include "task_pool.h"
+
+#include <cstdint>
+#include <string>
+
+// Minimum Pixels of Row Tile (Smaller images run on the calling thread)
+#define KERNEL_TILE_PIXELS 65536
+
+// Depth Visualization Kernel
+enum DepthKernel
+{
+    DEPTH_KERNEL_OPENCV, // cv::Mat::convertTo() and cv::cvtColor() (two passes)
+    DEPTH_KERNEL_LUT,    // 16-bit depth to gray lookup table (single pass)
+    DEPTH_KERNEL_SIMD    // SSE2/SSSE3/AVX2 scaling and BGR interleave (single pass, lookup table on other architectures)
+};
+
+// Parse Depth Kernel ("opencv", "lut" or "simd")
+DepthKernel parseDepthKernel( const std::string& name );
+
+// Retrieve Depth Kernel Name
+const char* depthKernelName( const DepthKernel kernel );
+
+// Retrieve Instruction Set of SIMD Kernel ("avx2", "ssse3", "sse2" or "scalar")
+const char* kernelInstructionSet();
+
+// Visualize Depth (CV_16UC1 to BGR, bgr_mat is reused if it has the same size)
+void visualizeDepth( const cv::Mat& depth_mat, cv::Mat& bgr_mat, const DepthKernel kernel = DEPTH_KERNEL_SIMD, TaskPool& pool = taskPool() );
+
+// Visualize User (Depth and user id N in colors[N - 1], user_mat is reused if it has the same size)
+void visualizeUser( const cv::Mat& depth_mat, const cv::Mat& user_map, const cv::Vec3b* colors, const uint32_t color_count, cv::Mat& user_mat, const DepthKernel kernel = DEPTH_KERNEL_SIMD, TaskPool& pool = taskPool() );
+
+#endif // __KERNEL__
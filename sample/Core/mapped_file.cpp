@@ -0,0 +1,116 @@
+#include "mapped_file.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Constructor
+MappedFile::MappedFile( const std::string& path )
+{
+    #ifdef _WIN32
+    file = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if( file == INVALID_HANDLE_VALUE ){
+        file = nullptr;
+        throw std::runtime_error( "failed can not open " + path );
+    }
+
+    LARGE_INTEGER file_size;
+    if( !GetFileSizeEx( file, &file_size ) ){
+        CloseHandle( file );
+        throw std::runtime_error( "failed can not retrieve size of " + path );
+    }
+    length = static_cast<size_t>( file_size.QuadPart );
+    if( !length ){
+        return;
+    }
+
+    mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if( !mapping ){
+        CloseHandle( file );
+        throw std::runtime_error( "failed can not map " + path );
+    }
+
+    address = static_cast<const uint8_t*>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+    if( !address ){
+        CloseHandle( mapping );
+        CloseHandle( file );
+        throw std::runtime_error( "failed can not map " + path );
+    }
+    #else
+    fd = open( path.c_str(), O_RDONLY );
+    if( fd < 0 ){
+        throw std::runtime_error( "failed can not open " + path );
+    }
+
+    struct stat status;
+    if( fstat( fd, &status ) != 0 ){
+        close( fd );
+        throw std::runtime_error( "failed can not retrieve size of " + path );
+    }
+    length = static_cast<size_t>( status.st_size );
+    if( !length ){
+        return;
+    }
+
+    void* map = mmap( nullptr, length, PROT_READ, MAP_SHARED, fd, 0 );
+    if( map == MAP_FAILED ){
+        close( fd );
+        throw std::runtime_error( "failed can not map " + path );
+    }
+    address = static_cast<const uint8_t*>( map );
+    #endif
+}
+
+// Destructor
+MappedFile::~MappedFile()
+{
+    #ifdef _WIN32
+    if( address ){
+        UnmapViewOfFile( address );
+    }
+    if( mapping ){
+        CloseHandle( mapping );
+    }
+    if( file ){
+        CloseHandle( file );
+    }
+    #else
+    if( address ){
+        munmap( const_cast<uint8_t*>( address ), length );
+    }
+    if( 0 <= fd ){
+        close( fd );
+    }
+    #endif
+}
+
+// Retrieve Mapped Data
+const uint8_t* MappedFile::data() const
+{
+    return address;
+}
+
+// Retrieve File Size
+size_t MappedFile::size() const
+{
+    return length;
+}
+
+// Advise Access Pattern
+void MappedFile::advise( const bool sequential )
+{
+    #ifndef _WIN32
+    if( address ){
+        madvise( const_cast<uint8_t*>( address ), length, sequential ? MADV_SEQUENTIAL : MADV_RANDOM );
+    }
+    #else
+    static_cast<void>( sequential );
+    #endif
+}
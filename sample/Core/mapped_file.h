@@ -0,0 +1,44 @@
+#ifndef __MAPPED_FILE__
+#define __MAPPED_FILE__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-Only Memory Mapped File
+class MappedFile
+{
+private:
+    // Mapping
+    const uint8_t* address = nullptr;
+    size_t length = 0;
+
+    #ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+    #else
+    int fd = -1;
+    #endif
+
+public:
+    // Constructor
+    explicit MappedFile( const std::string& path );
+
+    // Destructor
+    ~MappedFile();
+
+    // Non-Copyable
+    MappedFile( const MappedFile& ) = delete;
+    MappedFile& operator=( const MappedFile& ) = delete;
+
+    // Retrieve Mapped Data
+    const uint8_t* data() const;
+
+    // Retrieve File Size
+    size_t size() const;
+
+    // Advise Access Pattern (Sequential: read ahead, Random: no read ahead)
+    void advise( const bool sequential );
+};
+
+#endif // __MAPPED_FILE__
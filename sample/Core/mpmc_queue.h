@@ -0,0 +1,152 @@
+#ifndef __MPMC_QUEUE__
+#define __MPMC_QUEUE__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+// Cache Line Size [bytes] (Positions are kept on separate lines)
+#define MPMC_CACHE_LINE 64
+
+// Lock-Free Bounded Multi-Producer/Multi-Consumer Queue (D. Vyukov, capacity is power of two)
+// Sequence number of each cell tells whose turn it is: one CAS on the position and acquire/release on the cell.
+template<typename T>
+class MpmcQueue
+{
+private:
+    // Cell (Sequence is position for producer, position + 1 for consumer)
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T element;
+    };
+
+    // Buffer
+    std::unique_ptr<Cell[]> cells;
+    size_t cell_count;
+    size_t mask;
+
+    // Positions (Shared by Producers/Consumers, Padded to separate cache lines)
+    char padding0[MPMC_CACHE_LINE];
+    std::atomic<size_t> tail; // Next Position to Push (Producers)
+    std::atomic<uint64_t> dropped;
+    char padding1[MPMC_CACHE_LINE];
+    std::atomic<size_t> head; // Next Position to Pop (Consumers)
+    char padding2[MPMC_CACHE_LINE];
+
+public:
+    // Constructor
+    explicit MpmcQueue( const size_t capacity )
+        : tail( 0 ),
+          dropped( 0 ),
+          head( 0 )
+    {
+        if( !capacity ){
+            throw std::runtime_error( "failed invalid capacity of queue" );
+        }
+
+        cell_count = 1;
+        while( cell_count < capacity ){
+            cell_count <<= 1;
+        }
+        mask = cell_count - 1;
+
+        cells.reset( new Cell[cell_count] );
+        for( size_t position = 0; position < cell_count; position++ ){
+            cells[position].sequence.store( position, std::memory_order_relaxed );
+        }
+    }
+
+    MpmcQueue( const MpmcQueue& ) = delete;
+    MpmcQueue& operator=( const MpmcQueue& ) = delete;
+
+    // Push Element (Any thread, return false and drop element if full)
+    bool push( const T& element )
+    {
+        return emplace( [&element]( T& cell ){ cell = element; } );
+    }
+
+    // Push Element Written in Place by function( T& ) (Any thread, return false if full)
+    template<typename Function>
+    bool emplace( Function function )
+    {
+        Cell* cell;
+        size_t position = tail.load( std::memory_order_relaxed );
+        while( true ){
+            cell = &cells[position & mask];
+            const size_t sequence = cell->sequence.load( std::memory_order_acquire );
+            const intptr_t difference = static_cast<intptr_t>( sequence ) - static_cast<intptr_t>( position );
+            if( !difference ){
+                // Claim Cell
+                if( tail.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ){
+                    break;
+                }
+            }
+            else if( difference < 0 ){
+                // Cell of Previous Lap is not Popped yet (Full)
+                dropped.fetch_add( 1, std::memory_order_relaxed );
+                return false;
+            }
+            else{
+                position = tail.load( std::memory_order_relaxed );
+            }
+        }
+
+        function( cell->element );
+        cell->sequence.store( position + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Pop Element (Any thread, return false if empty)
+    bool pop( T& element )
+    {
+        Cell* cell;
+        size_t position = head.load( std::memory_order_relaxed );
+        while( true ){
+            cell = &cells[position & mask];
+            const size_t sequence = cell->sequence.load( std::memory_order_acquire );
+            const intptr_t difference = static_cast<intptr_t>( sequence ) - static_cast<intptr_t>( position + 1 );
+            if( !difference ){
+                // Claim Cell
+                if( head.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ){
+                    break;
+                }
+            }
+            else if( difference < 0 ){
+                // Cell is not Pushed yet (Empty)
+                return false;
+            }
+            else{
+                position = head.load( std::memory_order_relaxed );
+            }
+        }
+
+        element = cell->element;
+        cell->sequence.store( position + cell_count, std::memory_order_release );
+        return true;
+    }
+
+    // Retrieve Number of Elements (Approximate while other threads run)
+    size_t size() const
+    {
+        const size_t position = head.load( std::memory_order_acquire );
+        const size_t end = tail.load( std::memory_order_acquire );
+        return ( position < end ) ? end - position : 0;
+    }
+
+    // Retrieve Capacity
+    size_t capacity() const
+    {
+        return cell_count;
+    }
+
+    // Retrieve Number of Dropped Elements
+    uint64_t drops() const
+    {
+        return dropped.load( std::memory_order_relaxed );
+    }
+};
+
+#endif // __MPMC_QUEUE__
@@ -0,0 +1,297 @@
+#include "multi_source.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+#if defined( _WIN32 )
+#include <windows.h>
+#elif defined( __linux__ )
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Pin Thread to Core
+bool pinThread( std::thread& thread, const uint32_t core )
+{
+    #if defined( _WIN32 )
+    if( 8 * sizeof( DWORD_PTR ) <= core ){
+        return false;
+    }
+    return SetThreadAffinityMask( thread.native_handle(), static_cast<DWORD_PTR>( 1 ) << core ) != 0;
+    #elif defined( __linux__ )
+    if( CPU_SETSIZE <= core ){
+        return false;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO( &cpu_set );
+    CPU_SET( core, &cpu_set );
+    return pthread_setaffinity_np( thread.native_handle(), sizeof( cpu_set_t ), &cpu_set ) == 0;
+    #else
+    static_cast<void>( thread );
+    static_cast<void>( core );
+    return false;
+    #endif
+}
+
+// Constructor of Sensor
+MultiUserSource::Sensor::Sensor( std::unique_ptr<UserSource> source, const uint32_t capacity )
+    : source( std::move( source ) ),
+      frame_pool( capacity, []( UserFrame& frame ){ frame.release(); } ),
+      frames( 0 )
+{
+    requests.reserve( USER_COUNT * ( 1 + POSE_COUNT ) );
+    pending.reserve( USER_COUNT * ( 1 + POSE_COUNT ) );
+}
+
+// Constructor
+MultiUserSource::MultiUserSource( std::vector<std::unique_ptr<UserSource>> sources, const bool pin )
+    : ring( SENSOR_RING_SIZE * static_cast<uint32_t>( std::max<size_t>( sources.size(), 1 ) ) ),
+      running( true ),
+      active( static_cast<uint32_t>( sources.size() ) )
+{
+    if( sources.empty() ){
+        throw std::runtime_error( "failed multi source has no sensors" );
+    }
+    if( SENSOR_COUNT < sources.size() ){
+        throw std::runtime_error( "failed multi source has too many sensors" );
+    }
+
+    // Create Sensors (Pool holds frames in merged ring, capture and consumer)
+    const uint32_t capacity = SENSOR_RING_SIZE * static_cast<uint32_t>( sources.size() ) + 2;
+    for( std::unique_ptr<UserSource>& source : sources ){
+        if( !source ){
+            throw std::runtime_error( "failed multi source has invalid source" );
+        }
+        sensors.emplace_back( new Sensor( std::move( source ), capacity ) );
+    }
+
+    // Reserve Buffers of Sources (Before capture threads start)
+    reserveFrames( SENSOR_CONSUMER_FRAMES );
+
+    // Start Capture Threads (Pinned to Cores, Round-Robin)
+    const uint32_t cores = std::max( std::thread::hardware_concurrency(), 1u );
+    for( uint32_t index = 0; index < sensors.size(); index++ ){
+        Sensor& sensor = *sensors[index];
+        sensor.thread = std::thread( &MultiUserSource::capture, this, index );
+        if( pin ){
+            sensor.pinned = pinThread( sensor.thread, index % cores );
+        }
+    }
+}
+
+// Destructor
+MultiUserSource::~MultiUserSource()
+{
+    // Stop Capture Threads
+    stop();
+    for( std::unique_ptr<Sensor>& sensor : sensors ){
+        if( sensor->thread.joinable() ){
+            sensor->thread.join();
+        }
+    }
+
+    // Release Frames in Merged Ring (before frame pools of sensors)
+    FrameHandle<UserFrame> frame;
+    while( ring.pop( frame ) ){
+        frame.reset();
+    }
+}
+
+// Read Frame
+void MultiUserSource::readFrame( UserFrame& frame )
+{
+    // Retrieve Next Frame of Any Sensor
+    FrameHandle<UserFrame> merged;
+    if( !ring.pop( merged ) ){
+        std::lock_guard<std::mutex> lock( exception_mutex );
+        if( exception ){
+            std::rethrow_exception( exception );
+        }
+        throw EndOfSource( "end of multi source" );
+    }
+
+    // Copy Frame (Share pixels and frame references)
+    const UserFrame& source = *merged;
+    frame.depth_mat = source.depth_mat;
+    frame.user_map = source.user_map;
+    frame.users = source.users;
+    frame.skeleton = source.skeleton;
+    frame.intrinsics = source.intrinsics;
+    frame.sensor_timestamp = source.sensor_timestamp;
+    frame.frame_index = source.frame_index;
+    frame.sensor = source.sensor;
+    frame.timestamp = source.timestamp;
+    frame.user_frame = source.user_frame;
+    frame.depth_frame = source.depth_frame;
+    frame.depth_buffer = source.depth_buffer;
+    frame.user_buffer = source.user_buffer;
+
+    // Route Tracker Control to Sensor of Frame
+    current = source.sensor;
+    intrinsics = source.intrinsics;
+}
+
+// Start Skeleton Tracking
+nite::Status MultiUserSource::startSkeletonTracking( const nite::UserId id )
+{
+    Sensor& sensor = *sensors[current];
+    std::lock_guard<std::mutex> lock( sensor.request_mutex );
+    sensor.requests.push_back( Request{ false, id, nite::PoseType::POSE_PSI } );
+    return nite::Status::STATUS_OK;
+}
+
+// Start Pose Detection
+nite::Status MultiUserSource::startPoseDetection( const nite::UserId id, const nite::PoseType type )
+{
+    Sensor& sensor = *sensors[current];
+    std::lock_guard<std::mutex> lock( sensor.request_mutex );
+    sensor.requests.push_back( Request{ true, id, type } );
+    return nite::Status::STATUS_OK;
+}
+
+// Convert Joint Coordinates to Depth
+nite::Status MultiUserSource::convertJointCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY )
+{
+    // Pinhole Projection
+    return projectPoint( intrinsics, x, y, z, pOutX, pOutY ) ? nite::Status::STATUS_OK : nite::Status::STATUS_ERROR;
+}
+
+// Retrieve Number of Sensors
+uint32_t MultiUserSource::sensorCount() const
+{
+    return static_cast<uint32_t>( sensors.size() );
+}
+
+// Reserve Pooled Buffers for Frames in Flight
+void MultiUserSource::reserveFrames( const uint32_t frames )
+{
+    // A sensor may hold all frames of merged ring
+    const uint32_t flight = SENSOR_RING_SIZE * static_cast<uint32_t>( sensors.size() ) + 1 + frames;
+    for( std::unique_ptr<Sensor>& sensor : sensors ){
+        sensor->source->reserveFrames( flight );
+    }
+}
+
+// Retrieve Number of Captured Frames of Sensor
+uint64_t MultiUserSource::capturedFrames( const uint32_t sensor ) const
+{
+    return sensors.at( sensor )->frames.load( std::memory_order_relaxed );
+}
+
+// Retrieve Number of Frames Dropped from Merged Ring
+uint64_t MultiUserSource::droppedFrames() const
+{
+    return ring.drops();
+}
+
+// Retrieve Whether Capture Thread of Sensor is Pinned to a Core
+bool MultiUserSource::isPinned( const uint32_t sensor ) const
+{
+    return sensors.at( sensor )->pinned;
+}
+
+// Capture Thread
+void MultiUserSource::capture( const uint32_t index )
+{
+    Sensor& sensor = *sensors[index];
+    try{
+        while( running ){
+            // Run Tracker Control Requests (Queued since last frame)
+            {
+                std::lock_guard<std::mutex> lock( sensor.request_mutex );
+                std::swap( sensor.requests, sensor.pending );
+            }
+            for( const Request& request : sensor.pending ){
+                if( request.pose ){
+                    sensor.source->startPoseDetection( request.id, request.type );
+                }
+                else{
+                    sensor.source->startSkeletonTracking( request.id );
+                }
+            }
+            sensor.pending.clear();
+
+            // Read Frame (into Pooled Frame)
+            FrameHandle<UserFrame> frame = sensor.frame_pool.acquire();
+            sensor.source->readFrame( *frame );
+            frame->sensor = index;
+            sensor.frames.fetch_add( 1, std::memory_order_relaxed );
+
+            // Push Frame (Stamp capture time under merge lock)
+            std::lock_guard<std::mutex> lock( merge_mutex );
+            frame->timestamp = std::chrono::steady_clock::now();
+            ring.push( std::move( frame ) );
+        }
+    } catch( const EndOfSource& ){
+        // Close merged ring after the last source ended
+        if( active.fetch_sub( 1 ) == 1 ){
+            stop();
+        }
+    } catch( ... ){
+        stop( std::current_exception() );
+    }
+}
+
+// Stop Capture Threads
+void MultiUserSource::stop( const std::exception_ptr& error )
+{
+    // Keep First Exception
+    if( error ){
+        std::lock_guard<std::mutex> lock( exception_mutex );
+        if( !exception ){
+            exception = error;
+        }
+    }
+
+    // Close Merged Ring
+    running = false;
+    ring.close();
+}
+
+// Parse Multi Source URI
+bool parseMultiUri( const std::string& uri, std::vector<std::string>& uris )
+{
+    const std::string multi = "multi:";
+    if( uri.compare( 0, multi.size(), multi ) != 0 ){
+        return false;
+    }
+
+    uris.clear();
+    const std::string list = uri.substr( multi.size() );
+
+    // All Connected Devices
+    if( list.empty() ){
+        uris = enumerateDevices();
+        if( uris.empty() ){
+            throw std::runtime_error( "failed could not find devices" );
+        }
+        return true;
+    }
+
+    // Repeated Source
+    uint32_t count = 0;
+    int32_t consumed = 0;
+    if( std::sscanf( list.c_str(), "%u*%n", &count, &consumed ) == 1 && 0 < consumed ){
+        uris.assign( count, list.substr( consumed ) );
+    }
+    // Listed Sources
+    else{
+        size_t begin = 0;
+        while( begin <= list.size() ){
+            const size_t end = std::min( list.find( ',', begin ), list.size() );
+            uris.push_back( list.substr( begin, end - begin ) );
+            begin = end + 1;
+        }
+    }
+
+    for( const std::string& sensor_uri : uris ){
+        if( sensor_uri.compare( 0, multi.size(), multi ) == 0 ){
+            throw std::runtime_error( "failed multi source can not contain multi source" );
+        }
+    }
+    if( uris.empty() || SENSOR_COUNT < uris.size() ){
+        throw std::runtime_error( "failed invalid number of sensors of multi source" );
+    }
+    return true;
+}
@@ -0,0 +1,138 @@
+#ifndef __MULTI_SOURCE__
+#define __MULTI_SOURCE__
+
+#include <NiTE.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frame_pool.h"
+#include "projection.h"
+#include "ring.h"
+#include "user_source.h"
+
+// Maximum Number of Sensors of Multi Source
+#define SENSOR_COUNT 8
+
+// Merged Frames per Sensor (The oldest frame is dropped when full)
+#define SENSOR_RING_SIZE 2
+
+// Frames Held by Consumer of Merged Stream (Frame pool of pipeline)
+#define SENSOR_CONSUMER_FRAMES 4
+
+// Pin Thread to Core (Best effort, return false if not supported or failed)
+bool pinThread( std::thread& thread, const uint32_t core );
+
+// Frame Source from Multiple Sensors (One Tracker and Pinned Capture Thread per Sensor, Merged in Order of Capture Time)
+// Tracker control is queued to the sensor of the last read frame, and runs on its capture thread (one consumer thread only).
+class MultiUserSource : public UserSource
+{
+private:
+    // Tracker Control Request
+    struct Request
+    {
+        bool pose;
+        nite::UserId id;
+        nite::PoseType type;
+    };
+
+    // Sensor
+    struct Sensor
+    {
+        // Source (Owned by Capture Thread)
+        std::unique_ptr<UserSource> source;
+
+        // Frame Pool (Frames stay in merged ring until consumer copied them)
+        FramePool<UserFrame> frame_pool;
+
+        // Tracker Control Requests (Queued by Consumer, Run by Capture Thread)
+        std::mutex request_mutex;
+        std::vector<Request> requests;
+        std::vector<Request> pending; // Owned by Capture Thread
+
+        // Capture Thread
+        std::thread thread;
+        bool pinned = false;
+
+        // Number of Captured Frames
+        std::atomic<uint64_t> frames;
+
+        // Constructor
+        Sensor( std::unique_ptr<UserSource> source, const uint32_t capacity );
+    };
+
+    std::vector<std::unique_ptr<Sensor>> sensors;
+
+    // Merged Ring (Destroyed before frame pools of sensors)
+    Ring<FrameHandle<UserFrame>> ring;
+    std::mutex merge_mutex;
+
+    // Status
+    std::atomic<bool> running;
+    std::atomic<uint32_t> active;
+    std::exception_ptr exception;
+    std::mutex exception_mutex;
+
+    // Sensor and Intrinsics of Last Read Frame (Owned by Consumer)
+    uint32_t current = 0;
+    Intrinsics intrinsics;
+
+public:
+    // Constructor (Start capture threads, pin them to cores if pin is true)
+    explicit MultiUserSource( std::vector<std::unique_ptr<UserSource>> sources, const bool pin = true );
+
+    // Destructor (Stop and join capture threads)
+    ~MultiUserSource();
+
+    MultiUserSource( const MultiUserSource& ) = delete;
+    MultiUserSource& operator=( const MultiUserSource& ) = delete;
+
+    // Read Frame (Block until the next frame of any sensor is available)
+    void readFrame( UserFrame& frame ) override;
+
+    // Start Skeleton Tracking (Queued to sensor of last read frame)
+    nite::Status startSkeletonTracking( const nite::UserId id ) override;
+
+    // Start Pose Detection (Queued to sensor of last read frame)
+    nite::Status startPoseDetection( const nite::UserId id, const nite::PoseType type ) override;
+
+    // Convert Joint Coordinates to Depth (Intrinsics of last read frame)
+    nite::Status convertJointCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY ) override;
+
+    // Retrieve Number of Sensors
+    uint32_t sensorCount() const override;
+
+    // Reserve Pooled Buffers for Frames in Flight
+    void reserveFrames( const uint32_t frames ) override;
+
+    // Retrieve Number of Captured Frames of Sensor
+    uint64_t capturedFrames( const uint32_t sensor ) const;
+
+    // Retrieve Number of Frames Dropped from Merged Ring
+    uint64_t droppedFrames() const;
+
+    // Retrieve Whether Capture Thread of Sensor is Pinned to a Core
+    bool isPinned( const uint32_t sensor ) const;
+
+private:
+    // Capture Thread
+    void capture( const uint32_t index );
+
+    // Stop Capture Threads
+    void stop( const std::exception_ptr& error = nullptr );
+};
+
+// Parse Multi Source URI (Return false if uri is not a multi source)
+// "multi:"                   : All connected devices
+// "multi:URI,URI,..."        : Listed sources (except multi)
+// "multi:COUNT*URI"          : COUNT sources of the same uri (e.g. "multi:4*synthetic:320x240@30:2")
+bool parseMultiUri( const std::string& uri, std::vector<std::string>& uris );
+
+#endif // __MULTI_SOURCE__
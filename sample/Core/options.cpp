@@ -0,0 +1,63 @@
+#include "options.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+// Constructor
+Options::Options( const int argc, char* argv[], const size_t positional_count, const std::vector<std::string>& names )
+{
+    const std::string prefix = "--";
+    for( int32_t index = 1; index < argc; index++ ){
+        const std::string argument = argv[index];
+
+        // Positional Argument
+        if( argument.compare( 0, prefix.size(), prefix ) != 0 ){
+            if( positional_count <= positionals.size() ){
+                throw std::runtime_error( "failed unexpected argument " + argument );
+            }
+            positionals.push_back( argument );
+            continue;
+        }
+
+        // Named Option ("--NAME VALUE" or "--NAME=VALUE")
+        const size_t separator = argument.find( '=' );
+        const std::string name = argument.substr( prefix.size(), separator - prefix.size() );
+        if( std::find( names.begin(), names.end(), name ) == names.end() ){
+            std::string known;
+            for( const std::string& option : names ){
+                known += ( known.empty() ? "--" : ", --" ) + option;
+            }
+            throw std::runtime_error( "failed unknown option --" + name + " (" + known + ")" );
+        }
+
+        if( separator != std::string::npos ){
+            values[name] = argument.substr( separator + 1 );
+        }
+        else if( index + 1 < argc ){
+            values[name] = argv[++index];
+        }
+        else{
+            throw std::runtime_error( "failed missing value of --" + name );
+        }
+    }
+}
+
+// Retrieve Positional Argument
+std::string Options::positional( const size_t index, const std::string& default_value ) const
+{
+    return ( index < positionals.size() ) ? positionals[index] : default_value;
+}
+
+// Retrieve Option
+std::string Options::get( const std::string& name, const std::string& default_value ) const
+{
+    const std::map<std::string, std::string>::const_iterator value = values.find( name );
+    return ( value != values.end() ) ? value->second : default_value;
+}
+
+// Retrieve Whether Option is Given
+bool Options::has( const std::string& name ) const
+{
+    return values.find( name ) != values.end();
+}
@@ -0,0 +1,33 @@
+#ifndef __OPTIONS__
+#define __OPTIONS__
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+// Command Line Options (Positional arguments, then "--NAME VALUE" or "--NAME=VALUE")
+class Options
+{
+private:
+    // Positional Arguments
+    std::vector<std::string> positionals;
+
+    // Named Options
+    std::map<std::string, std::string> values;
+
+public:
+    // Constructor (Throw on unknown option, missing value or extra positional argument)
+    Options( const int argc, char* argv[], const size_t positional_count, const std::vector<std::string>& names );
+
+    // Retrieve Positional Argument
+    std::string positional( const size_t index, const std::string& default_value = "" ) const;
+
+    // Retrieve Option
+    std::string get( const std::string& name, const std::string& default_value = "none" ) const;
+
+    // Retrieve Whether Option is Given
+    bool has( const std::string& name ) const;
+};
+
+#endif // __OPTIONS__
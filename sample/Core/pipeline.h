@@ -0,0 +1,481 @@
+#ifndef __PIPELINE__
+#define __PIPELINE__
+
+#include <opencv2/opencv.hpp>
+
+#include "benchmark.h"
+#include "event_bus.h"
+#include "frame_pool.h"
+#include "kernel.h"
+#include "publisher.h"
+#include "ring.h"
+#include "session.h"
+#include "shared_frame.h"
+#include "shutdown.h"
+#include "sink.h"
+#include "telemetry.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#define RING_SIZE 2
+#define COLOR_COUNT 6
+
+// Number of Pooled Frames and Images (Capture/Process Stage, Ring and Display/Spare)
+#define POOL_SIZE ( RING_SIZE + 2 )
+
+// Drawn Image
+struct Image
+{
+    cv::Mat mat;
+    std::chrono::steady_clock::time_point timestamp;
+    ImageHandle buffer; // Pooled Buffer of mat
+};
+
+// Capture, Process and Display Pipeline
+// update() runs on capture thread, draw() on process thread and show() on main thread.
+template<typename SourceType, typename FrameType>
+class Pipeline
+{
+protected:
+    // Source
+    std::unique_ptr<SourceType> source;
+
+    // Depth Visualization Kernel
+    DepthKernel depth_kernel;
+
+    // Frame and Image Pools (Outlive handles below)
+    FramePool<FrameType> frame_pool;
+    ImagePool image_pool;
+
+    // Frame Buffer
+    FrameHandle<FrameType> capture_frame; // Owned by Capture Thread
+    FrameHandle<FrameType> frame;         // Owned by Process Thread
+    cv::Mat draw_mat;                     // Owned by Process Thread
+    ImageHandle draw_buffer;              // Owned by Process Thread
+    Image image;                          // Owned by Main Thread
+
+    // Color Table for Visualization
+    std::array<cv::Vec3b, COLOR_COUNT> colors;
+
+    // Depth Buffer
+    cv::Mat depth_mat;
+    uint32_t depth_width = 640;
+    uint32_t depth_height = 480;
+    uint32_t depth_fps = 30;
+
+private:
+    // Pipeline
+    Ring<FrameHandle<FrameType>> frame_ring;
+    Ring<Image> image_ring;
+    std::atomic<bool> running;
+    std::exception_ptr exception;
+    std::mutex exception_mutex;
+
+    // Headless Record Buffer
+    RecordStream record;
+
+    // Telemetry (Optional, Outlives Pipeline)
+    Telemetry* telemetry = nullptr;
+
+    // Event Emitter (Optional, Owned by Capture Thread, Bus Outlives Processing)
+    std::unique_ptr<EventEmitter> events;
+
+    // Shared Frame Writer (Optional, Used by Capture Thread, Outlives Processing)
+    SharedFrameWriter* shared_writer = nullptr;
+
+    // Stream Publisher (Optional, Used by Capture Thread, Outlives Processing)
+    StreamPublisher* publisher = nullptr;
+
+    // HighGUI Window is Opened
+    bool windows = false;
+
+public:
+    // Constructor
+    Pipeline( std::unique_ptr<SourceType> source, const DepthKernel depth_kernel )
+        : source( std::move( source ) ),
+          depth_kernel( depth_kernel ),
+          frame_pool( POOL_SIZE, []( FrameType& frame ){ frame.release(); } ),
+          image_pool( POOL_SIZE ),
+          frame_ring( RING_SIZE ),
+          image_ring( RING_SIZE ),
+          running( false )
+    {
+        cv::setUseOptimized( true );
+
+        // Initalize Color Table for Visualization
+        colors[0] = cv::Vec3b( 255,   0,   0 ); // Blue
+        colors[1] = cv::Vec3b(   0, 255,   0 ); // Green
+        colors[2] = cv::Vec3b(   0,   0, 255 ); // Red
+        colors[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
+        colors[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
+        colors[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
+
+        // Allocate Image Buffers of Default Depth Mode (Reserved again on mode change)
+        image_pool.reserve( depth_height, depth_width, CV_8UC3 );
+    }
+
+    // Destructor
+    virtual ~Pipeline()
+    {
+        // Close Windows
+        if( windows ){
+            cv::destroyAllWindows();
+        }
+    }
+
+    // Set Telemetry (nullptr: Disable, set before processing)
+    void setTelemetry( Telemetry* telemetry )
+    {
+        this->telemetry = telemetry;
+    }
+
+    // Set Event Bus (nullptr: Disable, set before processing)
+    void setEventBus( EventBus* bus )
+    {
+        events.reset( bus ? new EventEmitter( *bus ) : nullptr );
+    }
+
+    // Set Shared Frame Writer (nullptr: Disable, set before processing)
+    void setSharedFrameWriter( SharedFrameWriter* writer )
+    {
+        shared_writer = writer;
+    }
+
+    // Set Stream Publisher (nullptr: Disable, set before processing)
+    void setStreamPublisher( StreamPublisher* publisher )
+    {
+        this->publisher = publisher;
+    }
+
+    // Processing
+    void run()
+    {
+        // Run Pipeline
+        loop( nullptr, 0, true );
+    }
+
+    // Benchmark (Serial: Time of Each Stage, Pipeline: Throughput and Latency)
+    void benchmark( Benchmark& benchmark, const uint32_t frames, const bool pipeline, const bool display )
+    {
+        benchmark.begin( frames );
+
+        // Run Pipeline
+        if( pipeline ){
+            benchmark.finish( loop( &benchmark, frames, display ) );
+            return;
+        }
+
+        // Run Stages Serially (Mark boundary of frames for allocation counting)
+        benchmark.markFrame();
+        uint32_t count = 0;
+        for( ; count < frames; count++ ){
+            // Update Data (until End of Source)
+            try{
+                measure( &benchmark, STAGE_UPDATE, [this]{ capture_frame = frame_pool.acquire(); update(); emitEvents(); publishFrame(); } );
+            } catch( const EndOfSource& ){
+                break;
+            }
+            capture_frame->timestamp = std::chrono::steady_clock::now();
+            frame = std::move( capture_frame );
+
+            // Draw Data
+            measure( &benchmark, STAGE_DRAW, [this]{ updateDepth(); acquireDrawBuffer(); draw(); } );
+            image = Image{ draw_mat, frame->timestamp, std::move( draw_buffer ) };
+            draw_mat.release();
+            recordLatency( TELEMETRY_OUTPUT_LATENCY, image.timestamp );
+
+            // Show Data
+            if( display ){
+                measure( &benchmark, STAGE_SHOW, [this]{ show(); cv::waitKey( 1 ); } );
+                windows = true;
+                recordLatency( TELEMETRY_DISPLAY_AGE, image.timestamp );
+            }
+
+            benchmark.markFrame();
+        }
+
+        benchmark.finish( count );
+    }
+
+    // Headless Processing (Write each frame to sink until shutdown, end of source or frames, Return Number of Written Frames)
+    uint32_t headless( Sink& sink, Benchmark* benchmark = nullptr, const uint32_t frames = 0 )
+    {
+        installShutdownHandler();
+
+        // Write bool as JSON Literal (true/false)
+        record << std::boolalpha;
+
+        if( benchmark ){
+            benchmark->markFrame();
+        }
+
+        uint32_t count = 0;
+        while( !isShutdownRequested() && ( !frames || count < frames ) ){
+            // Update Data (until End of Source)
+            try{
+                measure( benchmark, STAGE_UPDATE, [this]{ capture_frame = frame_pool.acquire(); update(); emitEvents(); publishFrame(); } );
+            } catch( const EndOfSource& ){
+                break;
+            }
+            capture_frame->timestamp = std::chrono::steady_clock::now();
+            frame = std::move( capture_frame );
+
+            // Write Data
+            measure( benchmark, STAGE_WRITE, [this, &sink]{
+                record.reset();
+                write( record );
+                sink.write( record.str() );
+            } );
+            recordLatency( TELEMETRY_OUTPUT_LATENCY, frame->timestamp );
+
+            if( benchmark ){
+                benchmark->markFrame();
+            }
+            count++;
+        }
+
+        return count;
+    }
+
+protected:
+    // Update Data (Capture Thread)
+    virtual void update() = 0;
+
+    // Draw Data (Process Thread)
+    virtual void draw() = 0;
+
+    // Show Data (Main Thread)
+    virtual void show() = 0;
+
+    // Write Data as Record (Headless Mode, text records end with a new line)
+    virtual void write( std::ostream& stream ) = 0;
+
+    // Update Depth
+    inline void updateDepth()
+    {
+        // Retrieve Frame
+        if( frame->depth_mat.empty() ){
+            throw std::runtime_error( "failed can not retrieve depth frame" );
+        }
+
+        // Retrive Frame Size (Reallocate image buffers on mode change)
+        const uint32_t width = frame->depth_mat.cols;
+        const uint32_t height = frame->depth_mat.rows;
+        if( width != depth_width || height != depth_height ){
+            depth_width = width;
+            depth_height = height;
+            image_pool.reserve( depth_height, depth_width, CV_8UC3 );
+        }
+    }
+
+    // Draw Depth
+    inline void drawDepth()
+    {
+        // Retrieve cv::Mat form Depth Frame
+        depth_mat = frame->depth_mat;
+    }
+
+    // Read Frame from Source into capture_frame
+    inline void readFrame()
+    {
+        if( !telemetry ){
+            source->readFrame( *capture_frame );
+            return;
+        }
+
+        const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+        source->readFrame( *capture_frame );
+        const std::chrono::steady_clock::time_point output = std::chrono::steady_clock::now();
+        telemetry->record( TELEMETRY_READ, output - time );
+        telemetry->recordFrame( capture_frame->sensor, capture_frame->frame_index, capture_frame->sensor_timestamp, output );
+    }
+
+    // Emit Events of capture_frame
+    inline void emitEvents()
+    {
+        if( events ){
+            events->emit( *capture_frame );
+        }
+    }
+
+    // Publish capture_frame to Shared Memory and Subscribers
+    inline void publishFrame()
+    {
+        if( shared_writer ){
+            publishSharedFrame( *shared_writer, *capture_frame );
+        }
+        if( publisher ){
+            publishStream( *publisher, *capture_frame );
+        }
+    }
+
+    // Acquire Draw Buffer (Pooled BGR image of depth size)
+    inline void acquireDrawBuffer()
+    {
+        draw_buffer = image_pool.acquire( depth_height, depth_width, CV_8UC3 );
+        draw_mat = *draw_buffer;
+    }
+
+private:
+    // Measure Function (if Benchmark or Telemetry is given)
+    template<typename Function>
+    void measure( Benchmark* benchmark, const Stage stage, Function function )
+    {
+        if( !benchmark && !telemetry ){
+            function();
+            return;
+        }
+
+        const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+        function();
+        const std::chrono::steady_clock::duration duration = std::chrono::steady_clock::now() - time;
+        if( benchmark ){
+            benchmark->record( stage, duration );
+        }
+        if( telemetry ){
+            telemetry->record( static_cast<TelemetryHistogram>( TELEMETRY_UPDATE + stage ), duration );
+        }
+    }
+
+    // Record Latency since Capture Time to Telemetry
+    inline void recordLatency( const TelemetryHistogram histogram, const std::chrono::steady_clock::time_point& timestamp )
+    {
+        if( telemetry ){
+            telemetry->record( histogram, std::chrono::steady_clock::now() - timestamp );
+        }
+    }
+
+    // Record Depth and Drops of Rings to Telemetry
+    inline void recordQueues()
+    {
+        if( telemetry ){
+            telemetry->recordQueue( TELEMETRY_FRAME_QUEUE, frame_ring.size(), frame_ring.drops() );
+            telemetry->recordQueue( TELEMETRY_IMAGE_QUEUE, image_ring.size(), image_ring.drops() );
+        }
+    }
+
+    // Run Pipeline (Return Number of Shown Frames)
+    uint32_t loop( Benchmark* benchmark, const uint32_t frames, const bool display )
+    {
+        // Start Pipeline
+        running = true;
+        std::thread capture_thread( &Pipeline::capture, this );
+        std::thread process_thread( &Pipeline::process, this );
+
+        // Main Loop
+        uint32_t count = 0;
+        try{
+            while( running ){
+                // Retrieve Image
+                if( image_ring.pop( image, std::chrono::milliseconds( 10 ) ) ){
+                    // Show Data
+                    if( display ){
+                        measure( nullptr, STAGE_SHOW, [this]{ show(); } );
+                        windows = true;
+                        recordLatency( TELEMETRY_DISPLAY_AGE, image.timestamp );
+                    }
+
+                    // Record Latency
+                    count++;
+                    if( benchmark ){
+                        benchmark->record( STAGE_LATENCY, std::chrono::steady_clock::now() - image.timestamp );
+                        benchmark->markFrame();
+                        if( count == frames ){
+                            break;
+                        }
+                    }
+                }
+
+                // Key Check
+                if( display ){
+                    const int32_t key = cv::waitKey( 1 );
+                    if( key == 'q' ){
+                        break;
+                    }
+                }
+            }
+        } catch( ... ){
+            stop( std::current_exception() );
+        }
+
+        // Stop Pipeline
+        stop();
+        capture_thread.join();
+        process_thread.join();
+
+        // Rethrow Exception from Pipeline
+        if( exception ){
+            std::rethrow_exception( exception );
+        }
+
+        return count;
+    }
+
+    // Capture Thread
+    void capture()
+    {
+        try{
+            while( running ){
+                // Update Data (into Pooled Frame)
+                measure( nullptr, STAGE_UPDATE, [this]{ capture_frame = frame_pool.acquire(); update(); emitEvents(); publishFrame(); } );
+
+                // Push Frame
+                capture_frame->timestamp = std::chrono::steady_clock::now();
+                frame_ring.push( std::move( capture_frame ) );
+                recordQueues();
+            }
+        } catch( const EndOfSource& ){
+            stop();
+        } catch( ... ){
+            stop( std::current_exception() );
+        }
+    }
+
+    // Process Thread
+    void process()
+    {
+        try{
+            while( frame_ring.pop( frame ) ){
+                // Update Depth and Draw Data
+                measure( nullptr, STAGE_DRAW, [this]{ updateDepth(); acquireDrawBuffer(); draw(); } );
+
+                // Push Image
+                image_ring.push( Image{ draw_mat, frame->timestamp, std::move( draw_buffer ) } );
+                recordLatency( TELEMETRY_OUTPUT_LATENCY, frame->timestamp );
+                recordQueues();
+
+                // Release Image (Owned by Display Stage)
+                draw_mat.release();
+            }
+        } catch( ... ){
+            stop( std::current_exception() );
+        }
+    }
+
+    // Stop Pipeline
+    void stop( const std::exception_ptr& error = nullptr )
+    {
+        // Keep First Exception
+        if( error ){
+            std::lock_guard<std::mutex> lock( exception_mutex );
+            if( !exception ){
+                exception = error;
+            }
+        }
+
+        // Close Rings
+        running = false;
+        frame_ring.close();
+        image_ring.close();
+    }
+};
+
+#endif // __PIPELINE__
@@ -0,0 +1,439 @@
+#include "point_cloud.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define POINT_CLOUD_SSE
+#include <emmintrin.h>
+#endif
+
+// Initial Number of Points of User Cloud and Entries of Voxel Table
+#define POINT_CLOUD_INITIAL_POINTS 4096
+
+// Reserved Buffers per Depth Size (Users, and points of each user as fraction of depth pixels)
+#define POINT_CLOUD_RESERVED_USERS 6
+#define POINT_CLOUD_RESERVED_FRACTION 4
+
+// Voxel Key (Slot 10 bits, Voxel Index 18 bits x 3, +-131072 voxels around the sensor)
+#define VOXEL_INDEX_BITS 18
+#define VOXEL_INDEX_OFFSET ( 1 << ( VOXEL_INDEX_BITS - 1 ) )
+#define VOXEL_INDEX_MAX ( ( 1 << VOXEL_INDEX_BITS ) - 1 )
+
+// Parse Cloud Format
+CloudFormat parseCloudFormat( const std::string& name, float& voxel_size )
+{
+    // Voxel Size (Optional)
+    const size_t separator = name.find( ':' );
+    const std::string format = name.substr( 0, separator );
+    voxel_size = 0.0f;
+    if( separator != std::string::npos ){
+        char* end = nullptr;
+        voxel_size = std::strtof( name.c_str() + separator + 1, &end );
+        if( separator + 1 == name.size() || *end != '\0' || voxel_size < 0.0f ){
+            throw std::runtime_error( "failed invalid voxel size of " + name );
+        }
+    }
+
+    if( format == "cloud" ){
+        return CLOUD_FORMAT_BINARY;
+    }
+    if( format == "ply" ){
+        return CLOUD_FORMAT_PLY;
+    }
+
+    throw std::runtime_error( "failed unknown cloud format " + name + " (cloud[:VOXEL] or ply[:VOXEL])" );
+}
+
+// Retrieve Cloud Format Name
+const char* cloudFormatName( const CloudFormat format )
+{
+    switch( format ){
+        case CLOUD_FORMAT_BINARY:
+            return "cloud";
+        case CLOUD_FORMAT_PLY:
+            return "ply";
+        default:
+            return "unknown";
+    }
+}
+
+// Grow Point Arrays of User Cloud (Keep Points)
+static inline void grow( UserCloud& cloud )
+{
+    const size_t size = std::max<size_t>( cloud.x.size() * 2, POINT_CLOUD_INITIAL_POINTS );
+    cloud.x.resize( size );
+    cloud.y.resize( size );
+    cloud.z.resize( size );
+}
+
+// Add Point to User Cloud
+static inline void append( UserCloud& cloud, const float x, const float y, const float z )
+{
+    if( cloud.size == cloud.x.size() ){
+        grow( cloud );
+    }
+    cloud.x[cloud.size] = x;
+    cloud.y[cloud.size] = y;
+    cloud.z[cloud.size] = z;
+    cloud.size++;
+}
+
+// Voxel Index of Coordinate (Truncation of positive value is floor)
+static inline uint64_t voxelIndex( const float value, const float inverse )
+{
+    const float index = std::min( std::max( value * inverse + VOXEL_INDEX_OFFSET, 0.0f ), static_cast<float>( VOXEL_INDEX_MAX ) );
+    return static_cast<uint64_t>( index );
+}
+
+// Hash of Voxel Key (Fibonacci Hashing)
+static inline size_t voxelHash( const uint64_t key, const size_t mask )
+{
+    return static_cast<size_t>( ( key * 0x9E3779B97F4A7C15ull ) >> 32 ) & mask;
+}
+
+// Constructor
+UserCloudBuilder::UserCloudBuilder( const float voxel_size )
+    : voxel_size( voxel_size ),
+      voxel_inverse( ( 0.0f < voxel_size ) ? 1.0f / voxel_size : 0.0f )
+{
+    if( voxel_size < 0.0f ){
+        throw std::runtime_error( "failed invalid voxel size" );
+    }
+}
+
+// Build Point Clouds of Users
+void UserCloudBuilder::build( const cv::Mat& depth_mat, const cv::Mat& user_map, const Intrinsics& intrinsics )
+{
+    if( depth_mat.type() != CV_16UC1 || user_map.type() != CV_16UC1 || depth_mat.size() != user_map.size() ){
+        throw std::runtime_error( "failed depth and user map don't match" );
+    }
+    if( intrinsics.focal_x == 0.0f || intrinsics.focal_y == 0.0f ){
+        throw std::runtime_error( "failed invalid intrinsics" );
+    }
+
+    const uint32_t width = depth_mat.cols;
+    const uint32_t height = depth_mat.rows;
+
+    // Column Factor (Once per Depth Size and Intrinsics)
+    if( columns.size() != width || std::memcmp( &column_intrinsics, &intrinsics, sizeof( Intrinsics ) ) != 0 ){
+        columns.resize( width );
+        for( uint32_t u = 0; u < width; u++ ){
+            columns[u] = ( static_cast<float>( u ) - intrinsics.center_x ) / intrinsics.focal_x;
+        }
+        column_intrinsics = intrinsics;
+    }
+
+    // Reserve Buffers (Once per Depth Size)
+    if( reserved_pixels != width * height ){
+        reserve( width * height );
+    }
+
+    // Reset Clouds and Voxels (Keep Buffers)
+    for( UserCloud& cloud : clouds ){
+        cloud.size = 0;
+    }
+    cloud_count = 0;
+
+    const bool downsample = ( 0.0f < voxel_size );
+    if( downsample ){
+        voxels.clear();
+        last_voxel = UINT32_MAX;
+        if( ++voxel_stamp == 0 ){
+            for( VoxelEntry& entry : voxel_table ){
+                entry.stamp = 0;
+            }
+            voxel_stamp = 1;
+        }
+    }
+
+    // One Pass over Frame
+    uint16_t last_label = 0;
+    uint32_t last_slot = 0;
+    for( uint32_t v = 0; v < height; v++ ){
+        const uint16_t* depth = depth_mat.ptr<uint16_t>( v );
+        const uint16_t* labels = user_map.ptr<uint16_t>( v );
+        const float factor = ( static_cast<float>( v ) - intrinsics.center_y ) / intrinsics.focal_y;
+
+        // Add Pixel
+        const auto add = [&]( const uint32_t u ){
+            const uint16_t label = labels[u];
+            if( !label || !depth[u] ){
+                return;
+            }
+            if( label != last_label ){
+                last_slot = slot( label );
+                last_label = label;
+            }
+
+            const float z = static_cast<float>( depth[u] );
+            if( downsample ){
+                accumulate( last_slot, z * columns[u], z * factor, z );
+            }
+            else{
+                append( clouds[last_slot], z * columns[u], z * factor, z );
+            }
+        };
+
+        uint32_t u = 0;
+        for( ; u + 8 <= width; u += 8 ){
+            #if defined( POINT_CLOUD_SSE )
+            // Skip Background (8 Pixels)
+            const __m128i block = _mm_loadu_si128( reinterpret_cast<const __m128i*>( labels + u ) );
+            if( _mm_movemask_epi8( _mm_cmpeq_epi16( block, _mm_setzero_si128() ) ) == 0xFFFF ){
+                continue;
+            }
+            #endif
+            for( uint32_t i = u; i < u + 8; i++ ){
+                add( i );
+            }
+        }
+        for( ; u < width; u++ ){
+            add( u );
+        }
+    }
+
+    // Centroid of Voxels (Order of First Point)
+    if( downsample ){
+        for( const Voxel& voxel : voxels ){
+            const float inverse = 1.0f / voxel.count;
+            append( clouds[voxel.slot], voxel.x * inverse, voxel.y * inverse, voxel.z * inverse );
+        }
+    }
+}
+
+// Retrieve Number of Users
+size_t UserCloudBuilder::size() const
+{
+    return cloud_count;
+}
+
+// Retrieve Point Cloud of User
+const UserCloud& UserCloudBuilder::operator[]( const size_t index ) const
+{
+    return clouds[index];
+}
+
+// Retrieve Number of Points of All Users
+size_t UserCloudBuilder::points() const
+{
+    size_t count = 0;
+    for( uint32_t index = 0; index < cloud_count; index++ ){
+        count += clouds[index].size;
+    }
+    return count;
+}
+
+// Retrieve Voxel Size
+float UserCloudBuilder::voxelSize() const
+{
+    return voxel_size;
+}
+
+// Find Slot of User
+inline uint32_t UserCloudBuilder::slot( const uint16_t id )
+{
+    for( uint32_t index = 0; index < cloud_count; index++ ){
+        if( clouds[index].id == id ){
+            return index;
+        }
+    }
+
+    // Add Slot (Reuse Buffers of Previous Frames)
+    if( cloud_count == clouds.size() ){
+        clouds.emplace_back();
+    }
+    UserCloud& cloud = clouds[cloud_count];
+    cloud.id = id;
+    cloud.size = 0;
+    return cloud_count++;
+}
+
+// Add Point to Voxel of User
+inline void UserCloudBuilder::accumulate( const uint32_t slot, const float x, const float y, const float z )
+{
+    // Keep Load Factor under 0.5
+    if( voxel_table.size() < ( voxels.size() + 1 ) * 2 ){
+        growVoxelTable();
+    }
+
+    const float inverse = voxel_inverse;
+    const uint64_t key = ( static_cast<uint64_t>( slot & 0x3FF ) << ( VOXEL_INDEX_BITS * 3 ) )
+                       | ( voxelIndex( x, inverse ) << ( VOXEL_INDEX_BITS * 2 ) )
+                       | ( voxelIndex( y, inverse ) << VOXEL_INDEX_BITS )
+                       | voxelIndex( z, inverse );
+
+    // Same Voxel as Previous Point
+    if( last_voxel != UINT32_MAX && voxel_table[last_voxel].key == key ){
+        Voxel& voxel = voxels[voxel_table[last_voxel].index];
+        voxel.x += x;
+        voxel.y += y;
+        voxel.z += z;
+        voxel.count++;
+        return;
+    }
+
+    // Find Voxel (Linear Probing)
+    const size_t mask = voxel_table.size() - 1;
+    for( size_t index = voxelHash( key, mask ); ; index = ( index + 1 ) & mask ){
+        VoxelEntry& entry = voxel_table[index];
+        if( entry.stamp != voxel_stamp ){
+            // New Voxel
+            entry.key = key;
+            entry.stamp = voxel_stamp;
+            entry.index = static_cast<uint32_t>( voxels.size() );
+            voxels.push_back( Voxel{ x, y, z, 1, slot } );
+            last_voxel = static_cast<uint32_t>( index );
+            return;
+        }
+        if( entry.key == key ){
+            last_voxel = static_cast<uint32_t>( index );
+            Voxel& voxel = voxels[entry.index];
+            voxel.x += x;
+            voxel.y += y;
+            voxel.z += z;
+            voxel.count++;
+            return;
+        }
+    }
+}
+
+// Reserve Buffers of Depth Size
+void UserCloudBuilder::reserve( const size_t pixels )
+{
+    const size_t points = std::max<size_t>( pixels / POINT_CLOUD_RESERVED_FRACTION, POINT_CLOUD_INITIAL_POINTS );
+
+    // User Clouds
+    if( clouds.size() < POINT_CLOUD_RESERVED_USERS ){
+        clouds.resize( POINT_CLOUD_RESERVED_USERS );
+    }
+    for( UserCloud& cloud : clouds ){
+        if( cloud.x.size() < points ){
+            cloud.x.resize( points );
+            cloud.y.resize( points );
+            cloud.z.resize( points );
+        }
+    }
+
+    // Voxels (Table for 1/4 of points at load factor 0.5)
+    if( 0.0f < voxel_size ){
+        voxels.reserve( points );
+        size_t entries = POINT_CLOUD_INITIAL_POINTS;
+        while( entries < points / POINT_CLOUD_RESERVED_FRACTION * 2 ){
+            entries *= 2;
+        }
+        if( voxel_table.size() < entries ){
+            voxel_table.assign( entries, VoxelEntry{ 0, 0, 0 } );
+        }
+    }
+
+    reserved_pixels = pixels;
+}
+
+// Grow Voxel Table
+void UserCloudBuilder::growVoxelTable()
+{
+    std::vector<VoxelEntry> table( std::max<size_t>( voxel_table.size() * 2, POINT_CLOUD_INITIAL_POINTS ), VoxelEntry{ 0, 0, 0 } );
+    const size_t mask = table.size() - 1;
+    for( const VoxelEntry& entry : voxel_table ){
+        if( entry.stamp != voxel_stamp ){
+            continue;
+        }
+
+        size_t index = voxelHash( entry.key, mask );
+        while( table[index].stamp == voxel_stamp ){
+            index = ( index + 1 ) & mask;
+        }
+        table[index] = entry;
+    }
+    voxel_table.swap( table );
+    last_voxel = UINT32_MAX;
+}
+
+// Put Unsigned Integer (Little Endian)
+template<typename Type>
+static inline void put( std::string& buffer, const Type value )
+{
+    for( uint32_t i = 0; i < sizeof( Type ); i++ ){
+        buffer.push_back( static_cast<char>( ( value >> ( i * 8 ) ) & 0xFF ) );
+    }
+}
+
+// Constructor
+CloudWriter::CloudWriter( const CloudFormat format )
+    : format( format )
+{
+}
+
+// Encode Point Clouds of Frame
+void CloudWriter::encode( const UserCloudBuilder& builder, const uint32_t frame_index, const uint64_t timestamp, std::string& buffer )
+{
+    // float32 is written as is (Little Endian Host)
+    static_assert( sizeof( float ) == 4, "float must be 32 bits" );
+
+    if( format == CLOUD_FORMAT_BINARY ){
+        // Header
+        uint64_t payload = 0;
+        for( size_t index = 0; index < builder.size(); index++ ){
+            payload += 8 + static_cast<uint64_t>( builder[index].size ) * sizeof( float ) * 3;
+        }
+        if( 0xFFFFFFFFull < payload || 0xFFFF < builder.size() ){
+            throw std::runtime_error( "failed point cloud record is too large" );
+        }
+
+        buffer.reserve( buffer.size() + POINT_CLOUD_HEADER_SIZE + payload );
+        put<uint32_t>( buffer, POINT_CLOUD_MAGIC );
+        put<uint8_t>( buffer, POINT_CLOUD_VERSION );
+        put<uint8_t>( buffer, 0 );
+        put<uint16_t>( buffer, static_cast<uint16_t>( builder.size() ) );
+        put<uint32_t>( buffer, frame_index );
+        put<uint32_t>( buffer, static_cast<uint32_t>( payload ) );
+        put<uint64_t>( buffer, timestamp );
+
+        // Users (Arrays of Coordinates)
+        for( size_t index = 0; index < builder.size(); index++ ){
+            const UserCloud& cloud = builder[index];
+            put<uint16_t>( buffer, cloud.id );
+            put<uint16_t>( buffer, 0 );
+            put<uint32_t>( buffer, cloud.size );
+            buffer.append( reinterpret_cast<const char*>( cloud.x.data() ), cloud.size * sizeof( float ) );
+            buffer.append( reinterpret_cast<const char*>( cloud.y.data() ), cloud.size * sizeof( float ) );
+            buffer.append( reinterpret_cast<const char*>( cloud.z.data() ), cloud.size * sizeof( float ) );
+        }
+        return;
+    }
+
+    // PLY Header
+    char header[256];
+    const int32_t length = std::snprintf( header, sizeof( header ),
+        "ply\nformat binary_little_endian 1.0\ncomment frame %u timestamp %llu\nelement vertex %zu\n"
+        "property float x\nproperty float y\nproperty float z\nproperty ushort user\nend_header\n",
+        frame_index, static_cast<unsigned long long>( timestamp ), builder.points() );
+    buffer.append( header, length );
+
+    // PLY Vertices (x, y, z, user)
+    constexpr size_t vertex_size = sizeof( float ) * 3 + sizeof( uint16_t );
+    size_t offset = buffer.size();
+    buffer.resize( offset + builder.points() * vertex_size );
+    char* data = &buffer[0];
+    for( size_t index = 0; index < builder.size(); index++ ){
+        const UserCloud& cloud = builder[index];
+        for( uint32_t i = 0; i < cloud.size; i++ ){
+            std::memcpy( data + offset, &cloud.x[i], sizeof( float ) );
+            std::memcpy( data + offset + 4, &cloud.y[i], sizeof( float ) );
+            std::memcpy( data + offset + 8, &cloud.z[i], sizeof( float ) );
+            std::memcpy( data + offset + 12, &cloud.id, sizeof( uint16_t ) );
+            offset += vertex_size;
+        }
+    }
+}
+
+// Write Point Clouds of Frame to Stream
+void CloudWriter::write( const UserCloudBuilder& builder, const uint32_t frame_index, const uint64_t timestamp, std::ostream& stream )
+{
+    buffer.clear();
+    encode( builder, frame_index, timestamp, buffer );
+    stream.write( buffer.data(), buffer.size() );
+}
@@ -0,0 +1,144 @@
+#ifndef __POINT_CLOUD__
+#define __POINT_CLOUD__
+
+#include <opencv2/opencv.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "projection.h"
+
+// Point Cloud Stream Format
+// cloud = Record per Frame (Little Endian)
+//   Header : magic "NPCL" (4), version (1), reserved (1), user count (2),
+//            frame index (4), payload size (4, size of users), timestamp [us] (8)
+//   User   : id (2), reserved (2), point count (4), x [count], y [count], z [count] (float32 [mm])
+// ply   = "binary_little_endian 1.0" PLY document per Frame
+//         vertex: x, y, z (float [mm]), user (ushort)
+#define POINT_CLOUD_MAGIC 0x4C43504E // "NPCL"
+#define POINT_CLOUD_VERSION 1
+#define POINT_CLOUD_HEADER_SIZE 24
+
+// Point Cloud Format
+enum CloudFormat
+{
+    CLOUD_FORMAT_BINARY, // Stream Records
+    CLOUD_FORMAT_PLY     // PLY Documents
+};
+
+// Parse Cloud Format ("cloud[:VOXEL]" or "ply[:VOXEL]", VOXEL is voxel size [mm], 0: no downsampling)
+CloudFormat parseCloudFormat( const std::string& name, float& voxel_size );
+
+// Retrieve Cloud Format Name
+const char* cloudFormatName( const CloudFormat format );
+
+// Point Cloud of User (World coordinates [mm], first size points are valid)
+struct UserCloud
+{
+    uint16_t id = 0;
+    uint32_t size = 0;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+};
+
+// Per-User Point Cloud Builder (One pass over the frame, centroid per voxel if voxel size is set)
+class UserCloudBuilder
+{
+private:
+    // Voxel Size [mm] (0: No Downsampling)
+    float voxel_size;
+    float voxel_inverse;
+
+    // Clouds (Slots are reused, first cloud_count are valid)
+    std::vector<UserCloud> clouds;
+    uint32_t cloud_count = 0;
+
+    // Column Factor of Depth Size ( ( u - center_x ) / focal_x )
+    std::vector<float> columns;
+    Intrinsics column_intrinsics;
+
+    // Voxel Accumulator
+    struct Voxel
+    {
+        float x;
+        float y;
+        float z;
+        uint32_t count;
+        uint32_t slot;
+    };
+
+    // Voxel Table Entry (Open Addressing, entries of older stamp are empty)
+    struct VoxelEntry
+    {
+        uint64_t key;
+        uint32_t stamp;
+        uint32_t index;
+    };
+
+    std::vector<Voxel> voxels;
+    std::vector<VoxelEntry> voxel_table;
+    uint32_t voxel_stamp = 0;
+    uint32_t last_voxel = UINT32_MAX; // Table index of voxel of previous point
+
+    // Depth Size of Reserved Buffers
+    size_t reserved_pixels = 0;
+
+public:
+    // Constructor
+    explicit UserCloudBuilder( const float voxel_size = 0.0f );
+
+    // Build Point Clouds of Users
+    void build( const cv::Mat& depth_mat, const cv::Mat& user_map, const Intrinsics& intrinsics );
+
+    // Retrieve Number of Users
+    size_t size() const;
+
+    // Retrieve Point Cloud of User
+    const UserCloud& operator[]( const size_t index ) const;
+
+    // Retrieve Number of Points of All Users
+    size_t points() const;
+
+    // Retrieve Voxel Size
+    float voxelSize() const;
+
+private:
+    // Find Slot of User (Add if not found)
+    inline uint32_t slot( const uint16_t id );
+
+    // Add Point to Voxel of User
+    inline void accumulate( const uint32_t slot, const float x, const float y, const float z );
+
+    // Reserve Buffers of Depth Size (Users and points)
+    void reserve( const size_t pixels );
+
+    // Grow Voxel Table (Rehash entries of current stamp)
+    void growVoxelTable();
+};
+
+// Point Cloud Writer
+class CloudWriter
+{
+private:
+    // Format
+    CloudFormat format;
+
+    // Record Buffer
+    std::string buffer;
+
+public:
+    // Constructor
+    explicit CloudWriter( const CloudFormat format = CLOUD_FORMAT_BINARY );
+
+    // Encode Point Clouds of Frame (Append to Buffer)
+    void encode( const UserCloudBuilder& builder, const uint32_t frame_index, const uint64_t timestamp, std::string& buffer );
+
+    // Write Point Clouds of Frame to Stream
+    void write( const UserCloudBuilder& builder, const uint32_t frame_index, const uint64_t timestamp, std::ostream& stream );
+};
+
+#endif // __POINT_CLOUD__
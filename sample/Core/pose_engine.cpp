@@ -0,0 +1,524 @@
+#include "pose_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#if defined( __AVX2__ )
+#define POSE_AVX2
+#include <immintrin.h>
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define POSE_SSE
+#include <emmintrin.h>
+#endif
+
+// Degrees to Radians
+#define POSE_RADIANS 0.0174532925f
+
+// Joint Names (nite::JointType order)
+static const std::array<const char*, JOINT_COUNT> joint_names = { {
+    "head", "neck", "left_shoulder", "right_shoulder", "left_elbow", "right_elbow", "left_hand", "right_hand",
+    "torso", "left_hip", "right_hip", "left_knee", "right_knee", "left_foot", "right_foot"
+} };
+
+// Parse Joint Name
+uint32_t parseJointName( const std::string& name )
+{
+    for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+        if( name == joint_names[type] ){
+            return type;
+        }
+    }
+
+    throw std::runtime_error( "failed unknown joint " + name );
+}
+
+// Retrieve Joint Name
+const char* jointName( const uint32_t type )
+{
+    return ( type < JOINT_COUNT ) ? joint_names[type] : "unknown";
+}
+
+// Load Pose Definitions from File
+std::vector<PoseDefinition> loadPoseDefinitions( const std::string& path )
+{
+    std::ifstream stream( path );
+    if( !stream.is_open() ){
+        throw std::runtime_error( "failed can not open " + path );
+    }
+
+    std::vector<PoseDefinition> poses;
+    std::string line;
+    uint32_t number = 0;
+    while( std::getline( stream, line ) ){
+        number++;
+
+        // Skip Comment and Empty Line
+        const size_t comment = line.find( '#' );
+        if( comment != std::string::npos ){
+            line.erase( comment );
+        }
+
+        std::istringstream fields( line );
+        std::string keyword;
+        if( !( fields >> keyword ) ){
+            continue;
+        }
+        const std::string location = path + ":" + std::to_string( number );
+
+        // Pose
+        if( keyword == "pose" ){
+            PoseDefinition pose;
+            if( !( fields >> pose.name ) ){
+                throw std::runtime_error( "failed pose name is missing at " + location );
+            }
+            if( !( fields >> pose.hold ) ){
+                pose.hold = POSE_HOLD;
+            }
+            else if( !( fields >> pose.release ) ){
+                pose.release = POSE_RELEASE;
+            }
+            for( const PoseDefinition& other : poses ){
+                if( other.name == pose.name ){
+                    throw std::runtime_error( "failed duplicate pose " + pose.name + " at " + location );
+                }
+            }
+            poses.push_back( pose );
+            continue;
+        }
+
+        // Constraint
+        if( poses.empty() ){
+            throw std::runtime_error( "failed constraint before pose at " + location );
+        }
+        PoseConstraint constraint;
+        std::string first, second, third;
+        if( keyword == "angle" && ( fields >> first >> second >> third ) ){
+            constraint.type = POSE_CONSTRAINT_ANGLE;
+            constraint.joints = { { parseJointName( first ), parseJointName( second ), parseJointName( third ) } };
+        }
+        else if( keyword == "offset" && ( fields >> first >> second >> third ) ){
+            if( third != "x" && third != "y" && third != "z" ){
+                throw std::runtime_error( "failed invalid axis " + third + " at " + location );
+            }
+            constraint.type = static_cast<PoseConstraintType>( POSE_CONSTRAINT_OFFSET_X + ( third[0] - 'x' ) );
+            constraint.joints = { { parseJointName( first ), parseJointName( second ), 0 } };
+        }
+        else if( keyword == "distance" && ( fields >> first >> second ) ){
+            constraint.type = POSE_CONSTRAINT_DISTANCE;
+            constraint.joints = { { parseJointName( first ), parseJointName( second ), 0 } };
+        }
+        else{
+            throw std::runtime_error( "failed invalid constraint at " + location );
+        }
+        if( !( fields >> constraint.target >> constraint.tolerance ) || constraint.tolerance < 0.0f ){
+            throw std::runtime_error( "failed invalid target and tolerance at " + location );
+        }
+        poses.back().constraints.push_back( constraint );
+    }
+
+    if( poses.empty() ){
+        throw std::runtime_error( "failed no pose in " + path );
+    }
+
+    return poses;
+}
+
+// Save Pose Definitions to File
+void savePoseDefinitions( const std::string& path, const std::vector<PoseDefinition>& poses )
+{
+    std::ofstream stream( path, std::ios::out | std::ios::trunc );
+    if( !stream.is_open() ){
+        throw std::runtime_error( "failed can not open " + path );
+    }
+
+    stream.precision( 9 );
+    for( const PoseDefinition& pose : poses ){
+        stream << "pose " << pose.name << " " << pose.hold << " " << pose.release << "\n";
+        for( const PoseConstraint& constraint : pose.constraints ){
+            const std::array<uint32_t, 3>& joints = constraint.joints;
+            switch( constraint.type ){
+                case POSE_CONSTRAINT_ANGLE:
+                    stream << "angle " << jointName( joints[0] ) << " " << jointName( joints[1] ) << " " << jointName( joints[2] );
+                    break;
+                case POSE_CONSTRAINT_DISTANCE:
+                    stream << "distance " << jointName( joints[0] ) << " " << jointName( joints[1] );
+                    break;
+                default:
+                    stream << "offset " << jointName( joints[0] ) << " " << jointName( joints[1] ) << " " << static_cast<char>( 'x' + ( constraint.type - POSE_CONSTRAINT_OFFSET_X ) );
+                    break;
+            }
+            stream << " " << constraint.target << " " << constraint.tolerance << "\n";
+        }
+    }
+
+    if( !stream ){
+        throw std::runtime_error( "failed can not write " + path );
+    }
+}
+
+// Retrieve Instruction Set of Pose Kernels
+const char* poseInstructionSet()
+{
+#if defined( POSE_AVX2 )
+    return "avx2";
+#elif defined( POSE_SSE )
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+// Constructor
+PoseEngine::PoseEngine( const std::vector<PoseDefinition>& poses, const float confidence )
+    : confidence( confidence )
+{
+    if( poses.empty() ){
+        throw std::runtime_error( "failed no pose definition" );
+    }
+
+    // Compile Constraints (Angle as cosine, shared features)
+    begins.push_back( 0 );
+    for( const PoseDefinition& pose : poses ){
+        if( pose.constraints.empty() ){
+            throw std::runtime_error( "failed pose " + pose.name + " has no constraint" );
+        }
+        names.push_back( pose.name );
+        holds.push_back( static_cast<uint64_t>( pose.hold ) * 1000 );
+        releases.push_back( static_cast<uint64_t>( pose.release ) * 1000 );
+
+        for( const PoseConstraint& constraint : pose.constraints ){
+            const uint32_t used = ( constraint.type == POSE_CONSTRAINT_ANGLE ) ? 3 : 2;
+            Feature feature = { constraint.type, { { 0, 0, 0 } } };
+            for( uint32_t i = 0; i < used; i++ ){
+                if( JOINT_COUNT <= constraint.joints[i] ){
+                    throw std::runtime_error( "failed invalid joint of pose " + pose.name );
+                }
+                feature.joints[i] = constraint.joints[i];
+            }
+
+            uint32_t index = 0;
+            while( index < features.size() && !( features[index].type == feature.type && features[index].joints == feature.joints ) ){
+                index++;
+            }
+            if( index == features.size() ){
+                features.push_back( feature );
+            }
+            constraint_features.push_back( index );
+
+            float lower = constraint.target - constraint.tolerance;
+            float upper = constraint.target + constraint.tolerance;
+            if( constraint.type == POSE_CONSTRAINT_ANGLE ){
+                // Open Bounds of 0 and 180 Degrees (Cosine may round beyond -1/1)
+                const float minimum = lower;
+                lower = ( 180.0f <= upper ) ? -2.0f : std::cos( upper * POSE_RADIANS );
+                upper = ( minimum <= 0.0f ) ? 2.0f : std::cos( minimum * POSE_RADIANS );
+            }
+            lowers.push_back( lower );
+            uppers.push_back( upper );
+        }
+        begins.push_back( static_cast<uint32_t>( constraint_features.size() ) );
+    }
+
+    // Allocate Buffers
+    joints.assign( JOINT_COUNT * 3 * POSE_LANES, std::numeric_limits<float>::quiet_NaN() );
+    values.assign( features.size() * POSE_LANES, 0.0f );
+    matches.assign( names.size(), 0 );
+    states.resize( USER_COUNT * names.size() );
+    statuses.assign( USER_COUNT * names.size(), 0 );
+    reset();
+}
+
+// Evaluate Poses of Users in Snapshot
+void PoseEngine::evaluate( const SkeletonSnapshot& snapshot )
+{
+    // Restart at Timestamp going Back (e.g. loop of playback)
+    if( snapshot.timestamp < timestamp ){
+        reset();
+    }
+    timestamp = snapshot.timestamp;
+
+    // Transpose Joints of Tracked Users into Lanes of Slots (NaN: Below Confidence)
+    std::array<bool, USER_COUNT> seen;
+    seen.fill( false );
+    count = std::min<uint32_t>( snapshot.count, USER_COUNT );
+    for( uint32_t index = 0; index < count; index++ ){
+        slots[index] = USER_COUNT;
+        if( snapshot.states[index] != nite::SkeletonState::SKELETON_TRACKED ){
+            continue;
+        }
+        const uint32_t number = slot( snapshot.ids[index] );
+        slots[index] = number;
+        if( number == USER_COUNT ){
+            continue;
+        }
+        seen[number] = true;
+
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const size_t source = SkeletonSnapshot::lane( index, type );
+            const bool valid = confidence <= snapshot.position_confidence[source];
+            float* joint = &joints[type * 3 * POSE_LANES + number];
+            joint[0] = valid ? snapshot.x[source] : std::numeric_limits<float>::quiet_NaN();
+            joint[POSE_LANES] = valid ? snapshot.y[source] : std::numeric_limits<float>::quiet_NaN();
+            joint[2 * POSE_LANES] = valid ? snapshot.z[source] : std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+
+    // Free Slots of Users not Seen (Lost, not tracked or left)
+    for( uint32_t number = 0; number < USER_COUNT; number++ ){
+        if( seen[number] || !ids[number] ){
+            continue;
+        }
+        ids[number] = 0;
+        for( uint32_t lane = 0; lane < JOINT_COUNT * 3; lane++ ){
+            joints[lane * POSE_LANES + number] = std::numeric_limits<float>::quiet_NaN();
+        }
+        std::fill( states.begin() + number * names.size(), states.begin() + ( number + 1 ) * names.size(), State() );
+    }
+
+    // Match Poses of All Users
+    computeFeatures();
+    matchConstraints();
+
+    // Update State Machine of Users in Snapshot
+    const size_t poses = names.size();
+    std::fill( statuses.begin(), statuses.end(), 0 );
+    for( uint32_t index = 0; index < count; index++ ){
+        const uint32_t number = slots[index];
+        if( number == USER_COUNT ){
+            continue;
+        }
+
+        State* state = &states[number * poses];
+        uint8_t* status = &statuses[index * poses];
+        for( size_t pose = 0; pose < poses; pose++ ){
+            const bool match = ( matches[pose] >> number ) & 1;
+            State& current = state[pose];
+            if( match == current.active ){
+                current.pending = false;
+            }
+            else{
+                if( !current.pending ){
+                    current.pending = true;
+                    current.since = timestamp;
+                }
+                if( ( current.active ? releases[pose] : holds[pose] ) <= timestamp - current.since ){
+                    current.active = match;
+                    current.pending = false;
+                    status[pose] = match ? POSE_ENTERED : POSE_EXITED;
+                }
+            }
+            if( current.active && status[pose] != POSE_ENTERED ){
+                status[pose] |= POSE_HELD;
+            }
+        }
+    }
+}
+
+// Restart State of All Users
+void PoseEngine::reset()
+{
+    ids.fill( 0 );
+    slots.fill( USER_COUNT );
+    count = 0;
+    std::fill( joints.begin(), joints.end(), std::numeric_limits<float>::quiet_NaN() );
+    std::fill( states.begin(), states.end(), State() );
+    std::fill( statuses.begin(), statuses.end(), 0 );
+    timestamp = 0;
+}
+
+// Retrieve Number of Poses
+uint32_t PoseEngine::poseCount() const
+{
+    return static_cast<uint32_t>( names.size() );
+}
+
+// Retrieve Number of Distinct Features
+uint32_t PoseEngine::featureCount() const
+{
+    return static_cast<uint32_t>( features.size() );
+}
+
+// Retrieve Pose Name
+const std::string& PoseEngine::poseName( const uint32_t pose ) const
+{
+    return names[pose];
+}
+
+// Retrieve Status of All Users
+const std::vector<uint8_t>& PoseEngine::getStatuses() const
+{
+    return statuses;
+}
+
+// Retrieve Whether Constraints of Pose Match User
+bool PoseEngine::matched( const uint32_t user, const uint32_t pose ) const
+{
+    if( count <= user || slots[user] == USER_COUNT ){
+        return false;
+    }
+    return ( matches[pose] >> slots[user] ) & 1;
+}
+
+// Find Slot of User
+inline uint32_t PoseEngine::slot( const nite::UserId id )
+{
+    uint32_t free = USER_COUNT;
+    for( uint32_t index = 0; index < USER_COUNT; index++ ){
+        if( ids[index] == id ){
+            return index;
+        }
+        if( !ids[index] && free == USER_COUNT ){
+            free = index;
+        }
+    }
+
+    // Assign Free Slot (State of its lanes was cleared when it was freed)
+    if( free != USER_COUNT ){
+        ids[free] = id;
+    }
+    return free;
+}
+
+// Compute Features over Lanes
+void PoseEngine::computeFeatures()
+{
+    for( size_t index = 0; index < features.size(); index++ ){
+        const Feature& feature = features[index];
+        const float* a = &joints[feature.joints[0] * 3 * POSE_LANES];
+        const float* b = &joints[feature.joints[1] * 3 * POSE_LANES];
+        const float* c = &joints[feature.joints[2] * 3 * POSE_LANES];
+        float* value = &values[index * POSE_LANES];
+        size_t i = 0;
+
+        switch( feature.type ){
+            case POSE_CONSTRAINT_ANGLE:
+#if defined( POSE_AVX2 )
+                // AVX2 (8 Users per Iteration)
+                for( ; i + 8 <= POSE_LANES; i += 8 ){
+                    const __m256 ux = _mm256_sub_ps( _mm256_loadu_ps( a + i ), _mm256_loadu_ps( b + i ) );
+                    const __m256 uy = _mm256_sub_ps( _mm256_loadu_ps( a + POSE_LANES + i ), _mm256_loadu_ps( b + POSE_LANES + i ) );
+                    const __m256 uz = _mm256_sub_ps( _mm256_loadu_ps( a + 2 * POSE_LANES + i ), _mm256_loadu_ps( b + 2 * POSE_LANES + i ) );
+                    const __m256 vx = _mm256_sub_ps( _mm256_loadu_ps( c + i ), _mm256_loadu_ps( b + i ) );
+                    const __m256 vy = _mm256_sub_ps( _mm256_loadu_ps( c + POSE_LANES + i ), _mm256_loadu_ps( b + POSE_LANES + i ) );
+                    const __m256 vz = _mm256_sub_ps( _mm256_loadu_ps( c + 2 * POSE_LANES + i ), _mm256_loadu_ps( b + 2 * POSE_LANES + i ) );
+                    const __m256 dot = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( ux, vx ), _mm256_mul_ps( uy, vy ) ), _mm256_mul_ps( uz, vz ) );
+                    const __m256 uu = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( ux, ux ), _mm256_mul_ps( uy, uy ) ), _mm256_mul_ps( uz, uz ) );
+                    const __m256 vv = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( vx, vx ), _mm256_mul_ps( vy, vy ) ), _mm256_mul_ps( vz, vz ) );
+                    _mm256_storeu_ps( value + i, _mm256_div_ps( dot, _mm256_sqrt_ps( _mm256_mul_ps( uu, vv ) ) ) );
+                }
+#elif defined( POSE_SSE )
+                // SSE2 (4 Users per Iteration)
+                for( ; i + 4 <= POSE_LANES; i += 4 ){
+                    const __m128 ux = _mm_sub_ps( _mm_loadu_ps( a + i ), _mm_loadu_ps( b + i ) );
+                    const __m128 uy = _mm_sub_ps( _mm_loadu_ps( a + POSE_LANES + i ), _mm_loadu_ps( b + POSE_LANES + i ) );
+                    const __m128 uz = _mm_sub_ps( _mm_loadu_ps( a + 2 * POSE_LANES + i ), _mm_loadu_ps( b + 2 * POSE_LANES + i ) );
+                    const __m128 vx = _mm_sub_ps( _mm_loadu_ps( c + i ), _mm_loadu_ps( b + i ) );
+                    const __m128 vy = _mm_sub_ps( _mm_loadu_ps( c + POSE_LANES + i ), _mm_loadu_ps( b + POSE_LANES + i ) );
+                    const __m128 vz = _mm_sub_ps( _mm_loadu_ps( c + 2 * POSE_LANES + i ), _mm_loadu_ps( b + 2 * POSE_LANES + i ) );
+                    const __m128 dot = _mm_add_ps( _mm_add_ps( _mm_mul_ps( ux, vx ), _mm_mul_ps( uy, vy ) ), _mm_mul_ps( uz, vz ) );
+                    const __m128 uu = _mm_add_ps( _mm_add_ps( _mm_mul_ps( ux, ux ), _mm_mul_ps( uy, uy ) ), _mm_mul_ps( uz, uz ) );
+                    const __m128 vv = _mm_add_ps( _mm_add_ps( _mm_mul_ps( vx, vx ), _mm_mul_ps( vy, vy ) ), _mm_mul_ps( vz, vz ) );
+                    _mm_storeu_ps( value + i, _mm_div_ps( dot, _mm_sqrt_ps( _mm_mul_ps( uu, vv ) ) ) );
+                }
+#endif
+                // Scalar (Remaining Users)
+                for( ; i < POSE_LANES; i++ ){
+                    const float ux = a[i] - b[i], uy = a[POSE_LANES + i] - b[POSE_LANES + i], uz = a[2 * POSE_LANES + i] - b[2 * POSE_LANES + i];
+                    const float vx = c[i] - b[i], vy = c[POSE_LANES + i] - b[POSE_LANES + i], vz = c[2 * POSE_LANES + i] - b[2 * POSE_LANES + i];
+                    value[i] = ( ux * vx + uy * vy + uz * vz ) / std::sqrt( ( ux * ux + uy * uy + uz * uz ) * ( vx * vx + vy * vy + vz * vz ) );
+                }
+                break;
+
+            case POSE_CONSTRAINT_DISTANCE:
+#if defined( POSE_AVX2 )
+                for( ; i + 8 <= POSE_LANES; i += 8 ){
+                    const __m256 dx = _mm256_sub_ps( _mm256_loadu_ps( a + i ), _mm256_loadu_ps( b + i ) );
+                    const __m256 dy = _mm256_sub_ps( _mm256_loadu_ps( a + POSE_LANES + i ), _mm256_loadu_ps( b + POSE_LANES + i ) );
+                    const __m256 dz = _mm256_sub_ps( _mm256_loadu_ps( a + 2 * POSE_LANES + i ), _mm256_loadu_ps( b + 2 * POSE_LANES + i ) );
+                    _mm256_storeu_ps( value + i, _mm256_sqrt_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( dx, dx ), _mm256_mul_ps( dy, dy ) ), _mm256_mul_ps( dz, dz ) ) ) );
+                }
+#elif defined( POSE_SSE )
+                for( ; i + 4 <= POSE_LANES; i += 4 ){
+                    const __m128 dx = _mm_sub_ps( _mm_loadu_ps( a + i ), _mm_loadu_ps( b + i ) );
+                    const __m128 dy = _mm_sub_ps( _mm_loadu_ps( a + POSE_LANES + i ), _mm_loadu_ps( b + POSE_LANES + i ) );
+                    const __m128 dz = _mm_sub_ps( _mm_loadu_ps( a + 2 * POSE_LANES + i ), _mm_loadu_ps( b + 2 * POSE_LANES + i ) );
+                    _mm_storeu_ps( value + i, _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) ) ) );
+                }
+#endif
+                for( ; i < POSE_LANES; i++ ){
+                    const float dx = a[i] - b[i], dy = a[POSE_LANES + i] - b[POSE_LANES + i], dz = a[2 * POSE_LANES + i] - b[2 * POSE_LANES + i];
+                    value[i] = std::sqrt( dx * dx + dy * dy + dz * dz );
+                }
+                break;
+
+            default:
+            {
+                // Offset (Axis of constraint type)
+                const size_t axis = ( feature.type - POSE_CONSTRAINT_OFFSET_X ) * POSE_LANES;
+#if defined( POSE_AVX2 )
+                for( ; i + 8 <= POSE_LANES; i += 8 ){
+                    _mm256_storeu_ps( value + i, _mm256_sub_ps( _mm256_loadu_ps( a + axis + i ), _mm256_loadu_ps( b + axis + i ) ) );
+                }
+#elif defined( POSE_SSE )
+                for( ; i + 4 <= POSE_LANES; i += 4 ){
+                    _mm_storeu_ps( value + i, _mm_sub_ps( _mm_loadu_ps( a + axis + i ), _mm_loadu_ps( b + axis + i ) ) );
+                }
+#endif
+                for( ; i < POSE_LANES; i++ ){
+                    value[i] = a[axis + i] - b[axis + i];
+                }
+                break;
+            }
+        }
+    }
+}
+
+// Match Constraints over Lanes
+void PoseEngine::matchConstraints()
+{
+    for( size_t pose = 0; pose < names.size(); pose++ ){
+        uint32_t mask = 0;
+        for( size_t i = 0; i < POSE_LANES; ){
+#if defined( POSE_AVX2 )
+            // AVX2 (8 Users per Iteration, NaN compares false)
+            if( i + 8 <= POSE_LANES ){
+                __m256 match = _mm256_castsi256_ps( _mm256_set1_epi32( -1 ) );
+                for( uint32_t constraint = begins[pose]; constraint < begins[pose + 1]; constraint++ ){
+                    const __m256 value = _mm256_loadu_ps( &values[constraint_features[constraint] * POSE_LANES + i] );
+                    match = _mm256_and_ps( match, _mm256_cmp_ps( value, _mm256_set1_ps( lowers[constraint] ), _CMP_GE_OQ ) );
+                    match = _mm256_and_ps( match, _mm256_cmp_ps( value, _mm256_set1_ps( uppers[constraint] ), _CMP_LE_OQ ) );
+                }
+                mask |= static_cast<uint32_t>( _mm256_movemask_ps( match ) ) << i;
+                i += 8;
+                continue;
+            }
+#elif defined( POSE_SSE )
+            // SSE2 (4 Users per Iteration, NaN compares false)
+            if( i + 4 <= POSE_LANES ){
+                __m128 match = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+                for( uint32_t constraint = begins[pose]; constraint < begins[pose + 1]; constraint++ ){
+                    const __m128 value = _mm_loadu_ps( &values[constraint_features[constraint] * POSE_LANES + i] );
+                    match = _mm_and_ps( match, _mm_cmpge_ps( value, _mm_set1_ps( lowers[constraint] ) ) );
+                    match = _mm_and_ps( match, _mm_cmple_ps( value, _mm_set1_ps( uppers[constraint] ) ) );
+                }
+                mask |= static_cast<uint32_t>( _mm_movemask_ps( match ) ) << i;
+                i += 4;
+                continue;
+            }
+#endif
+            // Scalar
+            bool match = true;
+            for( uint32_t constraint = begins[pose]; constraint < begins[pose + 1] && match; constraint++ ){
+                const float value = values[constraint_features[constraint] * POSE_LANES + i];
+                match = lowers[constraint] <= value && value <= uppers[constraint];
+            }
+            mask |= static_cast<uint32_t>( match ) << i;
+            i++;
+        }
+        matches[pose] = mask;
+    }
+}
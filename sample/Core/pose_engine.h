@@ -0,0 +1,165 @@
+#ifndef __POSE_ENGINE__
+#define __POSE_ENGINE__
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "skeleton_snapshot.h"
+
+// Lanes of Pose Engine (Slots of Users, Padded to 8 Lanes of AVX)
+#define POSE_LANES ( ( USER_COUNT + 7 ) / 8 * 8 )
+
+// Default Hold Time [ms]
+#define POSE_HOLD 200
+
+// Default Release Time [ms]
+#define POSE_RELEASE 100
+
+// Pose Status (Same bits as poses of skeleton snapshot)
+#define POSE_ENTERED 0x01
+#define POSE_HELD 0x02
+#define POSE_EXITED 0x04
+
+// Pose Constraint Type
+enum PoseConstraintType
+{
+    POSE_CONSTRAINT_ANGLE,    // Angle at second joint between first and third joint [deg]
+    POSE_CONSTRAINT_OFFSET_X, // X of first joint - x of second joint [mm]
+    POSE_CONSTRAINT_OFFSET_Y, // Y of first joint - y of second joint [mm] (y is up)
+    POSE_CONSTRAINT_OFFSET_Z, // Z of first joint - z of second joint [mm] (z is away from sensor)
+    POSE_CONSTRAINT_DISTANCE  // Distance between first and second joint [mm]
+};
+
+// Pose Constraint (Matches if value is within target +/- tolerance)
+struct PoseConstraint
+{
+    PoseConstraintType type = POSE_CONSTRAINT_ANGLE;
+    std::array<uint32_t, 3> joints = { { 0, 0, 0 } }; // nite::JointType (Third joint is used by angle only)
+    float target = 0.0f;
+    float tolerance = 0.0f;
+};
+
+// Pose Definition
+struct PoseDefinition
+{
+    std::string name;
+    uint32_t hold = POSE_HOLD;       // [ms]
+    uint32_t release = POSE_RELEASE; // [ms]
+    std::vector<PoseConstraint> constraints;
+};
+
+// Parse Joint Name ("head", "neck", "left_shoulder", ..., "right_foot")
+uint32_t parseJointName( const std::string& name );
+
+// Retrieve Joint Name
+const char* jointName( const uint32_t type );
+
+// Load Pose Definitions from File (Constraint lines belong to the pose above, # starts a comment)
+//   pose NAME [HOLD [RELEASE]]                  : Start pose (hold and release time [ms])
+//   angle JOINT JOINT JOINT TARGET TOLERANCE    : Angle at second joint [deg]
+//   offset JOINT JOINT x|y|z TARGET TOLERANCE   : Coordinate of first joint relative to second joint [mm]
+//   distance JOINT JOINT TARGET TOLERANCE       : Distance between joints [mm]
+std::vector<PoseDefinition> loadPoseDefinitions( const std::string& path );
+
+// Save Pose Definitions to File
+void savePoseDefinitions( const std::string& path, const std::vector<PoseDefinition>& poses );
+
+// Retrieve Instruction Set of Pose Kernels ("avx2", "sse2" or "scalar")
+const char* poseInstructionSet();
+
+// Custom Pose Engine (All poses of tracked users of snapshot over joint-major lanes, debounced by hold and release time)
+class PoseEngine
+{
+private:
+    // Feature (Shared by constraints of same type and joints)
+    struct Feature
+    {
+        PoseConstraintType type;
+        std::array<uint32_t, 3> joints;
+    };
+
+    // Pose State of Slot
+    struct State
+    {
+        bool active = false;  // Entered and not exited
+        bool pending = false; // Match differs from active since time
+        uint64_t since = 0;
+    };
+
+    // Definitions
+    std::vector<std::string> names;
+    std::vector<uint64_t> holds;    // [us]
+    std::vector<uint64_t> releases; // [us]
+    float confidence;
+
+    // Compiled Constraints (Feature, lower and upper bound, constraints of pose p are [begins[p], begins[p + 1]))
+    std::vector<Feature> features;
+    std::vector<uint32_t> constraint_features;
+    std::vector<float> lowers;
+    std::vector<float> uppers;
+    std::vector<uint32_t> begins;
+
+    // Slots (User Id of Slot, 0: Free) and Slot of Users in Snapshot (USER_COUNT: No free slot)
+    std::array<nite::UserId, USER_COUNT> ids;
+    std::array<uint32_t, USER_COUNT> slots;
+    uint32_t count = 0;
+
+    // Joints (Joint-major, (type * 3 + axis) * POSE_LANES + slot) and Features (feature * POSE_LANES + slot)
+    std::vector<float> joints;
+    std::vector<float> values;
+
+    // Matched Slots of Poses (Bit of slot)
+    std::vector<uint32_t> matches;
+
+    // States (slot * poses + pose) and Status of Users in Snapshot (user * poses + pose)
+    std::vector<State> states;
+    std::vector<uint8_t> statuses;
+
+    // Sensor Timestamp of Previous Frame [us]
+    uint64_t timestamp = 0;
+
+public:
+    // Constructor (Joints below position confidence fail constraints)
+    explicit PoseEngine( const std::vector<PoseDefinition>& poses, const float confidence = 0.5f );
+
+    // Evaluate Poses of Users in Snapshot
+    void evaluate( const SkeletonSnapshot& snapshot );
+
+    // Restart State of All Users
+    void reset();
+
+    // Retrieve Number of Poses
+    uint32_t poseCount() const;
+
+    // Retrieve Number of Distinct Features
+    uint32_t featureCount() const;
+
+    // Retrieve Pose Name
+    const std::string& poseName( const uint32_t pose ) const;
+
+    // Retrieve Status of User in Snapshot and Pose (POSE_ENTERED, POSE_HELD and POSE_EXITED bits)
+    uint8_t status( const uint32_t user, const uint32_t pose ) const
+    {
+        return statuses[static_cast<size_t>( user ) * names.size() + pose];
+    }
+
+    // Retrieve Status of All Users (user * poses + pose)
+    const std::vector<uint8_t>& getStatuses() const;
+
+    // Retrieve Whether Constraints of Pose Match User in Snapshot (Without Debouncing)
+    bool matched( const uint32_t user, const uint32_t pose ) const;
+
+private:
+    // Find Slot of User (Assign free slot if not found, USER_COUNT if no slot is free)
+    inline uint32_t slot( const nite::UserId id );
+
+    // Compute Features over Lanes
+    void computeFeatures();
+
+    // Match Constraints over Lanes
+    void matchConstraints();
+};
+
+#endif // __POSE_ENGINE__
@@ -0,0 +1,257 @@
+#include "projection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined( __AVX2__ )
+#define PROJECTION_AVX2
+#include <immintrin.h>
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define PROJECTION_SSE
+#include <emmintrin.h>
+#endif
+
+// Minimum Points of Row Tile (Point Cloud)
+#define PROJECTION_TILE_POINTS 65536
+
+// Intrinsics from Field of View
+Intrinsics intrinsicsFromFieldOfView( const uint32_t width, const uint32_t height, const float horizontal_fov, const float vertical_fov )
+{
+    if( !width || !height || horizontal_fov <= 0.0f || vertical_fov <= 0.0f ){
+        throw std::runtime_error( "failed invalid field of view" );
+    }
+
+    // (NiTE World Coordinates: X Right, Y Up, Z Forward [mm])
+    Intrinsics intrinsics;
+    intrinsics.focal_x = ( width / 2.0f ) / std::tan( horizontal_fov / 2.0f );
+    intrinsics.focal_y = -( height / 2.0f ) / std::tan( vertical_fov / 2.0f );
+    intrinsics.center_x = width / 2.0f;
+    intrinsics.center_y = height / 2.0f;
+    return intrinsics;
+}
+
+// Load Intrinsics
+Intrinsics loadIntrinsics( const std::string& path )
+{
+    std::ifstream stream( path );
+    if( !stream.is_open() ){
+        throw std::runtime_error( "failed can not open " + path );
+    }
+
+    Intrinsics intrinsics;
+    uint32_t found = 0;
+    std::string line;
+    while( std::getline( stream, line ) ){
+        // Skip Comment and Empty Line
+        const size_t comment = line.find( '#' );
+        if( comment != std::string::npos ){
+            line.erase( comment );
+        }
+
+        std::istringstream fields( line );
+        std::string name;
+        float value;
+        if( !( fields >> name ) ){
+            continue;
+        }
+        if( !( fields >> value ) ){
+            throw std::runtime_error( "failed invalid calibration value of " + name );
+        }
+
+        // Parameters (Other names are ignored)
+        if( name == "focal_x" ){
+            intrinsics.focal_x = value;
+            found |= 0x01;
+        }
+        else if( name == "focal_y" ){
+            intrinsics.focal_y = value;
+            found |= 0x02;
+        }
+        else if( name == "center_x" ){
+            intrinsics.center_x = value;
+            found |= 0x04;
+        }
+        else if( name == "center_y" ){
+            intrinsics.center_y = value;
+            found |= 0x08;
+        }
+    }
+
+    if( found != 0x0F || intrinsics.focal_x == 0.0f || intrinsics.focal_y == 0.0f ){
+        throw std::runtime_error( "failed incomplete calibration file " + path );
+    }
+
+    return intrinsics;
+}
+
+// Save Intrinsics
+void saveIntrinsics( const std::string& path, const Intrinsics& intrinsics )
+{
+    std::ofstream stream( path, std::ios::out | std::ios::trunc );
+    if( !stream.is_open() ){
+        throw std::runtime_error( "failed can not open " + path );
+    }
+
+    stream.precision( 9 );
+    stream << "# depth x = center_x + focal_x * x / z, depth y = center_y + focal_y * y / z\n";
+    stream << "focal_x " << intrinsics.focal_x << "\n";
+    stream << "focal_y " << intrinsics.focal_y << "\n";
+    stream << "center_x " << intrinsics.center_x << "\n";
+    stream << "center_y " << intrinsics.center_y << "\n";
+    if( !stream ){
+        throw std::runtime_error( "failed can not write " + path );
+    }
+}
+
+// Project Points
+void projectPoints( const Intrinsics& intrinsics, const float* x, const float* y, const float* z, float* depth_x, float* depth_y, const size_t count )
+{
+    size_t i = 0;
+
+#if defined( PROJECTION_AVX2 )
+    // AVX2 (8 Points per Iteration)
+    const __m256 focal_x = _mm256_set1_ps( intrinsics.focal_x );
+    const __m256 focal_y = _mm256_set1_ps( intrinsics.focal_y );
+    const __m256 center_x = _mm256_set1_ps( intrinsics.center_x );
+    const __m256 center_y = _mm256_set1_ps( intrinsics.center_y );
+    const __m256 invalid = _mm256_set1_ps( -1.0f );
+    const __m256 one = _mm256_set1_ps( 1.0f );
+    const __m256 zero = _mm256_setzero_ps();
+    for( ; i + 8 <= count; i += 8 ){
+        const __m256 pz = _mm256_loadu_ps( z + i );
+        const __m256 valid = _mm256_cmp_ps( pz, zero, _CMP_GT_OQ );
+        const __m256 inverse = _mm256_div_ps( one, pz );
+        const __m256 px = _mm256_add_ps( center_x, _mm256_mul_ps( _mm256_mul_ps( focal_x, _mm256_loadu_ps( x + i ) ), inverse ) );
+        const __m256 py = _mm256_add_ps( center_y, _mm256_mul_ps( _mm256_mul_ps( focal_y, _mm256_loadu_ps( y + i ) ), inverse ) );
+        _mm256_storeu_ps( depth_x + i, _mm256_blendv_ps( invalid, px, valid ) );
+        _mm256_storeu_ps( depth_y + i, _mm256_blendv_ps( invalid, py, valid ) );
+    }
+#elif defined( PROJECTION_SSE )
+    // SSE2 (4 Points per Iteration)
+    const __m128 focal_x = _mm_set1_ps( intrinsics.focal_x );
+    const __m128 focal_y = _mm_set1_ps( intrinsics.focal_y );
+    const __m128 center_x = _mm_set1_ps( intrinsics.center_x );
+    const __m128 center_y = _mm_set1_ps( intrinsics.center_y );
+    const __m128 invalid = _mm_set1_ps( -1.0f );
+    const __m128 one = _mm_set1_ps( 1.0f );
+    const __m128 zero = _mm_setzero_ps();
+    for( ; i + 4 <= count; i += 4 ){
+        const __m128 pz = _mm_loadu_ps( z + i );
+        const __m128 valid = _mm_cmpgt_ps( pz, zero );
+        const __m128 inverse = _mm_div_ps( one, pz );
+        const __m128 px = _mm_add_ps( center_x, _mm_mul_ps( _mm_mul_ps( focal_x, _mm_loadu_ps( x + i ) ), inverse ) );
+        const __m128 py = _mm_add_ps( center_y, _mm_mul_ps( _mm_mul_ps( focal_y, _mm_loadu_ps( y + i ) ), inverse ) );
+        _mm_storeu_ps( depth_x + i, _mm_or_ps( _mm_and_ps( valid, px ), _mm_andnot_ps( valid, invalid ) ) );
+        _mm_storeu_ps( depth_y + i, _mm_or_ps( _mm_and_ps( valid, py ), _mm_andnot_ps( valid, invalid ) ) );
+    }
+#endif
+
+    // Scalar Tail
+    for( ; i < count; i++ ){
+        if( !projectPoint( intrinsics, x[i], y[i], z[i], depth_x + i, depth_y + i ) ){
+            depth_x[i] = -1.0f;
+            depth_y[i] = -1.0f;
+        }
+    }
+}
+
+// Unproject Points
+void unprojectPoints( const Intrinsics& intrinsics, const float* depth_x, const float* depth_y, const float* z, float* x, float* y, const size_t count )
+{
+    size_t i = 0;
+
+#if defined( PROJECTION_AVX2 )
+    // AVX2 (8 Points per Iteration)
+    const __m256 focal_x = _mm256_set1_ps( intrinsics.focal_x );
+    const __m256 focal_y = _mm256_set1_ps( intrinsics.focal_y );
+    const __m256 center_x = _mm256_set1_ps( intrinsics.center_x );
+    const __m256 center_y = _mm256_set1_ps( intrinsics.center_y );
+    for( ; i + 8 <= count; i += 8 ){
+        const __m256 pz = _mm256_loadu_ps( z + i );
+        _mm256_storeu_ps( x + i, _mm256_mul_ps( _mm256_div_ps( _mm256_sub_ps( _mm256_loadu_ps( depth_x + i ), center_x ), focal_x ), pz ) );
+        _mm256_storeu_ps( y + i, _mm256_mul_ps( _mm256_div_ps( _mm256_sub_ps( _mm256_loadu_ps( depth_y + i ), center_y ), focal_y ), pz ) );
+    }
+#elif defined( PROJECTION_SSE )
+    // SSE2 (4 Points per Iteration)
+    const __m128 focal_x = _mm_set1_ps( intrinsics.focal_x );
+    const __m128 focal_y = _mm_set1_ps( intrinsics.focal_y );
+    const __m128 center_x = _mm_set1_ps( intrinsics.center_x );
+    const __m128 center_y = _mm_set1_ps( intrinsics.center_y );
+    for( ; i + 4 <= count; i += 4 ){
+        const __m128 pz = _mm_loadu_ps( z + i );
+        _mm_storeu_ps( x + i, _mm_mul_ps( _mm_div_ps( _mm_sub_ps( _mm_loadu_ps( depth_x + i ), center_x ), focal_x ), pz ) );
+        _mm_storeu_ps( y + i, _mm_mul_ps( _mm_div_ps( _mm_sub_ps( _mm_loadu_ps( depth_y + i ), center_y ), focal_y ), pz ) );
+    }
+#endif
+
+    // Scalar Tail
+    for( ; i < count; i++ ){
+        unprojectPoint( intrinsics, depth_x[i], depth_y[i], z[i], x + i, y + i );
+    }
+}
+
+// Convert Depth Image to Point Cloud
+void depthToPointCloud( const Intrinsics& intrinsics, const uint16_t* depth, const uint32_t width, const uint32_t height, const size_t stride, PointBatch& cloud, TaskPool& pool )
+{
+    if( intrinsics.focal_x == 0.0f || intrinsics.focal_y == 0.0f ){
+        throw std::runtime_error( "failed invalid intrinsics" );
+    }
+
+    cloud.resize( static_cast<size_t>( width ) * height );
+
+    // Column Factor ( ( u - center_x ) / focal_x, x = z * factor )
+    std::vector<float> columns( width );
+    for( uint32_t u = 0; u < width; u++ ){
+        columns[u] = ( static_cast<float>( u ) - intrinsics.center_x ) / intrinsics.focal_x;
+    }
+
+    // Row Tiles
+    const size_t grain = ( PROJECTION_TILE_POINTS + std::max<size_t>( width, 1 ) - 1 ) / std::max<size_t>( width, 1 );
+    pool.parallelFor( height, grain, [&]( const size_t begin, const size_t end ){
+        for( size_t v = begin; v < end; v++ ){
+            const uint16_t* row = reinterpret_cast<const uint16_t*>( reinterpret_cast<const uint8_t*>( depth ) + v * stride );
+            const float factor = ( static_cast<float>( v ) - intrinsics.center_y ) / intrinsics.focal_y;
+            float* x = cloud.x.data() + v * width;
+            float* y = cloud.y.data() + v * width;
+            float* z = cloud.z.data() + v * width;
+
+            uint32_t u = 0;
+#if defined( PROJECTION_AVX2 )
+            // AVX2 (8 Pixels per Iteration)
+            const __m256 row_factor = _mm256_set1_ps( factor );
+            for( ; u + 8 <= width; u += 8 ){
+                const __m256 pz = _mm256_cvtepi32_ps( _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( row + u ) ) ) );
+                _mm256_storeu_ps( x + u, _mm256_mul_ps( pz, _mm256_loadu_ps( columns.data() + u ) ) );
+                _mm256_storeu_ps( y + u, _mm256_mul_ps( pz, row_factor ) );
+                _mm256_storeu_ps( z + u, pz );
+            }
+#elif defined( PROJECTION_SSE )
+            // SSE2 (8 Pixels per Iteration)
+            const __m128 row_factor = _mm_set1_ps( factor );
+            const __m128i zero = _mm_setzero_si128();
+            for( ; u + 8 <= width; u += 8 ){
+                const __m128i pixels = _mm_loadu_si128( reinterpret_cast<const __m128i*>( row + u ) );
+                const __m128 low = _mm_cvtepi32_ps( _mm_unpacklo_epi16( pixels, zero ) );
+                const __m128 high = _mm_cvtepi32_ps( _mm_unpackhi_epi16( pixels, zero ) );
+                _mm_storeu_ps( x + u, _mm_mul_ps( low, _mm_loadu_ps( columns.data() + u ) ) );
+                _mm_storeu_ps( x + u + 4, _mm_mul_ps( high, _mm_loadu_ps( columns.data() + u + 4 ) ) );
+                _mm_storeu_ps( y + u, _mm_mul_ps( low, row_factor ) );
+                _mm_storeu_ps( y + u + 4, _mm_mul_ps( high, row_factor ) );
+                _mm_storeu_ps( z + u, low );
+                _mm_storeu_ps( z + u + 4, high );
+            }
+#endif
+
+            // Scalar Tail
+            for( ; u < width; u++ ){
+                const float pz = static_cast<float>( row[u] );
+                x[u] = pz * columns[u];
+                y[u] = pz * factor;
+                z[u] = pz;
+            }
+        }
+    } );
+}
@@ -0,0 +1,125 @@
+#ifndef __PROJECTION__
+#define __PROJECTION__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "task_pool.h"
+
+// Camera Intrinsics (Pinhole projection from world coordinates [mm] to depth pixel, focal_y < 0 for Y up)
+struct Intrinsics
+{
+    float focal_x = 0.0f;
+    float focal_y = 0.0f;
+    float center_x = 0.0f;
+    float center_y = 0.0f;
+};
+
+// Intrinsics from Field of View [rad] of Depth Stream (Same model as openni::CoordinateConverter)
+Intrinsics intrinsicsFromFieldOfView( const uint32_t width, const uint32_t height, const float horizontal_fov, const float vertical_fov );
+
+// Load Intrinsics from Calibration File ("name value" lines of focal_x, focal_y, center_x and center_y)
+Intrinsics loadIntrinsics( const std::string& path );
+
+// Save Intrinsics to Calibration File
+void saveIntrinsics( const std::string& path, const Intrinsics& intrinsics );
+
+// Estimate Intrinsics from Projection of Two Points at 1 m Depth (project() returns false on failure)
+template<typename Project>
+bool estimateIntrinsics( Project project, Intrinsics& intrinsics )
+{
+    float x0, y0, x1, y1;
+    if( !project( 0.0f, 0.0f, 1000.0f, &x0, &y0 ) || !project( 1000.0f, 1000.0f, 1000.0f, &x1, &y1 ) ){
+        return false;
+    }
+
+    intrinsics.center_x = x0;
+    intrinsics.center_y = y0;
+    intrinsics.focal_x = x1 - x0;
+    intrinsics.focal_y = y1 - y0;
+    return true;
+}
+
+// Project Point (Return false if z <= 0)
+inline bool projectPoint( const Intrinsics& intrinsics, const float x, const float y, const float z, float* depth_x, float* depth_y )
+{
+    if( z <= 0.0f ){
+        return false;
+    }
+
+    const float inverse = 1.0f / z;
+    *depth_x = intrinsics.center_x + intrinsics.focal_x * x * inverse;
+    *depth_y = intrinsics.center_y + intrinsics.focal_y * y * inverse;
+    return true;
+}
+
+// Unproject Point (Depth Pixel and Depth [mm] to World Coordinates)
+inline void unprojectPoint( const Intrinsics& intrinsics, const float depth_x, const float depth_y, const float z, float* x, float* y )
+{
+    *x = ( depth_x - intrinsics.center_x ) / intrinsics.focal_x * z;
+    *y = ( depth_y - intrinsics.center_y ) / intrinsics.focal_y * z;
+}
+
+// Project Points (Structure of Arrays, SSE/AVX, z <= 0 to ( -1, -1 ))
+void projectPoints( const Intrinsics& intrinsics, const float* x, const float* y, const float* z, float* depth_x, float* depth_y, const size_t count );
+
+// Unproject Points (Structure of Arrays, SSE/AVX)
+void unprojectPoints( const Intrinsics& intrinsics, const float* depth_x, const float* depth_y, const float* z, float* x, float* y, const size_t count );
+
+// Point Batch (Structure of Arrays)
+struct PointBatch
+{
+    // World Coordinates [mm]
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+
+    // Depth Coordinates (Filled by project())
+    std::vector<float> depth_x;
+    std::vector<float> depth_y;
+
+    // Retrieve Number of Points
+    size_t size() const
+    {
+        return x.size();
+    }
+
+    // Clear Points (Keep Capacity)
+    void clear()
+    {
+        x.clear();
+        y.clear();
+        z.clear();
+    }
+
+    // Resize Points (Keep Capacity)
+    void resize( const size_t size )
+    {
+        x.resize( size );
+        y.resize( size );
+        z.resize( size );
+    }
+
+    // Add Point
+    void push( const float px, const float py, const float pz )
+    {
+        x.push_back( px );
+        y.push_back( py );
+        z.push_back( pz );
+    }
+
+    // Project All Points
+    void project( const Intrinsics& intrinsics )
+    {
+        depth_x.resize( x.size() );
+        depth_y.resize( x.size() );
+        projectPoints( intrinsics, x.data(), y.data(), z.data(), depth_x.data(), depth_y.data(), x.size() );
+    }
+};
+
+// Convert Depth Image to Point Cloud (World coordinates [mm], depth 0 to ( 0, 0, 0 ), stride [bytes])
+void depthToPointCloud( const Intrinsics& intrinsics, const uint16_t* depth, const uint32_t width, const uint32_t height, const size_t stride, PointBatch& cloud, TaskPool& pool = taskPool() );
+
+#endif // __PROJECTION__
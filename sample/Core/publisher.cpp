@@ -0,0 +1,900 @@
+#include "publisher.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment( lib, "ws2_32.lib" )
+typedef WSAPOLLFD PollDescriptor;
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+typedef pollfd PollDescriptor;
+#endif
+
+// Broken Connection is Reported by send() instead of SIGPIPE
+#ifdef MSG_NOSIGNAL
+#define PUBLISHER_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define PUBLISHER_SEND_FLAGS 0
+#endif
+
+// Maximum Length of Request Line [bytes]
+#define PUBLISHER_REQUEST_LENGTH 4096
+
+// Maximum Size of Datagram [bytes]
+#define PUBLISHER_DATAGRAM_SIZE 65507
+
+// Joint Names (nite::JointType order)
+static const char* const joint_names[PUBLISHER_JOINT_COUNT] = {
+    "head", "neck", "left_shoulder", "right_shoulder", "left_elbow", "right_elbow", "left_hand", "right_hand",
+    "torso", "left_hip", "right_hip", "left_knee", "right_knee", "left_foot", "right_foot"
+};
+
+// Pose Names (nite::PoseType order)
+static const char* const pose_names[PUBLISHER_POSE_COUNT] = { "psi", "crossed_hands" };
+
+// Gesture Names (nite::GestureType order)
+static const char* const gesture_names[] = { "wave", "click", "hand_raise" };
+
+// Subscriber
+struct StreamPublisher::Subscriber
+{
+    intptr_t fd = -1;         // TCP Socket (-1: UDP subscriber)
+    sockaddr_storage address; // Address of UDP Subscriber
+    socklen_t address_length = 0;
+    SubscriberFilter filter;
+    std::string request;      // Incomplete Request Line (TCP)
+    std::string pending;      // Unsent Bytes (TCP)
+    size_t offset = 0;
+    int64_t due = 0;          // Time of Next Message allowed by Rate [ns]
+    int64_t seen = 0;         // Time of Last Request [ns] (UDP)
+    bool requested = false;   // Valid Request was Received
+};
+
+// Retrieve Steady Clock [ns]
+static int64_t nanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+// Close Socket
+static void closeSocket( const intptr_t fd )
+{
+    if( fd < 0 ){
+        return;
+    }
+
+    #ifdef _WIN32
+    closesocket( static_cast<SOCKET>( fd ) );
+    #else
+    close( static_cast<int>( fd ) );
+    #endif
+}
+
+// Set Socket Non-Blocking
+static void setNonBlocking( const intptr_t fd )
+{
+    #ifdef _WIN32
+    u_long mode = 1;
+    if( ioctlsocket( static_cast<SOCKET>( fd ), FIONBIO, &mode ) != 0 ){
+        throw std::runtime_error( "failed can not set socket non-blocking" );
+    }
+    #else
+    const int flags = fcntl( static_cast<int>( fd ), F_GETFL, 0 );
+    if( flags < 0 || fcntl( static_cast<int>( fd ), F_SETFL, flags | O_NONBLOCK ) < 0 ){
+        throw std::runtime_error( "failed can not set socket non-blocking" );
+    }
+    #endif
+}
+
+// Retrieve Whether Last Socket Call would Block
+static bool wouldBlock()
+{
+    #ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+    #else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    #endif
+}
+
+// Retrieve Bound Port of Socket
+static uint16_t boundPort( const intptr_t fd )
+{
+    sockaddr_storage address = {};
+    socklen_t length = sizeof( address );
+    if( getsockname( fd, reinterpret_cast<sockaddr*>( &address ), &length ) != 0 ){
+        throw std::runtime_error( "failed can not retrieve bound port" );
+    }
+    if( address.ss_family == AF_INET6 ){
+        return ntohs( reinterpret_cast<const sockaddr_in6*>( &address )->sin6_port );
+    }
+    return ntohs( reinterpret_cast<const sockaddr_in*>( &address )->sin_port );
+}
+
+// Open Socket Bound to Address
+static intptr_t openSocket( const sockaddr* address, const socklen_t length, const int type )
+{
+    const intptr_t fd = static_cast<intptr_t>( socket( address->sa_family, type, 0 ) );
+    if( fd < 0 ){
+        throw std::runtime_error( "failed can not create socket" );
+    }
+
+    // Rebind while Connections of Previous Run are in TIME_WAIT
+    const int reuse = 1;
+    setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>( &reuse ), sizeof( reuse ) );
+    if( bind( fd, address, length ) != 0 ){
+        closeSocket( fd );
+        throw std::runtime_error( "failed can not bind socket" );
+    }
+
+    try{
+        setNonBlocking( fd );
+    } catch( ... ){
+        closeSocket( fd );
+        throw;
+    }
+    return fd;
+}
+
+// Append Number to Message (Format of std::ostream)
+static inline void appendNumber( std::string& message, const double value )
+{
+    char buffer[32];
+    const int length = std::snprintf( buffer, sizeof( buffer ), "%g", value );
+    message.append( buffer, static_cast<size_t>( std::max( length, 0 ) ) );
+}
+
+// Append Integer to Message
+static inline void appendInteger( std::string& message, const long long value )
+{
+    char buffer[32];
+    const int length = std::snprintf( buffer, sizeof( buffer ), "%lld", value );
+    message.append( buffer, static_cast<size_t>( std::max( length, 0 ) ) );
+}
+
+// Append Position to Message
+static inline void appendPosition( std::string& message, const float* position )
+{
+    message += ",\"position\":[";
+    appendNumber( message, position[0] );
+    message += ",";
+    appendNumber( message, position[1] );
+    message += ",";
+    appendNumber( message, position[2] );
+    message += "]";
+}
+
+// Append JSON String to Message
+static void appendString( std::string& message, const std::string& text )
+{
+    message += "\"";
+    for( const char character : text ){
+        message += ( character == '"' || character == '\\' || static_cast<unsigned char>( character ) < 0x20 ) ? '?' : character;
+    }
+    message += "\"";
+}
+
+// Retrieve Whether Messages of Filters are Same
+bool SubscriberFilter::encodes( const SubscriberFilter& other ) const
+{
+    return streams == other.streams && joints == other.joints && user_count == other.user_count
+        && std::equal( users.begin(), users.begin() + user_count, other.users.begin() );
+}
+
+// Retrieve Whether User is Selected
+bool SubscriberFilter::selects( const int32_t id ) const
+{
+    return !user_count || std::find( users.begin(), users.begin() + user_count, id ) != users.begin() + user_count;
+}
+
+// Parse Subscriber Request into Filter
+void parseSubscriberRequest( const std::string& request, SubscriberFilter& filter )
+{
+    SubscriberFilter parsed;
+    std::istringstream options( request );
+    std::string option;
+    while( options >> option ){
+        const size_t separator = option.find( '=' );
+        if( separator == std::string::npos ){
+            throw std::runtime_error( "failed invalid option " + option + " (key=value)" );
+        }
+        const std::string key = option.substr( 0, separator );
+        std::istringstream values( option.substr( separator + 1 ) );
+        std::string value;
+
+        // Streams
+        if( key == "streams" ){
+            parsed.streams = 0;
+            while( std::getline( values, value, ',' ) ){
+                if( value == "skeleton" ){
+                    parsed.streams |= PUBLISH_SKELETON;
+                } else if( value == "pose" ){
+                    parsed.streams |= PUBLISH_POSE;
+                } else if( value == "hand" ){
+                    parsed.streams |= PUBLISH_HAND;
+                } else if( value == "gesture" ){
+                    parsed.streams |= PUBLISH_GESTURE;
+                } else if( value == "all" ){
+                    parsed.streams |= PUBLISH_ALL;
+                } else{
+                    throw std::runtime_error( "failed unknown stream " + value + " (skeleton, pose, hand, gesture or all)" );
+                }
+            }
+        }
+        // Joints
+        else if( key == "joints" ){
+            parsed.joints = 0;
+            while( std::getline( values, value, ',' ) ){
+                const char* const* name = std::find( joint_names, joint_names + PUBLISHER_JOINT_COUNT, value );
+                if( name == joint_names + PUBLISHER_JOINT_COUNT ){
+                    throw std::runtime_error( "failed unknown joint " + value );
+                }
+                parsed.joints |= 1u << ( name - joint_names );
+            }
+        }
+        // Users
+        else if( key == "users" ){
+            while( std::getline( values, value, ',' ) ){
+                if( parsed.user_count == PUBLISHER_USER_COUNT ){
+                    throw std::runtime_error( "failed too many users (" + std::to_string( PUBLISHER_USER_COUNT ) + " users)" );
+                }
+                size_t length = 0;
+                try{
+                    parsed.users[parsed.user_count] = std::stoi( value, &length );
+                } catch( ... ){
+                    length = 0;
+                }
+                if( !length || length != value.size() ){
+                    throw std::runtime_error( "failed invalid user id " + value );
+                }
+                parsed.user_count++;
+            }
+        }
+        // Rate
+        else if( key == "rate" ){
+            size_t length = 0;
+            try{
+                parsed.rate = std::stof( values.str(), &length );
+            } catch( ... ){
+                length = 0;
+            }
+            if( !length || length != values.str().size() || !( 0.0f <= parsed.rate ) ){
+                throw std::runtime_error( "failed invalid rate " + values.str() );
+            }
+        } else{
+            throw std::runtime_error( "failed unknown option " + key + " (streams, joints, users or rate)" );
+        }
+    }
+
+    filter = parsed;
+}
+
+// Encode Frame as JSON Line for Filter
+void encodeFrame( const PublishedFrame& frame, const SubscriberFilter& filter, const std::vector<std::string>& names, std::string& message )
+{
+    // Frame
+    message += "{\"frame\":";
+    appendInteger( message, frame.frame_index );
+    message += ",\"timestamp\":";
+    appendInteger( message, static_cast<long long>( frame.timestamp ) );
+    message += ",\"sensor\":";
+    appendInteger( message, frame.sensor );
+
+    // Users (Joints of subset and NiTE poses of selected users)
+    if( filter.streams & ( PUBLISH_SKELETON | PUBLISH_POSE ) ){
+        message += ",\"users\":[";
+        bool first = true;
+        for( uint32_t number = 0; number < frame.user_count && number < PUBLISHER_USER_COUNT; number++ ){
+            const PublishedUser& user = frame.users[number];
+            if( !filter.selects( user.id ) ){
+                continue;
+            }
+            message += first ? "{\"id\":" : ",{\"id\":";
+            appendInteger( message, user.id );
+            first = false;
+
+            // Joints (x, y, z [mm], position confidence)
+            if( filter.streams & PUBLISH_SKELETON ){
+                message += ",\"joints\":{";
+                bool first_joint = true;
+                for( uint32_t type = 0; type < PUBLISHER_JOINT_COUNT; type++ ){
+                    if( !( filter.joints & ( 1u << type ) ) ){
+                        continue;
+                    }
+                    const PublishedJoint& joint = user.joints[type];
+                    message += first_joint ? "\"" : ",\"";
+                    message += joint_names[type];
+                    message += "\":[";
+                    appendNumber( message, joint.position[0] );
+                    message += ",";
+                    appendNumber( message, joint.position[1] );
+                    message += ",";
+                    appendNumber( message, joint.position[2] );
+                    message += ",";
+                    appendNumber( message, joint.confidence );
+                    message += "]";
+                    first_joint = false;
+                }
+                message += "}";
+            }
+
+            // Poses (entered, held, exited)
+            if( filter.streams & PUBLISH_POSE ){
+                message += ",\"poses\":{";
+                for( uint32_t type = 0; type < PUBLISHER_POSE_COUNT; type++ ){
+                    const uint8_t poses = user.poses >> ( type * 3 );
+                    message += type ? ",\"" : "\"";
+                    message += pose_names[type];
+                    message += ( poses & 0x01 ) ? "\":[1," : "\":[0,";
+                    message += ( poses & 0x02 ) ? "1," : "0,";
+                    message += ( poses & 0x04 ) ? "1]" : "0]";
+                }
+                message += "}";
+            }
+            message += "}";
+        }
+        message += "]";
+    }
+
+    // Hands (Tracking)
+    if( filter.streams & PUBLISH_HAND ){
+        message += ",\"hands\":[";
+        bool first = true;
+        for( uint32_t number = 0; number < frame.hand_count && number < PUBLISHER_HAND_COUNT; number++ ){
+            const PublishedHand& hand = frame.hands[number];
+            if( !( hand.flags & 0x04 ) ){
+                continue;
+            }
+            message += first ? "{\"id\":" : ",{\"id\":";
+            appendInteger( message, hand.id );
+            appendPosition( message, hand.position );
+            message += "}";
+            first = false;
+        }
+        message += "]";
+    }
+
+    // Gestures (Progress and Complete) and Matched Templates (Gesture engine)
+    if( filter.streams & PUBLISH_GESTURE ){
+        message += ",\"gestures\":[";
+        for( uint32_t number = 0; number < frame.gesture_count && number < PUBLISHER_GESTURE_COUNT; number++ ){
+            const PublishedGesture& gesture = frame.gestures[number];
+            message += number ? ",{\"type\":\"" : "{\"type\":\"";
+            message += ( gesture.type < sizeof( gesture_names ) / sizeof( gesture_names[0] ) ) ? gesture_names[gesture.type] : "unknown";
+            message += "\"";
+            appendPosition( message, gesture.position );
+            message += ( gesture.flags & 0x02 ) ? ",\"in_progress\":1" : ",\"in_progress\":0";
+            message += ( gesture.flags & 0x01 ) ? ",\"complete\":1}" : ",\"complete\":0}";
+        }
+        message += "],\"matches\":[";
+        for( uint32_t number = 0; number < frame.match_count && number < PUBLISHER_MATCH_COUNT; number++ ){
+            const PublishedMatch& match = frame.matches[number];
+            message += number ? ",{\"gesture\":" : "{\"gesture\":";
+            appendString( message, ( match.gesture < names.size() ) ? names[match.gesture] : std::to_string( match.gesture ) );
+            message += ",\"id\":";
+            appendInteger( message, match.id );
+            message += ",\"distance\":";
+            appendNumber( message, match.distance );
+            appendPosition( message, match.position );
+            message += "}";
+        }
+        message += "]";
+    }
+    message += "}\n";
+}
+
+// Constructor
+StreamPublisher::StreamPublisher( const std::string& host, const uint16_t port, const std::vector<std::string>& names )
+    : names( names ),
+      queue( PUBLISHER_QUEUE_SIZE ),
+      running( false ),
+      subscriber_count( 0 ),
+      requests( 0 ),
+      frames( 0 ),
+      sent( 0 ),
+      decimated( 0 ),
+      dropped( 0 ),
+      encodes( 0 )
+{
+    #ifdef _WIN32
+    WSADATA data;
+    if( WSAStartup( MAKEWORD( 2, 2 ), &data ) != 0 ){
+        throw std::runtime_error( "failed can not initialize winsock" );
+    }
+    #else
+    std::signal( SIGPIPE, SIG_IGN );
+    #endif
+
+    try{
+        // Resolve Address to Listen (Any IPv4 address if host is empty)
+        addrinfo hints = {};
+        hints.ai_family = host.empty() ? AF_INET : AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        addrinfo* addresses = nullptr;
+        const std::string service = std::to_string( port );
+        if( getaddrinfo( host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &addresses ) != 0 || !addresses ){
+            throw std::runtime_error( "failed can not resolve " + host + ":" + service );
+        }
+        sockaddr_storage address = {};
+        const socklen_t length = static_cast<socklen_t>( addresses->ai_addrlen );
+        std::memcpy( &address, addresses->ai_addr, addresses->ai_addrlen );
+        freeaddrinfo( addresses );
+
+        // TCP Listener (Port is assigned by system if 0)
+        listener = openSocket( reinterpret_cast<const sockaddr*>( &address ), length, SOCK_STREAM );
+        if( listen( listener, SOMAXCONN ) != 0 ){
+            throw std::runtime_error( "failed can not listen " + host + ":" + service );
+        }
+        bound_port = boundPort( listener );
+
+        // UDP Socket on Same Port
+        if( address.ss_family == AF_INET6 ){
+            reinterpret_cast<sockaddr_in6*>( &address )->sin6_port = htons( bound_port );
+        } else{
+            reinterpret_cast<sockaddr_in*>( &address )->sin_port = htons( bound_port );
+        }
+        datagram = openSocket( reinterpret_cast<const sockaddr*>( &address ), length, SOCK_DGRAM );
+
+        // Wake-Up Socket Pair on Loopback (Pipe of winsock)
+        sockaddr_in loopback = {};
+        loopback.sin_family = AF_INET;
+        loopback.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+        wake_receiver = openSocket( reinterpret_cast<const sockaddr*>( &loopback ), sizeof( loopback ), SOCK_DGRAM );
+        loopback.sin_port = htons( boundPort( wake_receiver ) );
+        wake_sender = static_cast<intptr_t>( socket( AF_INET, SOCK_DGRAM, 0 ) );
+        if( wake_sender < 0 || connect( wake_sender, reinterpret_cast<const sockaddr*>( &loopback ), sizeof( loopback ) ) != 0 ){
+            throw std::runtime_error( "failed can not connect wake-up socket" );
+        }
+        setNonBlocking( wake_sender );
+    } catch( ... ){
+        closeSockets();
+        throw;
+    }
+
+    // Start Event Loop
+    running = true;
+    thread = std::thread( &StreamPublisher::loop, this );
+}
+
+// Destructor
+StreamPublisher::~StreamPublisher()
+{
+    // Stop Event Loop
+    running = false;
+    wake();
+    if( thread.joinable() ){
+        thread.join();
+    }
+
+    closeSockets();
+}
+
+// Close Sockets
+void StreamPublisher::closeSockets()
+{
+    for( const std::unique_ptr<Subscriber>& subscriber : subscribers ){
+        closeSocket( subscriber->fd );
+    }
+    subscribers.clear();
+
+    for( intptr_t* fd : { &listener, &datagram, &wake_receiver, &wake_sender } ){
+        closeSocket( *fd );
+        *fd = -1;
+    }
+
+    #ifdef _WIN32
+    WSACleanup();
+    #endif
+}
+
+// Retrieve Bound Port
+uint16_t StreamPublisher::port() const
+{
+    return bound_port;
+}
+
+// Retrieve Statistics
+PublisherStatistics StreamPublisher::getStatistics() const
+{
+    PublisherStatistics statistics;
+    statistics.subscribers = subscriber_count.load( std::memory_order_relaxed );
+    statistics.requests = requests.load( std::memory_order_relaxed );
+    statistics.frames = frames.load( std::memory_order_relaxed );
+    statistics.queue_drops = queue.drops();
+    statistics.sent = sent.load( std::memory_order_relaxed );
+    statistics.decimated = decimated.load( std::memory_order_relaxed );
+    statistics.dropped = dropped.load( std::memory_order_relaxed );
+    statistics.encoded = encodes.load( std::memory_order_relaxed );
+    return statistics;
+}
+
+// Wake Event Loop
+void StreamPublisher::wake()
+{
+    // Loop is already awake if buffer of socket is full
+    const char byte = 0;
+    send( wake_sender, &byte, 1, 0 );
+}
+
+// Event Loop
+void StreamPublisher::loop()
+{
+    std::vector<PollDescriptor> descriptors;
+    std::vector<size_t> connections; // Index of TCP subscriber of descriptor (From 3rd descriptor)
+    char buffer[256];
+    while( running ){
+        // Poll Listener, UDP Socket, Wake-Up Socket and TCP Subscribers
+        descriptors.clear();
+        connections.clear();
+        for( const intptr_t fd : { listener, datagram, wake_receiver } ){
+            PollDescriptor descriptor = {};
+            descriptor.fd = static_cast<decltype( descriptor.fd )>( fd );
+            descriptor.events = POLLIN;
+            descriptors.push_back( descriptor );
+        }
+        for( size_t index = 0; index < subscribers.size(); index++ ){
+            const Subscriber& subscriber = *subscribers[index];
+            if( subscriber.fd < 0 ){
+                continue;
+            }
+            PollDescriptor descriptor = {};
+            descriptor.fd = static_cast<decltype( descriptor.fd )>( subscriber.fd );
+            descriptor.events = POLLIN | ( ( subscriber.offset < subscriber.pending.size() ) ? POLLOUT : 0 );
+            descriptors.push_back( descriptor );
+            connections.push_back( index );
+        }
+
+        #ifdef _WIN32
+        const int result = WSAPoll( descriptors.data(), static_cast<ULONG>( descriptors.size() ), PUBLISHER_POLL );
+        #else
+        const int result = poll( descriptors.data(), static_cast<nfds_t>( descriptors.size() ), PUBLISHER_POLL );
+        #endif
+        if( result < 0 && !wouldBlock() ){
+            break;
+        }
+
+        // Drain Wake-Ups
+        if( descriptors[2].revents & POLLIN ){
+            while( recv( wake_receiver, buffer, sizeof( buffer ), 0 ) > 0 ){
+            }
+        }
+
+        // Requests and Pending Bytes of TCP Subscribers (Reverse Order)
+        for( size_t number = connections.size(); 0 < number; number-- ){
+            const short events = descriptors[2 + number].revents;
+            Subscriber& subscriber = *subscribers[connections[number - 1]];
+            bool open = !( events & ( POLLERR | POLLNVAL ) );
+            if( open && ( events & ( POLLIN | POLLHUP ) ) ){
+                open = receive( subscriber );
+            }
+            if( open && ( events & POLLOUT ) ){
+                open = flush( subscriber );
+            }
+            if( !open ){
+                remove( connections[number - 1] );
+            }
+        }
+
+        // New Subscribers
+        if( descriptors[0].revents & POLLIN ){
+            accept();
+        }
+        if( descriptors[1].revents & POLLIN ){
+            receiveDatagrams();
+        }
+
+        // Frames
+        while( queue.pop( frame ) ){
+            dispatch( nanoseconds() );
+        }
+
+        // Expire UDP Subscribers without Request
+        const int64_t expired = nanoseconds() - static_cast<int64_t>( PUBLISHER_UDP_TIMEOUT ) * 1000000000;
+        for( size_t index = subscribers.size(); 0 < index; index-- ){
+            if( subscribers[index - 1]->fd < 0 && subscribers[index - 1]->seen < expired ){
+                remove( index - 1 );
+            }
+        }
+    }
+}
+
+// Accept TCP Subscribers
+void StreamPublisher::accept()
+{
+    while( true ){
+        const intptr_t fd = static_cast<intptr_t>( ::accept( listener, nullptr, nullptr ) );
+        if( fd < 0 ){
+            return;
+        }
+        if( PUBLISHER_MAX_SUBSCRIBERS <= subscribers.size() ){
+            closeSocket( fd );
+            continue;
+        }
+
+        // No Delay and Bounded Send Buffer
+        try{
+            setNonBlocking( fd );
+        } catch( ... ){
+            closeSocket( fd );
+            continue;
+        }
+        const int enable = 1;
+        setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>( &enable ), sizeof( enable ) );
+        const int size = PUBLISHER_SEND_BUFFER;
+        setsockopt( fd, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>( &size ), sizeof( size ) );
+
+        // Subscribe All until Request
+        std::unique_ptr<Subscriber> subscriber( new Subscriber() );
+        subscriber->fd = fd;
+        subscribers.push_back( std::move( subscriber ) );
+        subscriber_count = static_cast<uint32_t>( subscribers.size() );
+    }
+}
+
+// Receive UDP Requests
+void StreamPublisher::receiveDatagrams()
+{
+    char buffer[PUBLISHER_REQUEST_LENGTH];
+    while( true ){
+        sockaddr_storage address = {};
+        socklen_t length = sizeof( address );
+        const int size = static_cast<int>( recvfrom( datagram, buffer, sizeof( buffer ), 0, reinterpret_cast<sockaddr*>( &address ), &length ) );
+        if( size < 0 ){
+            if( wouldBlock() ){
+                return;
+            }
+            continue; // e.g. WSAECONNRESET of previous sendto() on windows
+        }
+
+        // Find Subscriber of Address
+        size_t index = 0;
+        while( index < subscribers.size() ){
+            const Subscriber& subscriber = *subscribers[index];
+            if( subscriber.fd < 0 && subscriber.address_length == length && std::memcmp( &subscriber.address, &address, length ) == 0 ){
+                break;
+            }
+            index++;
+        }
+        std::string line( buffer, static_cast<size_t>( size ) );
+        while( !line.empty() && ( line.back() == '\n' || line.back() == '\r' ) ){
+            line.pop_back();
+        }
+        if( index == subscribers.size() ){
+            if( line == "unsubscribe" || PUBLISHER_MAX_SUBSCRIBERS <= subscribers.size() ){
+                continue;
+            }
+            std::unique_ptr<Subscriber> subscriber( new Subscriber() );
+            subscriber->address = address;
+            subscriber->address_length = length;
+            subscribers.push_back( std::move( subscriber ) );
+            subscriber_count = static_cast<uint32_t>( subscribers.size() );
+        }
+
+        // Request is also Keep-Alive
+        Subscriber& subscriber = *subscribers[index];
+        subscriber.seen = nanoseconds();
+        if( !request( subscriber, line ) || !subscriber.requested ){
+            remove( index );
+        }
+    }
+}
+
+// Receive Request Lines of TCP Subscriber
+bool StreamPublisher::receive( Subscriber& subscriber )
+{
+    char buffer[1024];
+    while( true ){
+        const int size = static_cast<int>( recv( subscriber.fd, buffer, sizeof( buffer ), 0 ) );
+        if( size == 0 ){
+            return false;
+        }
+        if( size < 0 ){
+            return wouldBlock();
+        }
+        subscriber.request.append( buffer, static_cast<size_t>( size ) );
+
+        // Apply Complete Lines
+        size_t begin = 0;
+        size_t end = 0;
+        while( ( end = subscriber.request.find( '\n', begin ) ) != std::string::npos ){
+            std::string line = subscriber.request.substr( begin, end - begin );
+            if( !line.empty() && line.back() == '\r' ){
+                line.pop_back();
+            }
+            if( !request( subscriber, line ) ){
+                return false;
+            }
+            begin = end + 1;
+        }
+        subscriber.request.erase( 0, begin );
+        if( PUBLISHER_REQUEST_LENGTH < subscriber.request.size() ){
+            return false;
+        }
+    }
+}
+
+// Apply Request to Subscriber (Return false if unsubscribed)
+bool StreamPublisher::request( Subscriber& subscriber, const std::string& line )
+{
+    if( line.empty() ){
+        return true;
+    }
+    if( line == "unsubscribe" ){
+        return false;
+    }
+
+    try{
+        parseSubscriberRequest( line, subscriber.filter );
+        subscriber.due = 0;
+        subscriber.requested = true;
+        requests.fetch_add( 1, std::memory_order_relaxed );
+    } catch( std::exception& ex ){
+        // Keep Previous Filter, and Reply Error
+        std::string reply = "{\"error\":";
+        appendString( reply, ex.what() );
+        reply += "}\n";
+        if( 0 <= subscriber.fd ){
+            subscriber.pending += reply;
+        } else{
+            sendto( datagram, reply.data(), static_cast<int>( reply.size() ), 0, reinterpret_cast<const sockaddr*>( &subscriber.address ), subscriber.address_length );
+        }
+    }
+    return true;
+}
+
+// Send Pending Bytes of TCP Subscriber
+bool StreamPublisher::flush( Subscriber& subscriber )
+{
+    while( subscriber.offset < subscriber.pending.size() ){
+        const int size = static_cast<int>( send( subscriber.fd, subscriber.pending.data() + subscriber.offset, static_cast<int>( subscriber.pending.size() - subscriber.offset ), PUBLISHER_SEND_FLAGS ) );
+        if( size < 0 ){
+            if( wouldBlock() ){
+                break;
+            }
+            return false;
+        }
+        subscriber.offset += static_cast<size_t>( size );
+    }
+
+    // Reuse Buffer (Move unsent bytes to front once sent bytes dominate)
+    if( subscriber.offset == subscriber.pending.size() ){
+        subscriber.pending.clear();
+        subscriber.offset = 0;
+    } else if( subscriber.pending.size() < 2 * subscriber.offset ){
+        subscriber.pending.erase( 0, subscriber.offset );
+        subscriber.offset = 0;
+    }
+    return true;
+}
+
+// Dispatch Frame to Subscribers
+void StreamPublisher::dispatch( const int64_t now )
+{
+    frames.fetch_add( 1, std::memory_order_relaxed );
+    encoded_count = 0;
+
+    size_t index = 0;
+    while( index < subscribers.size() ){
+        Subscriber& subscriber = *subscribers[index];
+
+        // Decimate by Rate (A quarter of interval early for jitter)
+        if( 0.0f < subscriber.filter.rate ){
+            const int64_t interval = static_cast<int64_t>( 1e9 / subscriber.filter.rate );
+            if( now + interval / 4 < subscriber.due ){
+                decimated.fetch_add( 1, std::memory_order_relaxed );
+                index++;
+                continue;
+            }
+            subscriber.due = std::max( subscriber.due + interval, now + interval - interval / 4 );
+        }
+
+        // Decimate Slow TCP Subscriber
+        if( 0 <= subscriber.fd && PUBLISHER_BACKLOG < subscriber.pending.size() - subscriber.offset ){
+            dropped.fetch_add( 1, std::memory_order_relaxed );
+            index++;
+            continue;
+        }
+
+        const std::string& message = encode( subscriber.filter );
+        bool open = true;
+        if( 0 <= subscriber.fd ){
+            // Send Directly if Nothing is Pending, Buffer the Rest
+            size_t offset = 0;
+            if( subscriber.offset == subscriber.pending.size() ){
+                const int size = static_cast<int>( send( subscriber.fd, message.data(), static_cast<int>( message.size() ), PUBLISHER_SEND_FLAGS ) );
+                if( size < 0 && !wouldBlock() ){
+                    open = false;
+                }
+                offset = ( 0 < size ) ? static_cast<size_t>( size ) : 0;
+            }
+            if( open && offset < message.size() ){
+                subscriber.pending.append( message, offset, std::string::npos );
+            }
+        } else{
+            // Datagram is Dropped if Buffer of Socket is Full
+            if( PUBLISHER_DATAGRAM_SIZE < message.size()
+                || sendto( datagram, message.data(), static_cast<int>( message.size() ), 0, reinterpret_cast<const sockaddr*>( &subscriber.address ), subscriber.address_length ) < 0 ){
+                dropped.fetch_add( 1, std::memory_order_relaxed );
+                index++;
+                continue;
+            }
+        }
+
+        if( !open ){
+            remove( index );
+            continue;
+        }
+        sent.fetch_add( 1, std::memory_order_relaxed );
+        index++;
+    }
+}
+
+// Retrieve Encoded Message of Filter
+const std::string& StreamPublisher::encode( const SubscriberFilter& filter )
+{
+    for( uint32_t index = 0; index < encoded_count; index++ ){
+        if( encoded[index].filter.encodes( filter ) ){
+            return encoded[index].message;
+        }
+    }
+
+    // Reuse Capacity of Messages of Previous Frames
+    if( encoded_count == encoded.size() ){
+        encoded.emplace_back();
+    }
+    Encoded& entry = encoded[encoded_count++];
+    entry.filter = filter;
+    entry.message.clear();
+    encodeFrame( frame, filter, names, entry.message );
+    encodes.fetch_add( 1, std::memory_order_relaxed );
+    return entry.message;
+}
+
+// Remove Subscriber
+void StreamPublisher::remove( const size_t index )
+{
+    closeSocket( subscribers[index]->fd );
+    std::swap( subscribers[index], subscribers.back() );
+    subscribers.pop_back();
+    subscriber_count = static_cast<uint32_t>( subscribers.size() );
+}
+
+// Create Stream Publisher
+std::unique_ptr<StreamPublisher> createStreamPublisher( const std::string& uri, const std::vector<std::string>& names )
+{
+    // PORT or HOST:PORT (HOST may be IPv6 address in brackets)
+    const size_t separator = uri.rfind( ':' );
+    std::string host = ( separator == std::string::npos ) ? "" : uri.substr( 0, separator );
+    const std::string port = ( separator == std::string::npos ) ? uri : uri.substr( separator + 1 );
+    if( 2 <= host.size() && host.front() == '[' && host.back() == ']' ){
+        host = host.substr( 1, host.size() - 2 );
+    }
+
+    size_t length = 0;
+    unsigned long number = 0;
+    try{
+        number = std::stoul( port, &length );
+    } catch( ... ){
+        length = 0;
+    }
+    if( !length || length != port.size() || 65535 < number ){
+        throw std::runtime_error( "failed invalid publisher " + uri + " (PORT or HOST:PORT)" );
+    }
+
+    return std::unique_ptr<StreamPublisher>( new StreamPublisher( host, static_cast<uint16_t>( number ), names ) );
+}
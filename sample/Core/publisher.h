@@ -0,0 +1,262 @@
+#ifndef __PUBLISHER__
+#define __PUBLISHER__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spsc_queue.h"
+
+// Stream Publisher (Standalone, no OpenNI2/NiTE2/OpenCV)
+// Subscribers connect by TCP, or send a request datagram by UDP, and receive one JSON line per frame.
+// A request is one line of space separated options (all by default):
+//   streams=skeleton,pose,hand,gesture  Parts of frame ("users" for skeleton/pose, "hands", "gestures" and "matches")
+//   joints=head,left_hand,...           Joint subset ("neck", "torso", "left_"/"right_" + shoulder, elbow, hand, hip, knee, foot)
+//   users=1,2                           User id subset
+//   rate=10                             Maximum rate [Hz] (0: every frame)
+// UDP subscribers repeat the request within PUBLISHER_UDP_TIMEOUT, "unsubscribe" removes a subscriber.
+#define PUBLISHER_USER_COUNT 6
+#define PUBLISHER_JOINT_COUNT 15
+#define PUBLISHER_POSE_COUNT 2
+#define PUBLISHER_HAND_COUNT 6
+#define PUBLISHER_GESTURE_COUNT 8
+#define PUBLISHER_MATCH_COUNT 8
+
+// Capacity of Frame Queue from Tracker to Event Loop [frames]
+#define PUBLISHER_QUEUE_SIZE 16
+
+// Maximum Unsent Bytes of TCP Subscriber (Frames are dropped beyond this)
+#define PUBLISHER_BACKLOG 65536
+
+// Kernel Send Buffer of TCP Subscriber [bytes]
+#define PUBLISHER_SEND_BUFFER 65536
+
+// Maximum Number of Subscribers
+#define PUBLISHER_MAX_SUBSCRIBERS 256
+
+// Timeout of UDP Subscriber without Request [s]
+#define PUBLISHER_UDP_TIMEOUT 5
+
+// Poll Timeout of Event Loop [ms]
+#define PUBLISHER_POLL 100
+
+// Streams (Parts of frame)
+enum PublishStream
+{
+    PUBLISH_SKELETON = 0x01, // Joints of users
+    PUBLISH_POSE = 0x02,     // NiTE poses of users
+    PUBLISH_HAND = 0x04,     // Hands
+    PUBLISH_GESTURE = 0x08,  // NiTE gestures and custom gesture matches
+    PUBLISH_ALL = 0x0F
+};
+
+// Published Joint
+struct PublishedJoint
+{
+    float position[3]; // x, y, z [mm]
+    float confidence;  // Position Confidence
+};
+
+// Published User
+struct PublishedUser
+{
+    int32_t id;
+    uint8_t state; // nite::SkeletonState
+    uint8_t poses; // bit (3 * type + 0): entered, (3 * type + 1): held, (3 * type + 2): exited
+    PublishedJoint joints[PUBLISHER_JOINT_COUNT];
+};
+
+// Published Hand
+struct PublishedHand
+{
+    int32_t id;
+    uint32_t flags; // bit 0: new, 1: lost, 2: tracking, 3: touching field of view
+    float position[3];
+};
+
+// Published Gesture
+struct PublishedGesture
+{
+    uint32_t type;  // nite::GestureType
+    uint32_t flags; // bit 0: complete, 1: in progress
+    float position[3];
+};
+
+// Published Match (Custom gesture of gesture engine)
+struct PublishedMatch
+{
+    uint32_t gesture; // Index of Template
+    int32_t id;       // Hand Id or User Id
+    float distance;
+    float position[3];
+};
+
+// Published Frame (Copied by Value)
+struct PublishedFrame
+{
+    uint64_t timestamp = 0; // Sensor Timestamp [us]
+    int32_t frame_index = 0;
+    uint32_t sensor = 0;
+
+    uint32_t user_count = 0;
+    std::array<PublishedUser, PUBLISHER_USER_COUNT> users;
+    uint32_t hand_count = 0;
+    std::array<PublishedHand, PUBLISHER_HAND_COUNT> hands;
+    uint32_t gesture_count = 0;
+    std::array<PublishedGesture, PUBLISHER_GESTURE_COUNT> gestures;
+    uint32_t match_count = 0;
+    std::array<PublishedMatch, PUBLISHER_MATCH_COUNT> matches;
+};
+
+// Subscriber Filter
+struct SubscriberFilter
+{
+    uint32_t streams = PUBLISH_ALL;
+    uint32_t joints = ( 1u << PUBLISHER_JOINT_COUNT ) - 1; // Bit of joint type
+    uint32_t user_count = 0;                                // 0: All users
+    std::array<int32_t, PUBLISHER_USER_COUNT> users;
+    float rate = 0.0f;                                      // [Hz] (0: every frame)
+
+    // Retrieve Whether Messages of Filters are Same
+    bool encodes( const SubscriberFilter& other ) const;
+
+    // Retrieve Whether User is Selected
+    bool selects( const int32_t id ) const;
+};
+
+// Parse Subscriber Request into Filter (Throw if invalid)
+void parseSubscriberRequest( const std::string& request, SubscriberFilter& filter );
+
+// Encode Frame as JSON Line for Filter (Append to message, names of custom gesture templates if given)
+void encodeFrame( const PublishedFrame& frame, const SubscriberFilter& filter, const std::vector<std::string>& names, std::string& message );
+
+// Statistics of Publisher
+struct PublisherStatistics
+{
+    uint32_t subscribers = 0; // Current TCP and UDP subscribers
+    uint64_t requests = 0;    // Valid requests received
+    uint64_t frames = 0;      // Frames dispatched by event loop
+    uint64_t queue_drops = 0; // Frames dropped at publish() (Event loop was behind)
+    uint64_t sent = 0;        // Messages sent to subscribers
+    uint64_t decimated = 0;   // Messages skipped by rate of subscriber
+    uint64_t dropped = 0;     // Messages dropped by backlog of subscriber (Slow consumer)
+    uint64_t encoded = 0;     // Messages encoded (Once per distinct filter per frame)
+};
+
+// Stream Publisher (Lock-free handoff to event loop thread, encoded once per distinct filter, slow subscribers decimated)
+class StreamPublisher
+{
+private:
+    // Subscriber
+    struct Subscriber;
+
+    // Encoded Message of Filter (Reused across frames)
+    struct Encoded
+    {
+        SubscriberFilter filter;
+        std::string message;
+    };
+
+    // Names of Custom Gesture Templates
+    std::vector<std::string> names;
+
+    // Sockets
+    intptr_t listener = -1;
+    intptr_t datagram = -1;
+    intptr_t wake_receiver = -1;
+    intptr_t wake_sender = -1; // Used by tracker thread only
+    uint16_t bound_port = 0;
+
+    // Subscribers (Owned by event loop)
+    std::vector<std::unique_ptr<Subscriber>> subscribers;
+    std::vector<Encoded> encoded;
+    uint32_t encoded_count = 0;
+
+    // Frames from Tracker
+    SpscQueue<PublishedFrame> queue;
+    PublishedFrame frame; // Owned by event loop
+
+    // Event Loop
+    std::thread thread;
+    std::atomic<bool> running;
+
+    // Statistics
+    std::atomic<uint32_t> subscriber_count;
+    std::atomic<uint64_t> requests;
+    std::atomic<uint64_t> frames;
+    std::atomic<uint64_t> sent;
+    std::atomic<uint64_t> decimated;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint64_t> encodes;
+
+public:
+    // Constructor (Listen TCP and UDP on host and port, and start event loop)
+    StreamPublisher( const std::string& host, const uint16_t port, const std::vector<std::string>& names = std::vector<std::string>() );
+
+    // Destructor (Stop event loop and close subscribers)
+    ~StreamPublisher();
+
+    StreamPublisher( const StreamPublisher& ) = delete;
+    StreamPublisher& operator=( const StreamPublisher& ) = delete;
+
+    // Publish Frame Written in Place by function( PublishedFrame& ) (Tracker thread, return false if queue was full)
+    template<typename Function>
+    bool publish( Function function )
+    {
+        if( !queue.emplace( function ) ){
+            return false;
+        }
+        wake();
+        return true;
+    }
+
+    // Retrieve Bound Port
+    uint16_t port() const;
+
+    // Retrieve Statistics
+    PublisherStatistics getStatistics() const;
+
+private:
+    // Wake Event Loop (Tracker thread)
+    void wake();
+
+    // Event Loop
+    void loop();
+
+    // Accept TCP Subscribers
+    void accept();
+
+    // Receive UDP Requests
+    void receiveDatagrams();
+
+    // Receive Request Lines of TCP Subscriber (Return false if closed)
+    bool receive( Subscriber& subscriber );
+
+    // Apply Request to Subscriber (Return false if unsubscribed)
+    bool request( Subscriber& subscriber, const std::string& line );
+
+    // Send Pending Bytes of TCP Subscriber (Return false if closed)
+    bool flush( Subscriber& subscriber );
+
+    // Dispatch Frame to Subscribers
+    void dispatch( const int64_t now );
+
+    // Retrieve Encoded Message of Filter (Encoded once per frame)
+    const std::string& encode( const SubscriberFilter& filter );
+
+    // Remove Subscriber (Swap with last)
+    void remove( const size_t index );
+
+    // Close Sockets
+    void closeSockets();
+};
+
+// Create Stream Publisher ("PORT" or "HOST:PORT")
+std::unique_ptr<StreamPublisher> createStreamPublisher( const std::string& uri, const std::vector<std::string>& names = std::vector<std::string>() );
+
+#endif // __PUBLISHER__
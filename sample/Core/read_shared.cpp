@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "shared_frame.h"
+
+// Stop Reading if No Frame is Published for [s]
+#define READ_TIMEOUT 5
+
+// Write Frame as JSON Line (Fields of headless mode, and latency)
+static void writeFrame( const SharedFrameView& frame, std::ostream& stream )
+{
+    const SharedFrameInfo& info = *frame.info;
+    stream << "{\"frame\":" << info.frame_index << ",\"timestamp\":" << info.timestamp << ",\"sensor\":" << info.sensor;
+
+    // Users (Tracked Skeletons of Snapshot)
+    stream << ",\"users\":[";
+    for( uint32_t number = 0; number < info.user_count && number < SHARED_USER_COUNT; number++ ){
+        stream << ( number ? "," : "" ) << "{\"id\":" << info.user_ids[number];
+
+        // Joints (x, y, z [mm], position confidence)
+        stream << ",\"joints\":[";
+        for( uint32_t type = 0; type < SHARED_JOINT_COUNT; type++ ){
+            const size_t lane = SharedFrameView::lane( number, type );
+            stream << ( type ? "," : "" ) << "[" << frame.x[lane] << "," << frame.y[lane] << "," << frame.z[lane] << "," << frame.position_confidence[lane] << "]";
+        }
+        stream << "]}";
+    }
+    stream << "]";
+
+    // Hands
+    stream << ",\"hands\":[";
+    for( uint32_t number = 0; number < info.hand_count && number < SHARED_HAND_COUNT; number++ ){
+        const SharedHand& hand = info.hands[number];
+        stream << ( number ? "," : "" ) << "{\"id\":" << hand.id << ",\"tracking\":" << ( ( hand.flags & 0x04 ) ? "true" : "false" )
+               << ",\"position\":[" << hand.position[0] << "," << hand.position[1] << "," << hand.position[2] << "]}";
+    }
+    stream << "]";
+
+    // Planes (Size and value at center)
+    if( frame.depth ){
+        stream << ",\"depth\":[" << info.width << "," << info.height << "," << frame.depth[static_cast<size_t>( info.height / 2 ) * info.width + info.width / 2] << "]";
+    }
+    if( frame.user_map ){
+        stream << ",\"user_map\":[" << info.width << "," << info.height << "]";
+    }
+
+    // Planes Skipped by Size beyond Capacity
+    if( info.skipped ){
+        stream << ",\"skipped\":[" << ( ( info.skipped & SHARED_FRAME_DEPTH ) ? "\"depth\"" : "" ) << ( ( info.skipped == ( SHARED_FRAME_DEPTH | SHARED_FRAME_USER_MAP ) ) ? "," : "" )
+               << ( ( info.skipped & SHARED_FRAME_USER_MAP ) ? "\"user_map\"" : "" ) << "]";
+    }
+}
+
+// Shared Frame Reader
+// read_shared [name] [frames]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const std::string name = ( 1 < argc ) ? argv[1] : "nite2";
+        const uint64_t frames = ( 2 < argc ) ? std::stoull( argv[2] ) : 0;
+
+        SharedFrameReader reader( name );
+        std::ostringstream record;
+        uint64_t last = reader.latest();
+        uint64_t count = 0;
+        uint64_t lapped = 0;
+        while( !frames || count < frames ){
+            // Wait for Next Frame
+            const uint64_t latest = reader.wait( last, std::chrono::seconds( READ_TIMEOUT ) );
+            if( latest == last ){
+                break;
+            }
+            if( reader.slots() < latest - last ){
+                lapped += latest - last - reader.slots();
+                last = latest - reader.slots();
+            }
+
+            for( uint64_t sequence = last + 1; sequence <= latest && ( !frames || count < frames ); sequence++ ){
+                // Format in Place (Print only if not overwritten)
+                int64_t published = 0;
+                record.str( "" );
+                const SharedReadStatus status = reader.read( sequence, [&]( const SharedFrameView& frame ){
+                    published = frame.info->published;
+                    writeFrame( frame, record );
+                } );
+                if( status != SHARED_READ_OK ){
+                    lapped++;
+                    continue;
+                }
+
+                const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+                std::cout << record.str() << ",\"latency\":" << ( now - published ) / 1000 << "}\n";
+                count++;
+            }
+            last = latest;
+        }
+
+        std::cerr << count << " frames read, " << lapped << " frames lapped" << std::endl;
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
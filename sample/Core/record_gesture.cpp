@@ -0,0 +1,187 @@
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "gesture_engine.h"
+#include "hand_source.h"
+#include "shutdown.h"
+#include "user_source.h"
+#include "util.h"
+
+// Trajectory Recorder (Positions and sensor timestamps of one track)
+class TrajectoryRecorder
+{
+private:
+    GestureTemplate& gesture;
+    uint32_t skip;
+    uint32_t frames;
+    uint64_t start = 0;
+    uint64_t previous = 0;
+
+public:
+    // Constructor (Skip frames of track, then record frames)
+    TrajectoryRecorder( GestureTemplate& gesture, const uint32_t skip, const uint32_t frames )
+        : gesture( gesture ),
+          skip( skip ),
+          frames( frames )
+    {
+    }
+
+    // Add Position of Track, and Retrieve Whether Recording is Complete
+    bool add( const nite::Point3f& position, const uint64_t timestamp )
+    {
+        if( skip ){
+            skip--;
+            return false;
+        }
+        if( gesture.times.empty() ){
+            start = timestamp;
+        }
+        else if( timestamp <= previous ){
+            return false;
+        }
+        previous = timestamp;
+
+        gesture.times.push_back( static_cast<float>( timestamp - start ) / 1000.0f );
+        gesture.points.push_back( { { position.x, position.y, position.z } } );
+        return frames <= gesture.points.size();
+    }
+};
+
+// Record Trajectory of First Tracked Hand (Hand tracking is started at completed gestures)
+static void recordHand( const std::string& uri, TrajectoryRecorder& recorder )
+{
+    std::unique_ptr<HandSource> source = createHandSource( uri );
+    NITE_CHECK( source->startGestureDetection( nite::GestureType::GESTURE_WAVE ) );
+    NITE_CHECK( source->startGestureDetection( nite::GestureType::GESTURE_CLICK ) );
+
+    HandFrame frame;
+    nite::HandId track = 0;
+    while( !isShutdownRequested() ){
+        source->readFrame( frame );
+
+        // Start Hand Tracking with Gesture Detected Position
+        for( const Gesture& gesture : frame.gestures ){
+            if( gesture.is_complete ){
+                nite::HandId hand_id;
+                source->startHandTracking( gesture.current_position, &hand_id );
+            }
+        }
+
+        // Record First Tracked Hand (Fail if it is lost)
+        for( const Hand& hand : frame.hands ){
+            if( ( track && hand.id != track ) || !hand.is_tracking ){
+                if( hand.id == track && hand.is_lost ){
+                    throw std::runtime_error( "failed hand is lost while recording" );
+                }
+                continue;
+            }
+            track = hand.id;
+            if( recorder.add( hand.position, frame.sensor_timestamp ) ){
+                return;
+            }
+        }
+    }
+}
+
+// Record Trajectory of Hand Joint of First Tracked User (Skeleton)
+static void recordJoint( const std::string& uri, const nite::JointType joint, TrajectoryRecorder& recorder )
+{
+    std::unique_ptr<UserSource> source = createUserSource( uri );
+
+    UserFrame frame;
+    nite::UserId track = 0;
+    while( !isShutdownRequested() ){
+        source->readFrame( frame );
+
+        for( const User& user : frame.users ){
+            if( user.is_new ){
+                source->startSkeletonTracking( user.id );
+            }
+            if( ( track && user.id != track ) || user.skeleton_state != nite::SkeletonState::SKELETON_TRACKED ){
+                if( user.id == track && user.is_lost ){
+                    throw std::runtime_error( "failed user is lost while recording" );
+                }
+                continue;
+            }
+
+            // Joints below Confidence are not Recorded
+            const Joint& data = user.joints[joint];
+            track = user.id;
+            if( data.position_confidence < 0.5f ){
+                continue;
+            }
+            if( recorder.add( data.position, frame.sensor_timestamp ) ){
+                return;
+            }
+        }
+    }
+}
+
+// Gesture Template Recorder
+// record_gesture [hand|left_hand|right_hand] [source] [templates] [name] [skip] [frames] [threshold]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const std::string kind = ( 1 < argc ) ? argv[1] : "hand";
+        const std::string uri = ( 2 < argc ) ? argv[2] : "";
+        const std::string path = ( 3 < argc ) ? argv[3] : "gestures.txt";
+        const std::string name = ( 4 < argc ) ? argv[4] : "gesture";
+        const uint32_t skip = ( 5 < argc ) ? static_cast<uint32_t>( std::stoul( argv[5] ) ) : 0;
+        const uint32_t frames = ( 6 < argc ) ? static_cast<uint32_t>( std::stoul( argv[6] ) ) : 45;
+        const float threshold = ( 7 < argc ) ? std::stof( argv[7] ) : GESTURE_THRESHOLD;
+        if( frames < 2 || threshold <= 0.0f ){
+            throw std::runtime_error( "failed number of frames must be 2 or more and threshold must be greater than 0" );
+        }
+
+        // Load Existing Templates
+        std::vector<GestureTemplate> templates;
+        if( std::ifstream( path ).good() ){
+            templates = loadGestureTemplates( path );
+        }
+        for( const GestureTemplate& other : templates ){
+            if( other.name == name ){
+                throw std::runtime_error( "failed duplicate gesture " + name + " in " + path );
+            }
+        }
+
+        installShutdownHandler();
+
+        // Record Trajectory
+        GestureTemplate gesture;
+        gesture.name = name;
+        gesture.threshold = threshold;
+        TrajectoryRecorder recorder( gesture, skip, frames );
+        try{
+            if( kind == "hand" ){
+                recordHand( uri, recorder );
+            }
+            else if( kind == "left_hand" || kind == "right_hand" ){
+                recordJoint( uri, ( kind == "left_hand" ) ? nite::JointType::JOINT_LEFT_HAND : nite::JointType::JOINT_RIGHT_HAND, recorder );
+            }
+            else{
+                throw std::runtime_error( "failed unknown track kind " + kind + " (hand, left_hand or right_hand)" );
+            }
+        } catch( const EndOfSource& ){
+        }
+        if( gesture.points.size() < frames ){
+            throw std::runtime_error( "failed source ended after " + std::to_string( gesture.points.size() ) + " of " + std::to_string( frames ) + " frames" );
+        }
+
+        // Validate Template (Duration and motion) and Append to File
+        templates.push_back( gesture );
+        GestureEngine engine( templates );
+        saveGestureTemplates( path, templates );
+
+        std::cout << "recorded gesture " << name << " (" << gesture.points.size() << " points, " << gesture.times.back() << " ms) to " << path << std::endl;
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
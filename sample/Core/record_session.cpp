@@ -0,0 +1,154 @@
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "hand_source.h"
+#include "session.h"
+#include "shutdown.h"
+#include "user_source.h"
+#include "util.h"
+
+// Parse Session Flags ("all", "depth", "usermap" or "none")
+static uint32_t parseSessionFlags( const std::string& name, const SessionKind kind )
+{
+    if( name == "all" ){
+        return ( kind == SESSION_USER ) ? ( SESSION_DEPTH | SESSION_USER_MAP ) : SESSION_DEPTH;
+    }
+    if( name == "depth" ){
+        return SESSION_DEPTH;
+    }
+    if( name == "usermap" && kind == SESSION_USER ){
+        return SESSION_USER_MAP;
+    }
+    if( name == "none" ){
+        return 0;
+    }
+
+    throw std::runtime_error( "failed unknown session option " + name + " (all, depth, usermap or none)" );
+}
+
+// Record User Session (Start skeleton tracking and pose detection of new users)
+static uint64_t recordUser( const std::string& uri, const std::string& path, const std::string& options, const uint64_t frames )
+{
+    std::unique_ptr<UserSource> source = createUserSource( uri );
+    UserFrame frame;
+    source->readFrame( frame );
+
+    SessionWriter writer( path, createUserSessionHeader( frame, parseSessionFlags( options, SESSION_USER ) ) );
+
+    uint64_t count = 0;
+    while( true ){
+        // Start Skeleton Tracking and Pose Detection
+        for( const User& user : frame.users ){
+            if( user.is_new ){
+                source->startSkeletonTracking( user.id );
+                source->startPoseDetection( user.id, nite::PoseType::POSE_PSI );
+                source->startPoseDetection( user.id, nite::PoseType::POSE_CROSSED_HANDS );
+            }
+        }
+
+        // Append Frame
+        appendSession( writer, frame );
+        count++;
+        if( isShutdownRequested() || ( frames && frames <= count ) ){
+            break;
+        }
+
+        // Read Frame (until End of Source or Playback File Repeats)
+        const uint64_t timestamp = frame.sensor_timestamp;
+        try{
+            source->readFrame( frame );
+        } catch( const EndOfSource& ){
+            break;
+        }
+        if( frame.sensor_timestamp < timestamp ){
+            break;
+        }
+    }
+
+    writer.close();
+    return count;
+}
+
+// Record Hand Session (Start hand tracking at completed gestures)
+static uint64_t recordHand( const std::string& uri, const std::string& path, const std::string& options, const uint64_t frames )
+{
+    std::unique_ptr<HandSource> source = createHandSource( uri );
+    NITE_CHECK( source->startGestureDetection( nite::GestureType::GESTURE_WAVE ) );
+    NITE_CHECK( source->startGestureDetection( nite::GestureType::GESTURE_CLICK ) );
+    NITE_CHECK( source->startGestureDetection( nite::GestureType::GESTURE_HAND_RAISE ) );
+
+    HandFrame frame;
+    source->readFrame( frame );
+
+    SessionWriter writer( path, createHandSessionHeader( frame, parseSessionFlags( options, SESSION_HAND ) ) );
+
+    uint64_t count = 0;
+    while( true ){
+        // Start Hand Tracking with Gesture Detected Position
+        for( const Gesture& gesture : frame.gestures ){
+            if( gesture.is_complete ){
+                nite::HandId hand_id;
+                source->startHandTracking( gesture.current_position, &hand_id );
+            }
+        }
+
+        // Append Frame
+        appendSession( writer, frame );
+        count++;
+        if( isShutdownRequested() || ( frames && frames <= count ) ){
+            break;
+        }
+
+        // Read Frame (until End of Source or Playback File Repeats)
+        const uint64_t timestamp = frame.sensor_timestamp;
+        try{
+            source->readFrame( frame );
+        } catch( const EndOfSource& ){
+            break;
+        }
+        if( frame.sensor_timestamp < timestamp ){
+            break;
+        }
+    }
+
+    writer.close();
+    return count;
+}
+
+// Session Recorder
+// record_session [user|hand] [source] [output] [all|depth|usermap|none] [frames]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const std::string kind = ( 1 < argc ) ? argv[1] : "user";
+        const std::string uri = ( 2 < argc ) ? argv[2] : "";
+        const std::string path = ( 3 < argc ) ? argv[3] : kind + ".session";
+        const std::string options = ( 4 < argc ) ? argv[4] : "all";
+        const uint64_t frames = ( 5 < argc ) ? std::stoull( argv[5] ) : 0;
+
+        installShutdownHandler();
+
+        // Record Session
+        uint64_t count = 0;
+        if( kind == "user" ){
+            count = recordUser( uri, path, options, frames );
+        }
+        else if( kind == "hand" ){
+            count = recordHand( uri, path, options, frames );
+        }
+        else{
+            throw std::runtime_error( "failed unknown session kind " + kind + " (user or hand)" );
+        }
+
+        std::cout << "recorded " << count << " frames to " << path << std::endl;
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
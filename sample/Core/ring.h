@@ -0,0 +1,118 @@
+#ifndef __RING__
+#define __RING__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Bounded Ring (Single producer and consumer, push() drops the oldest element when full)
+template<typename T>
+class Ring
+{
+private:
+    // Buffer
+    std::vector<T> buffer;
+    uint32_t head = 0;
+    uint32_t count = 0;
+
+    // Status
+    bool closed = false;
+    uint64_t dropped = 0;
+
+    // Synchronization
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+
+public:
+    // Constructor
+    explicit Ring( const uint32_t capacity )
+        : buffer( capacity )
+    {
+    }
+
+    // Push Element (Drop Oldest)
+    void push( T&& element )
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if( closed ){
+                return;
+            }
+
+            if( count == buffer.size() ){
+                buffer[head] = T();
+                head = ( head + 1 ) % buffer.size();
+                count--;
+                dropped++;
+            }
+
+            buffer[( head + count ) % buffer.size()] = std::move( element );
+            count++;
+        }
+
+        condition.notify_one();
+    }
+
+    // Pop Element (Block until an element is available or the ring is closed)
+    bool pop( T& element )
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        condition.wait( lock, [this]{ return count || closed; } );
+        return take( element );
+    }
+
+    // Pop Element (Block until an element is available, the ring is closed or timeout)
+    template<typename Rep, typename Period>
+    bool pop( T& element, const std::chrono::duration<Rep, Period>& timeout )
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        condition.wait_for( lock, timeout, [this]{ return count || closed; } );
+        return take( element );
+    }
+
+    // Close Ring (Wake up waiting consumer)
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            closed = true;
+        }
+
+        condition.notify_all();
+    }
+
+    // Retrieve Number of Elements
+    uint32_t size() const
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        return count;
+    }
+
+    // Retrieve Number of Dropped Elements
+    uint64_t drops() const
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        return dropped;
+    }
+
+private:
+    // Take Front Element
+    bool take( T& element )
+    {
+        if( !count ){
+            return false;
+        }
+
+        element = std::move( buffer[head] );
+        buffer[head] = T();
+        head = ( head + 1 ) % buffer.size();
+        count--;
+
+        return true;
+    }
+};
+
+#endif // __RING__
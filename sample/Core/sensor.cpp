@@ -0,0 +1,90 @@
+#include "sensor.h"
+#include "util.h"
+
+// Initialize OpenNI2 and NiTE2
+void initializeSensor()
+{
+    // Initialize OpenNI2
+    OPENNI_CHECK( openni::OpenNI::initialize() );
+
+    // Initiaize Nite2
+    NITE_CHECK( nite::NiTE::initialize() );
+}
+
+// Enumerate Connected Devices
+std::vector<std::string> enumerateDevices()
+{
+    // Initialize OpenNI2 and NiTE2
+    initializeSensor();
+
+    // Retrive Connected Devices List
+    openni::Array<openni::DeviceInfo> device_info_list;
+    openni::OpenNI::enumerateDevices( &device_info_list );
+
+    std::vector<std::string> uris;
+    for( int32_t i = 0; i < device_info_list.getSize(); i++ ){
+        uris.push_back( device_info_list[i].getUri() );
+    }
+    return uris;
+}
+
+// Open Device
+bool openDevice( openni::Device& device, const std::string& uri )
+{
+    if( !uri.empty() ){
+        // Open Playback File (or Device URI)
+        OPENNI_CHECK( device.open( uri.c_str() ) );
+        return true;
+    }
+
+    #if (DEVICE != REALSENSE)
+    return false;
+    #else
+    // Retrive Connected Devices List
+    openni::Array<openni::DeviceInfo> device_info_list;
+    openni::OpenNI::enumerateDevices( &device_info_list );
+    if( !device_info_list.getSize() ){
+        throw std::runtime_error( "failed could not find devices" );
+    }
+
+    // Open Device
+    const openni::DeviceInfo& device_info = device_info_list[0];
+    const std::string device_uri = device_info.getUri();
+    OPENNI_CHECK( device.open( device_uri.c_str() ) );
+    return true;
+    #endif
+}
+
+// Read Field of View of Depth Stream
+bool readDepthFieldOfView( openni::Device& device, float& horizontal_fov, float& vertical_fov )
+{
+    if( !device.isValid() || !device.hasSensor( openni::SensorType::SENSOR_DEPTH ) ){
+        return false;
+    }
+
+    openni::VideoStream depth_stream;
+    OPENNI_CHECK( depth_stream.create( device, openni::SensorType::SENSOR_DEPTH ) );
+    horizontal_fov = depth_stream.getHorizontalFieldOfView();
+    vertical_fov = depth_stream.getVerticalFieldOfView();
+    depth_stream.destroy();
+
+    return 0.0f < horizontal_fov && 0.0f < vertical_fov;
+}
+
+#if (DEVICE == REALSENSE)
+// Convert World Coordinates to Depth by RealSense Projection
+nite::Status convertRealSenseCoordinatesToDepth( openni::Device& device, const uint32_t depth_height, const float x, const float y, const float z, float* pOutX, float* pOutY )
+{
+    Rs2PointPixel proj = { 0.0 };
+    proj.point[0] = x;
+    proj.point[1] = y;
+    proj.point[2] = z;
+
+    OPENNI_CHECK( device.invoke( RS2_PROJECT_POINT_TO_PIXEL, reinterpret_cast<void*>( &proj ), static_cast<int>( sizeof( proj ) ) ) );
+
+    *pOutX = proj.pixel[0];
+    *pOutY = depth_height - proj.pixel[1];
+
+    return nite::Status::STATUS_OK;
+}
+#endif
@@ -0,0 +1,43 @@
+#ifndef __SENSOR__
+#define __SENSOR__
+
+#include <OpenNI.h>
+#include <NiTE.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Specify Device
+// For RealSense https://github.com/IntelRealSense/librealsense/issues/2825
+#define PRIMESENSOR 0
+#define REALSENSE 1
+#define DEVICE PRIMESENSOR
+
+#if (DEVICE == REALSENSE)
+#define RS2_PROJECT_POINT_TO_PIXEL 0x1000
+struct Rs2PointPixel
+{
+    float point[3];
+    float pixel[2];
+};
+#endif
+
+// Initialize OpenNI2 and NiTE2
+void initializeSensor();
+
+// Enumerate Connected Devices (Return URIs in order of OpenNI2 device list)
+std::vector<std::string> enumerateDevices();
+
+// Open Device (First connected device for RealSense, return false if none was opened)
+bool openDevice( openni::Device& device, const std::string& uri );
+
+// Read Field of View of Depth Stream [rad] (Return false if device has no depth sensor)
+bool readDepthFieldOfView( openni::Device& device, float& horizontal_fov, float& vertical_fov );
+
+#if (DEVICE == REALSENSE)
+// Convert World Coordinates to Depth by RealSense Projection
+nite::Status convertRealSenseCoordinatesToDepth( openni::Device& device, const uint32_t depth_height, const float x, const float y, const float z, float* pOutX, float* pOutY );
+#endif
+
+#endif // __SENSOR__
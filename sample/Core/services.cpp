@@ -0,0 +1,32 @@
+#include "services.h"
+
+// Constructor
+SampleServices::SampleServices( const Options& options, const std::vector<std::string>& names )
+{
+    // Telemetry ("stdout", "file:PATH", "tcp:HOST:PORT" or "null")
+    const std::string telemetry_uri = options.get( "telemetry" );
+    if( telemetry_uri != "none" ){
+        telemetry_sink = createSink( telemetry_uri );
+        reporter.reset( new TelemetryReporter( telemetry, *telemetry_sink ) );
+    }
+
+    // Publisher ("PORT" or "HOST:PORT", see publisher.h)
+    const std::string publisher_uri = options.get( "publish" );
+    if( publisher_uri != "none" ){
+        publisher = createStreamPublisher( publisher_uri, names );
+    }
+
+    // Shared Memory ("NAME[:all|depth|usermap|none[:WIDTHxHEIGHT]]")
+    const std::string shared_uri = options.get( "shared" );
+    if( shared_uri != "none" ){
+        shared_writer = createSharedFrameWriter( shared_uri );
+    }
+
+    // Events ("stdout", "file:PATH", "tcp:HOST:PORT" or "null", in window and headless mode)
+    const std::string events_uri = options.get( "events" );
+    if( events_uri != "none" ){
+        events_sink = createSink( events_uri );
+        writer.reset( new EventWriter( bus, *events_sink, EVENT_MASK_ALL, names ) );
+        bus.start();
+    }
+}
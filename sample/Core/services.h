@@ -0,0 +1,47 @@
+#ifndef __SERVICES__
+#define __SERVICES__
+
+#include "options.h"
+#include "pipeline.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Sample Services (Telemetry, publisher, shared memory and events of "--telemetry", "--publish", "--shared" and "--events", "none" or not given: Disable)
+class SampleServices
+{
+private:
+    // Telemetry (Reporter is destroyed before sink)
+    Telemetry telemetry;
+    std::unique_ptr<Sink> telemetry_sink;
+    std::unique_ptr<TelemetryReporter> reporter;
+
+    // Publisher and Shared Memory
+    std::unique_ptr<StreamPublisher> publisher;
+    std::unique_ptr<SharedFrameWriter> shared_writer;
+
+    // Events (Writer is destroyed before sink and bus)
+    EventBus bus;
+    std::unique_ptr<Sink> events_sink;
+    std::unique_ptr<EventWriter> writer;
+
+public:
+    // Constructor (Create services of options, names of custom poses or templates for events and publisher)
+    explicit SampleServices( const Options& options, const std::vector<std::string>& names = std::vector<std::string>() );
+
+    SampleServices( const SampleServices& ) = delete;
+    SampleServices& operator=( const SampleServices& ) = delete;
+
+    // Attach Services to Pipeline (Before processing, pipeline is stopped before services are destroyed)
+    template<typename Source, typename Frame>
+    void attach( Pipeline<Source, Frame>& pipeline )
+    {
+        pipeline.setTelemetry( reporter ? &telemetry : nullptr );
+        pipeline.setStreamPublisher( publisher.get() );
+        pipeline.setSharedFrameWriter( shared_writer.get() );
+        pipeline.setEventBus( writer ? &bus : nullptr );
+    }
+};
+
+#endif // __SERVICES__
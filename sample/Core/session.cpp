@@ -0,0 +1,442 @@
+#include "session.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// Round Up to 8 bytes
+static inline uint64_t align8( const uint64_t size )
+{
+    return ( size + 7 ) & ~static_cast<uint64_t>( 7 );
+}
+
+// Validate Session Header
+static void validateHeader( const SessionHeader& header )
+{
+    if( header.magic != SESSION_MAGIC ){
+        throw std::runtime_error( "failed invalid session file" );
+    }
+    if( header.version != SESSION_VERSION ){
+        throw std::runtime_error( "failed unsupported session version " + std::to_string( header.version ) );
+    }
+    if( header.kind != SESSION_USER && header.kind != SESSION_HAND ){
+        throw std::runtime_error( "failed unknown session kind " + std::to_string( header.kind ) );
+    }
+    if( header.kind == SESSION_HAND && ( header.flags & SESSION_USER_MAP ) ){
+        throw std::runtime_error( "failed hand session doesn't have user map" );
+    }
+    if( ( header.flags & ( SESSION_DEPTH | SESSION_USER_MAP ) ) && ( !header.depth_width || !header.depth_height ) ){
+        throw std::runtime_error( "failed invalid session depth size" );
+    }
+}
+
+// Retrieve Size of Records
+static inline uint64_t recordSize( const SessionHeader& header, const SessionFrameHeader& frame_header )
+{
+    if( header.kind == SESSION_USER ){
+        return static_cast<uint64_t>( frame_header.count ) * sizeof( SessionUser );
+    }
+    return static_cast<uint64_t>( frame_header.count ) * sizeof( SessionHand ) + static_cast<uint64_t>( frame_header.gesture_count ) * sizeof( SessionGesture );
+}
+
+// Parse Session URI
+bool parseSessionUri( const std::string& uri, std::string& path, float& speed )
+{
+    const std::string session = "session:";
+    if( uri.compare( 0, session.size(), session ) != 0 ){
+        return false;
+    }
+
+    // Speed (Optional)
+    path = uri.substr( session.size() );
+    speed = 1.0f;
+    const size_t separator = path.rfind( '@' );
+    if( separator != std::string::npos ){
+        char* end = nullptr;
+        const float value = std::strtof( path.c_str() + separator + 1, &end );
+        if( separator + 1 < path.size() && *end == '\0' && 0.0f <= value ){
+            speed = value;
+            path.resize( separator );
+        }
+    }
+
+    return true;
+}
+
+// Retrieve Intrinsics of Session Header
+Intrinsics sessionIntrinsics( const SessionHeader& header )
+{
+    Intrinsics intrinsics;
+    intrinsics.focal_x = header.focal_x;
+    intrinsics.focal_y = header.focal_y;
+    intrinsics.center_x = header.center_x;
+    intrinsics.center_y = header.center_y;
+    return intrinsics;
+}
+
+// Set Intrinsics to Session Header
+void setSessionIntrinsics( SessionHeader& header, const Intrinsics& intrinsics )
+{
+    header.focal_x = intrinsics.focal_x;
+    header.focal_y = intrinsics.focal_y;
+    header.center_x = intrinsics.center_x;
+    header.center_y = intrinsics.center_y;
+}
+
+// Constructor
+ReplayClock::ReplayClock( const float speed )
+    : speed( speed )
+{
+}
+
+// Wait Frame
+void ReplayClock::wait( const uint64_t timestamp )
+{
+    if( speed <= 0.0f ){
+        return;
+    }
+
+    if( !started || timestamp < base_timestamp ){
+        started = true;
+        base_timestamp = timestamp;
+        base_time = std::chrono::steady_clock::now();
+        return;
+    }
+
+    const std::chrono::microseconds elapsed( static_cast<int64_t>( ( timestamp - base_timestamp ) / speed ) );
+    std::this_thread::sleep_until( base_time + elapsed );
+}
+
+// Restart from Next Frame
+void ReplayClock::reset()
+{
+    started = false;
+}
+
+// Constructor
+SessionWriter::SessionWriter( const std::string& path, const SessionHeader& header )
+    : stream( path, std::ios::out | std::ios::trunc | std::ios::binary ),
+      header( header )
+{
+    if( !stream.is_open() ){
+        throw std::runtime_error( "failed can not open " + path );
+    }
+
+    validateHeader( header );
+    image_size = align8( static_cast<uint64_t>( header.depth_width ) * header.depth_height * sizeof( uint16_t ) );
+
+    // Write Header
+    write( &header, sizeof( header ) );
+}
+
+// Destructor
+SessionWriter::~SessionWriter()
+{
+    try{
+        close();
+    } catch( ... ){
+    }
+}
+
+// Append Frame
+void SessionWriter::append( SessionFrameHeader frame_header, const void* records, const uint16_t* user_map, const size_t user_map_stride, const uint16_t* depth, const size_t depth_stride )
+{
+    if( !stream.is_open() ){
+        throw std::runtime_error( "failed session is closed" );
+    }
+    if( !chunk_index.empty() && frame_header.timestamp < chunk.last_timestamp ){
+        throw std::runtime_error( "failed timestamp of session must not decrease" );
+    }
+    if( ( ( header.flags & SESSION_USER_MAP ) && !user_map ) || ( ( header.flags & SESSION_DEPTH ) && !depth ) ){
+        throw std::runtime_error( "failed user map or depth is required by session" );
+    }
+
+    // Open Chunk (Chunk Header is written when the chunk is closed)
+    if( chunk_index.empty() ){
+        chunk_offset = offset;
+        chunk = SessionChunkHeader{ SESSION_CHUNK_MAGIC, 0, 0, frame_header.timestamp, frame_header.timestamp };
+        write( &chunk, sizeof( chunk ) );
+    }
+
+    // Frame Size
+    const uint64_t record_size = recordSize( header, frame_header );
+    frame_header.size = static_cast<uint32_t>( align8( sizeof( frame_header ) + record_size )
+                                             + ( ( header.flags & SESSION_USER_MAP ) ? image_size : 0 )
+                                             + ( ( header.flags & SESSION_DEPTH ) ? image_size : 0 ) );
+
+    // Write Frame
+    chunk_index.push_back( SessionIndexEntry{ frame_header.timestamp, offset } );
+    write( &frame_header, sizeof( frame_header ) );
+    write( records, static_cast<size_t>( record_size ) );
+    writePadding();
+    if( header.flags & SESSION_USER_MAP ){
+        writeImage( user_map, user_map_stride );
+    }
+    if( header.flags & SESSION_DEPTH ){
+        writeImage( depth, depth_stride );
+    }
+
+    chunk.frame_count++;
+    chunk.last_timestamp = frame_header.timestamp;
+
+    // Close Full Chunk
+    if( SESSION_CHUNK_FRAMES <= chunk_index.size() ){
+        closeChunk();
+    }
+}
+
+// Close
+void SessionWriter::close()
+{
+    if( !stream.is_open() ){
+        return;
+    }
+
+    closeChunk();
+
+    // Write Trailer
+    const SessionFooter footer = { SESSION_FOOTER_MAGIC, 0, chunk_table.size(), offset };
+    write( chunk_table.data(), chunk_table.size() * sizeof( SessionChunkEntry ) );
+    write( &footer, sizeof( footer ) );
+
+    stream.close();
+    if( stream.fail() ){
+        throw std::runtime_error( "failed can not close session" );
+    }
+}
+
+// Retrieve Session Header
+const SessionHeader& SessionWriter::sessionHeader() const
+{
+    return header;
+}
+
+// Retrieve Record Buffer
+uint8_t* SessionWriter::recordBuffer( const size_t size )
+{
+    if( record_buffer.size() < size ){
+        record_buffer.resize( size );
+    }
+    return record_buffer.data();
+}
+
+// Close Chunk
+void SessionWriter::closeChunk()
+{
+    if( chunk_index.empty() ){
+        return;
+    }
+
+    // Write Chunk Index
+    write( chunk_index.data(), chunk_index.size() * sizeof( SessionIndexEntry ) );
+    chunk.size = offset - chunk_offset;
+
+    // Write Chunk Header
+    stream.seekp( static_cast<std::streamoff>( chunk_offset ) );
+    stream.write( reinterpret_cast<const char*>( &chunk ), sizeof( chunk ) );
+    stream.seekp( 0, std::ios::end );
+
+    // Flush Chunk (Readable even if recording is interrupted)
+    stream.flush();
+    if( !stream ){
+        throw std::runtime_error( "failed can not write session" );
+    }
+
+    chunk_table.push_back( SessionChunkEntry{ chunk.first_timestamp, chunk_offset, chunk.frame_count, 0 } );
+    chunk_index.clear();
+}
+
+// Write Data
+void SessionWriter::write( const void* data, const size_t size )
+{
+    stream.write( static_cast<const char*>( data ), static_cast<std::streamsize>( size ) );
+    if( !stream ){
+        throw std::runtime_error( "failed can not write session" );
+    }
+    offset += size;
+}
+
+// Write Image
+void SessionWriter::writeImage( const uint16_t* image, const size_t stride )
+{
+    const size_t row_size = header.depth_width * sizeof( uint16_t );
+    const uint8_t* row = reinterpret_cast<const uint8_t*>( image );
+    for( uint32_t y = 0; y < header.depth_height; y++ ){
+        write( row + y * stride, row_size );
+    }
+    writePadding();
+}
+
+// Write Padding
+void SessionWriter::writePadding()
+{
+    static const uint8_t zeros[8] = {};
+    write( zeros, static_cast<size_t>( align8( offset ) - offset ) );
+}
+
+// Constructor
+SessionReader::SessionReader( const std::string& path )
+    : file( path )
+{
+    const uint8_t* data = file.data();
+    const uint64_t size = file.size();
+
+    // Header
+    if( size < sizeof( SessionHeader ) ){
+        throw std::runtime_error( "failed invalid session file " + path );
+    }
+    std::memcpy( &header, data, sizeof( header ) );
+    validateHeader( header );
+    image_size = align8( static_cast<uint64_t>( header.depth_width ) * header.depth_height * sizeof( uint16_t ) );
+
+    // Chunk Table from Trailer
+    bool trailer = false;
+    if( sizeof( SessionHeader ) + sizeof( SessionFooter ) <= size ){
+        SessionFooter footer;
+        std::memcpy( &footer, data + size - sizeof( footer ), sizeof( footer ) );
+        const uint64_t table_size = size - sizeof( footer ) - footer.table_offset;
+        if( footer.magic == SESSION_FOOTER_MAGIC && footer.table_offset % 8 == 0 && sizeof( SessionHeader ) <= footer.table_offset && footer.table_offset <= size - sizeof( footer )
+            && footer.chunk_count == table_size / sizeof( SessionChunkEntry ) && table_size % sizeof( SessionChunkEntry ) == 0 ){
+            const SessionChunkEntry* table = reinterpret_cast<const SessionChunkEntry*>( data + footer.table_offset );
+            chunk_table.assign( table, table + footer.chunk_count );
+            trailer = true;
+        }
+    }
+
+    // Chunk Table from Chunk Headers (Recording was interrupted)
+    if( !trailer ){
+        uint64_t offset = sizeof( SessionHeader );
+        while( offset + sizeof( SessionChunkHeader ) <= size ){
+            const SessionChunkHeader& chunk_header = *reinterpret_cast<const SessionChunkHeader*>( data + offset );
+            if( chunk_header.magic != SESSION_CHUNK_MAGIC || !chunk_header.frame_count || chunk_header.size < sizeof( SessionChunkHeader ) + chunk_header.frame_count * sizeof( SessionIndexEntry ) || size - offset < chunk_header.size ){
+                break;
+            }
+            chunk_table.push_back( SessionChunkEntry{ chunk_header.first_timestamp, offset, chunk_header.frame_count, 0 } );
+            offset += chunk_header.size;
+        }
+    }
+
+    for( const SessionChunkEntry& entry : chunk_table ){
+        frame_count += entry.frame_count;
+    }
+}
+
+// Retrieve Session Header
+const SessionHeader& SessionReader::sessionHeader() const
+{
+    return header;
+}
+
+// Retrieve Number of Frames
+uint64_t SessionReader::frames() const
+{
+    return frame_count;
+}
+
+// Retrieve Timestamp of First Frame
+uint64_t SessionReader::firstTimestamp() const
+{
+    return chunk_table.empty() ? 0 : chunk_table.front().first_timestamp;
+}
+
+// Retrieve Timestamp of Last Frame
+uint64_t SessionReader::lastTimestamp() const
+{
+    return chunk_table.empty() ? 0 : chunkHeader( chunk_table.size() - 1 ).last_timestamp;
+}
+
+// Seek to First Frame at or after Timestamp
+void SessionReader::seek( const uint64_t timestamp )
+{
+    // Last Chunk that Starts at or before Timestamp
+    const auto next = std::upper_bound( chunk_table.begin(), chunk_table.end(), timestamp, []( const uint64_t value, const SessionChunkEntry& entry ){
+        return value < entry.first_timestamp;
+    } );
+    chunk = ( next == chunk_table.begin() ) ? 0 : static_cast<size_t>( next - chunk_table.begin() ) - 1;
+    frame = 0;
+    if( chunk_table.empty() ){
+        return;
+    }
+
+    // First Frame at or after Timestamp in Chunk (Otherwise First Frame of Next Chunk)
+    const SessionIndexEntry* index = chunkIndex( chunk );
+    const uint32_t count = chunk_table[chunk].frame_count;
+    frame = static_cast<uint32_t>( std::lower_bound( index, index + count, timestamp, []( const SessionIndexEntry& entry, const uint64_t value ){
+        return entry.timestamp < value;
+    } ) - index );
+}
+
+// Read Frame and Advance
+bool SessionReader::read( SessionFrame& session_frame )
+{
+    while( chunk < chunk_table.size() && chunk_table[chunk].frame_count <= frame ){
+        chunk++;
+        frame = 0;
+    }
+    if( chunk_table.size() <= chunk ){
+        return false;
+    }
+
+    // Frame Header
+    const uint64_t offset = chunkIndex( chunk )[frame].offset;
+    if( offset % 8 || file.size() < offset + sizeof( SessionFrameHeader ) ){
+        throw std::runtime_error( "failed invalid session frame offset" );
+    }
+    const uint8_t* data = file.data() + offset;
+    const SessionFrameHeader* frame_header = reinterpret_cast<const SessionFrameHeader*>( data );
+
+    // Records
+    const uint64_t record_size = align8( sizeof( SessionFrameHeader ) + recordSize( header, *frame_header ) );
+    const uint64_t frame_size = record_size + ( ( header.flags & SESSION_USER_MAP ) ? image_size : 0 ) + ( ( header.flags & SESSION_DEPTH ) ? image_size : 0 );
+    if( frame_header->size != frame_size || file.size() - offset < frame_size ){
+        throw std::runtime_error( "failed invalid session frame size" );
+    }
+
+    session_frame = SessionFrame();
+    session_frame.header = frame_header;
+    if( header.kind == SESSION_USER ){
+        session_frame.users = reinterpret_cast<const SessionUser*>( data + sizeof( SessionFrameHeader ) );
+    }
+    else{
+        session_frame.hands = reinterpret_cast<const SessionHand*>( data + sizeof( SessionFrameHeader ) );
+        session_frame.gestures = reinterpret_cast<const SessionGesture*>( session_frame.hands + frame_header->count );
+    }
+
+    // User Map and Depth
+    uint64_t image_offset = record_size;
+    if( header.flags & SESSION_USER_MAP ){
+        session_frame.user_map = reinterpret_cast<const uint16_t*>( data + image_offset );
+        image_offset += image_size;
+    }
+    if( header.flags & SESSION_DEPTH ){
+        session_frame.depth = reinterpret_cast<const uint16_t*>( data + image_offset );
+    }
+
+    frame++;
+    return true;
+}
+
+// Retrieve Chunk Header
+const SessionChunkHeader& SessionReader::chunkHeader( const size_t index ) const
+{
+    const SessionChunkEntry& entry = chunk_table[index];
+    if( entry.offset % 8 || file.size() < entry.offset + sizeof( SessionChunkHeader ) ){
+        throw std::runtime_error( "failed invalid session chunk offset" );
+    }
+
+    const SessionChunkHeader& chunk_header = *reinterpret_cast<const SessionChunkHeader*>( file.data() + entry.offset );
+    if( chunk_header.magic != SESSION_CHUNK_MAGIC || chunk_header.frame_count != entry.frame_count
+        || chunk_header.size < sizeof( SessionChunkHeader ) + chunk_header.frame_count * sizeof( SessionIndexEntry ) || file.size() - entry.offset < chunk_header.size ){
+        throw std::runtime_error( "failed invalid session chunk" );
+    }
+
+    return chunk_header;
+}
+
+// Retrieve Chunk Index
+const SessionIndexEntry* SessionReader::chunkIndex( const size_t index ) const
+{
+    const SessionChunkHeader& chunk_header = chunkHeader( index );
+    return reinterpret_cast<const SessionIndexEntry*>( file.data() + chunk_table[index].offset + chunk_header.size - chunk_header.frame_count * sizeof( SessionIndexEntry ) );
+}
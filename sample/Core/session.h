@@ -0,0 +1,313 @@
+#ifndef __SESSION__
+#define __SESSION__
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+#include "projection.h"
+
+// Session File (Recorded Tracker Output, little endian, structures and frames are 8-byte aligned)
+// File   = Header (64 bytes) + Chunks + Trailer
+// Chunk  = Chunk Header (32 bytes) + Frames (SESSION_CHUNK_FRAMES or less) + Chunk Index (frame count x 16 bytes)
+//          Chunk Index: timestamp and file offset of each frame
+// Frame  = Frame Header (24 bytes) + Records + User Map (optional) + Depth (optional)
+//          Records: users (user session), or hands followed by gestures (hand session)
+//          User Map and Depth: depth width x depth height x uint16
+// Trailer = Chunk Table (chunk count x 24 bytes) + Footer (24 bytes)
+//          Chunk Table: first timestamp, file offset and frame count of each chunk
+// Without trailer (interrupted recording), the chunk table is rebuilt from the chunk headers.
+#define SESSION_MAGIC 0x5345534E        // "NSES"
+#define SESSION_CHUNK_MAGIC 0x4B4E4843  // "CHNK"
+#define SESSION_FOOTER_MAGIC 0x5844494E // "NIDX"
+#define SESSION_VERSION 1
+#define SESSION_CHUNK_FRAMES 64
+#define SESSION_JOINT_COUNT 15
+#define SESSION_POSE_COUNT 2
+
+// Session Kind
+enum SessionKind
+{
+    SESSION_USER = 1, // User Tracker (Skeleton, Pose and User)
+    SESSION_HAND = 2  // Hand Tracker (Hand and Gesture)
+};
+
+// Session Flags
+enum SessionFlag
+{
+    SESSION_DEPTH = 0x01,   // Depth is recorded
+    SESSION_USER_MAP = 0x02 // User map is recorded (user session only)
+};
+
+// Session Header
+struct SessionHeader
+{
+    uint32_t magic = SESSION_MAGIC;
+    uint32_t version = SESSION_VERSION;
+    uint32_t kind = SESSION_USER;
+    uint32_t flags = 0;
+    uint32_t depth_width = 0;
+    uint32_t depth_height = 0;
+
+    // Projection from World to Depth Coordinates (depth x = center_x + focal_x * x / z, depth y = center_y + focal_y * y / z)
+    float focal_x = 0.0f;
+    float focal_y = 0.0f;
+    float center_x = 0.0f;
+    float center_y = 0.0f;
+
+    uint8_t reserved[24] = {};
+};
+
+// Chunk Header
+struct SessionChunkHeader
+{
+    uint32_t magic;
+    uint32_t frame_count;
+    uint64_t size; // Chunk Header + Frames + Chunk Index
+    uint64_t first_timestamp;
+    uint64_t last_timestamp;
+};
+
+// Chunk Index Entry
+struct SessionIndexEntry
+{
+    uint64_t timestamp;
+    uint64_t offset;
+};
+
+// Chunk Table Entry
+struct SessionChunkEntry
+{
+    uint64_t first_timestamp;
+    uint64_t offset;
+    uint32_t frame_count;
+    uint32_t reserved;
+};
+
+// Footer
+struct SessionFooter
+{
+    uint32_t magic;
+    uint32_t reserved;
+    uint64_t chunk_count;
+    uint64_t table_offset;
+};
+
+// Frame Header
+struct SessionFrameHeader
+{
+    uint64_t timestamp = 0; // Sensor Timestamp [us]
+    uint32_t frame_index = 0;
+    uint32_t size = 0;      // Frame Header + Records + User Map + Depth (Padded to 8 bytes)
+    uint16_t count = 0;     // Users or Hands
+    uint16_t gesture_count = 0;
+    uint32_t reserved = 0;
+};
+
+// Recorded Joint
+struct SessionJoint
+{
+    float position[3];
+    float orientation[4]; // x, y, z, w
+    float position_confidence;
+    float orientation_confidence;
+};
+
+// Recorded User
+struct SessionUser
+{
+    uint16_t id;
+    uint8_t flags;                      // bit 0: new, 1: visible, 2: lost
+    uint8_t skeleton_state;
+    uint8_t poses[SESSION_POSE_COUNT];  // bit 0: entered, 1: held, 2: exited
+    uint8_t reserved[2];
+    float center_of_mass[3];
+    float bounding_box_min[3];
+    float bounding_box_max[3];
+    SessionJoint joints[SESSION_JOINT_COUNT];
+};
+
+// Recorded Hand
+struct SessionHand
+{
+    uint16_t id;
+    uint8_t flags; // bit 0: new, 1: lost, 2: tracking, 3: touching fov
+    uint8_t reserved;
+    float position[3];
+};
+
+// Recorded Gesture
+struct SessionGesture
+{
+    uint8_t type;
+    uint8_t flags; // bit 0: complete, 1: in progress
+    uint8_t reserved[2];
+    float position[3];
+};
+
+static_assert( sizeof( SessionHeader ) == 64 && sizeof( SessionChunkHeader ) == 32 && sizeof( SessionIndexEntry ) == 16 && sizeof( SessionChunkEntry ) == 24 && sizeof( SessionFooter ) == 24, "unexpected session file layout" );
+static_assert( sizeof( SessionFrameHeader ) == 24 && sizeof( SessionUser ) == 584 && sizeof( SessionHand ) == 16 && sizeof( SessionGesture ) == 16, "unexpected session record layout" );
+
+// Recorded Frame (Points into Mapped File)
+struct SessionFrame
+{
+    const SessionFrameHeader* header = nullptr;
+    const SessionUser* users = nullptr;       // header->count (user session)
+    const SessionHand* hands = nullptr;       // header->count (hand session)
+    const SessionGesture* gestures = nullptr; // header->gesture_count (hand session)
+    const uint16_t* user_map = nullptr;       // nullptr if not recorded
+    const uint16_t* depth = nullptr;          // nullptr if not recorded
+};
+
+// End of Finite Source (e.g. Session Replay)
+class EndOfSource : public std::runtime_error
+{
+public:
+    // Constructor
+    explicit EndOfSource( const std::string& message )
+        : std::runtime_error( message )
+    {
+    }
+};
+
+// Parse Session URI ("session:PATH[@SPEED]", Return false if uri is not session)
+bool parseSessionUri( const std::string& uri, std::string& path, float& speed );
+
+// Retrieve Intrinsics of Session Header
+Intrinsics sessionIntrinsics( const SessionHeader& header );
+
+// Set Intrinsics to Session Header
+void setSessionIntrinsics( SessionHeader& header, const Intrinsics& intrinsics );
+
+// Replay Clock (Wait until Recorded Time of Frame)
+class ReplayClock
+{
+private:
+    // Speed (0: No Wait)
+    float speed;
+
+    // Base Time
+    bool started = false;
+    uint64_t base_timestamp = 0;
+    std::chrono::steady_clock::time_point base_time;
+
+public:
+    // Constructor
+    explicit ReplayClock( const float speed );
+
+    // Wait Frame of Timestamp [us]
+    void wait( const uint64_t timestamp );
+
+    // Restart from Next Frame (e.g. after seek)
+    void reset();
+};
+
+// Session Writer
+class SessionWriter
+{
+private:
+    // Stream
+    std::ofstream stream;
+    uint64_t offset = 0;
+
+    // Header
+    SessionHeader header;
+    uint64_t image_size;
+
+    // Current Chunk
+    uint64_t chunk_offset = 0;
+    SessionChunkHeader chunk = {};
+    std::vector<SessionIndexEntry> chunk_index;
+
+    // Chunk Table
+    std::vector<SessionChunkEntry> chunk_table;
+
+    // Record Buffer (Reused across frames)
+    std::vector<uint8_t> record_buffer;
+
+public:
+    // Constructor
+    SessionWriter( const std::string& path, const SessionHeader& header );
+
+    // Destructor (Close)
+    ~SessionWriter();
+
+    // Append Frame (Users, or hands followed by gestures, and planes of flags)
+    void append( SessionFrameHeader frame_header, const void* records, const uint16_t* user_map, const size_t user_map_stride, const uint16_t* depth, const size_t depth_stride );
+
+    // Close (Write Trailer)
+    void close();
+
+    // Retrieve Session Header
+    const SessionHeader& sessionHeader() const;
+
+    // Retrieve Record Buffer of size Bytes (Reused across frames, valid until next call)
+    uint8_t* recordBuffer( const size_t size );
+
+private:
+    // Close Chunk (Write Chunk Index and Chunk Header)
+    void closeChunk();
+
+    // Write Data
+    void write( const void* data, const size_t size );
+
+    // Write Image (Padded to 8 bytes)
+    void writeImage( const uint16_t* image, const size_t stride );
+
+    // Write Padding (to 8 bytes)
+    void writePadding();
+};
+
+// Session Reader (Memory Mapped)
+class SessionReader
+{
+private:
+    // Mapped File
+    MappedFile file;
+
+    // Header
+    SessionHeader header;
+    uint64_t image_size;
+
+    // Chunk Table
+    std::vector<SessionChunkEntry> chunk_table;
+    uint64_t frame_count = 0;
+
+    // Position
+    size_t chunk = 0;
+    uint32_t frame = 0;
+
+public:
+    // Constructor
+    explicit SessionReader( const std::string& path );
+
+    // Retrieve Session Header
+    const SessionHeader& sessionHeader() const;
+
+    // Retrieve Number of Frames
+    uint64_t frames() const;
+
+    // Retrieve Timestamp of First and Last Frame
+    uint64_t firstTimestamp() const;
+    uint64_t lastTimestamp() const;
+
+    // Seek to First Frame at or after Timestamp (O(log n))
+    void seek( const uint64_t timestamp );
+
+    // Read Frame and Advance (Return false at end of session)
+    bool read( SessionFrame& session_frame );
+
+private:
+    // Retrieve Chunk Header
+    const SessionChunkHeader& chunkHeader( const size_t index ) const;
+
+    // Retrieve Chunk Index
+    const SessionIndexEntry* chunkIndex( const size_t index ) const;
+};
+
+#endif // __SESSION__
@@ -0,0 +1,449 @@
+#include "shared_frame.h"
+
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert( sizeof( SharedFrameHeader ) == SHARED_ALIGNMENT, "size of shared frame header must be one cache line" );
+
+// Parse Shared Frame Flags
+uint32_t parseSharedFrameFlags( const std::string& name )
+{
+    if( name == "all" ){
+        return SHARED_FRAME_DEPTH | SHARED_FRAME_USER_MAP;
+    }
+    if( name == "depth" ){
+        return SHARED_FRAME_DEPTH;
+    }
+    if( name == "usermap" ){
+        return SHARED_FRAME_USER_MAP;
+    }
+    if( name == "none" ){
+        return 0;
+    }
+    throw std::runtime_error( "failed unknown shared memory option " + name + " (all, depth, usermap or none)" );
+}
+
+// Align Size to Cache Line
+static inline size_t align( const size_t size )
+{
+    return ( size + SHARED_ALIGNMENT - 1 ) / SHARED_ALIGNMENT * SHARED_ALIGNMENT;
+}
+
+// Retrieve Offset of Joint Arrays in Slot
+static inline size_t jointOffset()
+{
+    return align( sizeof( SharedFrameSlot ) );
+}
+
+// Retrieve Size of Joint Array
+static inline size_t jointSize()
+{
+    return align( SHARED_LANES * sizeof( float ) );
+}
+
+// Retrieve Size of Plane
+static inline size_t planeSize( const uint32_t width, const uint32_t height )
+{
+    return align( static_cast<size_t>( width ) * height * sizeof( uint16_t ) );
+}
+
+// Retrieve Offset of Plane in Slot (Depth, then User Map)
+static inline size_t planeOffset( const uint32_t flags, const uint32_t width, const uint32_t height, const SharedFrameFlag plane )
+{
+    size_t offset = jointOffset() + SHARED_JOINT_ARRAYS * jointSize();
+    if( plane == SHARED_FRAME_USER_MAP && ( flags & SHARED_FRAME_DEPTH ) ){
+        offset += planeSize( width, height );
+    }
+    return offset;
+}
+
+// Retrieve Size of Slot
+static inline size_t slotSize( const uint32_t flags, const uint32_t width, const uint32_t height )
+{
+    size_t size = jointOffset() + SHARED_JOINT_ARRAYS * jointSize();
+    size += ( flags & SHARED_FRAME_DEPTH ) ? planeSize( width, height ) : 0;
+    size += ( flags & SHARED_FRAME_USER_MAP ) ? planeSize( width, height ) : 0;
+    return size;
+}
+
+// Retrieve Name of Region ("/NAME" or "Local\NAME")
+static inline std::string regionName( const std::string& name )
+{
+    if( name.empty() ){
+        throw std::runtime_error( "failed invalid name of shared memory" );
+    }
+
+    #ifdef _WIN32
+    return "Local\\" + name;
+    #else
+    return ( name[0] == '/' ) ? name : "/" + name;
+    #endif
+}
+
+// Constructor (Create)
+SharedMemory::SharedMemory( const std::string& name, const size_t size )
+    : length( size ),
+      name( regionName( name ) ),
+      owner( true )
+{
+    #ifdef _WIN32
+    mapping = CreateFileMappingA( INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>( static_cast<uint64_t>( size ) >> 32 ), static_cast<DWORD>( size ), this->name.c_str() );
+    if( !mapping ){
+        throw std::runtime_error( "failed can not create shared memory " + name );
+    }
+    if( GetLastError() == ERROR_ALREADY_EXISTS ){
+        CloseHandle( mapping );
+        mapping = nullptr;
+        throw std::runtime_error( "failed shared memory " + name + " is already used" );
+    }
+
+    address = static_cast<uint8_t*>( MapViewOfFile( mapping, FILE_MAP_ALL_ACCESS, 0, 0, size ) );
+    if( !address ){
+        CloseHandle( mapping );
+        throw std::runtime_error( "failed can not map shared memory " + name );
+    }
+    #else
+    // Replace Stale Region
+    shm_unlink( this->name.c_str() );
+    fd = shm_open( this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644 );
+    if( fd < 0 ){
+        throw std::runtime_error( "failed can not create shared memory " + name );
+    }
+
+    if( ftruncate( fd, static_cast<off_t>( size ) ) != 0 ){
+        close( fd );
+        shm_unlink( this->name.c_str() );
+        throw std::runtime_error( "failed can not allocate shared memory " + name );
+    }
+
+    void* map = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    if( map == MAP_FAILED ){
+        close( fd );
+        shm_unlink( this->name.c_str() );
+        throw std::runtime_error( "failed can not map shared memory " + name );
+    }
+    address = static_cast<uint8_t*>( map );
+    #endif
+}
+
+// Constructor (Open)
+SharedMemory::SharedMemory( const std::string& name )
+    : name( regionName( name ) )
+{
+    #ifdef _WIN32
+    mapping = OpenFileMappingA( FILE_MAP_READ, FALSE, this->name.c_str() );
+    if( !mapping ){
+        throw std::runtime_error( "failed can not open shared memory " + name );
+    }
+
+    address = static_cast<uint8_t*>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+    if( !address ){
+        CloseHandle( mapping );
+        throw std::runtime_error( "failed can not map shared memory " + name );
+    }
+
+    MEMORY_BASIC_INFORMATION information;
+    if( !VirtualQuery( address, &information, sizeof( information ) ) ){
+        UnmapViewOfFile( address );
+        CloseHandle( mapping );
+        throw std::runtime_error( "failed can not retrieve size of shared memory " + name );
+    }
+    length = static_cast<size_t>( information.RegionSize );
+    #else
+    fd = shm_open( this->name.c_str(), O_RDONLY, 0 );
+    if( fd < 0 ){
+        throw std::runtime_error( "failed can not open shared memory " + name );
+    }
+
+    struct stat status;
+    if( fstat( fd, &status ) != 0 || !status.st_size ){
+        close( fd );
+        throw std::runtime_error( "failed can not retrieve size of shared memory " + name );
+    }
+    length = static_cast<size_t>( status.st_size );
+
+    void* map = mmap( nullptr, length, PROT_READ, MAP_SHARED, fd, 0 );
+    if( map == MAP_FAILED ){
+        close( fd );
+        throw std::runtime_error( "failed can not map shared memory " + name );
+    }
+    address = static_cast<uint8_t*>( map );
+    #endif
+}
+
+// Destructor
+SharedMemory::~SharedMemory()
+{
+    #ifdef _WIN32
+    if( address ){
+        UnmapViewOfFile( address );
+    }
+    if( mapping ){
+        CloseHandle( mapping );
+    }
+    #else
+    if( address ){
+        munmap( address, length );
+    }
+    if( 0 <= fd ){
+        close( fd );
+    }
+    if( owner ){
+        shm_unlink( name.c_str() );
+    }
+    #endif
+}
+
+// Retrieve Mapped Data
+uint8_t* SharedMemory::data() const
+{
+    return address;
+}
+
+// Retrieve Size of Region
+size_t SharedMemory::size() const
+{
+    return length;
+}
+
+// Constructor
+SharedFrameWriter::SharedFrameWriter( const std::string& name, const uint32_t flags, const uint32_t width, const uint32_t height, const uint32_t slots )
+{
+    if( !slots || ( flags & ~( SHARED_FRAME_DEPTH | SHARED_FRAME_USER_MAP ) ) || ( flags && ( !width || !height ) ) ){
+        throw std::runtime_error( "failed invalid slots, planes or size of shared memory" );
+    }
+
+    // Create Region
+    const uint32_t capacity_width = flags ? width : 0;
+    const uint32_t capacity_height = flags ? height : 0;
+    const size_t slot_size = slotSize( flags, capacity_width, capacity_height );
+    memory.reset( new SharedMemory( name, sizeof( SharedFrameHeader ) + slot_size * slots ) );
+
+    // Initialize Slots (Sequence 0: no frame)
+    uint8_t* data = memory->data();
+    for( uint32_t index = 0; index < slots; index++ ){
+        SharedFrameSlot* target = new( data + sizeof( SharedFrameHeader ) + slot_size * index ) SharedFrameSlot();
+        target->sequence.store( 0, std::memory_order_relaxed );
+    }
+
+    // Initialize Header (Magic is stored last, readers check it before they read the rest)
+    header = new( data ) SharedFrameHeader();
+    header->version = SHARED_FRAME_VERSION;
+    header->slot_count = slots;
+    header->flags = flags;
+    header->width = capacity_width;
+    header->height = capacity_height;
+    header->slot_size = slot_size;
+    header->published.store( 0, std::memory_order_relaxed );
+    header->magic.store( SHARED_FRAME_MAGIC, std::memory_order_release );
+}
+
+// Begin Frame
+SharedFrame& SharedFrameWriter::begin()
+{
+    // Mark Slot as being Written (Fence orders the mark before writes of frame, against the check of readers)
+    sequence = header->published.load( std::memory_order_relaxed ) + 1;
+    slot = reinterpret_cast<SharedFrameSlot*>( memory->data() + sizeof( SharedFrameHeader ) + header->slot_size * ( ( sequence - 1 ) % header->slot_count ) );
+    slot->sequence.store( 2 * sequence - 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    // Point Frame into Slot
+    uint8_t* base = reinterpret_cast<uint8_t*>( slot );
+    slot->info = SharedFrameInfo();
+    frame.info = &slot->info;
+    float** arrays[SHARED_JOINT_ARRAYS] = { &frame.x, &frame.y, &frame.z, &frame.orientation_x, &frame.orientation_y, &frame.orientation_z, &frame.orientation_w, &frame.position_confidence, &frame.orientation_confidence };
+    for( uint32_t index = 0; index < SHARED_JOINT_ARRAYS; index++ ){
+        *arrays[index] = reinterpret_cast<float*>( base + jointOffset() + jointSize() * index );
+    }
+    frame.depth = ( header->flags & SHARED_FRAME_DEPTH ) ? reinterpret_cast<uint16_t*>( base + planeOffset( header->flags, header->width, header->height, SHARED_FRAME_DEPTH ) ) : nullptr;
+    frame.user_map = ( header->flags & SHARED_FRAME_USER_MAP ) ? reinterpret_cast<uint16_t*>( base + planeOffset( header->flags, header->width, header->height, SHARED_FRAME_USER_MAP ) ) : nullptr;
+    return frame;
+}
+
+// Write Plane of Frame being Written
+void SharedFrameWriter::writePlane( const SharedFrameFlag plane, const uint16_t* data, const size_t step, const uint32_t width, const uint32_t height )
+{
+    if( !slot ){
+        throw std::runtime_error( "failed write plane without begin of shared frame" );
+    }
+    if( !( header->flags & plane ) || !data ){
+        return;
+    }
+    if( width > header->width || height > header->height || ( slot->info.flags && ( width != slot->info.width || height != slot->info.height ) ) ){
+        slot->info.skipped |= plane;
+        return;
+    }
+
+    // Copy Rows (Packed by width)
+    uint16_t* target = ( plane == SHARED_FRAME_DEPTH ) ? frame.depth : frame.user_map;
+    const uint8_t* source = reinterpret_cast<const uint8_t*>( data );
+    const size_t row = static_cast<size_t>( width ) * sizeof( uint16_t );
+    if( step == row ){
+        std::memcpy( target, source, row * height );
+    }
+    else{
+        for( uint32_t y = 0; y < height; y++ ){
+            std::memcpy( target + static_cast<size_t>( width ) * y, source + step * y, row );
+        }
+    }
+
+    slot->info.flags |= plane;
+    slot->info.width = width;
+    slot->info.height = height;
+}
+
+// Commit Frame
+void SharedFrameWriter::commit()
+{
+    if( !slot ){
+        throw std::runtime_error( "failed commit without begin of shared frame" );
+    }
+    if( slot->info.width > header->width || slot->info.height > header->height || ( slot->info.flags & ~header->flags ) ){
+        throw std::runtime_error( "failed frame exceeds planes or size of shared memory" );
+    }
+
+    slot->info.published = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    slot->sequence.store( 2 * sequence, std::memory_order_release );
+    header->published.store( sequence, std::memory_order_release );
+    slot = nullptr;
+}
+
+// Retrieve Planes of Region
+uint32_t SharedFrameWriter::flags() const
+{
+    return header->flags;
+}
+
+// Retrieve Capacity of Depth and User Map
+uint32_t SharedFrameWriter::width() const
+{
+    return header->width;
+}
+
+uint32_t SharedFrameWriter::height() const
+{
+    return header->height;
+}
+
+// Retrieve Sequence of Latest Committed Frame
+uint64_t SharedFrameWriter::published() const
+{
+    return header->published.load( std::memory_order_relaxed );
+}
+
+// Constructor
+SharedFrameReader::SharedFrameReader( const std::string& name )
+    : memory( new SharedMemory( name ) )
+{
+    if( memory->size() < sizeof( SharedFrameHeader ) ){
+        throw std::runtime_error( "failed shared memory " + name + " is not a shared frame region" );
+    }
+
+    header = reinterpret_cast<const SharedFrameHeader*>( memory->data() );
+    if( header->magic.load( std::memory_order_acquire ) != SHARED_FRAME_MAGIC ){
+        throw std::runtime_error( "failed shared memory " + name + " is not initialized" );
+    }
+    if( header->version != SHARED_FRAME_VERSION ){
+        throw std::runtime_error( "failed unsupported version of shared memory " + name );
+    }
+    if( !header->slot_count || header->slot_size != slotSize( header->flags, header->width, header->height ) || memory->size() < sizeof( SharedFrameHeader ) + header->slot_size * header->slot_count ){
+        throw std::runtime_error( "failed invalid layout of shared memory " + name );
+    }
+}
+
+// Retrieve Number of Slots
+uint32_t SharedFrameReader::slots() const
+{
+    return header->slot_count;
+}
+
+// Retrieve Planes of Region
+uint32_t SharedFrameReader::flags() const
+{
+    return header->flags;
+}
+
+// Retrieve Capacity of Depth and User Map
+uint32_t SharedFrameReader::width() const
+{
+    return header->width;
+}
+
+uint32_t SharedFrameReader::height() const
+{
+    return header->height;
+}
+
+// Retrieve Slot of Sequence
+const SharedFrameSlot* SharedFrameReader::slotOf( const uint64_t sequence ) const
+{
+    if( !sequence ){
+        throw std::runtime_error( "failed invalid sequence of shared frame" );
+    }
+    return reinterpret_cast<const SharedFrameSlot*>( memory->data() + sizeof( SharedFrameHeader ) + header->slot_size * ( ( sequence - 1 ) % header->slot_count ) );
+}
+
+// Retrieve View of Slot
+SharedFrameView SharedFrameReader::view( const SharedFrameSlot* slot ) const
+{
+    const uint8_t* base = reinterpret_cast<const uint8_t*>( slot );
+    SharedFrameView view;
+    view.info = &slot->info;
+    const float** arrays[SHARED_JOINT_ARRAYS] = { &view.x, &view.y, &view.z, &view.orientation_x, &view.orientation_y, &view.orientation_z, &view.orientation_w, &view.position_confidence, &view.orientation_confidence };
+    for( uint32_t index = 0; index < SHARED_JOINT_ARRAYS; index++ ){
+        *arrays[index] = reinterpret_cast<const float*>( base + jointOffset() + jointSize() * index );
+    }
+
+    // Planes of Frame
+    const uint32_t flags = header->flags & slot->info.flags;
+    view.depth = ( flags & SHARED_FRAME_DEPTH ) ? reinterpret_cast<const uint16_t*>( base + planeOffset( header->flags, header->width, header->height, SHARED_FRAME_DEPTH ) ) : nullptr;
+    view.user_map = ( flags & SHARED_FRAME_USER_MAP ) ? reinterpret_cast<const uint16_t*>( base + planeOffset( header->flags, header->width, header->height, SHARED_FRAME_USER_MAP ) ) : nullptr;
+    return view;
+}
+
+// Parse Dimension of Shared Memory Size (Digits only, 0 if empty or out of 1-65535)
+static inline uint32_t parseDimension( const std::string& text )
+{
+    if( text.empty() || 5 < text.size() ){
+        return 0;
+    }
+    const unsigned long value = std::stoul( text );
+    return ( value <= 0xFFFF ) ? static_cast<uint32_t>( value ) : 0;
+}
+
+// Create Shared Frame Writer
+std::unique_ptr<SharedFrameWriter> createSharedFrameWriter( const std::string& uri )
+{
+    const size_t separator = uri.find( ':' );
+    if( separator == std::string::npos ){
+        return std::unique_ptr<SharedFrameWriter>( new SharedFrameWriter( uri ) );
+    }
+
+    // Capacity of Depth and User Map
+    const size_t size = uri.find( ':', separator + 1 );
+    uint32_t width = SHARED_FRAME_WIDTH;
+    uint32_t height = SHARED_FRAME_HEIGHT;
+    if( size != std::string::npos ){
+        const std::string capacity = uri.substr( size + 1 );
+        const size_t x = capacity.find( 'x' );
+        const bool valid = x != std::string::npos && capacity.find_first_not_of( "0123456789x" ) == std::string::npos && capacity.find( 'x', x + 1 ) == std::string::npos;
+        width = valid ? parseDimension( capacity.substr( 0, x ) ) : 0;
+        height = valid ? parseDimension( capacity.substr( x + 1 ) ) : 0;
+        if( !width || !height ){
+            throw std::runtime_error( "failed invalid shared memory size " + capacity + " (WIDTHxHEIGHT, 1-65535)" );
+        }
+    }
+
+    const std::string planes = uri.substr( separator + 1, ( size == std::string::npos ) ? std::string::npos : size - separator - 1 );
+    return std::unique_ptr<SharedFrameWriter>( new SharedFrameWriter( uri.substr( 0, separator ), parseSharedFrameFlags( planes ), width, height ) );
+}
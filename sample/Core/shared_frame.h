@@ -0,0 +1,321 @@
+#ifndef __SHARED_FRAME__
+#define __SHARED_FRAME__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Shared Frame Transport (Standalone, no OpenNI2/NiTE2/OpenCV)
+// Region = Header (64 bytes) + Slots (slot count x slot size, 64-byte aligned)
+// Slot   = Slot Header (sequence, info) + Joint Arrays (9 x SHARED_LANES x float32) + Depth (optional) + User Map (optional)
+// Seqlock: Frame n goes to slot (n - 1) % slot count, whose sequence is 2n - 1 while written and 2n after commit.
+// A reader checks the sequence before and after reading in place, so neither side waits and a lapped read fails.
+#define SHARED_FRAME_MAGIC 0x4D48534E // "NSHM"
+#define SHARED_FRAME_VERSION 2
+#define SHARED_FRAME_SLOTS 4
+#define SHARED_FRAME_WIDTH 640
+#define SHARED_FRAME_HEIGHT 480
+#define SHARED_USER_COUNT 6
+#define SHARED_HAND_COUNT 6
+#define SHARED_JOINT_COUNT 15
+#define SHARED_POSE_COUNT 2
+#define SHARED_JOINT_ARRAYS 9
+#define SHARED_LANES ( ( SHARED_USER_COUNT * SHARED_JOINT_COUNT + 15 ) / 16 * 16 )
+#define SHARED_ALIGNMENT 64
+
+// Spin of Reader Waiting for Next Frame [yields] and Sleep after Spin [us]
+#define SHARED_WAIT_SPIN 1000
+#define SHARED_WAIT_SLEEP 100
+
+// Lock-Free Atomics (Read by other processes)
+static_assert( ATOMIC_LLONG_LOCK_FREE == 2, "shared frame requires lock-free 64-bit atomics" );
+
+// Shared Frame Flags (Planes of Region, and Planes of Frame)
+enum SharedFrameFlag
+{
+    SHARED_FRAME_DEPTH = 0x01,   // Depth
+    SHARED_FRAME_USER_MAP = 0x02 // User Map (user frames only)
+};
+
+// Parse Shared Frame Flags ("all", "depth", "usermap" or "none")
+uint32_t parseSharedFrameFlags( const std::string& name );
+
+// Shared Hand
+struct SharedHand
+{
+    int32_t id = 0;
+    uint32_t flags = 0; // bit 0: new, 1: lost, 2: tracking, 3: touching field of view
+    float position[3] = { 0.0f, 0.0f, 0.0f }; // x, y, z [mm]
+};
+
+// Shared Frame Info (Fixed part of slot)
+struct SharedFrameInfo
+{
+    int64_t published = 0; // Commit Time [ns] (Steady clock, same for all processes of the host)
+    uint64_t timestamp = 0; // Sensor Timestamp [us]
+    int32_t frame_index = 0;
+    uint32_t sensor = 0;   // Sensor Index
+    uint32_t flags = 0;    // Planes of Frame (SharedFrameFlag)
+    uint32_t skipped = 0;  // Planes Skipped by Size beyond Capacity of Region (SharedFrameFlag)
+    uint32_t width = 0;    // Size of Depth and User Map (0 if no plane)
+    uint32_t height = 0;
+
+    // Depth Intrinsics (depth x = center_x + focal_x * x / z, depth y = center_y + focal_y * y / z)
+    float focal_x = 0.0f;
+    float focal_y = 0.0f;
+    float center_x = 0.0f;
+    float center_y = 0.0f;
+
+    // Users of Skeleton Snapshot (First user_count are valid)
+    uint32_t user_count = 0;
+    int32_t user_ids[SHARED_USER_COUNT] = {};
+    uint8_t user_states[SHARED_USER_COUNT] = {}; // nite::SkeletonState
+    uint8_t user_poses[SHARED_USER_COUNT] = {};  // bit (3 * type + 0): entered, (3 * type + 1): held, (3 * type + 2): exited
+
+    // Hands (First hand_count are valid)
+    uint32_t hand_count = 0;
+    SharedHand hands[SHARED_HAND_COUNT];
+};
+
+// Shared Frame (Slot being written by writer)
+struct SharedFrame
+{
+    SharedFrameInfo* info = nullptr;
+
+    // Joints (SHARED_LANES each)
+    float* x = nullptr; // Position [mm]
+    float* y = nullptr;
+    float* z = nullptr;
+    float* orientation_x = nullptr; // Orientation (Quaternion)
+    float* orientation_y = nullptr;
+    float* orientation_z = nullptr;
+    float* orientation_w = nullptr;
+    float* position_confidence = nullptr;
+    float* orientation_confidence = nullptr;
+
+    // Depth and User Map (nullptr if region doesn't have the plane)
+    uint16_t* depth = nullptr;
+    uint16_t* user_map = nullptr;
+};
+
+// Shared Frame View (Slot being read in place by reader, valid only while the read is not overwritten)
+struct SharedFrameView
+{
+    const SharedFrameInfo* info = nullptr;
+
+    // Joints (SHARED_LANES each)
+    const float* x = nullptr; // Position [mm]
+    const float* y = nullptr;
+    const float* z = nullptr;
+    const float* orientation_x = nullptr; // Orientation (Quaternion)
+    const float* orientation_y = nullptr;
+    const float* orientation_z = nullptr;
+    const float* orientation_w = nullptr;
+    const float* position_confidence = nullptr;
+    const float* orientation_confidence = nullptr;
+
+    // Depth and User Map (info->width x info->height, nullptr if frame doesn't have the plane)
+    const uint16_t* depth = nullptr;
+    const uint16_t* user_map = nullptr;
+
+    // Retrieve Lane of Joint
+    static size_t lane( const uint32_t user, const uint32_t type )
+    {
+        return static_cast<size_t>( user ) * SHARED_JOINT_COUNT + type;
+    }
+};
+
+// Region Header
+struct SharedFrameHeader
+{
+    std::atomic<uint32_t> magic; // Stored last by writer (Region is initialized)
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t flags;              // Planes of Region (SharedFrameFlag)
+    uint32_t width;              // Capacity of Depth and User Map
+    uint32_t height;
+    uint64_t slot_size;          // [bytes]
+    std::atomic<uint64_t> published; // Sequence of Latest Committed Frame (0: none)
+    uint8_t reserved[24];
+};
+
+// Slot Header
+struct SharedFrameSlot
+{
+    std::atomic<uint64_t> sequence; // 2n - 1: frame n is written, 2n: frame n is committed
+    uint64_t reserved[7];           // Keep sequence on its own cache line
+    SharedFrameInfo info;
+};
+
+// Read Status
+enum SharedReadStatus
+{
+    SHARED_READ_OK,         // Read a consistent frame
+    SHARED_READ_PENDING,    // Frame is not committed yet
+    SHARED_READ_OVERWRITTEN // Frame was overwritten before or while reading, discard what was read
+};
+
+// Named Shared Memory Region (POSIX shared memory or Windows file mapping, the creator removes the name)
+class SharedMemory
+{
+private:
+    // Mapping
+    uint8_t* address = nullptr;
+    size_t length = 0;
+    std::string name;
+    bool owner = false;
+
+    #ifdef _WIN32
+    void* mapping = nullptr;
+    #else
+    int fd = -1;
+    #endif
+
+public:
+    // Constructor (Create region of size, replace a stale region of the same name)
+    SharedMemory( const std::string& name, const size_t size );
+
+    // Constructor (Open existing region read-only)
+    explicit SharedMemory( const std::string& name );
+
+    // Destructor
+    ~SharedMemory();
+
+    // Non-Copyable
+    SharedMemory( const SharedMemory& ) = delete;
+    SharedMemory& operator=( const SharedMemory& ) = delete;
+
+    // Retrieve Mapped Data
+    uint8_t* data() const;
+
+    // Retrieve Size of Region
+    size_t size() const;
+};
+
+// Shared Frame Writer (One writer per region)
+class SharedFrameWriter
+{
+private:
+    std::unique_ptr<SharedMemory> memory;
+    SharedFrameHeader* header = nullptr;
+
+    // Sequence of Frame being Written
+    uint64_t sequence = 0;
+    SharedFrameSlot* slot = nullptr;
+    SharedFrame frame;
+
+public:
+    // Constructor (Create region of name with planes of flags up to width x height, and slots)
+    SharedFrameWriter( const std::string& name, const uint32_t flags = SHARED_FRAME_DEPTH | SHARED_FRAME_USER_MAP, const uint32_t width = SHARED_FRAME_WIDTH, const uint32_t height = SHARED_FRAME_HEIGHT, const uint32_t slots = SHARED_FRAME_SLOTS );
+
+    // Non-Copyable
+    SharedFrameWriter( const SharedFrameWriter& ) = delete;
+    SharedFrameWriter& operator=( const SharedFrameWriter& ) = delete;
+
+    // Begin Frame (Retrieve slot of next frame to write in place, info is cleared)
+    SharedFrame& begin();
+
+    // Write Plane of Frame being Written (Rows every step bytes, skipped and flagged in info.skipped if it doesn't fit)
+    void writePlane( const SharedFrameFlag plane, const uint16_t* data, const size_t step, const uint32_t width, const uint32_t height );
+
+    // Commit Frame (Stamp commit time and publish to readers)
+    void commit();
+
+    // Retrieve Planes of Region
+    uint32_t flags() const;
+
+    // Retrieve Capacity of Depth and User Map
+    uint32_t width() const;
+    uint32_t height() const;
+
+    // Retrieve Sequence of Latest Committed Frame
+    uint64_t published() const;
+};
+
+// Shared Frame Reader (Any number of readers per region, in any process)
+class SharedFrameReader
+{
+private:
+    std::unique_ptr<SharedMemory> memory;
+    const SharedFrameHeader* header = nullptr;
+
+public:
+    // Constructor (Open region of name, throw if it doesn't exist or is not a shared frame region)
+    explicit SharedFrameReader( const std::string& name );
+
+    // Non-Copyable
+    SharedFrameReader( const SharedFrameReader& ) = delete;
+    SharedFrameReader& operator=( const SharedFrameReader& ) = delete;
+
+    // Retrieve Sequence of Latest Committed Frame (0: none)
+    uint64_t latest() const
+    {
+        return header->published.load( std::memory_order_acquire );
+    }
+
+    // Wait for Frame after sequence (Spin, then sleep), Retrieve Latest Sequence (sequence at timeout)
+    template<typename Rep, typename Period>
+    uint64_t wait( const uint64_t sequence, const std::chrono::duration<Rep, Period>& timeout ) const
+    {
+        const std::chrono::steady_clock::time_point limit = std::chrono::steady_clock::now() + timeout;
+        for( uint32_t spin = 0; ; spin++ ){
+            const uint64_t current = latest();
+            if( sequence < current ){
+                return current;
+            }
+            if( spin < SHARED_WAIT_SPIN ){
+                std::this_thread::yield();
+                continue;
+            }
+            if( limit <= std::chrono::steady_clock::now() ){
+                return current;
+            }
+            std::this_thread::sleep_for( std::chrono::microseconds( SHARED_WAIT_SLEEP ) );
+        }
+    }
+
+    // Read Frame of Sequence in Place by function( const SharedFrameView& )
+    // What function reads is valid only if SHARED_READ_OK is returned (the writer may overwrite the slot meanwhile).
+    template<typename Function>
+    SharedReadStatus read( const uint64_t sequence, Function function ) const
+    {
+        const SharedFrameSlot* slot = slotOf( sequence );
+        const uint64_t expected = 2 * sequence;
+        const uint64_t before = slot->sequence.load( std::memory_order_acquire );
+        if( before != expected ){
+            return ( before < expected ) ? SHARED_READ_PENDING : SHARED_READ_OVERWRITTEN;
+        }
+
+        function( view( slot ) );
+
+        // Order reads of slot before the check (Writer marks slot odd before it writes)
+        std::atomic_thread_fence( std::memory_order_acquire );
+        return ( slot->sequence.load( std::memory_order_relaxed ) == expected ) ? SHARED_READ_OK : SHARED_READ_OVERWRITTEN;
+    }
+
+    // Retrieve Number of Slots (A reader may lag up to slot count - 1 frames)
+    uint32_t slots() const;
+
+    // Retrieve Planes of Region
+    uint32_t flags() const;
+
+    // Retrieve Capacity of Depth and User Map
+    uint32_t width() const;
+    uint32_t height() const;
+
+private:
+    // Retrieve Slot of Sequence
+    const SharedFrameSlot* slotOf( const uint64_t sequence ) const;
+
+    // Retrieve View of Slot
+    SharedFrameView view( const SharedFrameSlot* slot ) const;
+};
+
+// Create Shared Frame Writer ("NAME[:all|depth|usermap|none[:WIDTHxHEIGHT]]", "all" up to 640x480 by default)
+std::unique_ptr<SharedFrameWriter> createSharedFrameWriter( const std::string& uri );
+
+#endif // __SHARED_FRAME__
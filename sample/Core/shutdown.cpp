@@ -0,0 +1,26 @@
+#include "shutdown.h"
+
+#include <csignal>
+
+// Shutdown Request
+static volatile std::sig_atomic_t shutdown_requested = 0;
+
+// Signal Handler
+extern "C" void handleShutdown( int )
+{
+    shutdown_requested = 1;
+}
+
+// Install Shutdown Handler
+void installShutdownHandler()
+{
+    shutdown_requested = 0;
+    std::signal( SIGINT, handleShutdown );
+    std::signal( SIGTERM, handleShutdown );
+}
+
+// Retrieve Shutdown Request
+bool isShutdownRequested()
+{
+    return shutdown_requested != 0;
+}
@@ -0,0 +1,10 @@
+#ifndef __SHUTDOWN__
+#define __SHUTDOWN__
+
+// Install Shutdown Handler (SIGINT and SIGTERM request shutdown)
+void installShutdownHandler();
+
+// Retrieve Shutdown Request
+bool isShutdownRequested();
+
+#endif // __SHUTDOWN__
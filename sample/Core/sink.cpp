@@ -0,0 +1,224 @@
+#include "sink.h"
+
+#include <iostream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment( lib, "ws2_32.lib" )
+#else
+#include <csignal>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+// Write Record to Standard Output
+void StdoutSink::write( const std::string& record )
+{
+    std::cout.write( record.data(), record.size() );
+}
+
+// Constructor
+FileSink::FileSink( const std::string& path )
+    : stream( path, std::ios::out | std::ios::trunc | std::ios::binary )
+{
+    if( !stream.is_open() ){
+        throw std::runtime_error( "failed can not open " + path );
+    }
+}
+
+// Write Record to File
+void FileSink::write( const std::string& record )
+{
+    stream.write( record.data(), record.size() );
+    if( !stream ){
+        throw std::runtime_error( "failed can not write record" );
+    }
+}
+
+// Constructor
+SocketSink::SocketSink( const std::string& host, const std::string& port )
+{
+    #ifdef _WIN32
+    WSADATA data;
+    if( WSAStartup( MAKEWORD( 2, 2 ), &data ) != 0 ){
+        throw std::runtime_error( "failed can not initialize winsock" );
+    }
+    #else
+    // Broken Connection is Reported by send() instead of SIGPIPE
+    std::signal( SIGPIPE, SIG_IGN );
+    #endif
+
+    // Resolve Address
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if( getaddrinfo( host.c_str(), port.c_str(), &hints, &addresses ) != 0 ){
+        throw std::runtime_error( "failed can not resolve " + host + ":" + port );
+    }
+
+    // Connect
+    socket_fd = -1;
+    for( addrinfo* address = addresses; address; address = address->ai_next ){
+        const intptr_t fd = static_cast<intptr_t>( socket( address->ai_family, address->ai_socktype, address->ai_protocol ) );
+        if( fd < 0 ){
+            continue;
+        }
+
+        if( connect( fd, address->ai_addr, static_cast<int>( address->ai_addrlen ) ) == 0 ){
+            socket_fd = fd;
+            break;
+        }
+
+        #ifdef _WIN32
+        closesocket( fd );
+        #else
+        close( static_cast<int>( fd ) );
+        #endif
+    }
+    freeaddrinfo( addresses );
+
+    if( socket_fd < 0 ){
+        throw std::runtime_error( "failed can not connect " + host + ":" + port );
+    }
+}
+
+// Destructor
+SocketSink::~SocketSink()
+{
+    #ifdef _WIN32
+    closesocket( socket_fd );
+    WSACleanup();
+    #else
+    close( static_cast<int>( socket_fd ) );
+    #endif
+}
+
+// Write Record to TCP Socket
+void SocketSink::write( const std::string& record )
+{
+    size_t sent = 0;
+    while( sent < record.size() ){
+        const int result = send( socket_fd, record.data() + sent, static_cast<int>( record.size() - sent ), 0 );
+        if( result <= 0 ){
+            throw std::runtime_error( "failed can not send record" );
+        }
+        sent += result;
+    }
+}
+
+// Write Record to Nowhere
+void NullSink::write( const std::string& record )
+{
+    bytes += record.size();
+}
+
+// Retrieve Written Bytes
+uint64_t NullSink::written() const
+{
+    return bytes;
+}
+
+// Write Character to Record
+RecordStream::Buffer::int_type RecordStream::Buffer::overflow( int_type character )
+{
+    if( !traits_type::eq_int_type( character, traits_type::eof() ) ){
+        record.push_back( traits_type::to_char_type( character ) );
+    }
+    return traits_type::not_eof( character );
+}
+
+// Write Characters to Record
+std::streamsize RecordStream::Buffer::xsputn( const char* data, std::streamsize size )
+{
+    record.append( data, static_cast<size_t>( size ) );
+    return size;
+}
+
+// Constructor
+RecordStream::RecordStream()
+    : std::ostream( nullptr )
+{
+    buffer.record.reserve( RECORD_STREAM_CAPACITY );
+    rdbuf( &buffer );
+}
+
+// Clear Record
+void RecordStream::reset()
+{
+    buffer.record.clear();
+}
+
+// Retrieve Record
+const std::string& RecordStream::str() const
+{
+    return buffer.record;
+}
+
+// Write JSON String
+void writeJSONString( std::ostream& stream, const std::string& text )
+{
+    static const char hex[] = "0123456789abcdef";
+    stream << "\"";
+    for( const char character : text ){
+        switch( character ){
+            case '"':
+                stream << "\\\"";
+                break;
+            case '\\':
+                stream << "\\\\";
+                break;
+            case '\n':
+                stream << "\\n";
+                break;
+            case '\r':
+                stream << "\\r";
+                break;
+            case '\t':
+                stream << "\\t";
+                break;
+            default:
+                if( static_cast<unsigned char>( character ) < 0x20 ){
+                    stream << "\\u00" << hex[character >> 4] << hex[character & 0x0F];
+                }
+                else{
+                    stream << character;
+                }
+                break;
+        }
+    }
+    stream << "\"";
+}
+
+// Create Sink
+std::unique_ptr<Sink> createSink( const std::string& uri )
+{
+    // Standard Output
+    if( uri.empty() || uri == "stdout" ){
+        return std::unique_ptr<Sink>( new StdoutSink() );
+    }
+
+    // Discard
+    if( uri == "null" ){
+        return std::unique_ptr<Sink>( new NullSink() );
+    }
+
+    // File
+    const std::string file = "file:";
+    if( uri.compare( 0, file.size(), file ) == 0 ){
+        return std::unique_ptr<Sink>( new FileSink( uri.substr( file.size() ) ) );
+    }
+
+    // TCP Socket
+    const std::string tcp = "tcp:";
+    const size_t separator = uri.rfind( ':' );
+    if( uri.compare( 0, tcp.size(), tcp ) == 0 && tcp.size() <= separator ){
+        return std::unique_ptr<Sink>( new SocketSink( uri.substr( tcp.size(), separator - tcp.size() ), uri.substr( separator + 1 ) ) );
+    }
+
+    throw std::runtime_error( "failed unknown sink " + uri + " (stdout, file:PATH, tcp:HOST:PORT or null)" );
+}
@@ -0,0 +1,122 @@
+#ifndef __SINK__
+#define __SINK__
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+// Record Sink (Headless Output)
+class Sink
+{
+public:
+    // Destructor
+    virtual ~Sink() = default;
+
+    // Write Record (As is, text records end with a new line)
+    virtual void write( const std::string& record ) = 0;
+};
+
+// Sink to Standard Output
+class StdoutSink : public Sink
+{
+public:
+    // Write Record
+    void write( const std::string& record ) override;
+};
+
+// Sink to File
+class FileSink : public Sink
+{
+private:
+    // Stream
+    std::ofstream stream;
+
+public:
+    // Constructor
+    explicit FileSink( const std::string& path );
+
+    // Write Record
+    void write( const std::string& record ) override;
+};
+
+// Sink to TCP Socket (Client)
+class SocketSink : public Sink
+{
+private:
+    // Socket
+    intptr_t socket_fd;
+
+public:
+    // Constructor
+    SocketSink( const std::string& host, const std::string& port );
+
+    // Destructor
+    ~SocketSink();
+
+    // Write Record
+    void write( const std::string& record ) override;
+};
+
+// Sink to Nowhere (Measure Serialization Only)
+class NullSink : public Sink
+{
+private:
+    // Written Bytes
+    uint64_t bytes = 0;
+
+public:
+    // Write Record
+    void write( const std::string& record ) override;
+
+    // Retrieve Written Bytes
+    uint64_t written() const;
+};
+
+// Initial Capacity of Record Stream [bytes] (JSON of 6 tracked skeletons is about 8 KB)
+#define RECORD_STREAM_CAPACITY 65536
+
+// Record Stream (Headless record buffer, keeps its capacity across records)
+class RecordStream : public std::ostream
+{
+private:
+    // String Buffer
+    class Buffer : public std::streambuf
+    {
+    public:
+        std::string record;
+
+    protected:
+        // Write Character
+        int_type overflow( int_type character ) override;
+
+        // Write Characters
+        std::streamsize xsputn( const char* data, std::streamsize size ) override;
+    };
+
+    Buffer buffer;
+
+public:
+    // Constructor
+    RecordStream();
+
+    // Clear Record (Keep Capacity)
+    void reset();
+
+    // Retrieve Record
+    const std::string& str() const;
+};
+
+// Write JSON String (Quoted, quote, backslash and control characters are escaped)
+void writeJSONString( std::ostream& stream, const std::string& text );
+
+// Create Sink
+// "" or "stdout"       : Standard Output
+// "file:PATH"          : File
+// "tcp:HOST:PORT"      : TCP Socket
+// "null"               : Discard
+std::unique_ptr<Sink> createSink( const std::string& uri );
+
+#endif // __SINK__
@@ -0,0 +1,500 @@
+#include "skeleton_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+#if defined( __AVX2__ )
+#define FILTER_AVX2
+#include <immintrin.h>
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define FILTER_SSE
+#include <emmintrin.h>
+#endif
+
+// Two Pi
+#define FILTER_TWO_PI 6.28318531f
+
+// Parse Filter
+FilterParameters parseFilter( const std::string& name )
+{
+    // Split Method and Values
+    std::vector<float> values;
+    const size_t separator = name.find( ':' );
+    const std::string method = name.substr( 0, separator );
+    size_t begin = separator;
+    while( begin != std::string::npos ){
+        const size_t end = name.find( ':', begin + 1 );
+        const std::string field = name.substr( begin + 1, ( end == std::string::npos ) ? std::string::npos : end - begin - 1 );
+        char* last = nullptr;
+        const float value = std::strtof( field.c_str(), &last );
+        if( field.empty() || *last != '\0' || !( 0.0f <= value ) ){
+            throw std::runtime_error( "failed invalid filter parameter of " + name );
+        }
+        values.push_back( value );
+        begin = end;
+    }
+
+    FilterParameters parameters;
+    if( method == "none" && values.empty() ){
+        parameters.method = FILTER_NONE;
+        return parameters;
+    }
+    if( method == "oneeuro" && values.size() <= 3 ){
+        parameters.method = FILTER_ONE_EURO;
+        parameters.min_cutoff = ( 0 < values.size() ) ? values[0] : parameters.min_cutoff;
+        parameters.beta = ( 1 < values.size() ) ? values[1] : parameters.beta;
+        parameters.derivative_cutoff = ( 2 < values.size() ) ? values[2] : parameters.derivative_cutoff;
+        if( parameters.min_cutoff <= 0.0f || parameters.derivative_cutoff <= 0.0f ){
+            throw std::runtime_error( "failed cutoff frequency must be positive " + name );
+        }
+        return parameters;
+    }
+    if( method == "kalman" && values.size() <= 2 ){
+        parameters.method = FILTER_KALMAN;
+        parameters.acceleration = ( 0 < values.size() ) ? values[0] : parameters.acceleration;
+        parameters.noise = ( 1 < values.size() ) ? values[1] : parameters.noise;
+        if( parameters.noise <= 0.0f ){
+            throw std::runtime_error( "failed measurement noise must be positive " + name );
+        }
+        return parameters;
+    }
+
+    throw std::runtime_error( "failed unknown filter " + name + " (none, oneeuro[:MIN_CUTOFF[:BETA[:DERIVATIVE_CUTOFF]]] or kalman[:ACCELERATION[:NOISE]])" );
+}
+
+// Retrieve Filter Method Name
+const char* filterMethodName( const FilterMethod method )
+{
+    switch( method ){
+        case FILTER_NONE:
+            return "none";
+        case FILTER_ONE_EURO:
+            return "oneeuro";
+        case FILTER_KALMAN:
+            return "kalman";
+        default:
+            return "unknown";
+    }
+}
+
+// Retrieve Instruction Set of Filter Kernels
+const char* filterInstructionSet()
+{
+#if defined( FILTER_AVX2 )
+    return "avx2";
+#elif defined( FILTER_SSE )
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+// Constructor
+SkeletonFilter::SkeletonFilter( const FilterParameters& parameters )
+{
+    // Clear State
+    for( uint32_t axis = 0; axis < 3; axis++ ){
+        measurement[axis].fill( 0.0f );
+        position[axis].fill( 0.0f );
+        velocity[axis].fill( 0.0f );
+    }
+    covariance_pp.fill( 0.0f );
+    covariance_pv.fill( 0.0f );
+    covariance_vv.fill( 0.0f );
+    update.fill( 0 );
+
+    setParameters( parameters );
+}
+
+// Set Parameters
+void SkeletonFilter::setParameters( const FilterParameters& parameters )
+{
+    this->parameters = parameters;
+    reset();
+}
+
+// Retrieve Parameters
+const FilterParameters& SkeletonFilter::getParameters() const
+{
+    return parameters;
+}
+
+// Restart State of All Joints
+void SkeletonFilter::reset()
+{
+    ids.fill( 0 );
+    users.fill( UINT32_MAX );
+    active.fill( false );
+    started = false;
+}
+
+// Find Slot of User
+inline uint32_t SkeletonFilter::slot( const nite::UserId id )
+{
+    uint32_t free = USER_COUNT;
+    for( uint32_t index = 0; index < USER_COUNT; index++ ){
+        if( ids[index] == id ){
+            return index;
+        }
+        if( !ids[index] && free == USER_COUNT ){
+            free = index;
+        }
+    }
+
+    // Assign Free Slot (State of its lanes was cleared when it was freed)
+    if( free != USER_COUNT ){
+        ids[free] = id;
+    }
+    return free;
+}
+
+// Filter Joints of Snapshot
+void SkeletonFilter::apply( SkeletonSnapshot& snapshot )
+{
+    if( parameters.method == FILTER_NONE ){
+        return;
+    }
+
+    // Time Step (Restart at first frame, timestamp going back and gap)
+    float dt = 0.0f;
+    if( started && timestamp < snapshot.timestamp && snapshot.timestamp - timestamp <= FILTER_MAX_GAP ){
+        dt = static_cast<float>( snapshot.timestamp - timestamp ) * 1.0e-6f;
+    }
+    else{
+        reset();
+    }
+    timestamp = snapshot.timestamp;
+    started = true;
+
+    // Gather Joints of Users (Start state of joints without state)
+    users.fill( UINT32_MAX );
+    update.fill( 0 );
+    size_t lanes = 0;
+    for( uint32_t index = 0; index < snapshot.count; index++ ){
+        const uint32_t number = slot( snapshot.ids[index] );
+        if( number == USER_COUNT ){
+            continue;
+        }
+        users[number] = index;
+        lanes = std::max<size_t>( lanes, ( number + 1 ) * JOINT_COUNT );
+
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const uint32_t lane = number * JOINT_COUNT + type;
+            const size_t source = SkeletonSnapshot::lane( index, type );
+            if( snapshot.position_confidence[source] < parameters.confidence ){
+                active[lane] = false;
+                continue;
+            }
+
+            measurement[0][lane] = snapshot.x[source];
+            measurement[1][lane] = snapshot.y[source];
+            measurement[2][lane] = snapshot.z[source];
+            if( active[lane] ){
+                update[lane] = UINT32_MAX;
+                continue;
+            }
+
+            // Start State
+            for( uint32_t axis = 0; axis < 3; axis++ ){
+                position[axis][lane] = measurement[axis][lane];
+                velocity[axis][lane] = 0.0f;
+            }
+            covariance_pp[lane] = parameters.noise * parameters.noise;
+            covariance_pv[lane] = 0.0f;
+            covariance_vv[lane] = FILTER_INITIAL_SPEED * FILTER_INITIAL_SPEED;
+            active[lane] = true;
+        }
+    }
+
+    // Free Slots of Users not Seen (Lost, not tracked or left)
+    for( uint32_t number = 0; number < USER_COUNT; number++ ){
+        if( users[number] != UINT32_MAX ){
+            continue;
+        }
+        ids[number] = 0;
+        std::fill( active.begin() + number * JOINT_COUNT, active.begin() + ( number + 1 ) * JOINT_COUNT, false );
+    }
+
+    // Filter Lanes of All Users (Up to last used slot)
+    lanes = ( lanes + 7 ) / 8 * 8;
+    if( lanes && 0.0f < dt ){
+        if( parameters.method == FILTER_ONE_EURO ){
+            filterOneEuro( dt, lanes );
+        }
+        else{
+            filterKalman( dt, lanes );
+        }
+    }
+
+    // Scatter Filtered Joints
+    for( uint32_t number = 0; number < USER_COUNT; number++ ){
+        if( users[number] == UINT32_MAX ){
+            continue;
+        }
+
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const uint32_t lane = number * JOINT_COUNT + type;
+            if( active[lane] ){
+                const size_t target = SkeletonSnapshot::lane( users[number], type );
+                snapshot.x[target] = position[0][lane];
+                snapshot.y[target] = position[1][lane];
+                snapshot.z[target] = position[2][lane];
+            }
+        }
+    }
+}
+
+// One-Euro Kernel (alpha( cutoff ) = r / ( 1 + r ), r = 2 pi cutoff dt)
+void SkeletonFilter::filterOneEuro( const float dt, const size_t lanes )
+{
+    const float rate = FILTER_TWO_PI * dt;
+    const float derivative_rate = rate * parameters.derivative_cutoff;
+    const float derivative_alpha = derivative_rate / ( 1.0f + derivative_rate );
+    const float inverse_dt = 1.0f / dt;
+
+    float* mx = measurement[0].data();
+    float* my = measurement[1].data();
+    float* mz = measurement[2].data();
+    float* px = position[0].data();
+    float* py = position[1].data();
+    float* pz = position[2].data();
+    float* vx = velocity[0].data();
+    float* vy = velocity[1].data();
+    float* vz = velocity[2].data();
+    size_t i = 0;
+
+#if defined( FILTER_AVX2 )
+    // AVX2 (8 Joints per Iteration)
+    const __m256 inverse = _mm256_set1_ps( inverse_dt );
+    const __m256 smoothing = _mm256_set1_ps( derivative_alpha );
+    const __m256 min_cutoff = _mm256_set1_ps( parameters.min_cutoff );
+    const __m256 beta = _mm256_set1_ps( parameters.beta );
+    const __m256 period = _mm256_set1_ps( rate );
+    const __m256 one = _mm256_set1_ps( 1.0f );
+    for( ; i + 8 <= lanes; i += 8 ){
+        const __m256 mask = _mm256_castsi256_ps( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( update.data() + i ) ) );
+        const __m256 x = _mm256_loadu_ps( px + i );
+        const __m256 y = _mm256_loadu_ps( py + i );
+        const __m256 z = _mm256_loadu_ps( pz + i );
+        const __m256 dx = _mm256_sub_ps( _mm256_loadu_ps( mx + i ), x );
+        const __m256 dy = _mm256_sub_ps( _mm256_loadu_ps( my + i ), y );
+        const __m256 dz = _mm256_sub_ps( _mm256_loadu_ps( mz + i ), z );
+
+        // Filtered Derivative
+        const __m256 ux = _mm256_loadu_ps( vx + i );
+        const __m256 uy = _mm256_loadu_ps( vy + i );
+        const __m256 uz = _mm256_loadu_ps( vz + i );
+        const __m256 nx = _mm256_add_ps( ux, _mm256_mul_ps( smoothing, _mm256_sub_ps( _mm256_mul_ps( dx, inverse ), ux ) ) );
+        const __m256 ny = _mm256_add_ps( uy, _mm256_mul_ps( smoothing, _mm256_sub_ps( _mm256_mul_ps( dy, inverse ), uy ) ) );
+        const __m256 nz = _mm256_add_ps( uz, _mm256_mul_ps( smoothing, _mm256_sub_ps( _mm256_mul_ps( dz, inverse ), uz ) ) );
+
+        // Cutoff Frequency by Speed
+        const __m256 speed = _mm256_sqrt_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( nx, nx ), _mm256_mul_ps( ny, ny ) ), _mm256_mul_ps( nz, nz ) ) );
+        const __m256 r = _mm256_mul_ps( period, _mm256_add_ps( min_cutoff, _mm256_mul_ps( beta, speed ) ) );
+        const __m256 alpha = _mm256_div_ps( r, _mm256_add_ps( one, r ) );
+
+        _mm256_storeu_ps( vx + i, _mm256_blendv_ps( ux, nx, mask ) );
+        _mm256_storeu_ps( vy + i, _mm256_blendv_ps( uy, ny, mask ) );
+        _mm256_storeu_ps( vz + i, _mm256_blendv_ps( uz, nz, mask ) );
+        _mm256_storeu_ps( px + i, _mm256_blendv_ps( x, _mm256_add_ps( x, _mm256_mul_ps( alpha, dx ) ), mask ) );
+        _mm256_storeu_ps( py + i, _mm256_blendv_ps( y, _mm256_add_ps( y, _mm256_mul_ps( alpha, dy ) ), mask ) );
+        _mm256_storeu_ps( pz + i, _mm256_blendv_ps( z, _mm256_add_ps( z, _mm256_mul_ps( alpha, dz ) ), mask ) );
+    }
+#elif defined( FILTER_SSE )
+    // SSE2 (4 Joints per Iteration)
+    const __m128 inverse = _mm_set1_ps( inverse_dt );
+    const __m128 smoothing = _mm_set1_ps( derivative_alpha );
+    const __m128 min_cutoff = _mm_set1_ps( parameters.min_cutoff );
+    const __m128 beta = _mm_set1_ps( parameters.beta );
+    const __m128 period = _mm_set1_ps( rate );
+    const __m128 one = _mm_set1_ps( 1.0f );
+    for( ; i + 4 <= lanes; i += 4 ){
+        const __m128 mask = _mm_castsi128_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( update.data() + i ) ) );
+        const __m128 x = _mm_loadu_ps( px + i );
+        const __m128 y = _mm_loadu_ps( py + i );
+        const __m128 z = _mm_loadu_ps( pz + i );
+        const __m128 dx = _mm_sub_ps( _mm_loadu_ps( mx + i ), x );
+        const __m128 dy = _mm_sub_ps( _mm_loadu_ps( my + i ), y );
+        const __m128 dz = _mm_sub_ps( _mm_loadu_ps( mz + i ), z );
+
+        // Filtered Derivative
+        const __m128 ux = _mm_loadu_ps( vx + i );
+        const __m128 uy = _mm_loadu_ps( vy + i );
+        const __m128 uz = _mm_loadu_ps( vz + i );
+        const __m128 nx = _mm_add_ps( ux, _mm_mul_ps( smoothing, _mm_sub_ps( _mm_mul_ps( dx, inverse ), ux ) ) );
+        const __m128 ny = _mm_add_ps( uy, _mm_mul_ps( smoothing, _mm_sub_ps( _mm_mul_ps( dy, inverse ), uy ) ) );
+        const __m128 nz = _mm_add_ps( uz, _mm_mul_ps( smoothing, _mm_sub_ps( _mm_mul_ps( dz, inverse ), uz ) ) );
+
+        // Cutoff Frequency by Speed
+        const __m128 speed = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, nx ), _mm_mul_ps( ny, ny ) ), _mm_mul_ps( nz, nz ) ) );
+        const __m128 r = _mm_mul_ps( period, _mm_add_ps( min_cutoff, _mm_mul_ps( beta, speed ) ) );
+        const __m128 alpha = _mm_div_ps( r, _mm_add_ps( one, r ) );
+
+        _mm_storeu_ps( vx + i, _mm_or_ps( _mm_and_ps( mask, nx ), _mm_andnot_ps( mask, ux ) ) );
+        _mm_storeu_ps( vy + i, _mm_or_ps( _mm_and_ps( mask, ny ), _mm_andnot_ps( mask, uy ) ) );
+        _mm_storeu_ps( vz + i, _mm_or_ps( _mm_and_ps( mask, nz ), _mm_andnot_ps( mask, uz ) ) );
+        _mm_storeu_ps( px + i, _mm_or_ps( _mm_and_ps( mask, _mm_add_ps( x, _mm_mul_ps( alpha, dx ) ) ), _mm_andnot_ps( mask, x ) ) );
+        _mm_storeu_ps( py + i, _mm_or_ps( _mm_and_ps( mask, _mm_add_ps( y, _mm_mul_ps( alpha, dy ) ) ), _mm_andnot_ps( mask, y ) ) );
+        _mm_storeu_ps( pz + i, _mm_or_ps( _mm_and_ps( mask, _mm_add_ps( z, _mm_mul_ps( alpha, dz ) ) ), _mm_andnot_ps( mask, z ) ) );
+    }
+#endif
+
+    // Scalar Tail
+    for( ; i < lanes; i++ ){
+        if( !update[i] ){
+            continue;
+        }
+
+        const float dx = mx[i] - px[i];
+        const float dy = my[i] - py[i];
+        const float dz = mz[i] - pz[i];
+        vx[i] += derivative_alpha * ( dx * inverse_dt - vx[i] );
+        vy[i] += derivative_alpha * ( dy * inverse_dt - vy[i] );
+        vz[i] += derivative_alpha * ( dz * inverse_dt - vz[i] );
+
+        const float speed = std::sqrt( vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i] );
+        const float r = rate * ( parameters.min_cutoff + parameters.beta * speed );
+        const float alpha = r / ( 1.0f + r );
+        px[i] += alpha * dx;
+        py[i] += alpha * dy;
+        pz[i] += alpha * dz;
+    }
+}
+
+// Kalman Kernel (Constant velocity, covariance is shared by axes of joint)
+void SkeletonFilter::filterKalman( const float dt, const size_t lanes )
+{
+    const float variance = parameters.acceleration * parameters.acceleration;
+    const float noise_pp = variance * dt * dt * dt * dt / 4.0f;
+    const float noise_pv = variance * dt * dt * dt / 2.0f;
+    const float noise_vv = variance * dt * dt;
+    const float noise = parameters.noise * parameters.noise;
+
+    float* cpp = covariance_pp.data();
+    float* cpv = covariance_pv.data();
+    float* cvv = covariance_vv.data();
+    size_t i = 0;
+
+#if defined( FILTER_AVX2 )
+    // AVX2 (8 Joints per Iteration)
+    const __m256 step = _mm256_set1_ps( dt );
+    const __m256 two_step = _mm256_set1_ps( 2.0f * dt );
+    const __m256 step_square = _mm256_set1_ps( dt * dt );
+    const __m256 q_pp = _mm256_set1_ps( noise_pp );
+    const __m256 q_pv = _mm256_set1_ps( noise_pv );
+    const __m256 q_vv = _mm256_set1_ps( noise_vv );
+    const __m256 r = _mm256_set1_ps( noise );
+    const __m256 one = _mm256_set1_ps( 1.0f );
+    for( ; i + 8 <= lanes; i += 8 ){
+        const __m256 mask = _mm256_castsi256_ps( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( update.data() + i ) ) );
+
+        // Predict Covariance
+        const __m256 pp = _mm256_loadu_ps( cpp + i );
+        const __m256 pv = _mm256_loadu_ps( cpv + i );
+        const __m256 vv = _mm256_loadu_ps( cvv + i );
+        const __m256 predict_pp = _mm256_add_ps( _mm256_add_ps( pp, _mm256_mul_ps( two_step, pv ) ), _mm256_add_ps( _mm256_mul_ps( step_square, vv ), q_pp ) );
+        const __m256 predict_pv = _mm256_add_ps( _mm256_add_ps( pv, _mm256_mul_ps( step, vv ) ), q_pv );
+        const __m256 predict_vv = _mm256_add_ps( vv, q_vv );
+
+        // Gain
+        const __m256 inverse = _mm256_div_ps( one, _mm256_add_ps( predict_pp, r ) );
+        const __m256 gain_p = _mm256_mul_ps( predict_pp, inverse );
+        const __m256 gain_v = _mm256_mul_ps( predict_pv, inverse );
+
+        // Predict and Correct State of Each Axis
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            float* p = position[axis].data() + i;
+            float* v = velocity[axis].data() + i;
+            const __m256 state_p = _mm256_loadu_ps( p );
+            const __m256 state_v = _mm256_loadu_ps( v );
+            const __m256 predict = _mm256_add_ps( state_p, _mm256_mul_ps( step, state_v ) );
+            const __m256 innovation = _mm256_sub_ps( _mm256_loadu_ps( measurement[axis].data() + i ), predict );
+            _mm256_storeu_ps( p, _mm256_blendv_ps( state_p, _mm256_add_ps( predict, _mm256_mul_ps( gain_p, innovation ) ), mask ) );
+            _mm256_storeu_ps( v, _mm256_blendv_ps( state_v, _mm256_add_ps( state_v, _mm256_mul_ps( gain_v, innovation ) ), mask ) );
+        }
+
+        // Correct Covariance
+        const __m256 complement = _mm256_sub_ps( one, gain_p );
+        _mm256_storeu_ps( cpp + i, _mm256_blendv_ps( pp, _mm256_mul_ps( complement, predict_pp ), mask ) );
+        _mm256_storeu_ps( cpv + i, _mm256_blendv_ps( pv, _mm256_mul_ps( complement, predict_pv ), mask ) );
+        _mm256_storeu_ps( cvv + i, _mm256_blendv_ps( vv, _mm256_sub_ps( predict_vv, _mm256_mul_ps( gain_v, predict_pv ) ), mask ) );
+    }
+#elif defined( FILTER_SSE )
+    // SSE2 (4 Joints per Iteration)
+    const __m128 step = _mm_set1_ps( dt );
+    const __m128 two_step = _mm_set1_ps( 2.0f * dt );
+    const __m128 step_square = _mm_set1_ps( dt * dt );
+    const __m128 q_pp = _mm_set1_ps( noise_pp );
+    const __m128 q_pv = _mm_set1_ps( noise_pv );
+    const __m128 q_vv = _mm_set1_ps( noise_vv );
+    const __m128 r = _mm_set1_ps( noise );
+    const __m128 one = _mm_set1_ps( 1.0f );
+    for( ; i + 4 <= lanes; i += 4 ){
+        const __m128 mask = _mm_castsi128_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( update.data() + i ) ) );
+
+        // Predict Covariance
+        const __m128 pp = _mm_loadu_ps( cpp + i );
+        const __m128 pv = _mm_loadu_ps( cpv + i );
+        const __m128 vv = _mm_loadu_ps( cvv + i );
+        const __m128 predict_pp = _mm_add_ps( _mm_add_ps( pp, _mm_mul_ps( two_step, pv ) ), _mm_add_ps( _mm_mul_ps( step_square, vv ), q_pp ) );
+        const __m128 predict_pv = _mm_add_ps( _mm_add_ps( pv, _mm_mul_ps( step, vv ) ), q_pv );
+        const __m128 predict_vv = _mm_add_ps( vv, q_vv );
+
+        // Gain
+        const __m128 inverse = _mm_div_ps( one, _mm_add_ps( predict_pp, r ) );
+        const __m128 gain_p = _mm_mul_ps( predict_pp, inverse );
+        const __m128 gain_v = _mm_mul_ps( predict_pv, inverse );
+
+        // Predict and Correct State of Each Axis
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            float* p = position[axis].data() + i;
+            float* v = velocity[axis].data() + i;
+            const __m128 state_p = _mm_loadu_ps( p );
+            const __m128 state_v = _mm_loadu_ps( v );
+            const __m128 predict = _mm_add_ps( state_p, _mm_mul_ps( step, state_v ) );
+            const __m128 innovation = _mm_sub_ps( _mm_loadu_ps( measurement[axis].data() + i ), predict );
+            _mm_storeu_ps( p, _mm_or_ps( _mm_and_ps( mask, _mm_add_ps( predict, _mm_mul_ps( gain_p, innovation ) ) ), _mm_andnot_ps( mask, state_p ) ) );
+            _mm_storeu_ps( v, _mm_or_ps( _mm_and_ps( mask, _mm_add_ps( state_v, _mm_mul_ps( gain_v, innovation ) ) ), _mm_andnot_ps( mask, state_v ) ) );
+        }
+
+        // Correct Covariance
+        const __m128 complement = _mm_sub_ps( one, gain_p );
+        _mm_storeu_ps( cpp + i, _mm_or_ps( _mm_and_ps( mask, _mm_mul_ps( complement, predict_pp ) ), _mm_andnot_ps( mask, pp ) ) );
+        _mm_storeu_ps( cpv + i, _mm_or_ps( _mm_and_ps( mask, _mm_mul_ps( complement, predict_pv ) ), _mm_andnot_ps( mask, pv ) ) );
+        _mm_storeu_ps( cvv + i, _mm_or_ps( _mm_and_ps( mask, _mm_sub_ps( predict_vv, _mm_mul_ps( gain_v, predict_pv ) ) ), _mm_andnot_ps( mask, vv ) ) );
+    }
+#endif
+
+    // Scalar Tail
+    for( ; i < lanes; i++ ){
+        if( !update[i] ){
+            continue;
+        }
+
+        // Predict Covariance
+        const float predict_pp = cpp[i] + 2.0f * dt * cpv[i] + dt * dt * cvv[i] + noise_pp;
+        const float predict_pv = cpv[i] + dt * cvv[i] + noise_pv;
+        const float predict_vv = cvv[i] + noise_vv;
+
+        // Gain
+        const float inverse = 1.0f / ( predict_pp + noise );
+        const float gain_p = predict_pp * inverse;
+        const float gain_v = predict_pv * inverse;
+
+        // Predict and Correct State of Each Axis
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            const float predict = position[axis][i] + dt * velocity[axis][i];
+            const float innovation = measurement[axis][i] - predict;
+            position[axis][i] = predict + gain_p * innovation;
+            velocity[axis][i] += gain_v * innovation;
+        }
+
+        // Correct Covariance
+        cpp[i] = ( 1.0f - gain_p ) * predict_pp;
+        cpv[i] = ( 1.0f - gain_p ) * predict_pv;
+        cvv[i] = predict_vv - gain_v * predict_pv;
+    }
+}
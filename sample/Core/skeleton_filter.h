@@ -0,0 +1,112 @@
+#ifndef __SKELETON_FILTER__
+#define __SKELETON_FILTER__
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "skeleton_snapshot.h"
+
+// Filter Lanes (Slot of User x Joint, Padded to 8 Lanes of AVX)
+#define FILTER_LANES ( ( USER_COUNT * JOINT_COUNT + 7 ) / 8 * 8 )
+
+// Maximum Time Step [us] (State restarts after longer gaps)
+#define FILTER_MAX_GAP 500000
+
+// Initial Speed Deviation of Kalman Filter [mm/s]
+#define FILTER_INITIAL_SPEED 1000.0f
+
+// Skeleton Filter Method
+enum FilterMethod
+{
+    FILTER_NONE,     // Raw joints of tracker
+    FILTER_ONE_EURO, // One-Euro filter (low-pass, cutoff frequency rises with speed of joint)
+    FILTER_KALMAN    // Constant-velocity Kalman filter (white noise acceleration)
+};
+
+// Skeleton Filter Parameters
+struct FilterParameters
+{
+    FilterMethod method = FILTER_NONE;
+
+    // One-Euro
+    float min_cutoff = 1.0f;        // Cutoff frequency at rest [Hz] (lower is smoother)
+    float beta = 0.005f;            // Cutoff frequency per speed [Hz/(mm/s)] (higher is less lag)
+    float derivative_cutoff = 1.0f; // Cutoff frequency of speed [Hz]
+
+    // Kalman
+    float acceleration = 2000.0f; // Standard deviation of acceleration [mm/s^2] (process noise)
+    float noise = 15.0f;          // Standard deviation of measurement [mm]
+
+    // Position Confidence (Joints below are not filtered, and their state restarts)
+    float confidence = 0.5f;
+};
+
+// Parse Filter ("none", "oneeuro[:MIN_CUTOFF[:BETA[:DERIVATIVE_CUTOFF]]]" or "kalman[:ACCELERATION[:NOISE]]")
+FilterParameters parseFilter( const std::string& name );
+
+// Retrieve Filter Method Name
+const char* filterMethodName( const FilterMethod method );
+
+// Retrieve Instruction Set of Filter Kernels ("avx2", "sse2" or "scalar")
+const char* filterInstructionSet();
+
+// Skeleton Temporal Filter (Joint positions of snapshot in place, lanes of slot of user x joint)
+class SkeletonFilter
+{
+private:
+    typedef std::array<float, FILTER_LANES> Lanes;
+
+    // Parameters
+    FilterParameters parameters;
+
+    // Slots (User Id of Slot, 0: Free) and Index of User in Snapshot (UINT32_MAX: Not Seen)
+    std::array<nite::UserId, USER_COUNT> ids;
+    std::array<uint32_t, USER_COUNT> users;
+
+    // Lane Status (active: state is initialized, update: measured and filtered in this frame)
+    std::array<bool, FILTER_LANES> active;
+    std::array<uint32_t, FILTER_LANES> update;
+
+    // Measurement, Position and Velocity (Filtered derivative of One-Euro) of X, Y, Z
+    std::array<Lanes, 3> measurement;
+    std::array<Lanes, 3> position;
+    std::array<Lanes, 3> velocity;
+
+    // Covariance of Kalman Filter (Same for each axis)
+    Lanes covariance_pp;
+    Lanes covariance_pv;
+    Lanes covariance_vv;
+
+    // Sensor Timestamp of Previous Frame [us]
+    uint64_t timestamp = 0;
+    bool started = false;
+
+public:
+    // Constructor
+    explicit SkeletonFilter( const FilterParameters& parameters = FilterParameters() );
+
+    // Set Parameters (Restart State)
+    void setParameters( const FilterParameters& parameters );
+
+    // Retrieve Parameters
+    const FilterParameters& getParameters() const;
+
+    // Filter Joints of Snapshot
+    void apply( SkeletonSnapshot& snapshot );
+
+    // Restart State of All Joints
+    void reset();
+
+private:
+    // Find Slot of User (Assign free slot if not found, USER_COUNT if no slot is free)
+    inline uint32_t slot( const nite::UserId id );
+
+    // One-Euro Kernel (lanes is multiple of 8)
+    void filterOneEuro( const float dt, const size_t lanes );
+
+    // Kalman Kernel (lanes is multiple of 8)
+    void filterKalman( const float dt, const size_t lanes );
+};
+
+#endif // __SKELETON_FILTER__
@@ -0,0 +1,613 @@
+#include "skeleton_fusion.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+// Quaternion (x, y, z, w) from Rotation Matrix
+static std::array<float, 4> rotationToQuaternion( const std::array<float, 9>& r )
+{
+    std::array<float, 4> q;
+    const float trace = r[0] + r[4] + r[8];
+    if( 0.0f < trace ){
+        const float s = 2.0f * std::sqrt( trace + 1.0f );
+        q = { { ( r[7] - r[5] ) / s, ( r[2] - r[6] ) / s, ( r[3] - r[1] ) / s, 0.25f * s } };
+    }
+    else if( r[4] < r[0] && r[8] < r[0] ){
+        const float s = 2.0f * std::sqrt( 1.0f + r[0] - r[4] - r[8] );
+        q = { { 0.25f * s, ( r[1] + r[3] ) / s, ( r[2] + r[6] ) / s, ( r[7] - r[5] ) / s } };
+    }
+    else if( r[8] < r[4] ){
+        const float s = 2.0f * std::sqrt( 1.0f + r[4] - r[0] - r[8] );
+        q = { { ( r[1] + r[3] ) / s, 0.25f * s, ( r[5] + r[7] ) / s, ( r[2] - r[6] ) / s } };
+    }
+    else{
+        const float s = 2.0f * std::sqrt( 1.0f + r[8] - r[0] - r[4] );
+        q = { { ( r[2] + r[6] ) / s, ( r[5] + r[7] ) / s, 0.25f * s, ( r[3] - r[1] ) / s } };
+    }
+    return q;
+}
+
+// Extrinsics from Pose of Sensor in World
+Extrinsics extrinsicsFromPose( const float yaw, const float pitch, const float roll, const float x, const float y, const float z )
+{
+    // R = Ry( yaw ) * Rx( pitch ) * Rz( roll )
+    const float cy = std::cos( yaw ), sy = std::sin( yaw );
+    const float cp = std::cos( pitch ), sp = std::sin( pitch );
+    const float cr = std::cos( roll ), sr = std::sin( roll );
+
+    Extrinsics extrinsics;
+    extrinsics.rotation = { {
+        cy * cr + sy * sp * sr, -cy * sr + sy * sp * cr, sy * cp,
+        cp * sr,                 cp * cr,                -sp,
+        -sy * cr + cy * sp * sr, sy * sr + cy * sp * cr,  cy * cp
+    } };
+    extrinsics.translation = { { x, y, z } };
+    return extrinsics;
+}
+
+// Invert Extrinsics
+Extrinsics invertExtrinsics( const Extrinsics& extrinsics )
+{
+    const std::array<float, 9>& r = extrinsics.rotation;
+    const std::array<float, 3>& t = extrinsics.translation;
+
+    Extrinsics inverse;
+    inverse.rotation = { { r[0], r[3], r[6], r[1], r[4], r[7], r[2], r[5], r[8] } };
+    inverse.translation = { {
+        -( r[0] * t[0] + r[3] * t[1] + r[6] * t[2] ),
+        -( r[1] * t[0] + r[4] * t[1] + r[7] * t[2] ),
+        -( r[2] * t[0] + r[5] * t[1] + r[8] * t[2] )
+    } };
+    return inverse;
+}
+
+// Load Extrinsics from Calibration File
+Extrinsics loadExtrinsics( const std::string& path )
+{
+    std::ifstream stream( path );
+    if( !stream.is_open() ){
+        throw std::runtime_error( "failed can not open " + path );
+    }
+
+    Extrinsics extrinsics;
+    uint32_t found = 0;
+    std::string line;
+    while( std::getline( stream, line ) ){
+        // Skip Comment and Empty Line
+        const size_t comment = line.find( '#' );
+        if( comment != std::string::npos ){
+            line.erase( comment );
+        }
+
+        std::istringstream fields( line );
+        std::string name;
+        float value;
+        if( !( fields >> name ) ){
+            continue;
+        }
+        if( !( fields >> value ) ){
+            throw std::runtime_error( "failed invalid calibration value of " + name );
+        }
+
+        // Parameters (Other names are ignored)
+        if( name.size() == 3 && name[0] == 'r' && '0' <= name[1] && name[1] <= '2' && '0' <= name[2] && name[2] <= '2' ){
+            const uint32_t index = ( name[1] - '0' ) * 3 + ( name[2] - '0' );
+            extrinsics.rotation[index] = value;
+            found |= 1 << index;
+        }
+        else if( name == "tx" || name == "ty" || name == "tz" ){
+            const uint32_t index = name[1] - 'x';
+            extrinsics.translation[index] = value;
+            found |= 1 << ( 9 + index );
+        }
+    }
+
+    if( found != 0xFFF ){
+        throw std::runtime_error( "failed incomplete calibration " + path );
+    }
+
+    return extrinsics;
+}
+
+// Save Extrinsics to Calibration File
+void saveExtrinsics( const std::string& path, const Extrinsics& extrinsics )
+{
+    std::ofstream stream( path, std::ios::out | std::ios::trunc );
+    if( !stream.is_open() ){
+        throw std::runtime_error( "failed can not open " + path );
+    }
+
+    stream.precision( 9 );
+    stream << "# world = rotation (r00 - r22, row-major) * sensor + translation (tx, ty, tz) [mm]\n";
+    for( uint32_t index = 0; index < 9; index++ ){
+        stream << "r" << index / 3 << index % 3 << " " << extrinsics.rotation[index] << "\n";
+    }
+    stream << "tx " << extrinsics.translation[0] << "\n";
+    stream << "ty " << extrinsics.translation[1] << "\n";
+    stream << "tz " << extrinsics.translation[2] << "\n";
+    if( !stream ){
+        throw std::runtime_error( "failed can not write " + path );
+    }
+}
+
+// Constructor of Sensor
+SkeletonFusion::Sensor::Sensor()
+    : queue( FUSION_QUEUE_SIZE )
+{
+    offsets.fill( 0 );
+    rotation = { { 0.0f, 0.0f, 0.0f, 1.0f } };
+}
+
+// Constructor
+SkeletonFusion::SkeletonFusion( const std::vector<Extrinsics>& extrinsics, const FusionParameters& parameters )
+    : parameters( parameters )
+{
+    if( extrinsics.empty() || FUSION_SENSOR_COUNT < extrinsics.size() ){
+        throw std::runtime_error( "failed invalid number of sensors of fusion" );
+    }
+    if( !parameters.rate ){
+        throw std::runtime_error( "failed invalid output rate of fusion" );
+    }
+
+    for( const Extrinsics& sensor_extrinsics : extrinsics ){
+        sensors.emplace_back( new Sensor() );
+        sensors.back()->extrinsics = sensor_extrinsics;
+        sensors.back()->rotation = rotationToQuaternion( sensor_extrinsics.rotation );
+    }
+
+    for( Track& track : tracks ){
+        track.anchor.fill( 0.0f );
+        track.users.fill( 0 );
+        track.observation.fill( -1 );
+    }
+}
+
+// Push Snapshot of Sensor
+bool SkeletonFusion::push( const uint32_t sensor, const SkeletonSnapshot& snapshot, const uint64_t arrival )
+{
+    return sensors.at( sensor )->queue.emplace( [&snapshot, arrival]( Sample& sample ){
+        sample.snapshot = snapshot;
+        sample.arrival = arrival;
+    } );
+}
+
+// Fuse Skeletons at Time
+uint32_t SkeletonFusion::fuse( const uint64_t time, SkeletonSnapshot& fused )
+{
+    // Align and Sample Users of Sensors
+    observation_count = 0;
+    for( uint32_t index = 0; index < sensors.size(); index++ ){
+        drain( *sensors[index] );
+        sample( index, time );
+    }
+
+    // Associate Users across Sensors
+    associate( time );
+
+    // Fuse Joints
+    write( time, fused );
+
+    // Count Contributing Sensors
+    uint32_t contributing = 0;
+    for( uint32_t index = 0; index < sensors.size(); index++ ){
+        for( uint32_t number = 0; number < observation_count; number++ ){
+            if( observations[number].sensor == index ){
+                contributing++;
+                break;
+            }
+        }
+    }
+    return contributing;
+}
+
+// Run Fusion at Fixed Output Rate
+void SkeletonFusion::run( const std::function<bool( const SkeletonSnapshot& )>& output )
+{
+    SkeletonSnapshot fused;
+    const uint64_t period = 1000000 / parameters.rate;
+    uint64_t tick = now();
+    while( true ){
+        std::this_thread::sleep_until( std::chrono::steady_clock::time_point( std::chrono::microseconds( tick ) ) );
+
+        // Fuse at Tick - Latency
+        fuse( tick - std::min<uint64_t>( tick, parameters.latency ), fused );
+        if( !output( fused ) ){
+            break;
+        }
+
+        // Next Tick (Skip ticks if output fell behind)
+        tick += period;
+        const uint64_t current = now();
+        if( tick + period < current ){
+            tick = current;
+        }
+    }
+}
+
+// Retrieve Number of Sensors
+uint32_t SkeletonFusion::sensorCount() const
+{
+    return static_cast<uint32_t>( sensors.size() );
+}
+
+// Retrieve Number of Snapshots Dropped by Full Queue of Sensor
+uint64_t SkeletonFusion::droppedSnapshots( const uint32_t sensor ) const
+{
+    return sensors.at( sensor )->queue.drops();
+}
+
+// Retrieve Clock Offset of Sensor
+int64_t SkeletonFusion::clockOffset( const uint32_t sensor ) const
+{
+    return sensors.at( sensor )->offset;
+}
+
+// Retrieve Common Clock
+uint64_t SkeletonFusion::now()
+{
+    return static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count() );
+}
+
+// Drain Queue of Sensor into History
+inline void SkeletonFusion::drain( Sensor& sensor )
+{
+    while( true ){
+        // Pop into Next Slot of History (Overwrite oldest if full)
+        const bool full = sensor.history_count == FUSION_HISTORY;
+        const uint32_t slot = full ? sensor.history_head : ( sensor.history_head + sensor.history_count ) % FUSION_HISTORY;
+        if( !sensor.queue.pop( sensor.history[slot] ) ){
+            break;
+        }
+        if( full ){
+            sensor.history_head = ( sensor.history_head + 1 ) % FUSION_HISTORY;
+        }
+        else{
+            sensor.history_count++;
+        }
+
+        // Update Clock Offset (Minimum of arrival - sensor timestamp over window)
+        const Sample& sample = sensor.history[slot];
+        sensor.offsets[sensor.offset_next] = static_cast<int64_t>( sample.arrival ) - static_cast<int64_t>( sample.snapshot.timestamp );
+        sensor.offset_next = ( sensor.offset_next + 1 ) % FUSION_CLOCK_WINDOW;
+        sensor.offset_count = std::min<uint32_t>( sensor.offset_count + 1, FUSION_CLOCK_WINDOW );
+        sensor.offset = *std::min_element( sensor.offsets.begin(), sensor.offsets.begin() + sensor.offset_count );
+    }
+}
+
+// Sample Users of Sensor at Time
+inline void SkeletonFusion::sample( const uint32_t index, const uint64_t time )
+{
+    const Sensor& sensor = *sensors[index];
+
+    // Find Snapshots around Time (History is in order of sensor timestamp)
+    const Sample* previous = nullptr;
+    const Sample* next = nullptr;
+    int64_t previous_time = 0, next_time = 0;
+    for( uint32_t k = 0; k < sensor.history_count; k++ ){
+        const Sample& sample = sensor.history[( sensor.history_head + k ) % FUSION_HISTORY];
+        const int64_t sample_time = static_cast<int64_t>( sample.snapshot.timestamp ) + sensor.offset;
+        if( sample_time <= static_cast<int64_t>( time ) ){
+            previous = &sample;
+            previous_time = sample_time;
+        }
+        else{
+            next = &sample;
+            next_time = sample_time;
+            break;
+        }
+    }
+
+    // Skip Sensor without Recent Snapshot
+    if( !previous || parameters.max_age < static_cast<int64_t>( time ) - previous_time ){
+        return;
+    }
+
+    // Interpolate Users between Snapshots (or Hold Previous)
+    const float weight = next ? static_cast<float>( static_cast<int64_t>( time ) - previous_time ) / static_cast<float>( next_time - previous_time ) : 0.0f;
+    const SkeletonSnapshot& snapshot = previous->snapshot;
+    for( uint32_t number = 0; number < snapshot.count; number++ ){
+        if( snapshot.states[number] != nite::SkeletonState::SKELETON_TRACKED ){
+            continue;
+        }
+
+        uint32_t next_number = 0;
+        const SkeletonSnapshot* next_snapshot = nullptr;
+        if( next ){
+            for( ; next_number < next->snapshot.count; next_number++ ){
+                if( next->snapshot.ids[next_number] == snapshot.ids[number] ){
+                    next_snapshot = &next->snapshot;
+                    break;
+                }
+            }
+        }
+
+        observe( index, snapshot, number, next_snapshot, next_number, weight );
+    }
+}
+
+// Append Observation of User
+inline void SkeletonFusion::observe( const uint32_t index, const SkeletonSnapshot& previous, const uint32_t previous_user, const SkeletonSnapshot* next, const uint32_t next_user, const float weight )
+{
+    if( observations.size() <= observation_count ){
+        return;
+    }
+
+    const Sensor& sensor = *sensors[index];
+    const float threshold = parameters.confidence;
+    Observation& observation = observations[observation_count++];
+    observation.sensor = index;
+    observation.id = previous.ids[previous_user];
+    observation.track = -1;
+
+    const size_t previous_row = SkeletonSnapshot::lane( previous_user, 0 );
+    const size_t next_row = SkeletonSnapshot::lane( next_user, 0 );
+    for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+        const size_t p = previous_row + type;
+        const size_t n = next_row + type;
+
+        // Position (Interpolate if confident in both snapshots, otherwise take the more confident one)
+        float x = previous.x[p], y = previous.y[p], z = previous.z[p];
+        float confidence = previous.position_confidence[p];
+        if( next ){
+            if( threshold <= previous.position_confidence[p] && threshold <= next->position_confidence[n] ){
+                x += ( next->x[n] - x ) * weight;
+                y += ( next->y[n] - y ) * weight;
+                z += ( next->z[n] - z ) * weight;
+                confidence += ( next->position_confidence[n] - confidence ) * weight;
+            }
+            else if( previous.position_confidence[p] < next->position_confidence[n] ){
+                x = next->x[n];
+                y = next->y[n];
+                z = next->z[n];
+                confidence = next->position_confidence[n];
+            }
+        }
+        transformPoint( sensor.extrinsics, x, y, z, &observation.position[type * 3 + 0], &observation.position[type * 3 + 1], &observation.position[type * 3 + 2] );
+        observation.position_confidence[type] = confidence;
+
+        // Orientation (Normalized lerp on the same hemisphere, rotated to world)
+        float q[4] = { previous.orientation_x[p], previous.orientation_y[p], previous.orientation_z[p], previous.orientation_w[p] };
+        float orientation_confidence = previous.orientation_confidence[p];
+        if( next && threshold <= previous.orientation_confidence[p] && threshold <= next->orientation_confidence[n] ){
+            const float r[4] = { next->orientation_x[n], next->orientation_y[n], next->orientation_z[n], next->orientation_w[n] };
+            const float sign = ( q[0] * r[0] + q[1] * r[1] + q[2] * r[2] + q[3] * r[3] < 0.0f ) ? -1.0f : 1.0f;
+            float norm = 0.0f;
+            for( uint32_t axis = 0; axis < 4; axis++ ){
+                q[axis] += ( sign * r[axis] - q[axis] ) * weight;
+                norm += q[axis] * q[axis];
+            }
+            norm = ( 0.0f < norm ) ? 1.0f / std::sqrt( norm ) : 0.0f;
+            for( uint32_t axis = 0; axis < 4; axis++ ){
+                q[axis] *= norm;
+            }
+            orientation_confidence += ( next->orientation_confidence[n] - orientation_confidence ) * weight;
+        }
+        const std::array<float, 4>& s = sensor.rotation;
+        float* o = &observation.orientation[type * 4];
+        o[0] = s[3] * q[0] + s[0] * q[3] + s[1] * q[2] - s[2] * q[1];
+        o[1] = s[3] * q[1] - s[0] * q[2] + s[1] * q[3] + s[2] * q[0];
+        o[2] = s[3] * q[2] + s[0] * q[1] - s[1] * q[0] + s[2] * q[3];
+        o[3] = s[3] * q[3] - s[0] * q[0] - s[1] * q[1] - s[2] * q[2];
+        observation.orientation_confidence[type] = orientation_confidence;
+    }
+
+    // Anchor (Torso, or mean of confident joints)
+    if( threshold <= observation.position_confidence[FUSION_ANCHOR_JOINT] ){
+        for( uint32_t axis = 0; axis < 3; axis++ ){
+            observation.anchor[axis] = observation.position[FUSION_ANCHOR_JOINT * 3 + axis];
+        }
+        return;
+    }
+
+    float sum[3] = { 0.0f, 0.0f, 0.0f };
+    uint32_t count = 0;
+    for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+        if( threshold <= observation.position_confidence[type] ){
+            for( uint32_t axis = 0; axis < 3; axis++ ){
+                sum[axis] += observation.position[type * 3 + axis];
+            }
+            count++;
+        }
+    }
+    for( uint32_t axis = 0; axis < 3; axis++ ){
+        observation.anchor[axis] = count ? sum[axis] / count : observation.position[FUSION_ANCHOR_JOINT * 3 + axis];
+    }
+}
+
+// Associate Observations with Tracks
+inline void SkeletonFusion::associate( const uint64_t time )
+{
+    // Squared Distance of Anchors
+    auto distance = []( const std::array<float, 3>& a, const std::array<float, 3>& b ){
+        const float dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+        return dx * dx + dy * dy + dz * dz;
+    };
+
+    // Assign Observation to Track (User id of sensor follows the track)
+    auto assign = [this]( const uint32_t number, const int32_t track ){
+        Observation& observation = observations[number];
+        for( Track& other : tracks ){
+            if( other.users[observation.sensor] == observation.id ){
+                other.users[observation.sensor] = 0;
+            }
+        }
+        tracks[track].users[observation.sensor] = observation.id;
+        tracks[track].observation[observation.sensor] = static_cast<int32_t>( number );
+        observation.track = track;
+    };
+
+    for( Track& track : tracks ){
+        track.observation.fill( -1 );
+    }
+
+    // Previous Track of User (Within twice the gate)
+    const float gate = parameters.gate * parameters.gate;
+    for( uint32_t number = 0; number < observation_count; number++ ){
+        const Observation& observation = observations[number];
+        for( int32_t t = 0; t < static_cast<int32_t>( tracks.size() ); t++ ){
+            const Track& track = tracks[t];
+            if( track.active && track.users[observation.sensor] == observation.id && track.observation[observation.sensor] < 0 && distance( track.anchor, observation.anchor ) < 4.0f * gate ){
+                assign( number, t );
+                break;
+            }
+        }
+    }
+
+    while( true ){
+        // Nearest Track within Gate (At most one user per sensor and track)
+        while( true ){
+            uint32_t best_number = 0;
+            int32_t best_track = -1;
+            float best = gate;
+            for( uint32_t number = 0; number < observation_count; number++ ){
+                const Observation& observation = observations[number];
+                if( 0 <= observation.track ){
+                    continue;
+                }
+                for( int32_t t = 0; t < static_cast<int32_t>( tracks.size() ); t++ ){
+                    const Track& track = tracks[t];
+                    if( !track.active || 0 <= track.observation[observation.sensor] ){
+                        continue;
+                    }
+                    const float d = distance( track.anchor, observation.anchor );
+                    if( d < best ){
+                        best = d;
+                        best_number = number;
+                        best_track = t;
+                    }
+                }
+            }
+            if( best_track < 0 ){
+                break;
+            }
+            assign( best_number, best_track );
+        }
+
+        // New Track for First Unassigned User (Others may join it by gate)
+        uint32_t number = 0;
+        while( number < observation_count && 0 <= observations[number].track ){
+            number++;
+        }
+        if( number == observation_count ){
+            break;
+        }
+
+        int32_t t = 0;
+        while( t < static_cast<int32_t>( tracks.size() ) && tracks[t].active ){
+            t++;
+        }
+        if( t == static_cast<int32_t>( tracks.size() ) ){
+            break;
+        }
+
+        Track& track = tracks[t];
+        track.active = true;
+        track.id = next_id;
+        next_id = ( next_id == std::numeric_limits<uint16_t>::max() ) ? 1 : next_id + 1;
+        track.anchor = observations[number].anchor;
+        track.seen = time;
+        track.users.fill( 0 );
+        assign( number, t );
+    }
+
+    // Update Anchors of Tracks, and Remove Tracks not Seen for Timeout
+    for( Track& track : tracks ){
+        if( !track.active ){
+            continue;
+        }
+
+        float sum[3] = { 0.0f, 0.0f, 0.0f };
+        uint32_t count = 0;
+        for( const int32_t number : track.observation ){
+            if( 0 <= number ){
+                for( uint32_t axis = 0; axis < 3; axis++ ){
+                    sum[axis] += observations[number].anchor[axis];
+                }
+                count++;
+            }
+        }
+
+        if( count ){
+            for( uint32_t axis = 0; axis < 3; axis++ ){
+                track.anchor[axis] = sum[axis] / count;
+            }
+            track.seen = time;
+        }
+        else if( parameters.timeout < time - track.seen ){
+            track.active = false;
+            track.users.fill( 0 );
+        }
+    }
+}
+
+// Fuse Joints of Tracks into Snapshot
+inline void SkeletonFusion::write( const uint64_t time, SkeletonSnapshot& fused )
+{
+    const float threshold = parameters.confidence;
+    fused.frame_index = frame_index++;
+    fused.timestamp = time;
+    fused.count = 0;
+
+    for( const Track& track : tracks ){
+        if( !track.active || track.seen != time || fused.count == USER_COUNT ){
+            continue;
+        }
+
+        // User
+        const uint32_t number = fused.count++;
+        fused.ids[number] = static_cast<nite::UserId>( track.id );
+        fused.states[number] = nite::SkeletonState::SKELETON_TRACKED;
+        fused.poses[number] = 0;
+        fused.users[number] = number;
+
+        // Joints (Confidence weighted mean of confident sensors, or the most confident sensor)
+        const size_t row = SkeletonSnapshot::lane( number, 0 );
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            float sum[3] = { 0.0f, 0.0f, 0.0f };
+            float weight = 0.0f, confidence = -1.0f, orientation_confidence = -1.0f;
+            int32_t most = -1, most_orientation = -1;
+            for( const int32_t index : track.observation ){
+                if( index < 0 ){
+                    continue;
+                }
+
+                const Observation& observation = observations[index];
+                const float c = observation.position_confidence[type];
+                if( threshold <= c ){
+                    for( uint32_t axis = 0; axis < 3; axis++ ){
+                        sum[axis] += c * observation.position[type * 3 + axis];
+                    }
+                    weight += c;
+                }
+                if( confidence < c ){
+                    confidence = c;
+                    most = index;
+                }
+                if( orientation_confidence < observation.orientation_confidence[type] ){
+                    orientation_confidence = observation.orientation_confidence[type];
+                    most_orientation = index;
+                }
+            }
+
+            const size_t lane = row + type;
+            const float* position = &observations[most].position[type * 3];
+            fused.x[lane] = ( 0.0f < weight ) ? sum[0] / weight : position[0];
+            fused.y[lane] = ( 0.0f < weight ) ? sum[1] / weight : position[1];
+            fused.z[lane] = ( 0.0f < weight ) ? sum[2] / weight : position[2];
+            fused.position_confidence[lane] = confidence;
+
+            const float* orientation = &observations[most_orientation].orientation[type * 4];
+            fused.orientation_x[lane] = orientation[0];
+            fused.orientation_y[lane] = orientation[1];
+            fused.orientation_z[lane] = orientation[2];
+            fused.orientation_w[lane] = orientation[3];
+            fused.orientation_confidence[lane] = orientation_confidence;
+        }
+    }
+}
@@ -0,0 +1,192 @@
+#ifndef __SKELETON_FUSION__
+#define __SKELETON_FUSION__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "skeleton_snapshot.h"
+#include "spsc_queue.h"
+
+// Maximum Number of Sensors of Fusion
+#define FUSION_SENSOR_COUNT 8
+
+// Snapshots per Sensor Waiting for Fusion Thread (Newest snapshot is dropped when full)
+#define FUSION_QUEUE_SIZE 16
+
+// Snapshots per Sensor Kept for Interpolation (Owned by Fusion Thread)
+#define FUSION_HISTORY 8
+
+// Clock Offset Window per Sensor [snapshots]
+#define FUSION_CLOCK_WINDOW 64
+
+// Fused Tracks (Tracks beyond USER_COUNT are not written to output)
+#define FUSION_TRACK_COUNT ( 2 * USER_COUNT )
+
+// Torso Joint (nite::JointType::JOINT_TORSO, Anchor of Association)
+#define FUSION_ANCHOR_JOINT 8
+
+// Sensor Extrinsics (Sensor to World, world = rotation * sensor + translation [mm])
+struct Extrinsics
+{
+    std::array<float, 9> rotation = { { 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f } }; // Row-major
+    std::array<float, 3> translation = { { 0.0f, 0.0f, 0.0f } };
+};
+
+// Extrinsics from Pose of Sensor in World (Rotation about Y (yaw), X (pitch) and Z (roll) [rad], position [mm])
+Extrinsics extrinsicsFromPose( const float yaw, const float pitch, const float roll, const float x, const float y, const float z );
+
+// Invert Extrinsics (World to Sensor)
+Extrinsics invertExtrinsics( const Extrinsics& extrinsics );
+
+// Transform Point by Extrinsics
+inline void transformPoint( const Extrinsics& extrinsics, const float x, const float y, const float z, float* px, float* py, float* pz )
+{
+    const std::array<float, 9>& r = extrinsics.rotation;
+    *px = r[0] * x + r[1] * y + r[2] * z + extrinsics.translation[0];
+    *py = r[3] * x + r[4] * y + r[5] * z + extrinsics.translation[1];
+    *pz = r[6] * x + r[7] * y + r[8] * z + extrinsics.translation[2];
+}
+
+// Load Extrinsics from Calibration File ("name value" lines of r00 - r22, tx, ty and tz [mm])
+Extrinsics loadExtrinsics( const std::string& path );
+
+// Save Extrinsics to Calibration File
+void saveExtrinsics( const std::string& path, const Extrinsics& extrinsics );
+
+// Skeleton Fusion Parameters
+struct FusionParameters
+{
+    uint32_t rate = 30;          // Output Rate [Hz]
+    uint32_t latency = 100000;   // Output Latency [us] (Fused time is output time - latency)
+    uint32_t max_age = 100000;   // Maximum Age of Snapshot [us]
+    uint32_t timeout = 500000;   // Track Timeout [us] (Track is removed when no sensor sees it)
+    float gate = 500.0f;         // Association Gate [mm] (Distance of torso)
+    float confidence = 0.5f;     // Position Confidence (Joints below are used only as fallback)
+};
+
+// Skeleton Fusion (Snapshots of Multiple Sensors to Skeletons in World Coordinates)
+// Align clocks by minimum offset, interpolate at fused time, associate by previous track or nearest torso, and fuse by confidence.
+class SkeletonFusion
+{
+private:
+    // Snapshot of Sensor with Arrival Time [us]
+    struct Sample
+    {
+        SkeletonSnapshot snapshot;
+        uint64_t arrival = 0;
+    };
+
+    // Sensor
+    struct Sensor
+    {
+        // Queue from Sensor Thread
+        SpscQueue<Sample> queue;
+
+        // History (Owned by Fusion Thread, Ring of FUSION_HISTORY)
+        std::array<Sample, FUSION_HISTORY> history;
+        uint32_t history_head = 0;
+        uint32_t history_count = 0;
+        Sample pop; // Popped Sample
+
+        // Clock Offset (Owned by Fusion Thread)
+        std::array<int64_t, FUSION_CLOCK_WINDOW> offsets;
+        uint32_t offset_count = 0;
+        uint32_t offset_next = 0;
+        int64_t offset = 0;
+
+        // Extrinsics (and Rotation as Quaternion x, y, z, w)
+        Extrinsics extrinsics;
+        std::array<float, 4> rotation;
+
+        // Constructor
+        Sensor();
+    };
+
+    // User of Sensor at Fused Time (World Coordinates)
+    struct Observation
+    {
+        uint32_t sensor;
+        nite::UserId id;
+        std::array<float, 3> anchor;
+        std::array<float, JOINT_COUNT * 3> position;
+        std::array<float, JOINT_COUNT * 4> orientation;
+        std::array<float, JOINT_COUNT> position_confidence;
+        std::array<float, JOINT_COUNT> orientation_confidence;
+        int32_t track;
+    };
+
+    // Fused Track
+    struct Track
+    {
+        bool active = false;
+        uint16_t id = 0;
+        std::array<float, 3> anchor;
+        uint64_t seen = 0;                                    // Last Fused Time [us] with Observation
+        std::array<nite::UserId, FUSION_SENSOR_COUNT> users; // User Id of Each Sensor (0: None)
+        std::array<int32_t, FUSION_SENSOR_COUNT> observation; // Observation of Each Sensor at Fused Time (-1: None)
+    };
+
+    // Parameters
+    FusionParameters parameters;
+
+    // Sensors
+    std::vector<std::unique_ptr<Sensor>> sensors;
+
+    // Observations and Tracks (Owned by Fusion Thread)
+    std::array<Observation, FUSION_SENSOR_COUNT * USER_COUNT> observations;
+    uint32_t observation_count = 0;
+    std::array<Track, FUSION_TRACK_COUNT> tracks;
+    uint16_t next_id = 1;
+    int32_t frame_index = 0;
+
+public:
+    // Constructor (Extrinsics of each sensor)
+    explicit SkeletonFusion( const std::vector<Extrinsics>& extrinsics, const FusionParameters& parameters = FusionParameters() );
+
+    SkeletonFusion( const SkeletonFusion& ) = delete;
+    SkeletonFusion& operator=( const SkeletonFusion& ) = delete;
+
+    // Push Snapshot of Sensor (Sensor thread, arrival is now() at capture, return false if full)
+    bool push( const uint32_t sensor, const SkeletonSnapshot& snapshot, const uint64_t arrival );
+
+    // Fuse Skeletons at Time [us] of Common Clock (Fusion thread, return number of contributing sensors)
+    uint32_t fuse( const uint64_t time, SkeletonSnapshot& fused );
+
+    // Run Fusion at Fixed Output Rate (Fusion thread, until output returns false)
+    void run( const std::function<bool( const SkeletonSnapshot& )>& output );
+
+    // Retrieve Number of Sensors
+    uint32_t sensorCount() const;
+
+    // Retrieve Number of Snapshots Dropped by Full Queue of Sensor
+    uint64_t droppedSnapshots( const uint32_t sensor ) const;
+
+    // Retrieve Clock Offset of Sensor [us] (Common clock - sensor timestamp)
+    int64_t clockOffset( const uint32_t sensor ) const;
+
+    // Retrieve Common Clock [us] (Steady clock)
+    static uint64_t now();
+
+private:
+    // Drain Queue of Sensor into History
+    inline void drain( Sensor& sensor );
+
+    // Sample Users of Sensor at Time (Append Observations)
+    inline void sample( const uint32_t index, const uint64_t time );
+
+    // Append Observation of User (Interpolate between snapshots by weight of next, and transform to world)
+    inline void observe( const uint32_t index, const SkeletonSnapshot& previous, const uint32_t previous_user, const SkeletonSnapshot* next, const uint32_t next_user, const float weight );
+
+    // Associate Observations with Tracks
+    inline void associate( const uint64_t time );
+
+    // Fuse Joints of Tracks into Snapshot
+    inline void write( const uint64_t time, SkeletonSnapshot& fused );
+};
+
+#endif // __SKELETON_FUSION__
@@ -0,0 +1,57 @@
+#include "skeleton_snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Constructor
+SkeletonSnapshot::SkeletonSnapshot()
+    : storage( new float[SNAPSHOT_ARRAYS * SNAPSHOT_LANES + SNAPSHOT_ALIGNMENT / sizeof( float )] )
+{
+    ids.fill( 0 );
+    states.fill( nite::SkeletonState::SKELETON_NONE );
+    poses.fill( 0 );
+    users.fill( 0 );
+
+    assign();
+    std::fill( x, x + SNAPSHOT_ARRAYS * SNAPSHOT_LANES, 0.0f );
+}
+
+// Copy Constructor
+SkeletonSnapshot::SkeletonSnapshot( const SkeletonSnapshot& other )
+    : storage( new float[SNAPSHOT_ARRAYS * SNAPSHOT_LANES + SNAPSHOT_ALIGNMENT / sizeof( float )] )
+{
+    assign();
+    *this = other;
+}
+
+// Assignment
+SkeletonSnapshot& SkeletonSnapshot::operator=( const SkeletonSnapshot& other )
+{
+    if( this == &other ){
+        return *this;
+    }
+
+    frame_index = other.frame_index;
+    timestamp = other.timestamp;
+    count = other.count;
+    ids = other.ids;
+    states = other.states;
+    poses = other.poses;
+    users = other.users;
+    std::memcpy( x, other.x, SNAPSHOT_ARRAYS * SNAPSHOT_LANES * sizeof( float ) );
+    return *this;
+}
+
+// Point Arrays into Aligned Block of Storage
+void SkeletonSnapshot::assign()
+{
+    // Align Block to Cache Line
+    static_assert( SNAPSHOT_LANES * sizeof( float ) % SNAPSHOT_ALIGNMENT == 0, "snapshot arrays must be multiple of cache line" );
+    const uintptr_t address = reinterpret_cast<uintptr_t>( storage.get() );
+    float* block = storage.get() + ( ( SNAPSHOT_ALIGNMENT - address % SNAPSHOT_ALIGNMENT ) % SNAPSHOT_ALIGNMENT ) / sizeof( float );
+
+    float** arrays[SNAPSHOT_ARRAYS] = { &x, &y, &z, &orientation_x, &orientation_y, &orientation_z, &orientation_w, &position_confidence, &orientation_confidence };
+    for( uint32_t index = 0; index < SNAPSHOT_ARRAYS; index++ ){
+        *arrays[index] = block + index * SNAPSHOT_LANES;
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef __SKELETON_SNAPSHOT__
+#define __SKELETON_SNAPSHOT__
+
+#include <NiTE.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#define USER_COUNT 6
+#define JOINT_COUNT 15
+#define POSE_COUNT 2
+
+// Alignment of Snapshot Arrays [bytes] (Cache Line)
+#define SNAPSHOT_ALIGNMENT 64
+
+// Lanes of Snapshot Arrays (Users x Joints, Padded to Cache Line of Floats)
+#define SNAPSHOT_LANES ( ( USER_COUNT * JOINT_COUNT + 15 ) / 16 * 16 )
+
+// Joint Arrays of Snapshot
+#define SNAPSHOT_ARRAYS 9
+
+// Skeleton Snapshot (Structure of Arrays, lane = user * JOINT_COUNT + joint type, first count users are valid)
+// Lanes of invalid users keep finite values, so that SIMD kernels may run over whole cache lines.
+class SkeletonSnapshot
+{
+public:
+    // Frame
+    int32_t frame_index = 0;
+    uint64_t timestamp = 0; // Sensor Timestamp [us]
+
+    // Users (First count are valid)
+    uint32_t count = 0;
+    std::array<nite::UserId, USER_COUNT> ids;
+    std::array<nite::SkeletonState, USER_COUNT> states;
+    std::array<uint8_t, USER_COUNT> poses;  // bit (3 * type + 0): entered, (3 * type + 1): held, (3 * type + 2): exited
+    std::array<uint32_t, USER_COUNT> users; // Index of User in Frame
+
+    // Joints (SNAPSHOT_LANES each)
+    float* x; // Position [mm]
+    float* y;
+    float* z;
+    float* orientation_x; // Orientation (Quaternion)
+    float* orientation_y;
+    float* orientation_z;
+    float* orientation_w;
+    float* position_confidence;
+    float* orientation_confidence;
+
+private:
+    // Storage of Joint Arrays (Aligned block is inside)
+    std::unique_ptr<float[]> storage;
+
+public:
+    // Constructor
+    SkeletonSnapshot();
+
+    // Copy Constructor (Copy Arrays)
+    SkeletonSnapshot( const SkeletonSnapshot& other );
+
+    // Assignment (Copy Arrays, No Allocation)
+    SkeletonSnapshot& operator=( const SkeletonSnapshot& other );
+
+    // Retrieve Lane of Joint
+    static size_t lane( const uint32_t user, const uint32_t type )
+    {
+        return static_cast<size_t>( user ) * JOINT_COUNT + type;
+    }
+
+    // Retrieve Number of Valid Lanes
+    size_t lanes() const
+    {
+        return static_cast<size_t>( count ) * JOINT_COUNT;
+    }
+
+    // Clear Users (Keep Arrays)
+    void clear()
+    {
+        count = 0;
+    }
+
+private:
+    // Point Arrays into Aligned Block of Storage
+    void assign();
+};
+
+#endif // __SKELETON_SNAPSHOT__
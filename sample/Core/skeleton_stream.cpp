@@ -0,0 +1,523 @@
+#include "skeleton_stream.h"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+// Maximum Payload Size (255 users of float32 joints)
+static const size_t max_payload_size = 255 * ( 4 + SKELETON_JOINT_COUNT * 30 );
+
+// Parse Stream Encoding
+StreamEncoding parseStreamEncoding( const std::string& name )
+{
+    if( name == "float32" ){
+        return STREAM_ENCODING_FLOAT32;
+    }
+    if( name == "float16" ){
+        return STREAM_ENCODING_FLOAT16;
+    }
+    if( name == "quantized" ){
+        return STREAM_ENCODING_QUANTIZED;
+    }
+    if( name == "delta" ){
+        return STREAM_ENCODING_DELTA;
+    }
+
+    throw std::runtime_error( "failed unknown stream encoding " + name + " (float32, float16, quantized or delta)" );
+}
+
+// Retrieve Stream Encoding Name
+const char* streamEncodingName( const StreamEncoding encoding )
+{
+    switch( encoding ){
+        case STREAM_ENCODING_FLOAT32:
+            return "float32";
+        case STREAM_ENCODING_FLOAT16:
+            return "float16";
+        case STREAM_ENCODING_QUANTIZED:
+            return "quantized";
+        case STREAM_ENCODING_DELTA:
+            return "delta";
+        default:
+            return "unknown";
+    }
+}
+
+// Convert float32 to float16 (Round to Nearest Even)
+static uint16_t floatToHalf( const float value )
+{
+    uint32_t bits;
+    std::memcpy( &bits, &value, sizeof( bits ) );
+
+    const uint16_t sign = static_cast<uint16_t>( ( bits >> 16 ) & 0x8000 );
+    const int32_t exponent = static_cast<int32_t>( ( bits >> 23 ) & 0xFF ) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // Inf and NaN
+    if( ( ( bits >> 23 ) & 0xFF ) == 0xFF ){
+        return sign | 0x7C00 | ( mantissa ? 0x200 : 0 );
+    }
+
+    // Overflow
+    if( 31 <= exponent ){
+        return sign | 0x7C00;
+    }
+
+    // Subnormal and Underflow
+    if( exponent <= 0 ){
+        if( exponent < -10 ){
+            return sign;
+        }
+
+        mantissa |= 0x800000;
+        const uint32_t shift = static_cast<uint32_t>( 14 - exponent );
+        uint32_t half = mantissa >> shift;
+        const uint32_t rest = mantissa & ( ( 1u << shift ) - 1 );
+        const uint32_t halfway = 1u << ( shift - 1 );
+        if( halfway < rest || ( rest == halfway && ( half & 1 ) ) ){
+            half++;
+        }
+        return sign | static_cast<uint16_t>( half );
+    }
+
+    // Normal (Carry of Rounding may Overflow to Inf)
+    uint32_t half = ( static_cast<uint32_t>( exponent ) << 10 ) | ( mantissa >> 13 );
+    const uint32_t rest = mantissa & 0x1FFF;
+    if( 0x1000 < rest || ( rest == 0x1000 && ( half & 1 ) ) ){
+        half++;
+    }
+    return sign | static_cast<uint16_t>( half );
+}
+
+// Convert float16 to float32
+static float halfToFloat( const uint16_t half )
+{
+    const uint32_t sign = static_cast<uint32_t>( half & 0x8000 ) << 16;
+    int32_t exponent = ( half >> 10 ) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+
+    uint32_t bits;
+    if( exponent == 0x1F ){
+        // Inf and NaN
+        bits = sign | 0x7F800000 | ( mantissa << 13 );
+    }
+    else if( exponent == 0 && mantissa == 0 ){
+        // Zero
+        bits = sign;
+    }
+    else{
+        // Subnormal (Normalize)
+        if( exponent == 0 ){
+            exponent = 1;
+            while( !( mantissa & 0x400 ) ){
+                mantissa <<= 1;
+                exponent--;
+            }
+            mantissa &= 0x3FF;
+        }
+        bits = sign | ( static_cast<uint32_t>( exponent + 127 - 15 ) << 23 ) | ( mantissa << 13 );
+    }
+
+    float value;
+    std::memcpy( &value, &bits, sizeof( value ) );
+    return value;
+}
+
+// Quantize Value (Round and Clamp)
+static inline int32_t quantize( const float value, const float scale, const int32_t min, const int32_t max )
+{
+    const float scaled = std::round( value * scale );
+    if( !( static_cast<float>( min ) < scaled ) ){
+        return min;
+    }
+    if( !( scaled < static_cast<float>( max ) ) ){
+        return max;
+    }
+    return static_cast<int32_t>( scaled );
+}
+
+// Quantize Joints of User (position, orientation, confidence x 9 per joint)
+static void quantizeJoints( const SkeletonUser& user, QuantizedJoints& quantized )
+{
+    for( uint32_t type = 0; type < SKELETON_JOINT_COUNT; type++ ){
+        const SkeletonJoint& joint = user.joints[type];
+        int32_t* values = &quantized[type * 9];
+        for( uint32_t i = 0; i < 3; i++ ){
+            values[i] = quantize( joint.position[i], 1.0f, -32767, 32767 );
+        }
+        for( uint32_t i = 0; i < 4; i++ ){
+            values[3 + i] = quantize( joint.orientation[i], 32767.0f, -32767, 32767 );
+        }
+        values[7] = quantize( joint.position_confidence, 255.0f, 0, 255 );
+        values[8] = quantize( joint.orientation_confidence, 255.0f, 0, 255 );
+    }
+}
+
+// Dequantize Joints of User
+static void dequantizeJoints( const QuantizedJoints& quantized, SkeletonUser& user )
+{
+    for( uint32_t type = 0; type < SKELETON_JOINT_COUNT; type++ ){
+        SkeletonJoint& joint = user.joints[type];
+        const int32_t* values = &quantized[type * 9];
+        for( uint32_t i = 0; i < 3; i++ ){
+            joint.position[i] = static_cast<float>( values[i] );
+        }
+        for( uint32_t i = 0; i < 4; i++ ){
+            joint.orientation[i] = static_cast<float>( values[3 + i] ) / 32767.0f;
+        }
+        joint.position_confidence = static_cast<float>( values[7] ) / 255.0f;
+        joint.orientation_confidence = static_cast<float>( values[8] ) / 255.0f;
+    }
+}
+
+// Put Unsigned Integer (Little Endian)
+template<typename Type>
+static inline void put( std::string& buffer, const Type value )
+{
+    for( uint32_t i = 0; i < sizeof( Type ); i++ ){
+        buffer.push_back( static_cast<char>( ( value >> ( i * 8 ) ) & 0xFF ) );
+    }
+}
+
+// Put float32
+static inline void putFloat( std::string& buffer, const float value )
+{
+    uint32_t bits;
+    std::memcpy( &bits, &value, sizeof( bits ) );
+    put<uint32_t>( buffer, bits );
+}
+
+// Put Zigzag Varint
+static inline void putVarint( std::string& buffer, const int32_t value )
+{
+    uint32_t zigzag = ( static_cast<uint32_t>( value ) << 1 ) ^ static_cast<uint32_t>( value >> 31 );
+    while( 0x80 <= zigzag ){
+        buffer.push_back( static_cast<char>( ( zigzag & 0x7F ) | 0x80 ) );
+        zigzag >>= 7;
+    }
+    buffer.push_back( static_cast<char>( zigzag ) );
+}
+
+// Get Unsigned Integer (Little Endian)
+template<typename Type>
+static inline Type get( const uint8_t*& data, const uint8_t* end )
+{
+    if( static_cast<size_t>( end - data ) < sizeof( Type ) ){
+        throw std::runtime_error( "failed truncated skeleton stream record" );
+    }
+
+    Type value = 0;
+    for( uint32_t i = 0; i < sizeof( Type ); i++ ){
+        value |= static_cast<Type>( static_cast<Type>( data[i] ) << ( i * 8 ) );
+    }
+    data += sizeof( Type );
+    return value;
+}
+
+// Get float32
+static inline float getFloat( const uint8_t*& data, const uint8_t* end )
+{
+    const uint32_t bits = get<uint32_t>( data, end );
+    float value;
+    std::memcpy( &value, &bits, sizeof( value ) );
+    return value;
+}
+
+// Get Zigzag Varint
+static inline int32_t getVarint( const uint8_t*& data, const uint8_t* end )
+{
+    uint32_t zigzag = 0;
+    for( uint32_t shift = 0; shift < 35; shift += 7 ){
+        const uint8_t byte = get<uint8_t>( data, end );
+        zigzag |= static_cast<uint32_t>( byte & 0x7F ) << shift;
+        if( !( byte & 0x80 ) ){
+            return static_cast<int32_t>( zigzag >> 1 ) ^ -static_cast<int32_t>( zigzag & 1 );
+        }
+    }
+
+    throw std::runtime_error( "failed invalid skeleton stream varint" );
+}
+
+// Record Header
+struct Header
+{
+    StreamEncoding encoding;
+    uint8_t flags;
+    uint8_t user_count;
+    uint32_t frame_index;
+    uint32_t payload_size;
+    uint64_t timestamp;
+};
+
+// Parse Header (data must have SKELETON_STREAM_HEADER_SIZE bytes)
+static Header parseHeader( const uint8_t* data )
+{
+    const uint8_t* end = data + SKELETON_STREAM_HEADER_SIZE;
+    if( get<uint32_t>( data, end ) != SKELETON_STREAM_MAGIC ){
+        throw std::runtime_error( "failed invalid skeleton stream magic" );
+    }
+
+    const uint8_t version = get<uint8_t>( data, end );
+    if( version != SKELETON_STREAM_VERSION ){
+        throw std::runtime_error( "failed unsupported skeleton stream version " + std::to_string( version ) );
+    }
+
+    const uint8_t encoding = get<uint8_t>( data, end );
+    if( STREAM_ENCODING_DELTA < encoding ){
+        throw std::runtime_error( "failed unknown skeleton stream encoding " + std::to_string( encoding ) );
+    }
+
+    Header header;
+    header.encoding = static_cast<StreamEncoding>( encoding );
+    header.flags = get<uint8_t>( data, end );
+    header.user_count = get<uint8_t>( data, end );
+    header.frame_index = get<uint32_t>( data, end );
+    header.payload_size = get<uint32_t>( data, end );
+    header.timestamp = get<uint64_t>( data, end );
+    if( max_payload_size < header.payload_size ){
+        throw std::runtime_error( "failed invalid skeleton stream payload size " + std::to_string( header.payload_size ) );
+    }
+
+    return header;
+}
+
+// Constructor
+SkeletonStreamWriter::SkeletonStreamWriter( const StreamEncoding encoding, const uint32_t keyframe_interval )
+    : encoding( encoding ),
+      keyframe_interval( keyframe_interval )
+{
+}
+
+// Encode Record
+void SkeletonStreamWriter::encode( const SkeletonRecord& record, std::string& buffer )
+{
+    if( 255 < record.users.size() ){
+        throw std::runtime_error( "failed too many users in skeleton record" );
+    }
+
+    // Key Record (Decodable without Previous Records)
+    const bool key = ( encoding != STREAM_ENCODING_DELTA ) || count == 0 || ( keyframe_interval && count % keyframe_interval == 0 );
+    if( key ){
+        previous.clear();
+    }
+
+    // Header
+    const size_t begin = buffer.size();
+    put<uint32_t>( buffer, SKELETON_STREAM_MAGIC );
+    put<uint8_t>( buffer, SKELETON_STREAM_VERSION );
+    put<uint8_t>( buffer, static_cast<uint8_t>( encoding ) );
+    put<uint8_t>( buffer, key ? SKELETON_STREAM_KEY : 0 );
+    put<uint8_t>( buffer, static_cast<uint8_t>( record.users.size() ) );
+    put<uint32_t>( buffer, record.frame_index );
+    put<uint32_t>( buffer, 0 );
+    put<uint64_t>( buffer, record.timestamp );
+
+    // Users
+    QuantizedJoints quantized;
+    for( const SkeletonUser& user : record.users ){
+        put<uint16_t>( buffer, user.id );
+        put<uint8_t>( buffer, user.state );
+
+        switch( encoding ){
+            case STREAM_ENCODING_FLOAT32:
+                put<uint8_t>( buffer, user.poses & 0x3F );
+                for( const SkeletonJoint& joint : user.joints ){
+                    for( const float value : joint.position ){
+                        putFloat( buffer, value );
+                    }
+                    for( const float value : joint.orientation ){
+                        putFloat( buffer, value );
+                    }
+                    put<uint8_t>( buffer, static_cast<uint8_t>( quantize( joint.position_confidence, 255.0f, 0, 255 ) ) );
+                    put<uint8_t>( buffer, static_cast<uint8_t>( quantize( joint.orientation_confidence, 255.0f, 0, 255 ) ) );
+                }
+                break;
+            case STREAM_ENCODING_FLOAT16:
+                put<uint8_t>( buffer, user.poses & 0x3F );
+                for( const SkeletonJoint& joint : user.joints ){
+                    for( const float value : joint.position ){
+                        put<uint16_t>( buffer, floatToHalf( value ) );
+                    }
+                    for( const float value : joint.orientation ){
+                        put<uint16_t>( buffer, floatToHalf( value ) );
+                    }
+                    put<uint8_t>( buffer, static_cast<uint8_t>( quantize( joint.position_confidence, 255.0f, 0, 255 ) ) );
+                    put<uint8_t>( buffer, static_cast<uint8_t>( quantize( joint.orientation_confidence, 255.0f, 0, 255 ) ) );
+                }
+                break;
+            case STREAM_ENCODING_QUANTIZED:
+                put<uint8_t>( buffer, user.poses & 0x3F );
+                quantizeJoints( user, quantized );
+                for( uint32_t type = 0; type < SKELETON_JOINT_COUNT; type++ ){
+                    const int32_t* values = &quantized[type * 9];
+                    for( uint32_t i = 0; i < 7; i++ ){
+                        put<uint16_t>( buffer, static_cast<uint16_t>( values[i] ) );
+                    }
+                    put<uint8_t>( buffer, static_cast<uint8_t>( values[7] ) );
+                    put<uint8_t>( buffer, static_cast<uint8_t>( values[8] ) );
+                }
+                break;
+            case STREAM_ENCODING_DELTA:
+            {
+                // Difference from Previous Record of Same User (Absolute if there is no reference)
+                quantizeJoints( user, quantized );
+                const auto reference = previous.find( user.id );
+                const bool delta = reference != previous.end();
+                put<uint8_t>( buffer, ( user.poses & 0x3F ) | ( delta ? SKELETON_STREAM_DELTA : 0 ) );
+                for( uint32_t i = 0; i < quantized.size(); i++ ){
+                    putVarint( buffer, quantized[i] - ( delta ? reference->second[i] : 0 ) );
+                }
+                previous[user.id] = quantized;
+                break;
+            }
+            default:
+                throw std::runtime_error( "failed unknown stream encoding" );
+        }
+    }
+
+    // Payload Size
+    const uint32_t payload_size = static_cast<uint32_t>( buffer.size() - begin - SKELETON_STREAM_HEADER_SIZE );
+    for( uint32_t i = 0; i < 4; i++ ){
+        buffer[begin + 12 + i] = static_cast<char>( ( payload_size >> ( i * 8 ) ) & 0xFF );
+    }
+
+    count++;
+}
+
+// Write Record to Stream
+void SkeletonStreamWriter::write( const SkeletonRecord& record, std::ostream& stream )
+{
+    buffer.clear();
+    encode( record, buffer );
+    stream.write( buffer.data(), static_cast<std::streamsize>( buffer.size() ) );
+}
+
+// Force Next Record to be Key Record
+void SkeletonStreamWriter::reset()
+{
+    count = 0;
+    previous.clear();
+}
+
+// Decode Record
+size_t SkeletonStreamReader::decode( const char* data, const size_t size, SkeletonRecord& record )
+{
+    // Header
+    if( size < SKELETON_STREAM_HEADER_SIZE ){
+        return 0;
+    }
+
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>( data );
+    const Header header = parseHeader( begin );
+    const size_t record_size = SKELETON_STREAM_HEADER_SIZE + header.payload_size;
+    if( size < record_size ){
+        return 0;
+    }
+
+    if( header.flags & SKELETON_STREAM_KEY ){
+        previous.clear();
+    }
+
+    record.frame_index = header.frame_index;
+    record.timestamp = header.timestamp;
+    record.users.resize( header.user_count );
+
+    // Users
+    const uint8_t* cursor = begin + SKELETON_STREAM_HEADER_SIZE;
+    const uint8_t* end = begin + record_size;
+    QuantizedJoints quantized;
+    for( SkeletonUser& user : record.users ){
+        user.id = get<uint16_t>( cursor, end );
+        user.state = get<uint8_t>( cursor, end );
+        const uint8_t flags = get<uint8_t>( cursor, end );
+        user.poses = flags & 0x3F;
+
+        switch( header.encoding ){
+            case STREAM_ENCODING_FLOAT32:
+                for( SkeletonJoint& joint : user.joints ){
+                    for( float& value : joint.position ){
+                        value = getFloat( cursor, end );
+                    }
+                    for( float& value : joint.orientation ){
+                        value = getFloat( cursor, end );
+                    }
+                    joint.position_confidence = get<uint8_t>( cursor, end ) / 255.0f;
+                    joint.orientation_confidence = get<uint8_t>( cursor, end ) / 255.0f;
+                }
+                break;
+            case STREAM_ENCODING_FLOAT16:
+                for( SkeletonJoint& joint : user.joints ){
+                    for( float& value : joint.position ){
+                        value = halfToFloat( get<uint16_t>( cursor, end ) );
+                    }
+                    for( float& value : joint.orientation ){
+                        value = halfToFloat( get<uint16_t>( cursor, end ) );
+                    }
+                    joint.position_confidence = get<uint8_t>( cursor, end ) / 255.0f;
+                    joint.orientation_confidence = get<uint8_t>( cursor, end ) / 255.0f;
+                }
+                break;
+            case STREAM_ENCODING_QUANTIZED:
+                for( uint32_t type = 0; type < SKELETON_JOINT_COUNT; type++ ){
+                    int32_t* values = &quantized[type * 9];
+                    for( uint32_t i = 0; i < 7; i++ ){
+                        values[i] = static_cast<int16_t>( get<uint16_t>( cursor, end ) );
+                    }
+                    values[7] = get<uint8_t>( cursor, end );
+                    values[8] = get<uint8_t>( cursor, end );
+                }
+                dequantizeJoints( quantized, user );
+                break;
+            case STREAM_ENCODING_DELTA:
+            {
+                // Difference from Previous Record of Same User
+                const bool delta = ( flags & SKELETON_STREAM_DELTA ) != 0;
+                const auto reference = previous.find( user.id );
+                if( delta && reference == previous.end() ){
+                    throw std::runtime_error( "failed delta record without reference (decode from a key record)" );
+                }
+                for( uint32_t i = 0; i < quantized.size(); i++ ){
+                    quantized[i] = getVarint( cursor, end ) + ( delta ? reference->second[i] : 0 );
+                }
+                dequantizeJoints( quantized, user );
+                previous[user.id] = quantized;
+                break;
+            }
+            default:
+                throw std::runtime_error( "failed unknown stream encoding" );
+        }
+    }
+
+    if( cursor != end ){
+        throw std::runtime_error( "failed invalid skeleton stream payload size " + std::to_string( header.payload_size ) );
+    }
+
+    return record_size;
+}
+
+// Read Record from Stream
+bool SkeletonStreamReader::read( std::istream& stream, SkeletonRecord& record )
+{
+    // Header
+    buffer.resize( SKELETON_STREAM_HEADER_SIZE );
+    stream.read( &buffer[0], SKELETON_STREAM_HEADER_SIZE );
+    if( stream.gcount() == 0 ){
+        return false;
+    }
+    if( stream.gcount() != SKELETON_STREAM_HEADER_SIZE ){
+        throw std::runtime_error( "failed truncated skeleton stream header" );
+    }
+
+    // Payload
+    const Header header = parseHeader( reinterpret_cast<const uint8_t*>( buffer.data() ) );
+    buffer.resize( SKELETON_STREAM_HEADER_SIZE + header.payload_size );
+    if( header.payload_size ){
+        stream.read( &buffer[SKELETON_STREAM_HEADER_SIZE], header.payload_size );
+        if( stream.gcount() != static_cast<std::streamsize>( header.payload_size ) ){
+            throw std::runtime_error( "failed truncated skeleton stream record" );
+        }
+    }
+
+    decode( buffer.data(), buffer.size(), record );
+    return true;
+}
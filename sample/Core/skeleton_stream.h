@@ -0,0 +1,127 @@
+#ifndef __SKELETON_STREAM__
+#define __SKELETON_STREAM__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Skeleton Stream Wire Format (Standalone, no OpenNI2/NiTE2/OpenCV)
+// Record = Header (24 bytes) + Users (Little Endian)
+//   Header : magic "NSKL" (4), version (1), encoding (1), flags (1), user count (1),
+//            frame index (4), payload size (4, size of users), timestamp [us] (8)
+//   User   : id (2), skeleton state (1), flags (1), joints (SKELETON_JOINT_COUNT)
+//            flags bit 0-5: pose 0/1 entered, held, exited, bit 7: joints are delta coded
+//   Joint  : position x, y, z [mm], orientation x, y, z, w, position confidence, orientation confidence
+//            float32   : 7 x float32, 2 x uint8 (30 bytes)
+//            float16   : 7 x float16, 2 x uint8 (16 bytes, position precision is 2 mm at 2-4 m)
+//            quantized : 3 x int16 [mm], 4 x int16 [1/32767], 2 x uint8 (16 bytes)
+//            delta     : quantized values as zigzag varint difference from previous record of the same user
+//                        (absolute in key records, 9-25 bytes, 9 bytes if the joint does not move)
+//   Confidence is quantized to uint8 [1/255] in all encodings.
+#define SKELETON_STREAM_MAGIC 0x4C4B534E // "NSKL"
+#define SKELETON_STREAM_VERSION 1
+#define SKELETON_STREAM_HEADER_SIZE 24
+#define SKELETON_STREAM_KEY 0x01
+#define SKELETON_STREAM_DELTA 0x80
+#define SKELETON_JOINT_COUNT 15
+#define SKELETON_POSE_COUNT 2
+
+// Stream Encoding
+enum StreamEncoding
+{
+    STREAM_ENCODING_FLOAT32,   // Packed float32
+    STREAM_ENCODING_FLOAT16,   // Packed float16
+    STREAM_ENCODING_QUANTIZED, // Packed int16 (1 mm)
+    STREAM_ENCODING_DELTA      // Quantized and delta coded varint
+};
+
+// Parse Stream Encoding ("float32", "float16", "quantized" or "delta")
+StreamEncoding parseStreamEncoding( const std::string& name );
+
+// Retrieve Stream Encoding Name
+const char* streamEncodingName( const StreamEncoding encoding );
+
+// Skeleton Joint
+struct SkeletonJoint
+{
+    std::array<float, 3> position = { { 0.0f, 0.0f, 0.0f } };          // x, y, z [mm]
+    std::array<float, 4> orientation = { { 0.0f, 0.0f, 0.0f, 1.0f } }; // x, y, z, w
+    float position_confidence = 0.0f;
+    float orientation_confidence = 0.0f;
+};
+
+// Skeleton User
+struct SkeletonUser
+{
+    uint16_t id = 0;
+    uint8_t state = 0;
+    uint8_t poses = 0; // bit (3 * type + 0): entered, (3 * type + 1): held, (3 * type + 2): exited
+    std::array<SkeletonJoint, SKELETON_JOINT_COUNT> joints;
+};
+
+// Skeleton Record
+struct SkeletonRecord
+{
+    uint32_t frame_index = 0;
+    uint64_t timestamp = 0; // Sensor Timestamp [us]
+    std::vector<SkeletonUser> users;
+};
+
+// Quantized Joints of User (Delta Reference)
+typedef std::array<int32_t, SKELETON_JOINT_COUNT * 9> QuantizedJoints;
+
+// Skeleton Stream Writer
+class SkeletonStreamWriter
+{
+private:
+    // Encoding
+    StreamEncoding encoding;
+    uint32_t keyframe_interval;
+
+    // Number of Encoded Records
+    uint64_t count = 0;
+
+    // Delta Reference
+    std::unordered_map<uint16_t, QuantizedJoints> previous;
+
+    // Record Buffer
+    std::string buffer;
+
+public:
+    // Constructor (Delta encoding writes a key record every keyframe_interval records, 0: first record only)
+    explicit SkeletonStreamWriter( const StreamEncoding encoding = STREAM_ENCODING_QUANTIZED, const uint32_t keyframe_interval = 30 );
+
+    // Encode Record (Append to Buffer)
+    void encode( const SkeletonRecord& record, std::string& buffer );
+
+    // Write Record to Stream
+    void write( const SkeletonRecord& record, std::ostream& stream );
+
+    // Force Next Record to be Key Record (e.g. a new reader is connected)
+    void reset();
+};
+
+// Skeleton Stream Reader
+class SkeletonStreamReader
+{
+private:
+    // Delta Reference
+    std::unordered_map<uint16_t, QuantizedJoints> previous;
+
+    // Record Buffer
+    std::string buffer;
+
+public:
+    // Decode Record (Return Consumed Bytes, 0 if data doesn't contain a whole record yet)
+    size_t decode( const char* data, const size_t size, SkeletonRecord& record );
+
+    // Read Record from Stream (Return false at end of stream)
+    bool read( std::istream& stream, SkeletonRecord& record );
+};
+
+#endif // __SKELETON_STREAM__
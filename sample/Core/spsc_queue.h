@@ -0,0 +1,113 @@
+#ifndef __SPSC_QUEUE__
+#define __SPSC_QUEUE__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Cache Line Size [bytes] (Head and tail are kept on separate lines)
+#define SPSC_CACHE_LINE 64
+
+// Lock-Free Single-Producer/Single-Consumer Queue (Elements are copied by assignment, capacity is power of two)
+template<typename T>
+class SpscQueue
+{
+private:
+    // Buffer
+    std::vector<T> buffer;
+    size_t mask;
+
+    // Positions (Written by Producer/Consumer only, Padded to separate cache lines)
+    char padding0[SPSC_CACHE_LINE];
+    std::atomic<size_t> tail; // Next Position to Push (Producer)
+    std::atomic<uint64_t> dropped;
+    char padding1[SPSC_CACHE_LINE];
+    std::atomic<size_t> head; // Next Position to Pop (Consumer)
+    char padding2[SPSC_CACHE_LINE];
+
+public:
+    // Constructor
+    explicit SpscQueue( const size_t capacity )
+        : tail( 0 ),
+          dropped( 0 ),
+          head( 0 )
+    {
+        if( !capacity ){
+            throw std::runtime_error( "failed invalid capacity of queue" );
+        }
+
+        size_t size = 1;
+        while( size < capacity ){
+            size <<= 1;
+        }
+        buffer.resize( size );
+        mask = size - 1;
+    }
+
+    SpscQueue( const SpscQueue& ) = delete;
+    SpscQueue& operator=( const SpscQueue& ) = delete;
+
+    // Push Element (Producer, return false and drop element if full)
+    bool push( const T& element )
+    {
+        const size_t position = tail.load( std::memory_order_relaxed );
+        if( position - head.load( std::memory_order_acquire ) == buffer.size() ){
+            dropped.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+        }
+
+        buffer[position & mask] = element;
+        tail.store( position + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Push Element Written in Place by function( T& ) (Producer, return false if full)
+    template<typename Function>
+    bool emplace( Function function )
+    {
+        const size_t position = tail.load( std::memory_order_relaxed );
+        if( position - head.load( std::memory_order_acquire ) == buffer.size() ){
+            dropped.fetch_add( 1, std::memory_order_relaxed );
+            return false;
+        }
+
+        function( buffer[position & mask] );
+        tail.store( position + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Pop Element (Consumer, return false if empty)
+    bool pop( T& element )
+    {
+        const size_t position = head.load( std::memory_order_relaxed );
+        if( position == tail.load( std::memory_order_acquire ) ){
+            return false;
+        }
+
+        element = buffer[position & mask];
+        head.store( position + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Retrieve Number of Elements (Approximate while the other side runs)
+    size_t size() const
+    {
+        return tail.load( std::memory_order_acquire ) - head.load( std::memory_order_acquire );
+    }
+
+    // Retrieve Capacity
+    size_t capacity() const
+    {
+        return buffer.size();
+    }
+
+    // Retrieve Number of Dropped Elements
+    uint64_t drops() const
+    {
+        return dropped.load( std::memory_order_relaxed );
+    }
+};
+
+#endif // __SPSC_QUEUE__
@@ -0,0 +1,175 @@
+#include "task_pool.h"
+
+#include <algorithm>
+
+// Maximum Tiles per Thread (Balance Load without Too Small Tiles)
+#define TASK_POOL_TILES_PER_THREAD 4
+
+// Constructor
+TaskPool::TaskPool( const uint32_t threads )
+    : next_queue( 0 ),
+      queued( 0 )
+{
+    for( uint32_t i = 0; i < threads; i++ ){
+        queues.emplace_back( new Queue() );
+    }
+
+    for( uint32_t i = 0; i < threads; i++ ){
+        workers.emplace_back( &TaskPool::work, this, i );
+    }
+}
+
+// Destructor
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    condition.notify_all();
+
+    for( std::thread& worker : workers ){
+        worker.join();
+    }
+}
+
+// Retrieve Number of Worker Threads
+uint32_t TaskPool::threads() const
+{
+    return static_cast<uint32_t>( workers.size() );
+}
+
+// Parallel For
+void TaskPool::parallelFor( const size_t count, const size_t grain, const RangeFunction& function )
+{
+    if( !count ){
+        return;
+    }
+
+    // Run Inline (No Workers or Single Tile)
+    const size_t minimum = std::max<size_t>( grain, 1 );
+    if( workers.empty() || count <= minimum ){
+        function( 0, count );
+        return;
+    }
+
+    // Split Range into Tiles
+    const size_t limit = ( workers.size() + 1 ) * TASK_POOL_TILES_PER_THREAD;
+    const size_t split = std::min( ( count + minimum - 1 ) / minimum, limit );
+    const size_t size = ( count + split - 1 ) / split;
+    const size_t tiles = ( count + size - 1 ) / size;
+
+    Job job;
+    job.function = &function;
+    job.remaining = tiles;
+
+    // Queue Tiles except First (Round-Robin)
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        queued += tiles - 1;
+    }
+    for( size_t tile = 1; tile < tiles; tile++ ){
+        Queue& queue = *queues[next_queue++ % queues.size()];
+        std::lock_guard<std::mutex> lock( queue.mutex );
+        queue.tasks.push_back( Task{ &job, tile * size, std::min( count, ( tile + 1 ) * size ) } );
+    }
+    condition.notify_all();
+
+    // Run First Tile and Help until All Tiles are Taken
+    run( Task{ &job, 0, size } );
+
+    Task task;
+    while( job.remaining.load() && pop( queues.size(), task ) ){
+        run( task );
+    }
+
+    // Wait Tiles Running on Workers
+    {
+        std::unique_lock<std::mutex> lock( job.mutex );
+        job.condition.wait( lock, [&job]{ return job.remaining.load() == 0; } );
+    }
+
+    // Rethrow Exception of Tile
+    if( job.exception ){
+        std::rethrow_exception( job.exception );
+    }
+}
+
+// Worker Thread
+void TaskPool::work( const size_t index )
+{
+    while( true ){
+        // Run Task
+        Task task;
+        if( pop( index, task ) ){
+            run( task );
+            continue;
+        }
+
+        // Sleep until Task is Queued
+        std::unique_lock<std::mutex> lock( mutex );
+        condition.wait( lock, [this]{ return stopping || queued.load() > 0; } );
+        if( stopping && queued.load() == 0 ){
+            return;
+        }
+    }
+}
+
+// Pop Task
+bool TaskPool::pop( const size_t index, Task& task )
+{
+    // Own Queue (Back, Worker Only)
+    if( index < queues.size() ){
+        Queue& queue = *queues[index];
+        std::lock_guard<std::mutex> lock( queue.mutex );
+        if( !queue.tasks.empty() ){
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    // Steal from Other Queues (Front)
+    for( size_t i = 1; i <= queues.size(); i++ ){
+        Queue& queue = *queues[( index + i ) % queues.size()];
+        std::lock_guard<std::mutex> lock( queue.mutex );
+        if( !queue.tasks.empty() ){
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Run Task
+void TaskPool::run( const Task& task )
+{
+    Job& job = *task.job;
+
+    std::exception_ptr exception;
+    try{
+        ( *job.function )( task.begin, task.end );
+    } catch( ... ){
+        exception = std::current_exception();
+    }
+
+    // Complete Tile (Under lock, job is destroyed by calling thread)
+    std::lock_guard<std::mutex> lock( job.mutex );
+    if( exception && !job.exception ){
+        job.exception = exception;
+    }
+    if( --job.remaining == 0 ){
+        job.condition.notify_all();
+    }
+}
+
+// Retrieve Shared Task Pool
+TaskPool& taskPool()
+{
+    static TaskPool pool( std::max<uint32_t>( std::thread::hardware_concurrency(), 1 ) - 1 );
+    return pool;
+}
@@ -0,0 +1,96 @@
+#ifndef __TASK_POOL__
+#define __TASK_POOL__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent Work-Stealing Task Pool (Calling thread runs tiles too, single tile runs inline)
+class TaskPool
+{
+private:
+    // Range Function (Tile [begin, end))
+    typedef std::function<void( size_t, size_t )> RangeFunction;
+
+    // Job (One parallelFor Call, Owned by Calling Thread)
+    struct Job
+    {
+        const RangeFunction* function;
+        std::atomic<size_t> remaining;
+        std::exception_ptr exception;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    // Task (Tile of Job)
+    struct Task
+    {
+        Job* job;
+        size_t begin;
+        size_t end;
+    };
+
+    // Task Queue of Worker
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Workers
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::atomic<size_t> next_queue;
+
+    // Sleep/Wake
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::atomic<size_t> queued;
+    bool stopping = false;
+
+public:
+    // Constructor (threads 0: run every range inline on the calling thread)
+    explicit TaskPool( const uint32_t threads );
+
+    // Destructor (Join Workers)
+    ~TaskPool();
+
+    TaskPool( const TaskPool& ) = delete;
+    TaskPool& operator=( const TaskPool& ) = delete;
+
+    // Retrieve Number of Worker Threads
+    uint32_t threads() const;
+
+    // Run function( begin, end ) over [0, count) in tiles of grain (or more) elements (Rethrow first exception)
+    void parallelFor( const size_t count, const size_t grain, const RangeFunction& function );
+
+    // Run function( begin, end ) over [0, count) by Reference (No allocation)
+    template<typename Function>
+    void parallelFor( const size_t count, const size_t grain, const Function& function )
+    {
+        parallelFor( count, grain, RangeFunction( std::cref( function ) ) );
+    }
+
+private:
+    // Worker Thread
+    void work( const size_t index );
+
+    // Pop Own Task (Back) or Steal Task of Other Worker (Front)
+    bool pop( const size_t index, Task& task );
+
+    // Run Task
+    void run( const Task& task );
+};
+
+// Retrieve Shared Task Pool (Hardware concurrency - 1 workers, created at first use)
+TaskPool& taskPool();
+
+#endif // __TASK_POOL__
@@ -0,0 +1,244 @@
+#include "telemetry.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Histogram, Counter and Queue Names
+static const std::array<const char*, TELEMETRY_HISTOGRAM_COUNT> histogram_names = { { "read", "update", "draw", "show", "write", "sensor_latency", "output_latency", "display_age" } };
+static const std::array<const char*, TELEMETRY_COUNTER_COUNT> counter_names = { { "frames", "skipped_frames", "gaps" } };
+static const std::array<const char*, TELEMETRY_QUEUE_COUNT> queue_names = { { "frame", "image" } };
+
+// Retrieve Histogram Name
+const char* telemetryHistogramName( const TelemetryHistogram histogram )
+{
+    return histogram_names[histogram];
+}
+
+// Retrieve Counter Name
+const char* telemetryCounterName( const TelemetryCounter counter )
+{
+    return counter_names[counter];
+}
+
+// Retrieve Queue Name
+const char* telemetryQueueName( const TelemetryQueue queue )
+{
+    return queue_names[queue];
+}
+
+// Constructor
+LatencyHistogram::LatencyHistogram()
+    : count( 0 ),
+      sum( 0 ),
+      maximum( 0 )
+{
+    for( std::atomic<uint64_t>& bucket : buckets ){
+        bucket.store( 0, std::memory_order_relaxed );
+    }
+}
+
+// Summarize Histogram
+HistogramSummary LatencyHistogram::summarize( const bool reset )
+{
+    // Read Buckets
+    std::array<uint64_t, HISTOGRAM_BUCKETS> counts;
+    uint64_t total = 0;
+    for( uint32_t i = 0; i < HISTOGRAM_BUCKETS; i++ ){
+        counts[i] = reset ? buckets[i].exchange( 0, std::memory_order_relaxed ) : buckets[i].load( std::memory_order_relaxed );
+        total += counts[i];
+    }
+    const uint64_t samples = reset ? count.exchange( 0, std::memory_order_relaxed ) : count.load( std::memory_order_relaxed );
+    const uint64_t values = reset ? sum.exchange( 0, std::memory_order_relaxed ) : sum.load( std::memory_order_relaxed );
+    const uint64_t largest = reset ? maximum.exchange( 0, std::memory_order_relaxed ) : maximum.load( std::memory_order_relaxed );
+
+    HistogramSummary summary;
+    if( !total ){
+        return summary;
+    }
+
+    summary.count = total;
+    summary.mean = samples ? static_cast<double>( values ) / static_cast<double>( samples ) : 0.0;
+    summary.max = largest;
+
+    // Retrieve Percentiles (Upper bound of bucket, not above maximum)
+    const std::array<double, 4> ranks = { { 0.5, 0.9, 0.99, 0.999 } };
+    std::array<uint64_t*, 4> percentiles = { { &summary.p50, &summary.p90, &summary.p99, &summary.p999 } };
+    uint64_t accumulated = 0;
+    uint32_t rank = 0;
+    for( uint32_t i = 0; i < HISTOGRAM_BUCKETS && rank < ranks.size(); i++ ){
+        accumulated += counts[i];
+        while( rank < ranks.size() && static_cast<double>( accumulated ) >= ranks[rank] * static_cast<double>( total ) ){
+            *percentiles[rank] = std::min( upper( i ), largest );
+            rank++;
+        }
+    }
+
+    return summary;
+}
+
+// Constructor
+Telemetry::Telemetry()
+    : previous( std::chrono::steady_clock::now() )
+{
+    for( std::atomic<uint64_t>& counter : counters ){
+        counter.store( 0, std::memory_order_relaxed );
+    }
+    for( uint32_t i = 0; i < TELEMETRY_QUEUE_COUNT; i++ ){
+        depths[i].store( 0, std::memory_order_relaxed );
+        max_depths[i].store( 0, std::memory_order_relaxed );
+        drops[i].store( 0, std::memory_order_relaxed );
+    }
+}
+
+// Record Frame
+void Telemetry::recordFrame( const uint32_t sensor, const int32_t frame_index, const uint64_t sensor_timestamp, const std::chrono::steady_clock::time_point& output )
+{
+    count( TELEMETRY_FRAMES );
+    if( sensor >= TELEMETRY_SENSOR_COUNT ){
+        return;
+    }
+    Sensor& state = sensors[sensor];
+
+    // Frame Index Gaps (Restart of source is not a gap)
+    if( state.valid && state.frame_index < frame_index && frame_index - state.frame_index > 1 ){
+        count( TELEMETRY_GAPS );
+        count( TELEMETRY_SKIPPED_FRAMES, static_cast<uint64_t>( frame_index - state.frame_index - 1 ) );
+    }
+    state.valid = true;
+    state.frame_index = frame_index;
+
+    // Sensor Latency (Offset beyond minimum offset over window)
+    if( !sensor_timestamp ){
+        return;
+    }
+    const int64_t time = std::chrono::duration_cast<std::chrono::microseconds>( output.time_since_epoch() ).count();
+    const int64_t offset = time - static_cast<int64_t>( sensor_timestamp );
+    state.offsets[state.offset_next] = offset;
+    state.offset_next = ( state.offset_next + 1 ) % TELEMETRY_CLOCK_WINDOW;
+    state.offset_count = std::min<uint32_t>( state.offset_count + 1, TELEMETRY_CLOCK_WINDOW );
+    const int64_t minimum = *std::min_element( state.offsets.begin(), state.offsets.begin() + state.offset_count );
+    histograms[TELEMETRY_SENSOR_LATENCY].record( static_cast<uint64_t>( offset - minimum ) );
+}
+
+// Take Snapshot
+void Telemetry::snapshot( TelemetrySnapshot& snapshot, const bool reset )
+{
+    std::lock_guard<std::mutex> lock( snapshot_mutex );
+
+    // Elapsed Time since Previous Snapshot
+    const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+    snapshot.elapsed = std::chrono::duration<double>( time - previous ).count();
+    if( reset ){
+        previous = time;
+    }
+
+    // Histograms and Counters
+    for( uint32_t i = 0; i < TELEMETRY_HISTOGRAM_COUNT; i++ ){
+        snapshot.histograms[i] = histograms[i].summarize( reset );
+    }
+    for( uint32_t i = 0; i < TELEMETRY_COUNTER_COUNT; i++ ){
+        snapshot.counters[i] = counters[i].load( std::memory_order_relaxed );
+    }
+
+    // Queues
+    for( uint32_t i = 0; i < TELEMETRY_QUEUE_COUNT; i++ ){
+        snapshot.depths[i] = depths[i].load( std::memory_order_relaxed );
+        snapshot.max_depths[i] = reset ? max_depths[i].exchange( 0, std::memory_order_relaxed ) : max_depths[i].load( std::memory_order_relaxed );
+        snapshot.drops[i] = drops[i].load( std::memory_order_relaxed );
+    }
+}
+
+// Write Telemetry Snapshot as JSON Line
+void writeTelemetryJSON( const TelemetrySnapshot& snapshot, std::ostream& stream )
+{
+    stream << "{\"elapsed\":" << snapshot.elapsed << ",\"unit\":\"us\"";
+
+    // Counters
+    stream << ",\"counters\":{";
+    for( uint32_t i = 0; i < TELEMETRY_COUNTER_COUNT; i++ ){
+        stream << ( i ? "," : "" ) << "\"" << counter_names[i] << "\":" << snapshot.counters[i];
+    }
+    stream << "}";
+
+    // Histograms (Recorded only)
+    stream << ",\"histograms\":{";
+    bool first = true;
+    for( uint32_t i = 0; i < TELEMETRY_HISTOGRAM_COUNT; i++ ){
+        const HistogramSummary& summary = snapshot.histograms[i];
+        if( !summary.count ){
+            continue;
+        }
+
+        stream << ( first ? "" : "," ) << "\"" << histogram_names[i] << "\":{";
+        stream << "\"count\":" << summary.count << ",";
+        stream << "\"mean\":" << summary.mean << ",";
+        stream << "\"p50\":" << summary.p50 << ",";
+        stream << "\"p90\":" << summary.p90 << ",";
+        stream << "\"p99\":" << summary.p99 << ",";
+        stream << "\"p999\":" << summary.p999 << ",";
+        stream << "\"max\":" << summary.max << "}";
+        first = false;
+    }
+    stream << "}";
+
+    // Queues
+    stream << ",\"queues\":{";
+    for( uint32_t i = 0; i < TELEMETRY_QUEUE_COUNT; i++ ){
+        stream << ( i ? "," : "" ) << "\"" << queue_names[i] << "\":{";
+        stream << "\"depth\":" << snapshot.depths[i] << ",";
+        stream << "\"max_depth\":" << snapshot.max_depths[i] << ",";
+        stream << "\"drops\":" << snapshot.drops[i] << "}";
+    }
+    stream << "}}\n";
+}
+
+// Constructor
+TelemetryReporter::TelemetryReporter( Telemetry& telemetry, Sink& sink, const uint32_t interval )
+    : telemetry( telemetry ),
+      sink( sink ),
+      interval( interval )
+{
+    if( !interval ){
+        throw std::runtime_error( "failed invalid interval of telemetry" );
+    }
+
+    thread = std::thread( &TelemetryReporter::report, this );
+}
+
+// Destructor
+TelemetryReporter::~TelemetryReporter()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    condition.notify_all();
+    thread.join();
+}
+
+// Report Thread
+void TelemetryReporter::report()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now() + interval;
+    while( !condition.wait_until( lock, next, [this]{ return stopping; } ) ){
+        dump();
+        next += interval;
+    }
+
+    // Last Dump (Frames since previous dump)
+    dump();
+}
+
+// Dump Snapshot
+void TelemetryReporter::dump()
+{
+    telemetry.snapshot( snapshot );
+    record.reset();
+    writeTelemetryJSON( snapshot, record );
+    try{
+        sink.write( record.str() );
+    } catch( ... ){
+        // Ignore (Telemetry doesn't stop the tracker loop)
+    }
+}
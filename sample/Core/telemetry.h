@@ -0,0 +1,253 @@
+#ifndef __TELEMETRY__
+#define __TELEMETRY__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+#include "sink.h"
+
+// Latency Histogram Buckets (Log-linear, 3% error, up to 2^HISTOGRAM_MAX_BITS us)
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB_COUNT ( 1 << HISTOGRAM_SUB_BITS )
+#define HISTOGRAM_MAX_BITS 32
+#define HISTOGRAM_BUCKETS ( ( HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1 ) * HISTOGRAM_SUB_COUNT )
+
+// Maximum Number of Sensors of Frame Index Tracking
+#define TELEMETRY_SENSOR_COUNT 8
+
+// Sensor Clock Offset Window [frames]
+#define TELEMETRY_CLOCK_WINDOW 64
+
+// Default Interval of Periodic Stats Dump [ms]
+#define TELEMETRY_INTERVAL 1000
+
+// Telemetry Histogram
+enum TelemetryHistogram
+{
+    TELEMETRY_READ,           // Time blocked in readFrame() of source
+    TELEMETRY_UPDATE,         // update() (Stage timings as benchmark.h)
+    TELEMETRY_DRAW,           // updateDepth() and draw()
+    TELEMETRY_SHOW,           // show()
+    TELEMETRY_WRITE,          // write() and Sink::write() (headless mode)
+    TELEMETRY_SENSOR_LATENCY, // Sensor timestamp to tracker output (beyond minimum over window)
+    TELEMETRY_OUTPUT_LATENCY, // Tracker output to drawn or written
+    TELEMETRY_DISPLAY_AGE,    // Tracker output to shown (age of skeleton when it is on screen)
+    TELEMETRY_HISTOGRAM_COUNT
+};
+
+// Telemetry Counter
+enum TelemetryCounter
+{
+    TELEMETRY_FRAMES,         // Frames read from source
+    TELEMETRY_SKIPPED_FRAMES, // Frames skipped by tracker (frame index gaps)
+    TELEMETRY_GAPS,           // Frame index gaps
+    TELEMETRY_COUNTER_COUNT
+};
+
+// Telemetry Queue
+enum TelemetryQueue
+{
+    TELEMETRY_FRAME_QUEUE, // Capture to process ring
+    TELEMETRY_IMAGE_QUEUE, // Process to display ring
+    TELEMETRY_QUEUE_COUNT
+};
+
+// Retrieve Names
+const char* telemetryHistogramName( const TelemetryHistogram histogram );
+const char* telemetryCounterName( const TelemetryCounter counter );
+const char* telemetryQueueName( const TelemetryQueue queue );
+
+// Summary of Histogram [us]
+struct HistogramSummary
+{
+    uint64_t count = 0;
+    double mean = 0.0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+    uint64_t max = 0;
+};
+
+// Lock-Free Latency Histogram [us] (Percentiles are the upper bound of bucket)
+class LatencyHistogram
+{
+private:
+    std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> buckets;
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> maximum;
+
+public:
+    // Constructor
+    LatencyHistogram();
+
+    // Record Value [us]
+    void record( const uint64_t value )
+    {
+        buckets[bucket( value )].fetch_add( 1, std::memory_order_relaxed );
+        count.fetch_add( 1, std::memory_order_relaxed );
+        sum.fetch_add( value, std::memory_order_relaxed );
+        uint64_t current = maximum.load( std::memory_order_relaxed );
+        while( current < value && !maximum.compare_exchange_weak( current, value, std::memory_order_relaxed ) ){
+        }
+    }
+
+    // Summarize (Reset after reading if reset is true)
+    HistogramSummary summarize( const bool reset = false );
+
+    // Retrieve Bucket of Value
+    static uint32_t bucket( const uint64_t value )
+    {
+        if( value < 2 * HISTOGRAM_SUB_COUNT ){
+            return static_cast<uint32_t>( value );
+        }
+        if( value >> HISTOGRAM_MAX_BITS ){
+            return HISTOGRAM_BUCKETS - 1;
+        }
+        // Most Significant Bit (Binary search over 32 bits)
+        uint32_t bits = 0;
+        uint64_t remain = value;
+        for( uint32_t step = HISTOGRAM_MAX_BITS / 2; step; step /= 2 ){
+            if( remain >> step ){
+                remain >>= step;
+                bits += step;
+            }
+        }
+        const uint32_t shift = bits - HISTOGRAM_SUB_BITS;
+        return ( shift + 1 ) * HISTOGRAM_SUB_COUNT + static_cast<uint32_t>( value >> shift ) - HISTOGRAM_SUB_COUNT;
+    }
+
+    // Retrieve Upper Bound of Bucket
+    static uint64_t upper( const uint32_t bucket )
+    {
+        if( bucket < 2 * HISTOGRAM_SUB_COUNT ){
+            return bucket;
+        }
+        const uint32_t shift = bucket / HISTOGRAM_SUB_COUNT - 1;
+        return ( ( static_cast<uint64_t>( bucket % HISTOGRAM_SUB_COUNT + HISTOGRAM_SUB_COUNT ) + 1 ) << shift ) - 1;
+    }
+};
+
+// Telemetry Snapshot (Pull API)
+struct TelemetrySnapshot
+{
+    double elapsed = 0.0; // Seconds since previous snapshot (or start)
+    std::array<HistogramSummary, TELEMETRY_HISTOGRAM_COUNT> histograms;
+    std::array<uint64_t, TELEMETRY_COUNTER_COUNT> counters;
+    std::array<uint32_t, TELEMETRY_QUEUE_COUNT> depths;     // Last Depth
+    std::array<uint32_t, TELEMETRY_QUEUE_COUNT> max_depths; // Maximum Depth since previous snapshot
+    std::array<uint64_t, TELEMETRY_QUEUE_COUNT> drops;      // Dropped Elements (Total)
+};
+
+// Tracker Loop Telemetry (Lock-free counters, histograms and queue gauges, recordFrame() from capture thread only)
+class Telemetry
+{
+private:
+    // Histograms and Counters
+    std::array<LatencyHistogram, TELEMETRY_HISTOGRAM_COUNT> histograms;
+    std::array<std::atomic<uint64_t>, TELEMETRY_COUNTER_COUNT> counters;
+
+    // Queues
+    std::array<std::atomic<uint32_t>, TELEMETRY_QUEUE_COUNT> depths;
+    std::array<std::atomic<uint32_t>, TELEMETRY_QUEUE_COUNT> max_depths;
+    std::array<std::atomic<uint64_t>, TELEMETRY_QUEUE_COUNT> drops;
+
+    // Frame Index and Clock Offset of Sensors (Owned by thread of recordFrame())
+    struct Sensor
+    {
+        bool valid = false;
+        int32_t frame_index = 0;
+        std::array<int64_t, TELEMETRY_CLOCK_WINDOW> offsets;
+        uint32_t offset_count = 0;
+        uint32_t offset_next = 0;
+    };
+    std::array<Sensor, TELEMETRY_SENSOR_COUNT> sensors;
+
+    // Time of Previous Snapshot
+    std::chrono::steady_clock::time_point previous;
+    std::mutex snapshot_mutex;
+
+public:
+    // Constructor
+    Telemetry();
+
+    Telemetry( const Telemetry& ) = delete;
+    Telemetry& operator=( const Telemetry& ) = delete;
+
+    // Record Duration
+    void record( const TelemetryHistogram histogram, const std::chrono::steady_clock::duration& duration )
+    {
+        const int64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>( duration ).count();
+        histograms[histogram].record( static_cast<uint64_t>( 0 < microseconds ? microseconds : 0 ) );
+    }
+
+    // Add to Counter
+    void count( const TelemetryCounter counter, const uint64_t value = 1 )
+    {
+        counters[counter].fetch_add( value, std::memory_order_relaxed );
+    }
+
+    // Record Queue Depth and Total Dropped Elements
+    void recordQueue( const TelemetryQueue queue, const uint32_t depth, const uint64_t dropped )
+    {
+        depths[queue].store( depth, std::memory_order_relaxed );
+        uint32_t current = max_depths[queue].load( std::memory_order_relaxed );
+        while( current < depth && !max_depths[queue].compare_exchange_weak( current, depth, std::memory_order_relaxed ) ){
+        }
+        drops[queue].store( dropped, std::memory_order_relaxed );
+    }
+
+    // Record Frame (Frame index gaps and sensor latency of sensor)
+    void recordFrame( const uint32_t sensor, const int32_t frame_index, const uint64_t sensor_timestamp, const std::chrono::steady_clock::time_point& output );
+
+    // Take Snapshot (Reset histograms and maximum queue depths if reset is true)
+    void snapshot( TelemetrySnapshot& snapshot, const bool reset = true );
+};
+
+// Write Telemetry Snapshot as JSON Line
+void writeTelemetryJSON( const TelemetrySnapshot& snapshot, std::ostream& stream );
+
+// Periodic Stats Dump (One JSON line to sink every interval on background thread)
+class TelemetryReporter
+{
+private:
+    Telemetry& telemetry;
+    Sink& sink;
+    std::chrono::milliseconds interval;
+
+    // Thread
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping = false;
+
+    // Record Buffer
+    TelemetrySnapshot snapshot;
+    RecordStream record;
+
+public:
+    // Constructor (Start thread)
+    TelemetryReporter( Telemetry& telemetry, Sink& sink, const uint32_t interval = TELEMETRY_INTERVAL );
+
+    // Destructor (Stop thread after last dump)
+    ~TelemetryReporter();
+
+    TelemetryReporter( const TelemetryReporter& ) = delete;
+    TelemetryReporter& operator=( const TelemetryReporter& ) = delete;
+
+private:
+    // Report Thread
+    void report();
+
+    // Dump Snapshot
+    void dump();
+};
+
+#endif // __TELEMETRY__
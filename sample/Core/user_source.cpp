@@ -0,0 +1,842 @@
+#include "user_source.h"
+#include "multi_source.h"
+#include "util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+// Constructor
+UserTrackerSource::UserTrackerSource( const std::string& uri )
+{
+    // Initialize OpenNI2 and NiTE2
+    initializeSensor();
+
+    // Create User Tracker (Opened Device or Any Connected Device)
+    if( openDevice( device, uri ) ){
+        NITE_CHECK( user_tracker.create( &device ) );
+
+        // Read Depth Field of View (RealSense projects by its own camera model)
+        #if (DEVICE != REALSENSE)
+        if( !readDepthFieldOfView( device, horizontal_fov, vertical_fov ) ){
+            horizontal_fov = vertical_fov = 0.0f;
+        }
+        #endif
+    }
+    else{
+        NITE_CHECK( user_tracker.create() );
+    }
+}
+
+// Read Frame
+void UserTrackerSource::readFrame( UserFrame& frame )
+{
+    // Update Frame
+    NITE_CHECK( user_tracker.readFrame( &frame.user_frame ) );
+
+    // Retrieve Depth Frame
+    frame.depth_frame = frame.user_frame.getDepthFrame();
+    if( !frame.depth_frame.isValid() ){
+        throw std::runtime_error( "failed can not retrieve depth frame" );
+    }
+
+    // Retrive Frame Size
+    depth_width = frame.depth_frame.getWidth();
+    depth_height = frame.depth_frame.getHeight();
+
+    // Compute Depth Intrinsics (Once per depth size, field of view or two projections by tracker)
+    if( intrinsics_width != depth_width || intrinsics_height != depth_height ){
+        if( 0.0f < horizontal_fov ){
+            intrinsics = intrinsicsFromFieldOfView( depth_width, depth_height, horizontal_fov, vertical_fov );
+        }
+        else{
+            const bool estimated = estimateIntrinsics( [this]( const float x, const float y, const float z, float* pOutX, float* pOutY ){
+                return convertJointCoordinatesToDepth( x, y, z, pOutX, pOutY ) == nite::Status::STATUS_OK;
+            }, intrinsics );
+            if( !estimated ){
+                throw std::runtime_error( "failed can not estimate depth intrinsics" );
+            }
+        }
+        intrinsics_width = depth_width;
+        intrinsics_height = depth_height;
+    }
+    frame.intrinsics = intrinsics;
+
+    // Create cv::Mat form Depth Frame and User Map (Valid while Frame References are held)
+    frame.depth_mat = cv::Mat( depth_height, depth_width, CV_16UC1, const_cast<void*>( frame.depth_frame.getData() ), frame.depth_frame.getStrideInBytes() );
+    const nite::UserMap& user_map = frame.user_frame.getUserMap();
+    frame.user_map = cv::Mat( user_map.getHeight(), user_map.getWidth(), CV_16UC1, const_cast<nite::UserId*>( user_map.getPixels() ), user_map.getStride() );
+
+    // Retrieve Timestamp
+    frame.sensor_timestamp = frame.user_frame.getTimestamp();
+    frame.frame_index = frame.user_frame.getFrameIndex();
+
+    // Retrieve Users
+    const nite::Array<nite::UserData>& users = frame.user_frame.getUsers();
+    frame.users.resize( users.getSize() );
+    for( int32_t index = 0; index < users.getSize(); index++ ){
+        const nite::UserData& user = users[index];
+        User& data = frame.users[index];
+
+        // Retrieve User Status
+        data.id = user.getId();
+        data.is_new = user.isNew();
+        data.is_visible = user.isVisible();
+        data.is_lost = user.isLost();
+        data.center_of_mass = user.getCenterOfMass();
+
+        // Retrieve Bounding Box
+        const nite::BoundingBox& bounding_box = user.getBoundingBox();
+        data.bounding_box_min = nite::Point3f( bounding_box.min.x, bounding_box.min.y, bounding_box.min.z );
+        data.bounding_box_max = nite::Point3f( bounding_box.max.x, bounding_box.max.y, bounding_box.max.z );
+
+        // Retrieve Skeleton
+        const nite::Skeleton& skeleton = user.getSkeleton();
+        data.skeleton_state = skeleton.getState();
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const nite::SkeletonJoint& joint = skeleton.getJoint( static_cast<nite::JointType>( type ) );
+            data.joints[type].position = joint.getPosition();
+            data.joints[type].orientation = joint.getOrientation();
+            data.joints[type].position_confidence = joint.getPositionConfidence();
+            data.joints[type].orientation_confidence = joint.getOrientationConfidence();
+        }
+
+        // Retrieve Poses
+        for( uint32_t type = 0; type < POSE_COUNT; type++ ){
+            const nite::PoseData& pose = user.getPose( static_cast<nite::PoseType>( type ) );
+            data.poses[type].is_entered = pose.isEntered();
+            data.poses[type].is_held = pose.isHeld();
+            data.poses[type].is_exited = pose.isExited();
+        }
+    }
+}
+
+// Start Skeleton Tracking
+nite::Status UserTrackerSource::startSkeletonTracking( const nite::UserId id )
+{
+    return user_tracker.startSkeletonTracking( id );
+}
+
+// Start Pose Detection
+nite::Status UserTrackerSource::startPoseDetection( const nite::UserId id, const nite::PoseType type )
+{
+    return user_tracker.startPoseDetection( id, type );
+}
+
+// Convert Joint Coordinates to Depth
+nite::Status UserTrackerSource::convertJointCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY )
+{
+    #if (DEVICE != REALSENSE)
+    return user_tracker.convertJointCoordinatesToDepth( x, y, z, pOutX, pOutY ); // for PrimeSensor
+    #else
+    return convertRealSenseCoordinatesToDepth( device, depth_height, x, y, z, pOutX, pOutY ); // for RealSense
+    #endif
+}
+
+// Constructor
+SyntheticUserSource::SyntheticUserSource( const uint32_t width, const uint32_t height, const uint32_t fps, const uint32_t users )
+    : depth_width( width ),
+      depth_height( height ),
+      depth_fps( fps ),
+      user_count( std::min<uint32_t>( users, USER_COUNT ) ),
+      image_pool( 8 )
+{
+    if( !depth_width || !depth_height ){
+        throw std::runtime_error( "failed invalid synthetic resolution" );
+    }
+
+    // Camera Intrinsics from PrimeSense Field of View (58.5 x 45.6 degrees)
+    intrinsics = intrinsicsFromFieldOfView( depth_width, depth_height, 1.0210f, 0.7959f );
+
+    // Allocate Buffers of Depth and User Map
+    image_pool.reserve( depth_height, depth_width, CV_16UC1 );
+
+    // Initialize Status
+    skeleton_tracking.fill( false );
+    for( uint32_t number = 0; number < USER_COUNT; number++ ){
+        pose_detection[number].fill( false );
+        pose_held[number].fill( false );
+    }
+}
+
+// Read Frame
+void SyntheticUserSource::readFrame( UserFrame& frame )
+{
+    // Wait Next Frame
+    if( depth_fps ){
+        if( !index ){
+            next = std::chrono::steady_clock::now();
+        }
+
+        std::this_thread::sleep_until( next );
+        next += std::chrono::microseconds( 1000000 / depth_fps );
+    }
+
+    // Generate Users
+    const uint32_t rate = depth_fps ? depth_fps : 30;
+    const float time = static_cast<float>( index ) / rate;
+    frame.users.resize( user_count );
+    for( uint32_t number = 0; number < user_count; number++ ){
+        generateUser( number, time, frame.users[number] );
+    }
+
+    // Generate Depth and User Map (Pooled Buffers)
+    frame.depth_buffer = image_pool.acquire( depth_height, depth_width, CV_16UC1 );
+    frame.user_buffer = image_pool.acquire( depth_height, depth_width, CV_16UC1 );
+    frame.depth_mat = *frame.depth_buffer;
+    frame.user_map = *frame.user_buffer;
+    generateDepth( frame.users, frame.depth_mat, frame.user_map );
+
+    // Set Timestamp
+    frame.sensor_timestamp = static_cast<uint64_t>( index ) * 1000000 / rate;
+    frame.frame_index = static_cast<int32_t>( index );
+    frame.user_frame = nite::UserTrackerFrameRef();
+    frame.depth_frame = openni::VideoFrameRef();
+
+    // Set Intrinsics
+    frame.intrinsics = intrinsics;
+
+    index++;
+}
+
+// Start Skeleton Tracking
+nite::Status SyntheticUserSource::startSkeletonTracking( const nite::UserId id )
+{
+    if( id < 1 || user_count < static_cast<uint32_t>( id ) ){
+        return nite::Status::STATUS_BAD_USER_ID;
+    }
+
+    skeleton_tracking[id - 1] = true;
+    return nite::Status::STATUS_OK;
+}
+
+// Start Pose Detection
+nite::Status SyntheticUserSource::startPoseDetection( const nite::UserId id, const nite::PoseType type )
+{
+    if( id < 1 || user_count < static_cast<uint32_t>( id ) || POSE_COUNT <= static_cast<uint32_t>( type ) ){
+        return nite::Status::STATUS_BAD_USER_ID;
+    }
+
+    pose_detection[id - 1][type] = true;
+    return nite::Status::STATUS_OK;
+}
+
+// Convert Joint Coordinates to Depth
+nite::Status SyntheticUserSource::convertJointCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY )
+{
+    // Pinhole Projection
+    return projectPoint( intrinsics, x, y, z, pOutX, pOutY ) ? nite::Status::STATUS_OK : nite::Status::STATUS_ERROR;
+}
+
+// Reserve Pooled Buffers for Frames in Flight
+void SyntheticUserSource::reserveFrames( const uint32_t frames )
+{
+    image_pool.reserve( depth_height, depth_width, CV_16UC1, 2 * static_cast<size_t>( frames ) );
+}
+
+// Generate User
+inline void SyntheticUserSource::generateUser( const uint32_t number, const float time, User& user )
+{
+    // Torso Position (Users stand side by side and sway)
+    const float phase = static_cast<float>( number );
+    const float torso_x = ( phase - ( user_count - 1 ) / 2.0f ) * 700.0f + 200.0f * std::sin( time * 0.5f + phase );
+    const float torso_y = 0.0f;
+    const float torso_z = 2500.0f + 300.0f * std::sin( time * 0.3f + phase );
+
+    // Arm Angle (0: Down - PI: Up)
+    const float raise = 0.5f + 0.5f * std::sin( time * 1.5f + phase );
+    const float angle = static_cast<float>( CV_PI ) * raise;
+    const float arm_x = std::sin( angle );
+    const float arm_y = -std::cos( angle );
+
+    // Joint Offsets from Torso [mm]
+    const std::array<cv::Point2f, JOINT_COUNT> offsets = { {
+        cv::Point2f(    0.0f,  450.0f ),                               // Head
+        cv::Point2f(    0.0f,  300.0f ),                               // Neck
+        cv::Point2f( -170.0f,  280.0f ),                               // Left Shoulder
+        cv::Point2f(  170.0f,  280.0f ),                               // Right Shoulder
+        cv::Point2f( -170.0f - 280.0f * arm_x, 280.0f + 280.0f * arm_y ), // Left Elbow
+        cv::Point2f(  170.0f + 280.0f * arm_x, 280.0f + 280.0f * arm_y ), // Right Elbow
+        cv::Point2f( -170.0f - 560.0f * arm_x, 280.0f + 560.0f * arm_y ), // Left Hand
+        cv::Point2f(  170.0f + 560.0f * arm_x, 280.0f + 560.0f * arm_y ), // Right Hand
+        cv::Point2f(    0.0f,    0.0f ),                               // Torso
+        cv::Point2f( -100.0f, -200.0f ),                               // Left Hip
+        cv::Point2f(  100.0f, -200.0f ),                               // Right Hip
+        cv::Point2f( -100.0f, -600.0f ),                               // Left Knee
+        cv::Point2f(  100.0f, -600.0f ),                               // Right Knee
+        cv::Point2f( -100.0f, -1000.0f ),                              // Left Foot
+        cv::Point2f(  100.0f, -1000.0f )                               // Right Foot
+    } };
+
+    // User Status
+    user.id = static_cast<nite::UserId>( number + 1 );
+    user.is_new = ( index == 0 );
+    user.is_visible = true;
+    user.is_lost = false;
+    user.center_of_mass = nite::Point3f( torso_x, torso_y, torso_z );
+    user.skeleton_state = skeleton_tracking[number] ? nite::SkeletonState::SKELETON_TRACKED : nite::SkeletonState::SKELETON_NONE;
+
+    // Joints
+    for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+        Joint& joint = user.joints[type];
+        joint.position = nite::Point3f( torso_x + offsets[type].x, torso_y + offsets[type].y, torso_z );
+        joint.orientation.x = 0.0f;
+        joint.orientation.y = 0.0f;
+        joint.orientation.z = 0.0f;
+        joint.orientation.w = 1.0f;
+        joint.position_confidence = skeleton_tracking[number] ? 1.0f : 0.0f;
+        joint.orientation_confidence = joint.position_confidence;
+    }
+
+    // Bounding Box (Depth Coordinates)
+    float min_x, min_y, max_x, max_y;
+    convertJointCoordinatesToDepth( torso_x - 300.0f, torso_y +  500.0f, torso_z, &min_x, &min_y );
+    convertJointCoordinatesToDepth( torso_x + 300.0f, torso_y - 1050.0f, torso_z, &max_x, &max_y );
+    user.bounding_box_min = nite::Point3f( min_x, min_y, torso_z );
+    user.bounding_box_max = nite::Point3f( max_x, max_y, torso_z );
+
+    // Poses (Psi is held while both hands are raised)
+    const std::array<bool, POSE_COUNT> held = { { raise > 0.8f, false } };
+    for( uint32_t type = 0; type < POSE_COUNT; type++ ){
+        Pose& pose = user.poses[type];
+        const bool is_held = pose_detection[number][type] && held[type];
+        pose.is_entered = is_held && !pose_held[number][type];
+        pose.is_held = is_held && pose_held[number][type];
+        pose.is_exited = !is_held && pose_held[number][type];
+        pose_held[number][type] = is_held;
+    }
+}
+
+// Generate Depth and User Map
+inline void SyntheticUserSource::generateDepth( const std::vector<User>& users, cv::Mat& depth_mat, cv::Mat& user_map )
+{
+    // Background (Slanted Floor to Wall, 4000-5000mm)
+    for( uint32_t y = 0; y < depth_height; y++ ){
+        uint16_t* depth = depth_mat.ptr<uint16_t>( y );
+        uint16_t* label = user_map.ptr<uint16_t>( y );
+        const uint16_t value = static_cast<uint16_t>( 5000 - ( 1000 * y ) / depth_height );
+        std::fill( depth, depth + depth_width, value );
+        std::fill( label, label + depth_width, static_cast<uint16_t>( 0 ) );
+    }
+
+    // Users (Ellipse Silhouette with Depth Test)
+    for( const User& user : users ){
+        const float center_x = ( user.bounding_box_min.x + user.bounding_box_max.x ) / 2.0f;
+        const float center_y = ( user.bounding_box_min.y + user.bounding_box_max.y ) / 2.0f;
+        const float radius_x = ( user.bounding_box_max.x - user.bounding_box_min.x ) / 2.0f;
+        const float radius_y = ( user.bounding_box_max.y - user.bounding_box_min.y ) / 2.0f;
+        const uint16_t z = static_cast<uint16_t>( user.center_of_mass.z );
+
+        const int32_t top = std::max<int32_t>( 0, static_cast<int32_t>( center_y - radius_y ) );
+        const int32_t bottom = std::min<int32_t>( depth_height - 1, static_cast<int32_t>( center_y + radius_y ) );
+        for( int32_t y = top; y <= bottom; y++ ){
+            // Span of Ellipse in Row
+            const float dy = ( y - center_y ) / radius_y;
+            const float span = radius_x * std::sqrt( std::max( 0.0f, 1.0f - dy * dy ) );
+            const int32_t left = std::max<int32_t>( 0, static_cast<int32_t>( center_x - span ) );
+            const int32_t right = std::min<int32_t>( depth_width - 1, static_cast<int32_t>( center_x + span ) );
+
+            uint16_t* depth = depth_mat.ptr<uint16_t>( y );
+            uint16_t* label = user_map.ptr<uint16_t>( y );
+            for( int32_t x = left; x <= right; x++ ){
+                if( z < depth[x] ){
+                    depth[x] = z;
+                    label[x] = static_cast<uint16_t>( user.id );
+                }
+            }
+        }
+    }
+}
+
+// Constructor
+SessionUserSource::SessionUserSource( const std::string& path, const float speed )
+    : reader( path ),
+      clock( speed )
+{
+    const SessionHeader& header = reader.sessionHeader();
+    if( header.kind != SESSION_USER ){
+        throw std::runtime_error( "failed " + path + " is not user session" );
+    }
+
+    // Blank Depth and User Map
+    if( !( header.flags & SESSION_DEPTH ) || !( header.flags & SESSION_USER_MAP ) ){
+        blank_mat = cv::Mat::zeros( header.depth_height ? header.depth_height : 480, header.depth_width ? header.depth_width : 640, CV_16UC1 );
+    }
+}
+
+// Read Frame
+void SessionUserSource::readFrame( UserFrame& frame )
+{
+    // Read Frame
+    SessionFrame session_frame;
+    if( !reader.read( session_frame ) ){
+        throw EndOfSource( "end of session" );
+    }
+    const SessionFrameHeader& frame_header = *session_frame.header;
+
+    // Wait Recorded Time
+    clock.wait( frame_header.timestamp );
+
+    // Create cv::Mat from Mapped Depth and User Map
+    const SessionHeader& header = reader.sessionHeader();
+    frame.depth_mat = session_frame.depth ? cv::Mat( header.depth_height, header.depth_width, CV_16UC1, const_cast<uint16_t*>( session_frame.depth ) ) : blank_mat;
+    frame.user_map = session_frame.user_map ? cv::Mat( header.depth_height, header.depth_width, CV_16UC1, const_cast<uint16_t*>( session_frame.user_map ) ) : blank_mat;
+
+    // Retrieve Timestamp
+    frame.sensor_timestamp = frame_header.timestamp;
+    frame.frame_index = static_cast<int32_t>( frame_header.frame_index );
+    frame.user_frame = nite::UserTrackerFrameRef();
+    frame.depth_frame = openni::VideoFrameRef();
+
+    // Recorded Intrinsics
+    frame.intrinsics = sessionIntrinsics( header );
+
+    // Retrieve Users
+    frame.users.resize( frame_header.count );
+    for( uint32_t index = 0; index < frame_header.count; index++ ){
+        const SessionUser& user = session_frame.users[index];
+        User& data = frame.users[index];
+
+        // Retrieve User Status
+        data.id = static_cast<nite::UserId>( user.id );
+        data.is_new = ( user.flags & 0x01 ) != 0;
+        data.is_visible = ( user.flags & 0x02 ) != 0;
+        data.is_lost = ( user.flags & 0x04 ) != 0;
+        data.center_of_mass = nite::Point3f( user.center_of_mass[0], user.center_of_mass[1], user.center_of_mass[2] );
+
+        // Retrieve Bounding Box
+        data.bounding_box_min = nite::Point3f( user.bounding_box_min[0], user.bounding_box_min[1], user.bounding_box_min[2] );
+        data.bounding_box_max = nite::Point3f( user.bounding_box_max[0], user.bounding_box_max[1], user.bounding_box_max[2] );
+
+        // Retrieve Skeleton
+        data.skeleton_state = static_cast<nite::SkeletonState>( user.skeleton_state );
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const SessionJoint& joint = user.joints[type];
+            data.joints[type].position = nite::Point3f( joint.position[0], joint.position[1], joint.position[2] );
+            data.joints[type].orientation.x = joint.orientation[0];
+            data.joints[type].orientation.y = joint.orientation[1];
+            data.joints[type].orientation.z = joint.orientation[2];
+            data.joints[type].orientation.w = joint.orientation[3];
+            data.joints[type].position_confidence = joint.position_confidence;
+            data.joints[type].orientation_confidence = joint.orientation_confidence;
+        }
+
+        // Retrieve Poses
+        for( uint32_t type = 0; type < POSE_COUNT; type++ ){
+            data.poses[type].is_entered = ( user.poses[type] & 0x01 ) != 0;
+            data.poses[type].is_held = ( user.poses[type] & 0x02 ) != 0;
+            data.poses[type].is_exited = ( user.poses[type] & 0x04 ) != 0;
+        }
+    }
+}
+
+// Start Skeleton Tracking
+nite::Status SessionUserSource::startSkeletonTracking( const nite::UserId id )
+{
+    static_cast<void>( id );
+    return nite::Status::STATUS_OK;
+}
+
+// Start Pose Detection
+nite::Status SessionUserSource::startPoseDetection( const nite::UserId id, const nite::PoseType type )
+{
+    static_cast<void>( id );
+    static_cast<void>( type );
+    return nite::Status::STATUS_OK;
+}
+
+// Convert Joint Coordinates to Depth
+nite::Status SessionUserSource::convertJointCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY )
+{
+    // Recorded Projection
+    return projectPoint( sessionIntrinsics( reader.sessionHeader() ), x, y, z, pOutX, pOutY ) ? nite::Status::STATUS_OK : nite::Status::STATUS_ERROR;
+}
+
+// Seek to First Frame at or after Timestamp
+void SessionUserSource::seek( const uint64_t timestamp )
+{
+    reader.seek( timestamp );
+    clock.reset();
+}
+
+// Retrieve Session
+const SessionReader& SessionUserSource::session() const
+{
+    return reader;
+}
+
+// Project Joints
+void projectJoints( const UserFrame& frame, const float threshold, JointBatch& batch )
+{
+    // Reserve Joints of All Users (Capacity is kept across frames)
+    const size_t capacity = frame.users.size() * JOINT_COUNT;
+    batch.resize( capacity );
+
+    // Gather Joints of Tracked Users
+    size_t count = 0;
+    for( uint32_t index = 0; index < frame.users.size(); index++ ){
+        const User& user = frame.users[index];
+        if( user.is_lost || user.skeleton_state != nite::SkeletonState::SKELETON_TRACKED ){
+            continue;
+        }
+
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const Joint& joint = user.joints[type];
+            if( joint.position_confidence < threshold ){
+                continue;
+            }
+
+            batch.x[count] = joint.position.x;
+            batch.y[count] = joint.position.y;
+            batch.z[count] = joint.position.z;
+            batch.user[count] = index;
+            batch.type[count] = type;
+            count++;
+        }
+    }
+    batch.resize( count );
+
+    // Project All Joints
+    batch.project( frame.intrinsics );
+}
+
+// Project Joints of Snapshot
+void projectJoints( const SkeletonSnapshot& snapshot, const Intrinsics& intrinsics, const float threshold, JointBatch& batch )
+{
+    // Reserve Joints of All Users (Capacity is kept across frames)
+    const size_t lanes = snapshot.lanes();
+    batch.resize( lanes );
+
+    // Gather Confident Joints
+    size_t count = 0;
+    for( size_t lane = 0; lane < lanes; lane++ ){
+        if( snapshot.position_confidence[lane] < threshold ){
+            continue;
+        }
+
+        batch.x[count] = snapshot.x[lane];
+        batch.y[count] = snapshot.y[lane];
+        batch.z[count] = snapshot.z[lane];
+        batch.user[count] = snapshot.users[lane / JOINT_COUNT];
+        batch.type[count] = static_cast<uint32_t>( lane % JOINT_COUNT );
+        count++;
+    }
+    batch.resize( count );
+
+    // Project All Joints
+    batch.project( intrinsics );
+}
+
+// Fill Skeleton Snapshot
+void fillSnapshot( const UserFrame& frame, SkeletonSnapshot& snapshot )
+{
+    snapshot.frame_index = frame.frame_index;
+    snapshot.timestamp = frame.sensor_timestamp;
+    snapshot.count = 0;
+
+    for( uint32_t index = 0; index < frame.users.size() && snapshot.count < USER_COUNT; index++ ){
+        const User& user = frame.users[index];
+        if( user.is_lost || user.skeleton_state != nite::SkeletonState::SKELETON_TRACKED ){
+            continue;
+        }
+
+        // User
+        const uint32_t number = snapshot.count++;
+        snapshot.ids[number] = user.id;
+        snapshot.states[number] = user.skeleton_state;
+        snapshot.users[number] = index;
+
+        // Poses
+        uint8_t poses = 0;
+        for( uint32_t type = 0; type < POSE_COUNT; type++ ){
+            const Pose& pose = user.poses[type];
+            poses |= ( pose.is_entered << ( type * 3 + 0 ) ) | ( pose.is_held << ( type * 3 + 1 ) ) | ( pose.is_exited << ( type * 3 + 2 ) );
+        }
+        snapshot.poses[number] = poses;
+
+        // Joints (Row of User)
+        const size_t row = SkeletonSnapshot::lane( number, 0 );
+        float* x = snapshot.x + row;
+        float* y = snapshot.y + row;
+        float* z = snapshot.z + row;
+        float* orientation_x = snapshot.orientation_x + row;
+        float* orientation_y = snapshot.orientation_y + row;
+        float* orientation_z = snapshot.orientation_z + row;
+        float* orientation_w = snapshot.orientation_w + row;
+        float* position_confidence = snapshot.position_confidence + row;
+        float* orientation_confidence = snapshot.orientation_confidence + row;
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const Joint& joint = user.joints[type];
+            x[type] = joint.position.x;
+            y[type] = joint.position.y;
+            z[type] = joint.position.z;
+            orientation_x[type] = joint.orientation.x;
+            orientation_y[type] = joint.orientation.y;
+            orientation_z[type] = joint.orientation.z;
+            orientation_w[type] = joint.orientation.w;
+            position_confidence[type] = joint.position_confidence;
+            orientation_confidence[type] = joint.orientation_confidence;
+        }
+    }
+}
+
+// Create Frame Source
+std::unique_ptr<UserSource> createUserSource( const std::string& uri )
+{
+    // Multiple Sensors
+    std::vector<std::string> uris;
+    if( parseMultiUri( uri, uris ) ){
+        std::vector<std::unique_ptr<UserSource>> sources;
+        for( const std::string& sensor_uri : uris ){
+            sources.push_back( createUserSource( sensor_uri ) );
+        }
+        return std::unique_ptr<UserSource>( new MultiUserSource( std::move( sources ) ) );
+    }
+
+    // Recorded Session
+    std::string path;
+    float speed;
+    if( parseSessionUri( uri, path, speed ) ){
+        return std::unique_ptr<UserSource>( new SessionUserSource( path, speed ) );
+    }
+
+    // Synthetic Generator
+    const std::string synthetic = "synthetic";
+    if( uri.compare( 0, synthetic.size(), synthetic ) == 0 ){
+        uint32_t width = 640, height = 480, fps = 30, users = USER_COUNT;
+        std::sscanf( uri.c_str(), "synthetic:%ux%u@%u:%u", &width, &height, &fps, &users );
+        return std::unique_ptr<UserSource>( new SyntheticUserSource( width, height, fps, users ) );
+    }
+
+    // NiTE User Tracker (Connected Device or Playback File)
+    return std::unique_ptr<UserSource>( new UserTrackerSource( uri ) );
+}
+
+// Convert Tracked Skeletons of User Frame to Skeleton Stream Record
+void convertSkeletonRecord( const UserFrame& frame, SkeletonRecord& record )
+{
+    static_assert( JOINT_COUNT == SKELETON_JOINT_COUNT && POSE_COUNT == SKELETON_POSE_COUNT, "skeleton stream layout doesn't match NiTE2" );
+
+    record.frame_index = static_cast<uint32_t>( frame.frame_index );
+    record.timestamp = frame.sensor_timestamp;
+    record.users.clear();
+
+    for( const User& user : frame.users ){
+        if( user.is_lost || user.skeleton_state != nite::SkeletonState::SKELETON_TRACKED ){
+            continue;
+        }
+
+        // User
+        record.users.emplace_back();
+        SkeletonUser& data = record.users.back();
+        data.id = static_cast<uint16_t>( user.id );
+        data.state = static_cast<uint8_t>( user.skeleton_state );
+
+        // Poses
+        data.poses = 0;
+        for( uint32_t type = 0; type < POSE_COUNT; type++ ){
+            const Pose& pose = user.poses[type];
+            data.poses |= ( pose.is_entered << ( type * 3 + 0 ) ) | ( pose.is_held << ( type * 3 + 1 ) ) | ( pose.is_exited << ( type * 3 + 2 ) );
+        }
+
+        // Joints
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const Joint& joint = user.joints[type];
+            SkeletonJoint& stream_joint = data.joints[type];
+            stream_joint.position = { { joint.position.x, joint.position.y, joint.position.z } };
+            stream_joint.orientation = { { joint.orientation.x, joint.orientation.y, joint.orientation.z, joint.orientation.w } };
+            stream_joint.position_confidence = joint.position_confidence;
+            stream_joint.orientation_confidence = joint.orientation_confidence;
+        }
+    }
+}
+
+// Convert Skeleton Snapshot to Skeleton Stream Record
+void convertSkeletonRecord( const SkeletonSnapshot& snapshot, SkeletonRecord& record )
+{
+    record.frame_index = static_cast<uint32_t>( snapshot.frame_index );
+    record.timestamp = snapshot.timestamp;
+    record.users.resize( snapshot.count );
+
+    for( uint32_t number = 0; number < snapshot.count; number++ ){
+        // User
+        SkeletonUser& data = record.users[number];
+        data.id = static_cast<uint16_t>( snapshot.ids[number] );
+        data.state = static_cast<uint8_t>( snapshot.states[number] );
+        data.poses = snapshot.poses[number];
+
+        // Joints
+        const size_t row = SkeletonSnapshot::lane( number, 0 );
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const size_t lane = row + type;
+            SkeletonJoint& stream_joint = data.joints[type];
+            stream_joint.position = { { snapshot.x[lane], snapshot.y[lane], snapshot.z[lane] } };
+            stream_joint.orientation = { { snapshot.orientation_x[lane], snapshot.orientation_y[lane], snapshot.orientation_z[lane], snapshot.orientation_w[lane] } };
+            stream_joint.position_confidence = snapshot.position_confidence[lane];
+            stream_joint.orientation_confidence = snapshot.orientation_confidence[lane];
+        }
+    }
+}
+
+// Create Session Header of User Session
+SessionHeader createUserSessionHeader( const UserFrame& frame, const uint32_t flags )
+{
+    static_assert( JOINT_COUNT == SESSION_JOINT_COUNT && POSE_COUNT == SESSION_POSE_COUNT, "session layout doesn't match NiTE2" );
+
+    SessionHeader header;
+    header.kind = SESSION_USER;
+    header.flags = flags;
+    header.depth_width = frame.depth_mat.cols;
+    header.depth_height = frame.depth_mat.rows;
+
+    // Projection (Intrinsics of Source)
+    setSessionIntrinsics( header, frame.intrinsics );
+
+    return header;
+}
+
+// Append User Frame to Session
+void appendSession( SessionWriter& writer, const UserFrame& frame )
+{
+    const SessionHeader& header = writer.sessionHeader();
+    const cv::Size size( header.depth_width, header.depth_height );
+    if( ( ( header.flags & SESSION_DEPTH ) && frame.depth_mat.size() != size ) || ( ( header.flags & SESSION_USER_MAP ) && frame.user_map.size() != size ) ){
+        throw std::runtime_error( "failed frame size doesn't match session" );
+    }
+
+    // Users (Record buffer of writer, no allocation in steady state)
+    SessionUser* users = reinterpret_cast<SessionUser*>( writer.recordBuffer( frame.users.size() * sizeof( SessionUser ) ) );
+    for( size_t index = 0; index < frame.users.size(); index++ ){
+        const User& data = frame.users[index];
+        SessionUser& user = users[index];
+
+        // User Status
+        user = SessionUser();
+        user.id = static_cast<uint16_t>( data.id );
+        user.flags = ( data.is_new ? 0x01 : 0 ) | ( data.is_visible ? 0x02 : 0 ) | ( data.is_lost ? 0x04 : 0 );
+        user.skeleton_state = static_cast<uint8_t>( data.skeleton_state );
+        user.center_of_mass[0] = data.center_of_mass.x;
+        user.center_of_mass[1] = data.center_of_mass.y;
+        user.center_of_mass[2] = data.center_of_mass.z;
+
+        // Bounding Box
+        user.bounding_box_min[0] = data.bounding_box_min.x;
+        user.bounding_box_min[1] = data.bounding_box_min.y;
+        user.bounding_box_min[2] = data.bounding_box_min.z;
+        user.bounding_box_max[0] = data.bounding_box_max.x;
+        user.bounding_box_max[1] = data.bounding_box_max.y;
+        user.bounding_box_max[2] = data.bounding_box_max.z;
+
+        // Skeleton
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const Joint& joint = data.joints[type];
+            SessionJoint& session_joint = user.joints[type];
+            session_joint.position[0] = joint.position.x;
+            session_joint.position[1] = joint.position.y;
+            session_joint.position[2] = joint.position.z;
+            session_joint.orientation[0] = joint.orientation.x;
+            session_joint.orientation[1] = joint.orientation.y;
+            session_joint.orientation[2] = joint.orientation.z;
+            session_joint.orientation[3] = joint.orientation.w;
+            session_joint.position_confidence = joint.position_confidence;
+            session_joint.orientation_confidence = joint.orientation_confidence;
+        }
+
+        // Poses
+        for( uint32_t type = 0; type < POSE_COUNT; type++ ){
+            const Pose& pose = data.poses[type];
+            user.poses[type] = ( pose.is_entered ? 0x01 : 0 ) | ( pose.is_held ? 0x02 : 0 ) | ( pose.is_exited ? 0x04 : 0 );
+        }
+    }
+
+    SessionFrameHeader frame_header;
+    frame_header.timestamp = frame.sensor_timestamp;
+    frame_header.frame_index = static_cast<uint32_t>( frame.frame_index );
+    frame_header.count = static_cast<uint16_t>( frame.users.size() );
+    writer.append( frame_header, users,
+                   frame.user_map.empty() ? nullptr : frame.user_map.ptr<uint16_t>(), frame.user_map.step,
+                   frame.depth_mat.empty() ? nullptr : frame.depth_mat.ptr<uint16_t>(), frame.depth_mat.step );
+}
+
+// Publish User Frame to Shared Memory
+void publishSharedFrame( SharedFrameWriter& writer, const UserFrame& frame )
+{
+    static_assert( USER_COUNT == SHARED_USER_COUNT && JOINT_COUNT == SHARED_JOINT_COUNT && POSE_COUNT == SHARED_POSE_COUNT && SNAPSHOT_LANES == SHARED_LANES, "shared frame layout doesn't match skeleton snapshot" );
+
+    SharedFrame& shared = writer.begin();
+    SharedFrameInfo& info = *shared.info;
+    info.timestamp = frame.sensor_timestamp;
+    info.frame_index = frame.frame_index;
+    info.sensor = frame.sensor;
+    info.focal_x = frame.intrinsics.focal_x;
+    info.focal_y = frame.intrinsics.focal_y;
+    info.center_x = frame.intrinsics.center_x;
+    info.center_y = frame.intrinsics.center_y;
+
+    // Users of Skeleton Snapshot
+    const SkeletonSnapshot& snapshot = frame.skeleton;
+    info.user_count = snapshot.count;
+    for( uint32_t number = 0; number < snapshot.count; number++ ){
+        info.user_ids[number] = static_cast<int32_t>( snapshot.ids[number] );
+        info.user_states[number] = static_cast<uint8_t>( snapshot.states[number] );
+        info.user_poses[number] = snapshot.poses[number];
+    }
+
+    // Joint Arrays (Valid lanes)
+    const size_t size = snapshot.lanes() * sizeof( float );
+    std::memcpy( shared.x, snapshot.x, size );
+    std::memcpy( shared.y, snapshot.y, size );
+    std::memcpy( shared.z, snapshot.z, size );
+    std::memcpy( shared.orientation_x, snapshot.orientation_x, size );
+    std::memcpy( shared.orientation_y, snapshot.orientation_y, size );
+    std::memcpy( shared.orientation_z, snapshot.orientation_z, size );
+    std::memcpy( shared.orientation_w, snapshot.orientation_w, size );
+    std::memcpy( shared.position_confidence, snapshot.position_confidence, size );
+    std::memcpy( shared.orientation_confidence, snapshot.orientation_confidence, size );
+
+    // Depth and User Map
+    if( !frame.depth_mat.empty() ){
+        writer.writePlane( SHARED_FRAME_DEPTH, frame.depth_mat.ptr<uint16_t>(), frame.depth_mat.step, frame.depth_mat.cols, frame.depth_mat.rows );
+    }
+    if( !frame.user_map.empty() ){
+        writer.writePlane( SHARED_FRAME_USER_MAP, frame.user_map.ptr<uint16_t>(), frame.user_map.step, frame.user_map.cols, frame.user_map.rows );
+    }
+
+    writer.commit();
+}
+
+// Publish User Frame to Subscribers
+bool publishStream( StreamPublisher& publisher, const UserFrame& frame )
+{
+    static_assert( USER_COUNT == PUBLISHER_USER_COUNT && JOINT_COUNT == PUBLISHER_JOINT_COUNT && POSE_COUNT == PUBLISHER_POSE_COUNT, "published frame layout doesn't match skeleton snapshot" );
+
+    return publisher.publish( [&]( PublishedFrame& published ){
+        published.timestamp = frame.sensor_timestamp;
+        published.frame_index = frame.frame_index;
+        published.sensor = frame.sensor;
+
+        // Users of Skeleton Snapshot
+        const SkeletonSnapshot& snapshot = frame.skeleton;
+        published.user_count = snapshot.count;
+        for( uint32_t number = 0; number < snapshot.count; number++ ){
+            PublishedUser& user = published.users[number];
+            user.id = static_cast<int32_t>( snapshot.ids[number] );
+            user.state = static_cast<uint8_t>( snapshot.states[number] );
+            user.poses = snapshot.poses[number];
+            for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+                const size_t lane = SkeletonSnapshot::lane( number, type );
+                PublishedJoint& joint = user.joints[type];
+                joint.position[0] = snapshot.x[lane];
+                joint.position[1] = snapshot.y[lane];
+                joint.position[2] = snapshot.z[lane];
+                joint.confidence = snapshot.position_confidence[lane];
+            }
+        }
+
+        published.hand_count = 0;
+        published.gesture_count = 0;
+        published.match_count = 0;
+    } );
+}
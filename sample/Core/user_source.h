@@ -0,0 +1,324 @@
+#ifndef __USER_SOURCE__
+#define __USER_SOURCE__
+
+#include <OpenNI.h>
+#include <NiTE.h>
+#include <opencv2/opencv.hpp>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "frame_pool.h"
+#include "projection.h"
+#include "publisher.h"
+#include "sensor.h"
+#include "session.h"
+#include "shared_frame.h"
+#include "skeleton_snapshot.h"
+#include "skeleton_stream.h"
+
+// Joint
+struct Joint
+{
+    nite::Point3f position;
+    nite::Quaternion orientation;
+    float position_confidence = 0.0f;
+    float orientation_confidence = 0.0f;
+};
+
+// Pose
+struct Pose
+{
+    bool is_entered = false;
+    bool is_held = false;
+    bool is_exited = false;
+};
+
+// User
+struct User
+{
+    nite::UserId id = 0;
+    bool is_new = false;
+    bool is_visible = false;
+    bool is_lost = false;
+    nite::Point3f center_of_mass;
+    nite::Point3f bounding_box_min;
+    nite::Point3f bounding_box_max;
+    nite::SkeletonState skeleton_state = nite::SkeletonState::SKELETON_NONE;
+    std::array<Joint, JOINT_COUNT> joints;
+    std::array<Pose, POSE_COUNT> poses;
+};
+
+// User Frame
+struct UserFrame
+{
+    // Depth (CV_16UC1) and User Map (CV_16UC1)
+    cv::Mat depth_mat;
+    cv::Mat user_map;
+
+    // Users
+    std::vector<User> users;
+
+    // Skeleton Snapshot (Tracked Users)
+    SkeletonSnapshot skeleton;
+
+    // Custom Pose Status of Users in Skeleton Snapshot (user * poses + pose)
+    std::vector<uint8_t> pose_status;
+
+    // Depth Intrinsics (Cached by Source, Project joints without calling into the tracker)
+    Intrinsics intrinsics;
+
+    // Sensor Timestamp [us] and Frame Index
+    uint64_t sensor_timestamp = 0;
+    int32_t frame_index = 0;
+
+    // Sensor Index (Multi source, 0 for single sensor)
+    uint32_t sensor = 0;
+
+    // Capture Time
+    std::chrono::steady_clock::time_point timestamp;
+
+    // Frame References (Keep buffers of depth_mat and user_map alive)
+    nite::UserTrackerFrameRef user_frame;
+    openni::VideoFrameRef depth_frame;
+
+    // Pooled Buffers of depth_mat and user_map (Synthetic Source)
+    ImageHandle depth_buffer;
+    ImageHandle user_buffer;
+
+    // Constructor (Reserve Users)
+    UserFrame()
+    {
+        users.reserve( USER_COUNT );
+    }
+
+    // Release References (Keep capacity of users for reuse)
+    void release()
+    {
+        depth_mat.release();
+        user_map.release();
+        user_frame.release();
+        depth_frame.release();
+        depth_buffer.reset();
+        user_buffer.reset();
+    }
+};
+
+// User Frame Source
+class UserSource
+{
+public:
+    // Destructor
+    virtual ~UserSource() = default;
+
+    // Read Frame (Block until next frame is available)
+    virtual void readFrame( UserFrame& frame ) = 0;
+
+    // Start Skeleton Tracking
+    virtual nite::Status startSkeletonTracking( const nite::UserId id ) = 0;
+
+    // Start Pose Detection
+    virtual nite::Status startPoseDetection( const nite::UserId id, const nite::PoseType type ) = 0;
+
+    // Convert Joint Coordinates to Depth
+    virtual nite::Status convertJointCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY ) = 0;
+
+    // Retrieve Number of Sensors (frame.sensor is less than this)
+    virtual uint32_t sensorCount() const
+    {
+        return 1;
+    }
+
+    // Reserve Pooled Buffers for Frames in Flight
+    virtual void reserveFrames( const uint32_t frames )
+    {
+        static_cast<void>( frames );
+    }
+};
+
+// Frame Source from NiTE User Tracker (Connected Device or Playback File)
+class UserTrackerSource : public UserSource
+{
+private:
+    // Device
+    openni::Device device;
+
+    // Tracker
+    nite::UserTracker user_tracker;
+
+    // Depth Size
+    uint32_t depth_width = 640;
+    uint32_t depth_height = 480;
+
+    // Depth Field of View [rad] (Read once from opened device, 0 if unknown)
+    float horizontal_fov = 0.0f;
+    float vertical_fov = 0.0f;
+
+    // Depth Intrinsics (Computed once per depth size)
+    Intrinsics intrinsics;
+    uint32_t intrinsics_width = 0;
+    uint32_t intrinsics_height = 0;
+
+public:
+    // Constructor
+    explicit UserTrackerSource( const std::string& uri );
+
+    // Read Frame
+    void readFrame( UserFrame& frame ) override;
+
+    // Start Skeleton Tracking
+    nite::Status startSkeletonTracking( const nite::UserId id ) override;
+
+    // Start Pose Detection
+    nite::Status startPoseDetection( const nite::UserId id, const nite::PoseType type ) override;
+
+    // Convert Joint Coordinates to Depth
+    nite::Status convertJointCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY ) override;
+};
+
+// Frame Source from Deterministic Synthetic Generator (No Sensor Required)
+class SyntheticUserSource : public UserSource
+{
+private:
+    // Configuration
+    uint32_t depth_width;
+    uint32_t depth_height;
+    uint32_t depth_fps;
+    uint32_t user_count;
+
+    // Camera Intrinsics (PrimeSense Field of View)
+    Intrinsics intrinsics;
+
+    // Depth and User Map Buffers (Frames hold them until released)
+    ImagePool image_pool;
+
+    // Status
+    uint32_t index = 0;
+    std::array<bool, USER_COUNT> skeleton_tracking;
+    std::array<std::array<bool, POSE_COUNT>, USER_COUNT> pose_detection;
+    std::array<std::array<bool, POSE_COUNT>, USER_COUNT> pose_held;
+    std::chrono::steady_clock::time_point next;
+
+public:
+    // Constructor
+    SyntheticUserSource( const uint32_t width, const uint32_t height, const uint32_t fps, const uint32_t users );
+
+    // Read Frame
+    void readFrame( UserFrame& frame ) override;
+
+    // Start Skeleton Tracking
+    nite::Status startSkeletonTracking( const nite::UserId id ) override;
+
+    // Start Pose Detection
+    nite::Status startPoseDetection( const nite::UserId id, const nite::PoseType type ) override;
+
+    // Convert Joint Coordinates to Depth
+    nite::Status convertJointCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY ) override;
+
+    // Reserve Pooled Buffers for Frames in Flight (Depth and user map of each frame)
+    void reserveFrames( const uint32_t frames ) override;
+
+private:
+    // Generate User
+    inline void generateUser( const uint32_t number, const float time, User& user );
+
+    // Generate Depth and User Map
+    inline void generateDepth( const std::vector<User>& users, cv::Mat& depth_mat, cv::Mat& user_map );
+};
+
+// Frame Source from Recorded Session (No Sensor and NiTE2 Required, depth and user map point into the mapped file)
+class SessionUserSource : public UserSource
+{
+private:
+    // Session
+    SessionReader reader;
+    ReplayClock clock;
+
+    // Blank Depth and User Map (Not Recorded)
+    cv::Mat blank_mat;
+
+public:
+    // Constructor (speed 0 replays as fast as possible)
+    SessionUserSource( const std::string& path, const float speed );
+
+    // Read Frame (Throw EndOfSource at end of session)
+    void readFrame( UserFrame& frame ) override;
+
+    // Start Skeleton Tracking (Recorded)
+    nite::Status startSkeletonTracking( const nite::UserId id ) override;
+
+    // Start Pose Detection (Recorded)
+    nite::Status startPoseDetection( const nite::UserId id, const nite::PoseType type ) override;
+
+    // Convert Joint Coordinates to Depth (Recorded Projection)
+    nite::Status convertJointCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY ) override;
+
+    // Seek to First Frame at or after Timestamp [us]
+    void seek( const uint64_t timestamp );
+
+    // Retrieve Session
+    const SessionReader& session() const;
+};
+
+// Joint Batch (Joints of All Tracked Users, Structure of Arrays)
+struct JointBatch : public PointBatch
+{
+    std::vector<uint32_t> user; // Index of User in Frame
+    std::vector<uint32_t> type; // Joint Type
+
+    // Clear Joints (Keep Capacity)
+    void clear()
+    {
+        PointBatch::clear();
+        user.clear();
+        type.clear();
+    }
+
+    // Resize Joints (Keep Capacity)
+    void resize( const size_t size )
+    {
+        PointBatch::resize( size );
+        user.resize( size );
+        type.resize( size );
+    }
+};
+
+// Project Joints (Confidence >= threshold of tracked users, in one batch by frame.intrinsics)
+void projectJoints( const UserFrame& frame, const float threshold, JointBatch& batch );
+
+// Project Joints of Snapshot
+void projectJoints( const SkeletonSnapshot& snapshot, const Intrinsics& intrinsics, const float threshold, JointBatch& batch );
+
+// Fill Skeleton Snapshot of Tracked Users of Frame (Users beyond USER_COUNT are dropped)
+void fillSnapshot( const UserFrame& frame, SkeletonSnapshot& snapshot );
+
+// Create Frame Source
+// ""                                  : Connected Device
+// "*.oni"                             : Playback File
+// "synthetic[:WIDTHxHEIGHT@FPS:USERS]" : Synthetic Generator (FPS 0 runs as fast as possible)
+// "session:PATH[@SPEED]"              : Recorded Session (SPEED 1 by default, 0 replays as fast as possible)
+// "multi:[URI,...]"                   : Multiple Sensors (All connected devices if empty)
+std::unique_ptr<UserSource> createUserSource( const std::string& uri );
+
+// Create Session Header of User Session (flags: SESSION_DEPTH and/or SESSION_USER_MAP)
+SessionHeader createUserSessionHeader( const UserFrame& frame, const uint32_t flags );
+
+// Append User Frame to Session
+void appendSession( SessionWriter& writer, const UserFrame& frame );
+
+// Convert Tracked Skeletons of User Frame to Skeleton Stream Record
+void convertSkeletonRecord( const UserFrame& frame, SkeletonRecord& record );
+
+// Convert Skeleton Snapshot to Skeleton Stream Record
+void convertSkeletonRecord( const SkeletonSnapshot& snapshot, SkeletonRecord& record );
+
+// Publish User Frame to Shared Memory
+void publishSharedFrame( SharedFrameWriter& writer, const UserFrame& frame );
+
+// Publish User Frame to Subscribers (Return false if the event loop was behind)
+bool publishStream( StreamPublisher& publisher, const UserFrame& frame );
+
+#endif // __USER_SOURCE__
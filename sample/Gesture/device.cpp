@@ -2,48 +2,14 @@
 #include "util.h"
 
 // Constructor
-Device::Device()
+Device::Device( std::unique_ptr<HandSource> source, const DepthKernel depth_kernel )
+    : Pipeline( std::move( source ), depth_kernel )
 {
-    // Initialize
-    initialize();
-}
-
-// Destructor
-Device::~Device()
-{
-    // Finalize
-    finalize();
-}
-
-// Processing
-void Device::run()
-{
-    // Main Loop
-    while( true ){
-        // Update Data
-        update();
-
-        // Draw Data
-        draw();
-
-        // Show Data
-        show();
-
-        // Key Check
-        const int32_t key = cv::waitKey( 10 );
-        if( key == 'q' ){
-            break;
-        }
+    // Initialize Gesture Status Text
+    for( uint32_t type = 0; type < GESTURE_TYPE_COUNT; type++ ){
+        gesture_status[type][0] = std::string( to_string( static_cast<nite::GestureType>( type ) ) ) + " is in progress";
+        gesture_status[type][1] = std::string( to_string( static_cast<nite::GestureType>( type ) ) ) + " is complete";
     }
-}
-
-// Initialize
-void Device::initialize()
-{
-    cv::setUseOptimized( true );
-
-    // Initiaize Nite2
-    NITE_CHECK( nite::NiTE::initialize() );
 
     // Initialize Hand
     initializeHand();
@@ -52,20 +18,29 @@ void Device::initialize()
 // Initialize Hand
 inline void Device::initializeHand()
 {
-    // Create Hand Tracker
-    NITE_CHECK( hand_tracker.create() );
-
     // Start Gesture Detection
-    NITE_CHECK( hand_tracker.startGestureDetection( nite::GestureType::GESTURE_WAVE ) );
-    NITE_CHECK( hand_tracker.startGestureDetection( nite::GestureType::GESTURE_CLICK ) );
-    //NITE_CHECK( hand_tracker.startGestureDetection( nite::GestureType::GESTURE_HAND_RAISE ) ); // Not Recommended
+    NITE_CHECK( source->startGestureDetection( nite::GestureType::GESTURE_WAVE ) );
+    NITE_CHECK( source->startGestureDetection( nite::GestureType::GESTURE_CLICK ) );
+    //NITE_CHECK( source->startGestureDetection( nite::GestureType::GESTURE_HAND_RAISE ) ); // Not Recommended
+}
+
+// Set Gesture Templates
+void Device::setGestures( const std::string& path )
+{
+    gesture_engine.reset( new GestureEngine( loadGestureTemplates( path ) ) );
+    template_names.clear();
+    for( uint32_t gesture = 0; gesture < gesture_engine->templateCount(); gesture++ ){
+        template_names.push_back( gesture_engine->templateName( gesture ) );
+    }
+
+    // Reserve Matches of Pooled Frames
+    frame_pool.prepare( []( HandFrame& frame ){ frame.matches.reserve( GESTURE_TRACK_COUNT ); } );
 }
 
-// Finalize
-void Device::finalize()
+// Retrieve Names of Templates
+const std::vector<std::string>& Device::getTemplateNames() const
 {
-    // Close Windows
-    cv::destroyAllWindows();
+    return template_names;
 }
 
 // Update Data
@@ -73,31 +48,26 @@ void Device::update()
 {
     // Update Hand
     updateHand();
-
-    // Update Depth
-    updateDepth();
 }
 
 // Update Hnad
 inline void Device::updateHand()
 {
     // Update Frame
-    NITE_CHECK( hand_tracker.readFrame( &hand_frame ) );
-}
+    readFrame();
+
+    // Match Trajectories of Tracked Hands
+    if( gesture_engine ){
+        for( const Gesture& gesture : capture_frame->gestures ){
+            if( gesture.is_complete ){
+                nite::HandId hand_id;
+                source->startHandTracking( gesture.current_position, &hand_id );
+            }
+        }
 
-// Update Depth
-inline void Device::updateDepth()
-{
-    // Retrieve Frame
-    depth_frame = hand_frame.getDepthFrame();
-    if( !depth_frame.isValid() ){
-        throw std::runtime_error( "failed can not retrieve depth frame" );
-        std::exit( EXIT_FAILURE );
+        gesture_engine->update( capture_frame->hands, capture_frame->sensor_timestamp );
+        capture_frame->matches = gesture_engine->getMatches();
     }
-
-    // Retrive Frame Size
-    depth_width = depth_frame.getWidth();
-    depth_height = depth_frame.getHeight();
 }
 
 // Draw Data
@@ -110,13 +80,6 @@ void Device::draw()
     drawGesture();
 }
 
-// Draw Depth
-inline void Device::drawDepth()
-{
-    // Create cv::Mat form Depth Frame
-    depth_mat = cv::Mat( depth_height, depth_width, CV_16UC1, const_cast<void*>( depth_frame.getData() ) );
-}
-
 // Draw Gesture
 inline void Device::drawGesture()
 {
@@ -124,51 +87,51 @@ inline void Device::drawGesture()
         return;
     }
 
-    // Scaling
-    depth_mat.convertTo( gesture_mat, CV_8U, -255.0 / 10000.0, 255.0 ); // 0-10000 -> 255(white)-0(black)
-    //depth_mat.convertTo( gesture_mat, CV_8U, 255.0 / 10000.0, 0.0 ); // 0-10000 -> 0(black)-255(white)
-
-    // Convert GRAY to BGR
-    cv::cvtColor( gesture_mat, gesture_mat, cv::COLOR_GRAY2BGR );
+    // Scaling and Convert GRAY to BGR (0-10000 -> 255(white)-0(black))
+    visualizeDepth( depth_mat, draw_mat, depth_kernel );
 
     // Retrieve Gestures
-    const nite::Array<nite::GestureData>& gestures = hand_frame.getGestures();
+    const std::vector<Gesture>& gestures = frame->gestures;
 
     // Draw Gestures
     uint32_t offset = 0;
-    for( int32_t index = 0; index < gestures.getSize(); index++, offset += 20 ){
+    for( int32_t index = 0; index < static_cast<int32_t>( gestures.size() ); index++, offset += 20 ){
         // Retrieve Gesture
-        const nite::GestureData& gesture = gestures[index];
+        const Gesture& gesture = gestures[index];
 
         // Draw Status
-        std::string status = to_string( gesture.getType() );
-        if( gesture.isInProgress() ){
-            status += " is in progress";
-        }
-        else if( gesture.isComplete() ){
-            status += " is complete";
+        if( ( !gesture.is_in_progress && !gesture.is_complete ) || GESTURE_TYPE_COUNT <= static_cast<uint32_t>( gesture.type ) ){
+            continue;
         }
-        else{
+        const std::string& status = gesture_status[gesture.type][gesture.is_in_progress ? 0 : 1];
+
+        cv::putText( draw_mat, status, cv::Point( 20, 20 + offset ), cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Vec3b( 0, 0, 0 ) );
+    }
+
+    // Draw Matched Templates at Hand Position
+    for( const GestureMatch& match : frame->matches ){
+        float x, y;
+        const nite::Point3f& position = match.position;
+        if( template_names.size() <= match.gesture || !projectPoint( frame->intrinsics, position.x, position.y, position.z, &x, &y ) ){
             continue;
         }
 
-        cv::putText( gesture_mat, status, cv::Point( 20, 20 + offset ), cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Vec3b( 0, 0, 0 ) );
-        std::cout << status << std::endl;
+        cv::putText( draw_mat, template_names[match.gesture], cv::Point( static_cast<int32_t>( x ), static_cast<int32_t>( y ) ), cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Vec3b( 0, 0, 255 ) );
     }
 }
 
 // Convert Gesture Type to String
-inline std::string Device::to_string( nite::GestureType type )
+inline const char* Device::to_string( nite::GestureType type )
 {
     switch( type ){
         case nite::GestureType::GESTURE_WAVE:
-            return std::string( "Wave" );
+            return "Wave";
         case nite::GestureType::GESTURE_CLICK:
-            return std::string( "Click" );
+            return "Click";
         case nite::GestureType::GESTURE_HAND_RAISE:
-            return std::string( "Hand Raise" );
+            return "Hand Raise";
         default:
-            return std::string( "Unknown Gesture" );
+            return "Unknown Gesture";
     }
 }
 
@@ -182,10 +145,44 @@ void Device::show()
 // Show Gesture
 inline void Device::showGesture()
 {
-    if( gesture_mat.empty() ){
+    if( image.mat.empty() ){
         return;
     }
 
     // Show Gesture Image
-    cv::imshow( "Gesture", gesture_mat );
+    cv::imshow( "Gesture", image.mat );
+}
+
+// Write Data
+void Device::write( std::ostream& stream )
+{
+    // Frame
+    stream << "{\"frame\":" << frame->frame_index << ",\"timestamp\":" << frame->sensor_timestamp;
+
+    // Gestures (Progress and Complete)
+    stream << ",\"gestures\":[";
+    bool first = true;
+    for( const Gesture& gesture : frame->gestures ){
+        const nite::Point3f& position = gesture.current_position;
+        stream << ( first ? "" : "," ) << "{\"type\":\"" << to_string( gesture.type ) << "\",\"position\":[" << position.x << "," << position.y << "," << position.z << "]";
+        stream << ",\"in_progress\":" << gesture.is_in_progress << ",\"complete\":" << gesture.is_complete << "}";
+        first = false;
+    }
+    stream << "]";
+
+    // Matched Templates (Gesture engine)
+    if( !template_names.empty() ){
+        stream << ",\"matches\":[";
+        first = true;
+        for( const GestureMatch& match : frame->matches ){
+            const nite::Point3f& position = match.position;
+            stream << ( first ? "" : "," ) << "{\"gesture\":";
+            writeJSONString( stream, template_names[match.gesture] );
+            stream << ",\"hand\":" << match.id << ",\"distance\":" << match.distance;
+            stream << ",\"position\":[" << position.x << "," << position.y << "," << position.z << "]}";
+            first = false;
+        }
+        stream << "]";
+    }
+    stream << "}\n";
 }
@@ -1,74 +1,69 @@
 #ifndef __DEVICE__
 #define __DEVICE__
 
+#include <OpenNI.h>
 #include <NiTE.h>
 #include <opencv2/opencv.hpp>
 
+#include "pipeline.h"
+#include "gesture_engine.h"
+#include "hand_source.h"
+
 #include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Gesture Types (Wave, Click and Hand Raise)
+#define GESTURE_TYPE_COUNT 3
 
-class Device
+class Device : public Pipeline<HandSource, HandFrame>
 {
 private:
-    // Tracker
-    nite::HandTracker hand_tracker;
+    // Gesture Status Text of each Type (In Progress and Complete, built once)
+    std::array<std::array<std::string, 2>, GESTURE_TYPE_COUNT> gesture_status;
 
-    // Hand Buffer
-    nite::HandTrackerFrameRef hand_frame;
-    cv::Mat gesture_mat;
-
-    // Depth Buffer
-    openni::VideoFrameRef depth_frame;
-    cv::Mat depth_mat;
-    uint32_t depth_width = 640;
-    uint32_t depth_height = 480;
-    uint32_t depth_fps = 30;
+    // Trajectory Gesture Engine (Owned by Capture Thread, NiTE gestures only if not set)
+    std::unique_ptr<GestureEngine> gesture_engine;
+    std::vector<std::string> template_names; // Names of Templates (Read by Process Thread)
 
 public:
     // Constructor
-    Device();
+    explicit Device( std::unique_ptr<HandSource> source, const DepthKernel depth_kernel = DEPTH_KERNEL_SIMD );
 
-    // Destructor
-    ~Device();
+    // Set Gesture Templates (Template file of gesture_engine.h)
+    void setGestures( const std::string& path );
 
-    // Processing
-    void run();
+    // Retrieve Names of Templates (Empty if not set)
+    const std::vector<std::string>& getTemplateNames() const;
 
 private:
-    // Initialize
-    void initialize();
-
     // Initialize Hand
     inline void initializeHand();
 
-    // Finalize
-    void finalize();
-
     // Update Data
-    void update();
+    void update() override;
 
     // Update Hand
     inline void updateHand();
 
-    // Update Depth
-    inline void updateDepth();
-
     // Draw Data
-    void draw();
+    void draw() override;
 
     // Draw Gesture
     inline void drawGesture();
 
-    // Draw Depth
-    inline void drawDepth();
-
     // Convert Gesture Type to String
-    inline std::string to_string( nite::GestureType type );
+    inline const char* to_string( nite::GestureType type );
 
     // Show Data
-    void show();
+    void show() override;
 
     // Show Gesture
     inline void showGesture();
+
+    // Write Data
+    void write( std::ostream& stream ) override;
 };
 
 #endif // __DEVICE__
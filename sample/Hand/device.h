@@ -5,94 +5,41 @@
 #include <NiTE.h>
 #include <opencv2/opencv.hpp>
 
-#include <array>
+#include "pipeline.h"
+#include "hand_source.h"
 
-#define HAND_COUNT 6
+#include <memory>
 
-// Specify Device
-// For RealSense https://github.com/IntelRealSense/librealsense/issues/2825
-#define PRIMESENSOR 0
-#define REALSENSE 1
-#define DEVICE PRIMESENSOR
-
-#if (DEVICE == REALSENSE)
-#define RS2_PROJECT_POINT_TO_PIXEL 0x1000
-struct Rs2PointPixel
+class Device : public Pipeline<HandSource, HandFrame>
 {
-    float point[3];
-    float pixel[2];
-};
-#endif
-
-class Device
-{
-private:
-    // Device
-    openni::Device device;
-
-    // Tracker
-    nite::HandTracker hand_tracker;
-
-    // Hand Buffer
-    nite::HandTrackerFrameRef hand_frame;
-    cv::Mat hand_mat;
-    std::array<cv::Vec3b, HAND_COUNT> colors;
-
-    // Depth Buffer
-    openni::VideoFrameRef depth_frame;
-    cv::Mat depth_mat;
-    uint32_t depth_width = 640;
-    uint32_t depth_height = 480;
-    uint32_t depth_fps = 30;
-
 public:
     // Constructor
-    Device();
-
-    // Destructor
-    ~Device();
-
-    // Processing
-    void run();
+    explicit Device( std::unique_ptr<HandSource> source, const DepthKernel depth_kernel = DEPTH_KERNEL_SIMD );
 
 private:
-    // Initialize
-    void initialize();
-
     // Initialize Hand
     inline void initializeHand();
 
-    // Finalize
-    void finalize();
-
     // Update Data
-    void update();
+    void update() override;
 
     // Update Hand
     inline void updateHand();
 
-    // Update Depth
-    inline void updateDepth();
-
     // Draw Data
-    void draw();
+    void draw() override;
 
     // Draw Hand
     inline void drawHand();
 
-    // Draw Depth
-    inline void drawDepth();
-
-    #if (DEVICE == REALSENSE)
-    // Convert Joint Coordinates to Depth for RealSense
-    inline nite::Status convertJointCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY );
-    #endif
-
     // Show Data
-    void show();
+    void show() override;
 
     // Show Hand
     inline void showHand();
+
+    // Write Data
+    void write( std::ostream& stream ) override;
 };
 
 #endif // __DEVICE__
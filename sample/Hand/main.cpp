@@ -2,11 +2,34 @@
 #include <sstream>
 
 #include "device.h"
+#include "options.h"
+#include "services.h"
 
 int main( int argc, char* argv[] )
 {
     try{
-        Device device;
+        // Options (Positional source and kernel, and "--NAME VALUE")
+        const Options options( argc, argv, 2, { "sink", "events", "shared", "publish" } );
+
+        // Source ("": Connected Device, "*.oni": Playback File, "synthetic[:WIDTHxHEIGHT@FPS:HANDS]": Synthetic Generator)
+        const std::string uri = options.positional( 0 );
+
+        // Depth Visualization Kernel ("opencv", "lut" or "simd")
+        const DepthKernel depth_kernel = parseDepthKernel( options.positional( 1, "simd" ) );
+
+        Device device( createHandSource( uri ), depth_kernel );
+
+        // Services ("--publish", "--shared" and "--events", see services.h)
+        SampleServices services( options );
+        services.attach( device );
+
+        // Headless Mode ("stdout", "file:PATH", "tcp:HOST:PORT" or "null", until SIGINT/SIGTERM)
+        if( options.has( "sink" ) ){
+            std::unique_ptr<Sink> sink = createSink( options.get( "sink" ) );
+            device.headless( *sink );
+            return 0;
+        }
+
         device.run();
     } catch( std::exception& ex ){
         std::cout << ex.what() << std::endl;
@@ -0,0 +1,60 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "allocation.h"
+#include "benchmark.h"
+#include "device.h"
+
+// Benchmark
+// bench_pose [source] [frames] [serial|pipeline|headless] [json|csv] [display] [opencv|lut|simd] [poses]
+int main( int argc, char* argv[] )
+{
+    try{
+        // Parse Arguments
+        const std::string uri = ( 1 < argc ) ? argv[1] : "synthetic:640x480@0";
+        const uint32_t frames = ( 2 < argc ) ? static_cast<uint32_t>( std::stoul( argv[2] ) ) : 1000;
+        const std::string mode = ( 3 < argc ) ? argv[3] : "serial";
+        const std::string format = ( 4 < argc ) ? argv[4] : "json";
+        const bool display = ( 5 < argc ) && ( std::string( argv[5] ) == "display" );
+        const DepthKernel depth_kernel = parseDepthKernel( ( 6 < argc ) ? argv[6] : "simd" );
+        const std::string poses = ( 7 < argc ) ? argv[7] : "none";
+
+        // Run Benchmark
+        Benchmark benchmark( "Pose", uri, mode + "/" + depthKernelName( depth_kernel ) );
+        benchmark.countAllocations( allocationCount );
+        {
+            Device device( createUserSource( uri ), depth_kernel );
+            if( poses != "none" ){
+                device.setPoses( poses );
+            }
+            if( mode == "headless" ){
+                // Headless (Update and Write to Null Sink)
+                NullSink sink;
+                benchmark.begin( frames );
+                benchmark.finish( device.headless( sink, &benchmark, frames ) );
+            }
+            else{
+                device.benchmark( benchmark, frames, mode == "pipeline", display );
+            }
+        }
+
+        // Write Result
+        if( format == "csv" ){
+            benchmark.writeCSV( std::cout );
+        }
+        else{
+            benchmark.writeJSON( std::cout );
+        }
+
+        // Fail if Steady-State Frames Allocate
+        if( benchmark.allocates() ){
+            throw std::runtime_error( "failed steady-state frames allocate" );
+        }
+    } catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
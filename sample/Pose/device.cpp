@@ -2,94 +2,49 @@
 #include "util.h"
 
 // Constructor
-Device::Device()
+Device::Device( std::unique_ptr<UserSource> source, const DepthKernel depth_kernel )
+    : Pipeline( std::move( source ), depth_kernel )
 {
-    // Initialize
-    initialize();
-}
-
-// Destructor
-Device::~Device()
-{
-    // Finalize
-    finalize();
-}
-
-// Processing
-void Device::run()
-{
-    // Main Loop
-    while( true ){
-        // Update Data
-        update();
-
-        // Draw Data
-        draw();
-
-        // Show Data
-        show();
-
-        // Key Check
-        const int32_t key = cv::waitKey( 10 );
-        if( key == 'q' ){
-            break;
+    // Initialize Pose Status Text
+    const std::array<const char*, POSE_STATUS_COUNT> states = { { " is entered", " is held", " is exited", " is not detected" } };
+    for( uint32_t type = 0; type < POSE_COUNT; type++ ){
+        for( uint32_t status = 0; status < POSE_STATUS_COUNT; status++ ){
+            pose_status[type][status] = std::string( to_string( static_cast<nite::PoseType>( type ) ) ) + states[status];
         }
     }
 }
 
-// Initialize
-void Device::initialize()
+// Set Skeleton Stream Encoding
+void Device::setStreamEncoding( const StreamEncoding encoding )
 {
-    cv::setUseOptimized( true );
-
-    // Initialize OpenNI2
-    OPENNI_CHECK( openni::OpenNI::initialize() );
-
-    // Initiaize Nite2
-    NITE_CHECK( nite::NiTE::initialize() );
-
-    // Initialize User
-    initializeUser();
+    // Skeleton stream records don't carry sensor index
+    if( 1 < source->sensorCount() ){
+        throw std::runtime_error( "failed binary skeleton stream doesn't support multiple sensors" );
+    }
 
-    // Initalize Color Table for Visualization
-    colors[0] = cv::Vec3b( 255,   0,   0 ); // Blue
-    colors[1] = cv::Vec3b(   0, 255,   0 ); // Green
-    colors[2] = cv::Vec3b(   0,   0, 255 ); // Red
-    colors[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
-    colors[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
-    colors[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
+    stream_writer.reset( new SkeletonStreamWriter( encoding ) );
 }
 
-// Initialize User
-inline void Device::initializeUser()
+// Set Custom Poses
+void Device::setPoses( const std::string& path )
 {
-    #if (DEVICE != REALSENSE)
-    // Create User Tracker
-    NITE_CHECK( user_tracker.create() );
-    #else
-    // Retrive Connected Devices List
-    openni::Array<openni::DeviceInfo> device_info_list;
-    openni::OpenNI::enumerateDevices( &device_info_list );
-    if( !device_info_list.getSize() ){
-        throw std::runtime_error( "failed could not find devices" );
-        std::exit( EXIT_FAILURE );
+    // Pose state follows user ids, which are unique per sensor only
+    pose_engines.assign( source->sensorCount(), PoseEngine( loadPoseDefinitions( path ) ) );
+    const PoseEngine& pose_engine = pose_engines.front();
+    pose_names.clear();
+    for( uint32_t pose = 0; pose < pose_engine.poseCount(); pose++ ){
+        pose_names.push_back( pose_engine.poseName( pose ) );
     }
 
-    // Open Device
-    const openni::DeviceInfo& device_info = device_info_list[0];
-    const std::string device_uri = device_info.getUri();
-    OPENNI_CHECK( device.open( device_uri.c_str() ) );
-
-    // Create User Tracker
-    NITE_CHECK( user_tracker.create( &device ) );
-    #endif
+    // Reserve Pose Status of Pooled Frames
+    const size_t size = pose_engine.getStatuses().size();
+    frame_pool.prepare( [size]( UserFrame& frame ){ frame.pose_status.reserve( size ); } );
 }
 
-// Finalize
-void Device::finalize()
+// Retrieve Names of Custom Poses
+const std::vector<std::string>& Device::getPoseNames() const
 {
-    // Close Windows
-    cv::destroyAllWindows();
+    return pose_names;
 }
 
 // Update Data
@@ -103,66 +58,56 @@ void Device::update()
 
     // Update Pose
     updatePose();
-
-    // Update Depth
-    updateDepth();
 }
 
 // Update User
 inline void Device::updateUser()
 {
     // Update Frame
-    NITE_CHECK( user_tracker.readFrame( &user_frame ) );
+    readFrame();
 }
 
 // Update Skeleton
 inline void Device::updateSkeleton()
 {
     // Retrieve User
-    const nite::Array<nite::UserData>& users = user_frame.getUsers();
+    const std::vector<User>& users = capture_frame->users;
 
     // Start Tracking
-    #pragma omp parallel for
-    for( int32_t i = 0; i < users.getSize(); i++ ){
-        const nite::UserData& user = users[i];
-        if( user.isNew() ){
+    for( uint32_t i = 0; i < users.size(); i++ ){
+        const User& user = users[i];
+        if( user.is_new ){
             // Start Skeleton Tracking
-            NITE_CHECK( user_tracker.startSkeletonTracking( user.getId() ) );
+            NITE_CHECK( source->startSkeletonTracking( user.id ) );
         }
     }
+
+    // Fill Skeleton Snapshot (Read by draw and write)
+    fillSnapshot( *capture_frame, capture_frame->skeleton );
 }
 
 // Update Pose
 inline void Device::updatePose()
 {
     // Retrieve User
-    const nite::Array<nite::UserData>& users = user_frame.getUsers();
+    const std::vector<User>& users = capture_frame->users;
 
     // Start Tracking
-    #pragma omp parallel for
-    for( int32_t i = 0; i < users.getSize(); i++ ){
-        const nite::UserData& user = users[i];
-        if( user.isNew() ){
+    for( uint32_t i = 0; i < users.size(); i++ ){
+        const User& user = users[i];
+        if( user.is_new ){
             // Start Pose Trtacking
-            NITE_CHECK( user_tracker.startPoseDetection( user.getId(), nite::PoseType::POSE_PSI ) );
-            NITE_CHECK( user_tracker.startPoseDetection( user.getId(), nite::PoseType::POSE_CROSSED_HANDS ) );
+            NITE_CHECK( source->startPoseDetection( user.id, nite::PoseType::POSE_PSI ) );
+            NITE_CHECK( source->startPoseDetection( user.id, nite::PoseType::POSE_CROSSED_HANDS ) );
         }
     }
-}
 
-// Update Depth
-inline void Device::updateDepth()
-{
-    // Retrieve Frame
-    depth_frame = user_frame.getDepthFrame();
-    if( !depth_frame.isValid() ){
-        throw std::runtime_error( "failed can not retrieve depth frame" );
-        std::exit( EXIT_FAILURE );
+    // Evaluate Custom Poses of Tracked Users (Engine of sensor of frame)
+    if( !pose_engines.empty() ){
+        PoseEngine& pose_engine = pose_engines[capture_frame->sensor];
+        pose_engine.evaluate( capture_frame->skeleton );
+        capture_frame->pose_status = pose_engine.getStatuses();
     }
-
-    // Retrive Frame Size
-    depth_width = depth_frame.getWidth();
-    depth_height = depth_frame.getHeight();
 }
 
 // Draw Data
@@ -178,13 +123,6 @@ void Device::draw()
     drawPose();
 }
 
-// Draw Depth
-inline void Device::drawDepth()
-{
-    // Create cv::Mat form Depth Frame
-    depth_mat = cv::Mat( depth_height, depth_width, CV_16UC1, const_cast<void*>( depth_frame.getData() ) );
-}
-
 // Draw Skeleton
 inline void Device::drawSkeleton()
 {
@@ -192,58 +130,20 @@ inline void Device::drawSkeleton()
         return;
     }
 
-    // Scaling
-    depth_mat.convertTo( skeleton_mat, CV_8U, -255.0 / 10000.0, 255.0 ); // 0-10000 -> 255(white)-0(black)
-    //depth_mat.convertTo( skeleton_mat, CV_8U, 255.0 / 10000.0, 0.0 ); // 0-10000 -> 0(black)-255(white)
-
-    // Convert GRAY to BGR
-    cv::cvtColor( skeleton_mat, skeleton_mat, cv::COLOR_GRAY2BGR );
+    // Scaling and Convert GRAY to BGR (0-10000 -> 255(white)-0(black))
+    visualizeDepth( depth_mat, draw_mat, depth_kernel );
 
-    // Retrieve User
-    const nite::Array<nite::UserData>& users = user_frame.getUsers();
+    // Project Joints of Tracked Users (One Batch by Intrinsics of Frame)
+    constexpr float threshold = 0.7f;
+    projectJoints( frame->skeleton, frame->intrinsics, threshold, joint_batch );
 
     // Draw Skeleton Joints
-    #pragma omp parallel for
-    for( uint32_t index = 0; index < users.getSize(); index++ ){
-        // Retrieve User
-        const nite::UserData& user = users[index];
-        if( user.isLost() ){
-            continue;
-        }
-
-        // Retrieve Skeleton
-        const nite::Skeleton& skeleton = user.getSkeleton();
-        if( skeleton.getState() != nite::SkeletonState::SKELETON_TRACKED ){
-            continue;
-        }
-
-        // Draw Joints
-        constexpr float threshold = 0.7f;
-        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
-            // Retrieve Joint
-            const nite::SkeletonJoint& joint = skeleton.getJoint( static_cast<nite::JointType>( type ) );
-            if( joint.getPositionConfidence() < threshold ){
-                continue;
-            }
-
-            // Retrieve Joint Position
-            const nite::Point3f& position = joint.getPosition();
-
-            // Convert Joint Coordinates to Depth
-            float x, y;
-            #if (DEVICE != REALSENSE)
-            NITE_CHECK( user_tracker.convertJointCoordinatesToDepth( position.x, position.y, position.z, &x, &y ) ); // for PrimeSensor
-            #else
-            NITE_CHECK( convertJointCoordinatesToDepth( position.x, position.y, position.z, &x, &y ) ); // for RealSense
-            #endif
-
-            // Draw Joint
-            const uint32_t depth_x = static_cast<uint32_t>( x );
-            const uint32_t depth_y = static_cast<uint32_t>( y );
-            if( 0 <= depth_x && depth_x < depth_width && 0 <= depth_y && depth_y < depth_height ){
-                const cv::Point point( depth_x, depth_y );
-                cv::circle( skeleton_mat, point, 5, colors[index], -1 );
-            }
+    for( size_t i = 0; i < joint_batch.size(); i++ ){
+        const float x = joint_batch.depth_x[i];
+        const float y = joint_batch.depth_y[i];
+        if( 0.0f <= x && x < depth_width && 0.0f <= y && y < depth_height ){
+            const cv::Point point( static_cast<int32_t>( x ), static_cast<int32_t>( y ) );
+            cv::circle( draw_mat, point, 5, colors[joint_batch.user[i] % colors.size()], -1 );
         }
     }
 }
@@ -251,32 +151,29 @@ inline void Device::drawSkeleton()
 // Draw Pose
 inline void Device::drawPose()
 {
-    if( skeleton_mat.empty() ){
+    // Draw over Skeleton (No copy of skeleton image)
+    if( draw_mat.empty() ){
         return;
     }
 
-    skeleton_mat.copyTo( pose_mat );
-
     // Retrieve Users
-    const nite::Array<nite::UserData>& users = user_frame.getUsers();
+    const std::vector<User>& users = frame->users;
 
     // Draw Pose Status
-    #pragma omp parallel for
-    for( uint32_t index = 0; index < users.getSize(); index++ ){
+    for( uint32_t index = 0; index < users.size(); index++ ){
         // Retrieve User
-        const nite::UserData& user = users[index];
-        if( user.isLost() ){
+        const User& user = users[index];
+        if( user.is_lost ){
             continue;
         }
 
         // Check Visible
-        if( !user.isVisible() ){
+        if( !user.is_visible ){
             continue;
         }
 
         // Check Tracked
-        const nite::Skeleton& skeleton = user.getSkeleton();
-        if( skeleton.getState() != nite::SkeletonState::SKELETON_TRACKED ){
+        if( user.skeleton_state != nite::SkeletonState::SKELETON_TRACKED ){
             continue;
         }
 
@@ -284,56 +181,51 @@ inline void Device::drawPose()
         uint32_t offset = 0;
         for( uint32_t type = 0; type < POSE_COUNT; type++, offset += 20 ){
             // Retrieve Pose
-            const nite::PoseData& pose = user.getPose( static_cast<nite::PoseType>( type ) );
+            const Pose& pose = user.poses[type];
 
             // Draw Status
-            std::string status = to_string( pose.getType() );
-            if( pose.isEntered() ){
-                status += " is entered";
-            }
-            else if( pose.isHeld() ){
-                status += " is held";
+            uint32_t status = 3; // Not Detected
+            if( pose.is_entered ){
+                status = 0;
             }
-            else if( pose.isExited() ){
-                status += " is exited";
+            else if( pose.is_held ){
+                status = 1;
             }
-            else{
-                status += " is not detected";
+            else if( pose.is_exited ){
+                status = 2;
             }
 
-            cv::putText( pose_mat, status, cv::Point( 20, 20 + offset ), cv::FONT_HERSHEY_SIMPLEX, 0.5, colors[index] );
+            cv::putText( draw_mat, pose_status[type][status], cv::Point( 20, 20 + offset ), cv::FONT_HERSHEY_SIMPLEX, 0.5, colors[index % colors.size()] );
         }
     }
-}
-
-#if (DEVICE == REALSENSE)
-// Convert Joint Coordinates To Depth for RealSense
-inline nite::Status Device::convertJointCoordinatesToDepth( const float x, const float y, const float z, float * pOutX, float * pOutY )
-{
-    Rs2PointPixel proj = { 0.0 };
-    proj.point[0] = x;
-    proj.point[1] = y;
-    proj.point[2] = z;
-
-    OPENNI_CHECK( device.invoke( RS2_PROJECT_POINT_TO_PIXEL, reinterpret_cast<void*>( &proj ), static_cast<int32_t>( sizeof( proj ) ) ) );
 
-    *pOutX = proj.pixel[0];
-    *pOutY = depth_height - proj.pixel[1];
-
-    return nite::Status::STATUS_OK;
+    // Draw Entered and Held Custom Poses (Color of user)
+    const SkeletonSnapshot& skeleton = frame->skeleton;
+    const size_t poses = pose_names.size();
+    if( !poses || frame->pose_status.size() != USER_COUNT * poses ){
+        return;
+    }
+    uint32_t offset = 20 + POSE_COUNT * 20;
+    for( uint32_t number = 0; number < skeleton.count; number++ ){
+        for( size_t pose = 0; pose < poses; pose++ ){
+            if( frame->pose_status[number * poses + pose] & ( POSE_ENTERED | POSE_HELD ) ){
+                cv::putText( draw_mat, pose_names[pose], cv::Point( 20, offset ), cv::FONT_HERSHEY_SIMPLEX, 0.5, colors[skeleton.users[number] % colors.size()] );
+                offset += 20;
+            }
+        }
+    }
 }
-#endif
 
 // Convert Pose Type to String
-inline std::string Device::to_string( nite::PoseType type )
+inline const char* Device::to_string( nite::PoseType type )
 {
     switch( type ){
         case nite::PoseType::POSE_PSI:
-            return std::string( "Psi" );
+            return "Psi";
         case nite::PoseType::POSE_CROSSED_HANDS:
-            return std::string( "Crossed Hands" );
+            return "Crossed Hands";
         default:
-            return std::string( "Unknown Pose" );
+            return "Unknown Pose";
     }
 }
 
@@ -347,10 +239,63 @@ void Device::show()
 // Show Pose
 inline void Device::showPose()
 {
-    if( pose_mat.empty() ){
+    if( image.mat.empty() ){
         return;
     }
 
     // Show Pose Image
-    cv::imshow( "Pose", pose_mat );
+    cv::imshow( "Pose", image.mat );
+}
+
+// Write Data
+void Device::write( std::ostream& stream )
+{
+    // Binary Skeleton Stream
+    if( stream_writer ){
+        convertSkeletonRecord( frame->skeleton, stream_record );
+        stream_writer->write( stream_record, stream );
+        return;
+    }
+
+    // Frame
+    stream << "{\"frame\":" << frame->frame_index << ",\"timestamp\":" << frame->sensor_timestamp;
+
+    // Sensor (Multiple Sensors)
+    if( 1 < source->sensorCount() ){
+        stream << ",\"sensor\":" << frame->sensor;
+    }
+
+    // Users (Tracked Skeletons and Poses of Snapshot)
+    const SkeletonSnapshot& skeleton = frame->skeleton;
+    stream << ",\"users\":[";
+    for( uint32_t number = 0; number < skeleton.count; number++ ){
+        stream << ( number ? "," : "" ) << "{\"id\":" << skeleton.ids[number];
+
+        // Joints (x, y, z [mm], position confidence)
+        stream << ",\"joints\":[";
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const size_t lane = SkeletonSnapshot::lane( number, type );
+            stream << ( type ? "," : "" ) << "[" << skeleton.x[lane] << "," << skeleton.y[lane] << "," << skeleton.z[lane] << "," << skeleton.position_confidence[lane] << "]";
+        }
+        stream << "]";
+
+        // Poses (entered, held, exited)
+        stream << ",\"poses\":{";
+        for( uint32_t type = 0; type < POSE_COUNT; type++ ){
+            const uint8_t poses = skeleton.poses[number] >> ( type * 3 );
+            stream << ( type ? "," : "" ) << "\"" << to_string( static_cast<nite::PoseType>( type ) ) << "\":[" << static_cast<bool>( poses & 0x01 ) << "," << static_cast<bool>( poses & 0x02 ) << "," << static_cast<bool>( poses & 0x04 ) << "]";
+        }
+
+        // Custom Poses (entered, held, exited)
+        if( frame->pose_status.size() == USER_COUNT * pose_names.size() ){
+            for( size_t pose = 0; pose < pose_names.size(); pose++ ){
+                const uint8_t status = frame->pose_status[number * pose_names.size() + pose];
+                stream << ",";
+                writeJSONString( stream, pose_names[pose] );
+                stream << ":[" << static_cast<bool>( status & POSE_ENTERED ) << "," << static_cast<bool>( status & POSE_HELD ) << "," << static_cast<bool>( status & POSE_EXITED ) << "]";
+            }
+        }
+        stream << "}}";
+    }
+    stream << "]}\n";
 }
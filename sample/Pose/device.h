@@ -5,71 +5,51 @@
 #include <NiTE.h>
 #include <opencv2/opencv.hpp>
 
-#include <array>
+#include "pipeline.h"
+#include "pose_engine.h"
+#include "user_source.h"
 
-#define USER_COUNT 6
-#define JOINT_COUNT 15
-#define POSE_COUNT 2
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
 
-// Specify Device
-// For RealSense https://github.com/IntelRealSense/librealsense/issues/2825
-#define PRIMESENSOR 0
-#define REALSENSE 1
-#define DEVICE PRIMESENSOR
+// Pose Detection Status (Entered, Held, Exited and Not Detected)
+#define POSE_STATUS_COUNT 4
 
-#if (DEVICE == REALSENSE)
-#define RS2_PROJECT_POINT_TO_PIXEL 0x1000
-struct Rs2PointPixel
-{
-    float point[3];
-    float pixel[2];
-};
-#endif
-
-class Device
+class Device : public Pipeline<UserSource, UserFrame>
 {
 private:
-    // Device
-    openni::Device device;
+    // Projected Joints (Owned by Process Thread)
+    JointBatch joint_batch;
 
-    // Tracker
-    nite::UserTracker user_tracker;
+    // Skeleton Stream Writer (JSON if not set)
+    std::unique_ptr<SkeletonStreamWriter> stream_writer;
+    SkeletonRecord stream_record;
 
-    // User Buffer
-    nite::UserTrackerFrameRef user_frame;
-    cv::Mat skeleton_mat;
-    cv::Mat pose_mat;
-    std::array<cv::Vec3b, USER_COUNT> colors;
+    // Pose Status Text (Built once)
+    std::array<std::array<std::string, POSE_STATUS_COUNT>, POSE_COUNT> pose_status;
 
-    // Depth Buffer
-    openni::VideoFrameRef depth_frame;
-    cv::Mat depth_mat;
-    uint32_t depth_width = 640;
-    uint32_t depth_height = 480;
-    uint32_t depth_fps = 30;
+    // Custom Pose Engines (One per Sensor, Owned by Capture Thread, NiTE poses only if empty)
+    std::vector<PoseEngine> pose_engines;
+    std::vector<std::string> pose_names; // Names of Custom Poses (Read by Process Thread)
 
 public:
     // Constructor
-    Device();
-
-    // Destructor
-    ~Device();
+    explicit Device( std::unique_ptr<UserSource> source, const DepthKernel depth_kernel = DEPTH_KERNEL_SIMD );
 
-    // Processing
-    void run();
+    // Set Skeleton Stream Encoding (Headless mode)
+    void setStreamEncoding( const StreamEncoding encoding );
 
-private:
-    // Initialize
-    void initialize();
+    // Set Custom Poses (Pose definition file of pose_engine.h)
+    void setPoses( const std::string& path );
 
-    // Initialize User
-    inline void initializeUser();
-
-    // Finalize
-    void finalize();
+    // Retrieve Names of Custom Poses (Empty if not set)
+    const std::vector<std::string>& getPoseNames() const;
 
+private:
     // Update Data
-    void update();
+    void update() override;
 
     // Update User
     inline void updateUser();
@@ -80,11 +60,8 @@ private:
     // Update Pose
     inline void updatePose();
 
-    // Update Depth
-    inline void updateDepth();
-
     // Draw Data
-    void draw();
+    void draw() override;
 
     // Draw Skeleton
     inline void drawSkeleton();
@@ -92,22 +69,17 @@ private:
     // Draw Pose
     inline void drawPose();
 
-    // Draw Depth
-    inline void drawDepth();
-
-    #if (DEVICE == REALSENSE)
-    // Convert Joint Coordinates to Depth for RealSense
-    inline nite::Status convertJointCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY );
-    #endif
-
     // Convert Pose Type to String
-    inline std::string to_string( nite::PoseType type );
+    inline const char* to_string( nite::PoseType type );
 
     // Show Data
-    void show();
+    void show() override;
 
     // Show Pose
     inline void showPose();
+
+    // Write Data
+    void write( std::ostream& stream ) override;
 };
 
 #endif // __DEVICE__
@@ -2,94 +2,29 @@
 #include "util.h"
 
 // Constructor
-Device::Device()
+Device::Device( std::unique_ptr<UserSource> source, const DepthKernel depth_kernel )
+    : Pipeline( std::move( source ), depth_kernel ),
+      filters( this->source->sensorCount() )
 {
-    // Initialize
-    initialize();
 }
 
-// Destructor
-Device::~Device()
+// Set Skeleton Stream Encoding
+void Device::setStreamEncoding( const StreamEncoding encoding )
 {
-    // Finalize
-    finalize();
-}
-
-// Processing
-void Device::run()
-{
-    // Main Loop
-    while( true ){
-        // Update Data
-        update();
-
-        // Draw Data
-        draw();
-
-        // Show Data
-        show();
-
-        // Key Check
-        const int32_t key = cv::waitKey( 10 );
-        if( key == 'q' ){
-            break;
-        }
+    // Skeleton stream records don't carry sensor index
+    if( 1 < source->sensorCount() ){
+        throw std::runtime_error( "failed binary skeleton stream doesn't support multiple sensors" );
     }
-}
-
-// Initialize
-void Device::initialize()
-{
-    cv::setUseOptimized( true );
-
-    // Initialize OpenNI2
-    OPENNI_CHECK( openni::OpenNI::initialize() );
 
-    // Initiaize Nite2
-    NITE_CHECK( nite::NiTE::initialize() );
-
-    // Initialize User
-    initializeUser();
-
-    // Initalize Color Table for Visualization
-    colors[0] = cv::Vec3b( 255,   0,   0 ); // Blue
-    colors[1] = cv::Vec3b(   0, 255,   0 ); // Green
-    colors[2] = cv::Vec3b(   0,   0, 255 ); // Red
-    colors[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
-    colors[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
-    colors[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
+    stream_writer.reset( new SkeletonStreamWriter( encoding ) );
 }
 
-// Initialize User
-inline void Device::initializeUser()
+// Set Joint Filter
+void Device::setFilter( const FilterParameters& parameters )
 {
-    #if (DEVICE != REALSENSE)
-    // Create User Tracker
-    NITE_CHECK( user_tracker.create() );
-    #else
-    // Retrive Connected Devices List
-    openni::Array<openni::DeviceInfo> device_info_list;
-    openni::OpenNI::enumerateDevices( &device_info_list );
-    if( !device_info_list.getSize() ){
-        throw std::runtime_error( "failed could not find devices" );
-        std::exit( EXIT_FAILURE );
+    for( SkeletonFilter& filter : filters ){
+        filter.setParameters( parameters );
     }
-
-    // Open Device
-    const openni::DeviceInfo& device_info = device_info_list[0];
-    const std::string device_uri = device_info.getUri();
-    OPENNI_CHECK( device.open( device_uri.c_str() ) );
-
-    // Create User Tracker
-    NITE_CHECK( user_tracker.create( &device ) );
-    #endif
-}
-
-// Finalize
-void Device::finalize()
-{
-    // Close Windows
-    cv::destroyAllWindows();
 }
 
 // Update Data
@@ -100,48 +35,35 @@ void Device::update()
 
     // Update Skeleton
     updateSkeleton();
-
-    // Update Depth
-    updateDepth();
 }
 
 // Update User
 inline void Device::updateUser()
 {
     // Update Frame
-    NITE_CHECK( user_tracker.readFrame( &user_frame ) );
+    readFrame();
 }
 
 // Update Skeleton
 inline void Device::updateSkeleton()
 {
     // Retrieve User
-    const nite::Array<nite::UserData>& users = user_frame.getUsers();
+    const std::vector<User>& users = capture_frame->users;
 
     // Start Tracking
-    #pragma omp parallel for
-    for( int32_t i = 0; i < users.getSize(); i++ ){
-        const nite::UserData& user = users[i];
-        if( user.isNew() ){
+    for( uint32_t i = 0; i < users.size(); i++ ){
+        const User& user = users[i];
+        if( user.is_new ){
             // Start Skeleton Tracking
-            user_tracker.startSkeletonTracking( user.getId() );
+            source->startSkeletonTracking( user.id );
         }
     }
-}
 
-// Update Depth
-inline void Device::updateDepth()
-{
-    // Retrieve Frame
-    depth_frame = user_frame.getDepthFrame();
-    if( !depth_frame.isValid() ){
-        throw std::runtime_error( "failed can not retrieve depth frame" );
-        std::exit( EXIT_FAILURE );
-    }
+    // Fill Skeleton Snapshot (Read by draw and write)
+    fillSnapshot( *capture_frame, capture_frame->skeleton );
 
-    // Retrive Frame Size
-    depth_width = depth_frame.getWidth();
-    depth_height = depth_frame.getHeight();
+    // Filter Joints (User ids are unique per sensor)
+    filters[capture_frame->sensor].apply( capture_frame->skeleton );
 }
 
 // Draw Data
@@ -154,31 +76,6 @@ void Device::draw()
     drawSkeleton();
 }
 
-// Draw Depth
-inline void Device::drawDepth()
-{
-    // Create cv::Mat form Depth Frame
-    depth_mat = cv::Mat( depth_height, depth_width, CV_16UC1, const_cast<void*>( depth_frame.getData() ) );
-}
-
-#if (DEVICE == REALSENSE)
-// Convert Joint Coordinates To Depth for RealSense
-inline nite::Status Device::convertJointCoordinatesToDepth( const float x, const float y, const float z, float * pOutX, float * pOutY )
-{
-    Rs2PointPixel proj = { 0.0 };
-    proj.point[0] = x;
-    proj.point[1] = y;
-    proj.point[2] = z;
-
-    OPENNI_CHECK( device.invoke( RS2_PROJECT_POINT_TO_PIXEL, reinterpret_cast<void*>( &proj ), static_cast<int>( sizeof( proj ) ) ) );
-
-    *pOutX = proj.pixel[0];
-    *pOutY = depth_height - proj.pixel[1];
-
-    return nite::Status::STATUS_OK;
-}
-#endif
-
 // Draw Skeleton
 inline void Device::drawSkeleton()
 {
@@ -186,68 +83,21 @@ inline void Device::drawSkeleton()
         return;
     }
 
-    // Scaling
-    depth_mat.convertTo( skeleton_mat, CV_8U, -255.0 / 10000.0, 255.0 ); // 0-10000 -> 255(white)-0(black)
-    //depth_mat.convertTo( skeleton_mat, CV_8U, 255.0 / 10000.0, 0.0 ); // 0-10000 -> 0(black)-255(white)
+    // Scaling and Convert GRAY to BGR (0-10000 -> 255(white)-0(black))
+    visualizeDepth( depth_mat, draw_mat, depth_kernel );
 
-    // Convert GRAY to BGR
-    cv::cvtColor( skeleton_mat, skeleton_mat, cv::COLOR_GRAY2BGR );
-
-    // Retrieve User
-    const nite::Array<nite::UserData>& users = user_frame.getUsers();
+    // Project Joints of Tracked Users (One Batch by Intrinsics of Frame)
+    constexpr float threshold = 0.7f;
+    projectJoints( frame->skeleton, frame->intrinsics, threshold, joint_batch );
 
     // Draw Skeleton Joints
-    #pragma omp parallel for
-    for( int32_t index = 0; index < users.getSize(); index++ ){
-        const nite::UserData& user = users[index];
-        if( user.isLost() ){
-            continue;
-        }
-
-        // Retrieve Skeleton
-        const nite::Skeleton& skeleton = user.getSkeleton();
-        if( skeleton.getState() != nite::SkeletonState::SKELETON_TRACKED ){
-            continue;
+    for( size_t i = 0; i < joint_batch.size(); i++ ){
+        const float x = joint_batch.depth_x[i];
+        const float y = joint_batch.depth_y[i];
+        if( 0.0f <= x && x < depth_width && 0.0f <= y && y < depth_height ){
+            const cv::Point point( static_cast<int32_t>( x ), static_cast<int32_t>( y ) );
+            cv::circle( draw_mat, point, 5, colors[joint_batch.user[i] % colors.size()], -1 );
         }
-
-        // Draw Joints
-        constexpr float threshold = 0.7f;
-        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
-            // Retrieve Joint
-            const nite::SkeletonJoint& joint = skeleton.getJoint( static_cast< nite::JointType >( type ) );
-            if( joint.getPositionConfidence() < threshold ){
-                continue;
-            }
-
-            // Retrieve Joint Position
-            const nite::Point3f& position = joint.getPosition();
-
-            // Convert Joint Coordinates to Depth
-            float x, y;
-            #if (DEVICE != REALSENSE)
-            NITE_CHECK( user_tracker.convertJointCoordinatesToDepth( position.x, position.y, position.z, &x, &y ) ); // for PrimeSensor
-            #else
-            NITE_CHECK( convertJointCoordinatesToDepth( position.x, position.y, position.z, &x, &y ) ); // for RealSense
-            #endif
-
-            // Draw Joint
-            const uint32_t depth_x = static_cast<uint32_t>( x );
-            const uint32_t depth_y = static_cast<uint32_t>( y );
-            if( 0 <= depth_x && depth_x < depth_width && 0 <= depth_y && depth_y < depth_height ){
-                const cv::Point point( depth_x, depth_y );
-                cv::circle( skeleton_mat, point, 5, colors[index], -1 );
-            }
-        }
-
-        /*
-        // Retrieve Bounding Box
-        const nite::BoundingBox& bounding_box = user.getBoundingBox();
-
-        // Draw Bouding Box
-        const cv::Point point_min( static_cast<uint32_t>( bounding_box.min.x ), static_cast<uint32_t>( bounding_box.min.y ) );
-        const cv::Point point_max( static_cast<uint32_t>( bounding_box.max.x ), static_cast<uint32_t>( bounding_box.max.y ) );
-        cv::rectangle( skeleton_mat, point_min, point_max, colors[index], 1 );
-        */
     }
 }
 
@@ -261,10 +111,46 @@ void Device::show()
 // Show Skeleton
 inline void Device::showSkeleton()
 {
-    if( skeleton_mat.empty() ){
+    if( image.mat.empty() ){
         return;
     }
 
     // Show Skeleton Image
-    cv::imshow( "Skeleton", skeleton_mat );
+    cv::imshow( "Skeleton", image.mat );
+}
+
+// Write Data
+void Device::write( std::ostream& stream )
+{
+    // Binary Skeleton Stream
+    if( stream_writer ){
+        convertSkeletonRecord( frame->skeleton, stream_record );
+        stream_writer->write( stream_record, stream );
+        return;
+    }
+
+    // Frame
+    stream << "{\"frame\":" << frame->frame_index << ",\"timestamp\":" << frame->sensor_timestamp;
+
+    // Sensor (Multiple Sensors)
+    if( 1 < source->sensorCount() ){
+        stream << ",\"sensor\":" << frame->sensor;
+    }
+
+    // Users (Tracked Skeletons of Snapshot)
+    const SkeletonSnapshot& skeleton = frame->skeleton;
+    stream << ",\"users\":[";
+    for( uint32_t number = 0; number < skeleton.count; number++ ){
+        stream << ( number ? "," : "" ) << "{\"id\":" << skeleton.ids[number];
+
+        // Joints (x, y, z [mm], position confidence)
+        stream << ",\"joints\":[";
+        for( uint32_t type = 0; type < JOINT_COUNT; type++ ){
+            const size_t lane = SkeletonSnapshot::lane( number, type );
+            stream << ( type ? "," : "" ) << "[" << skeleton.x[lane] << "," << skeleton.y[lane] << "," << skeleton.z[lane] << "," << skeleton.position_confidence[lane] << "]";
+        }
+        stream << "]";
+        stream << "}";
+    }
+    stream << "]}\n";
 }
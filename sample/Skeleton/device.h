@@ -5,69 +5,39 @@
 #include <NiTE.h>
 #include <opencv2/opencv.hpp>
 
-#include <array>
+#include "pipeline.h"
+#include "skeleton_filter.h"
+#include "user_source.h"
 
-#define USER_COUNT 6
-#define JOINT_COUNT 15
+#include <memory>
+#include <vector>
 
-// Specify Device
-// For RealSense https://github.com/IntelRealSense/librealsense/issues/2825
-#define PRIMESENSOR 0
-#define REALSENSE 1
-#define DEVICE PRIMESENSOR
-
-#if (DEVICE == REALSENSE)
-#define RS2_PROJECT_POINT_TO_PIXEL 0x1000
-struct Rs2PointPixel
-{
-    float point[3];
-    float pixel[2];
-};
-#endif
-
-class Device
+class Device : public Pipeline<UserSource, UserFrame>
 {
 private:
-    // Device
-    openni::Device device;
-
-    // Tracker
-    nite::UserTracker user_tracker;
+    // Joint Filters of Sensors (Owned by Capture Thread)
+    std::vector<SkeletonFilter> filters;
 
-    // User Buffer
-    nite::UserTrackerFrameRef user_frame;
-    cv::Mat skeleton_mat;
-    std::array<cv::Vec3b, USER_COUNT> colors;
+    // Projected Joints (Owned by Process Thread)
+    JointBatch joint_batch;
 
-    // Depth Buffer
-    openni::VideoFrameRef depth_frame;
-    cv::Mat depth_mat;
-    uint32_t depth_width = 640;
-    uint32_t depth_height = 480;
-    uint32_t depth_fps = 30;
+    // Skeleton Stream Writer (JSON if not set)
+    std::unique_ptr<SkeletonStreamWriter> stream_writer;
+    SkeletonRecord stream_record;
 
 public:
     // Constructor
-    Device();
+    explicit Device( std::unique_ptr<UserSource> source, const DepthKernel depth_kernel = DEPTH_KERNEL_SIMD );
 
-    // Destructor
-    ~Device();
+    // Set Skeleton Stream Encoding (Headless mode, single sensor only)
+    void setStreamEncoding( const StreamEncoding encoding );
 
-    // Processing
-    void run();
+    // Set Joint Filter
+    void setFilter( const FilterParameters& parameters );
 
 private:
-    // Initialize
-    void initialize();
-
-    // Initialize User
-    inline void initializeUser();
-
-    // Finalize
-    void finalize();
-
     // Update Data
-    void update();
+    void update() override;
 
     // Update User
     inline void updateUser();
@@ -75,28 +45,20 @@ private:
     // Update Skeleton
     inline void updateSkeleton();
 
-    // Update Depth
-    inline void updateDepth();
-
     // Draw Data
-    void draw();
+    void draw() override;
 
     // Draw Skeleton
     inline void drawSkeleton();
 
-    // Draw Depth
-    inline void drawDepth();
-
-    #if (DEVICE == REALSENSE)
-    // Convert Joint Coordinates to Depth for RealSense
-    inline nite::Status convertJointCoordinatesToDepth( const float x, const float y, const float z, float* pOutX, float* pOutY );
-    #endif
-
     // Show Data
-    void show();
+    void show() override;
 
     // Show Skeleton
     inline void showSkeleton();
+
+    // Write Data
+    void write( std::ostream& stream ) override;
 };
 
 #endif // __DEVICE__
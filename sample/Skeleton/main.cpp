@@ -2,11 +2,43 @@
 #include <sstream>
 
 #include "device.h"
+#include "options.h"
+#include "services.h"
 
 int main( int argc, char* argv[] )
 {
     try{
-        Device device;
+        // Options (Positional source and kernel, and "--NAME VALUE")
+        const Options options( argc, argv, 2, { "sink", "format", "filter", "telemetry", "events", "shared", "publish" } );
+
+        // Source ("": Connected Device, "*.oni": Playback File, "synthetic[:WIDTHxHEIGHT@FPS:USERS]" or "multi:[URI,...]")
+        const std::string uri = options.positional( 0 );
+
+        // Depth Visualization Kernel ("opencv", "lut" or "simd")
+        const DepthKernel depth_kernel = parseDepthKernel( options.positional( 1, "simd" ) );
+
+        Device device( createUserSource( uri ), depth_kernel );
+
+        // Joint Filter ("none", "oneeuro[:MIN_CUTOFF[:BETA[:DERIVATIVE_CUTOFF]]]" or "kalman[:ACCELERATION[:NOISE]]")
+        device.setFilter( parseFilter( options.get( "filter" ) ) );
+
+        // Services ("--telemetry", "--publish", "--shared" and "--events", see services.h)
+        SampleServices services( options );
+        services.attach( device );
+
+        // Headless Mode ("stdout", "file:PATH", "tcp:HOST:PORT" or "null", until SIGINT/SIGTERM)
+        if( options.has( "sink" ) ){
+            // Record Format ("json", "float32", "float16", "quantized" or "delta")
+            const std::string format = options.get( "format", "json" );
+            if( format != "json" ){
+                device.setStreamEncoding( parseStreamEncoding( format ) );
+            }
+
+            std::unique_ptr<Sink> sink = createSink( options.get( "sink" ) );
+            device.headless( *sink );
+            return 0;
+        }
+
         device.run();
     } catch( std::exception& ex ){
         std::cout << ex.what() << std::endl;
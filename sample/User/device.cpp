@@ -2,73 +2,16 @@
 #include "util.h"
 
 // Constructor
-Device::Device()
+Device::Device( std::unique_ptr<UserSource> source, const DepthKernel depth_kernel )
+    : Pipeline( std::move( source ), depth_kernel )
 {
-    // Initialize
-    initialize();
 }
 
-// Destructor
-Device::~Device()
+// Set Point Cloud Format
+void Device::setCloudFormat( const CloudFormat format, const float voxel_size )
 {
-    // Finalize
-    finalize();
-}
-
-// Processing
-void Device::run()
-{
-    // Main Loop
-    while( true ){
-        // Update Data
-        update();
-
-        // Draw Data
-        draw();
-
-        // Show Data
-        show();
-
-        // Key Check
-        const int32_t key = cv::waitKey( 10 );
-        if( key == 'q' ){
-            break;
-        }
-    }
-}
-
-// Initialize
-void Device::initialize()
-{
-    cv::setUseOptimized( true );
-
-    // Initiaize Nite2
-    NITE_CHECK( nite::NiTE::initialize() );
-
-    // Initialize User
-    initializeUser();
-
-    // Initalize Color Table for Visualization
-    colors[0] = cv::Vec3b( 255,   0,   0 ); // Blue
-    colors[1] = cv::Vec3b(   0, 255,   0 ); // Green
-    colors[2] = cv::Vec3b(   0,   0, 255 ); // Red
-    colors[3] = cv::Vec3b( 255, 255,   0 ); // Cyan
-    colors[4] = cv::Vec3b( 255,   0, 255 ); // Magenta
-    colors[5] = cv::Vec3b(   0, 255, 255 ); // Yellow
-}
-
-// Initialize User
-inline void Device::initializeUser()
-{
-    // Create User Tracker
-    NITE_CHECK( user_tracker.create() );
-}
-
-// Finalize
-void Device::finalize()
-{
-    // Close Windows
-    cv::destroyAllWindows();
+    cloud_builder.reset( new UserCloudBuilder( voxel_size ) );
+    cloud_writer.reset( new CloudWriter( format ) );
 }
 
 // Update Data
@@ -76,31 +19,13 @@ void Device::update()
 {
     // Update User
     updateUser();
-
-    // Update Depth
-    updateDepth();
 }
 
 // Update User
 inline void Device::updateUser()
 {
     // Update Frame
-    NITE_CHECK( user_tracker.readFrame( &user_frame ) );
-}
-
-// Update Depth
-inline void Device::updateDepth()
-{
-    // Retrieve Frame
-    depth_frame = user_frame.getDepthFrame();
-    if( !depth_frame.isValid() ){
-        throw std::runtime_error( "failed can not retrieve depth frame" );
-        std::exit( EXIT_FAILURE );
-    }
-
-    // Retrive Frame Size
-    depth_width = depth_frame.getWidth();
-    depth_height = depth_frame.getHeight();
+    readFrame();
 }
 
 // Draw Data
@@ -113,13 +38,6 @@ void Device::draw()
     drawUser();
 }
 
-// Draw Depth
-inline void Device::drawDepth()
-{
-    // Create cv::Mat form Depth Frame
-    depth_mat = cv::Mat( depth_height, depth_width, CV_16UC1, const_cast<void*>( depth_frame.getData() ) );
-}
-
 // Draw User
 inline void Device::drawUser()
 {
@@ -127,25 +45,8 @@ inline void Device::drawUser()
         return;
     }
 
-    // Scaling
-    depth_mat.convertTo( user_mat, CV_8U, -255.0 / 10000.0, 255.0 ); // 0-10000 -> 255(white)-0(black)
-    //depth_mat.convertTo( user_mat, CV_8U, 255.0 / 10000.0, 0.0 ); // 0-10000 -> 0(black)-255(white)
-
-    // Convert GRAY to BGR
-    cv::cvtColor( user_mat, user_mat, cv::COLOR_GRAY2BGR );
-
-    // Retrieve User Map
-    const nite::UserMap& user_map = user_frame.getUserMap();
-
-    // Draw User Area
-    const nite::UserId* user_id = user_map.getPixels();
-    user_mat.forEach<cv::Vec3b>( [&]( cv::Vec3b& p, const int* position ){
-        const uint32_t index = position[0] * depth_width + position[1];
-        const uint16_t id    = user_id[index];
-        if( id != 0 && id <= USER_COUNT ){
-            p = colors[id - 1];
-        }
-    } );
+    // Draw User Area over Depth (Fused Scaling, GRAY to BGR and User Color)
+    visualizeUser( depth_mat, frame->user_map, colors.data(), static_cast<uint32_t>( colors.size() ), draw_mat, depth_kernel );
 }
 
 // Show Data
@@ -158,10 +59,45 @@ void Device::show()
 // Show User
 inline void Device::showUser()
 {
-    if( user_mat.empty() ){
+    if( image.mat.empty() ){
         return;
     }
 
     // Show User Image
-    cv::imshow( "User", user_mat );
+    cv::imshow( "User", image.mat );
+}
+
+// Write Data
+void Device::write( std::ostream& stream )
+{
+    // Per-User Point Clouds
+    if( cloud_writer ){
+        cloud_builder->build( frame->depth_mat, frame->user_map, frame->intrinsics );
+        cloud_writer->write( *cloud_builder, static_cast<uint32_t>( frame->frame_index ), frame->sensor_timestamp, stream );
+        return;
+    }
+
+    // Frame
+    stream << "{\"frame\":" << frame->frame_index << ",\"timestamp\":" << frame->sensor_timestamp;
+
+    // Sensor (Multiple Sensors)
+    if( 1 < source->sensorCount() ){
+        stream << ",\"sensor\":" << frame->sensor;
+    }
+
+    // Users (Center of Mass and Bounding Box)
+    stream << ",\"users\":[";
+    bool first = true;
+    for( const User& user : frame->users ){
+        if( user.is_lost ){
+            continue;
+        }
+
+        const nite::Point3f& center = user.center_of_mass;
+        stream << ( first ? "" : "," ) << "{\"id\":" << user.id << ",\"visible\":" << user.is_visible;
+        stream << ",\"center_of_mass\":[" << center.x << "," << center.y << "," << center.z << "]";
+        stream << ",\"bounding_box\":[" << user.bounding_box_min.x << "," << user.bounding_box_min.y << "," << user.bounding_box_max.x << "," << user.bounding_box_max.y << "]}";
+        first = false;
+    }
+    stream << "]}\n";
 }
@@ -1,74 +1,51 @@
 #ifndef __DEVICE__
 #define __DEVICE__
 
+#include <OpenNI.h>
 #include <NiTE.h>
 #include <opencv2/opencv.hpp>
 
-#include <array>
+#include "pipeline.h"
+#include "point_cloud.h"
+#include "user_source.h"
 
-#define USER_COUNT 6
+#include <memory>
 
-class Device
+class Device : public Pipeline<UserSource, UserFrame>
 {
 private:
-    // Tracker
-    nite::UserTracker user_tracker;
-
-    // User Buffer
-    nite::UserTrackerFrameRef user_frame;
-    cv::Mat user_mat;
-    std::array<cv::Vec3b, USER_COUNT> colors;
-
-    // Depth Buffer
-    openni::VideoFrameRef depth_frame;
-    cv::Mat depth_mat;
-    uint32_t depth_width = 640;
-    uint32_t depth_height = 480;
-    uint32_t depth_fps = 30;
+    // Point Cloud Builder and Writer (JSON if not set)
+    std::unique_ptr<UserCloudBuilder> cloud_builder;
+    std::unique_ptr<CloudWriter> cloud_writer;
 
 public:
     // Constructor
-    Device();
-
-    // Destructor
-    ~Device();
+    explicit Device( std::unique_ptr<UserSource> source, const DepthKernel depth_kernel = DEPTH_KERNEL_SIMD );
 
-    // Processing
-    void run();
+    // Set Point Cloud Format (Headless mode)
+    void setCloudFormat( const CloudFormat format, const float voxel_size );
 
 private:
-    // Initialize
-    void initialize();
-
-    // Initialize User
-    inline void initializeUser();
-
-    // Finalize
-    void finalize();
-
     // Update Data
-    void update();
+    void update() override;
 
     // Update User
     inline void updateUser();
 
-    // Update Depth
-    inline void updateDepth();
-
     // Draw Data
-    void draw();
+    void draw() override;
 
     // Draw User
     inline void drawUser();
 
-    // Draw Depth
-    inline void drawDepth();
-
     // Show Data
-    void show();
+    void show() override;
 
     // Show User
     inline void showUser();
+
+    // Write Data
+    void write( std::ostream& stream ) override;
 };
 
 #endif // __DEVICE__